@@ -0,0 +1,461 @@
+// End-to-end control path benchmarks. These drive a real AudioManager against
+// the session's audio server (PulseAudio or pipewire-pulse; a headless
+// instance is fine), so numbers include the pactl round trips users pay for.
+//
+//   bench_wavemux --benchmark_out=bench.json --benchmark_out_format=json
+//
+// Stop wavemuxd first: the benchmarks create and remove the channel sinks.
+// Everything else created here (null sinks, loopbacks, playback clients) is
+// removed again on exit.
+#include <benchmark/benchmark.h>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QLoggingCategory>
+#include <QProcess>
+#include <QRegularExpression>
+#include <QStringList>
+#include <QTimer>
+#include <functional>
+#include <memory>
+#include "audiomanager.h"
+#include "pactlparser.h"
+#include "wavemux/types.h"
+
+namespace {
+    constexpr int TIMEOUT_MS = 10000;
+    const QString LOAD_SINK = "wavemux_bench_load";
+    const QStringList OUTPUT_SINKS = {"wavemux_bench_out_a", "wavemux_bench_out_b"};
+
+    QString run(const QString &command) {
+        QProcess process;
+        process.start("sh", {"-c", command});
+        process.waitForFinished(60000);
+        return QString::fromUtf8(process.readAllStandardOutput()).trimmed();
+    }
+
+    bool serverAvailable() {
+        return QProcess::execute("pactl", {"info"}) == 0;
+    }
+
+    // Runs the event loop until done() holds; false on timeout
+    bool waitFor(const std::function<bool()> &done, int timeoutMs = TIMEOUT_MS) {
+        QElapsedTimer timer;
+        timer.start();
+        while (!done()) {
+            if (timer.elapsed() > timeoutMs) {
+                return false;
+            }
+            QEventLoop loop;
+            QTimer::singleShot(1, &loop, &QEventLoop::quit);
+            loop.exec();
+        }
+        return true;
+    }
+
+    void loadNullSink(const QString &name) {
+        run(QString("pactl list sinks short | grep -q '\\s%1\\s' || "
+                    "pactl load-module module-null-sink sink_name=%1").arg(name));
+    }
+
+    void unloadNullSinks() {
+        run("pactl list modules short | grep 'sink_name=wavemux_bench_' | cut -f1 | xargs -r -n1 pactl unload-module");
+    }
+
+    void unloadChannelSinks() {
+        run("pactl list modules short | grep -E 'sink_name=wavemux_(game|chat|media|aux|unassigned)' "
+            "| cut -f1 | xargs -r -n1 pactl unload-module");
+    }
+
+    // Idle sink-inputs for list and routing load: loopbacks between the
+    // monitor and the input of a suspended null sink, which keeps a couple of
+    // thousand of them from costing the server any processing
+    class StreamLoad {
+    public:
+        ~StreamLoad() { resize(0); }
+
+        void resize(int count) {
+            if (count > 0) {
+                loadNullSink(LOAD_SINK);
+                run(QString("pactl suspend-sink %1 1").arg(LOAD_SINK));
+            }
+            if (count > m_modules.size()) {
+                const QString output = run(QString(
+                    "for i in $(seq %1); do pactl load-module module-loopback source=%2.monitor sink=%2 "
+                    "source_dont_move=true sink_dont_move=true; done").arg(count - m_modules.size()).arg(LOAD_SINK));
+                m_modules += output.split('\n', Qt::SkipEmptyParts);
+            } else if (count < m_modules.size()) {
+                run("for m in " + m_modules.mid(count).join(' ') + "; do pactl unload-module $m; done");
+                m_modules = m_modules.mid(0, count);
+            }
+        }
+
+    private:
+        QStringList m_modules;  // Loopback module indexes
+    };
+
+    // An application playing into the default sink, as the daemon sees a new
+    // stream. pacat gets no data, so the stream idles until killed.
+    class PlaybackClient {
+    public:
+        explicit PlaybackClient(const QString &name) {
+            m_process.start("pacat", {"--playback", "--raw", "--client-name=" + name, "--stream-name=" + name});
+            m_process.waitForStarted(TIMEOUT_MS);
+        }
+        ~PlaybackClient() {
+            m_process.kill();
+            m_process.waitForFinished(TIMEOUT_MS);
+        }
+
+    private:
+        QProcess m_process;
+    };
+
+    // The manager shared by the steady-state benchmarks. Startup benchmarks
+    // release it so they start from the state they are measuring.
+    std::unique_ptr<WaveMux::AudioManager> g_manager;
+
+    WaveMux::AudioManager *sharedManager(benchmark::State &state) {
+        if (!serverAvailable()) {
+            state.SkipWithError("No audio server (pactl info failed)");
+            return nullptr;
+        }
+        if (!g_manager) {
+            g_manager = std::make_unique<WaveMux::AudioManager>();
+            if (!g_manager->initialize()) {
+                g_manager.reset();
+            }
+        }
+        if (!g_manager) {
+            state.SkipWithError("AudioManager failed to initialize");
+        }
+        return g_manager.get();
+    }
+
+    void releaseSharedManager() {
+        if (g_manager) {
+            g_manager->shutdown();
+            g_manager.reset();
+        }
+    }
+}
+
+// Startup with no sinks left over: every channel sink is created
+static void BM_StartupCold(benchmark::State &state) {
+    if (!serverAvailable()) {
+        state.SkipWithError("No audio server (pactl info failed)");
+        return;
+    }
+    releaseSharedManager();
+    for (auto _ : state) {
+        state.PauseTiming();
+        unloadChannelSinks();
+        state.ResumeTiming();
+
+        WaveMux::AudioManager manager;
+        const bool initialized = manager.initialize();
+
+        state.PauseTiming();
+        if (!initialized) {
+            state.SkipWithError("AudioManager failed to initialize");
+        }
+        manager.shutdown();
+        state.ResumeTiming();
+        if (!initialized) {
+            break;
+        }
+    }
+}
+BENCHMARK(BM_StartupCold)->Unit(benchmark::kMillisecond)->Iterations(5);
+
+// Restart over the sinks of a previous instance (e.g. after a crash), which
+// are adopted instead of created
+static void BM_StartupWarm(benchmark::State &state) {
+    if (!serverAvailable()) {
+        state.SkipWithError("No audio server (pactl info failed)");
+        return;
+    }
+    releaseSharedManager();
+    for (auto _ : state) {
+        state.PauseTiming();
+        for (const char *id : {"game", "chat", "media", "aux", "unassigned"}) {
+            loadNullSink(QString("wavemux_") + id);
+        }
+        state.ResumeTiming();
+
+        WaveMux::AudioManager manager;
+        const bool initialized = manager.initialize();
+
+        state.PauseTiming();
+        if (!initialized) {
+            state.SkipWithError("AudioManager failed to initialize");
+        }
+        manager.shutdown();
+        state.ResumeTiming();
+        if (!initialized) {
+            break;
+        }
+    }
+}
+BENCHMARK(BM_StartupWarm)->Unit(benchmark::kMillisecond)->Iterations(5);
+
+// Channel fader: applied once the server has taken the new volume
+static void BM_ChannelFaderToApplied(benchmark::State &state) {
+    WaveMux::AudioManager *manager = sharedManager(state);
+    if (!manager) {
+        return;
+    }
+    int volume = 0;
+    for (auto _ : state) {
+        volume = (volume + 7) % 101;
+        if (!manager->setChannelVolume("game", volume)) {
+            state.SkipWithError("setChannelVolume failed");
+            break;
+        }
+    }
+}
+BENCHMARK(BM_ChannelFaderToApplied)->Unit(benchmark::kMillisecond);
+
+// Application fader: queued, so applied is when the command queue drains
+static void BM_AppFaderToApplied(benchmark::State &state) {
+    WaveMux::AudioManager *manager = sharedManager(state);
+    if (!manager) {
+        return;
+    }
+    uint32_t streamId = 0;
+    auto connection = QObject::connect(manager, &WaveMux::AudioManager::streamAdded,
+        [&streamId](uint32_t id, const QString &appName) {
+            if (appName == "wavemux-bench-fader") {
+                streamId = id;
+            }
+        });
+    PlaybackClient client("wavemux-bench-fader");
+    const bool seen = waitFor([&]() { return streamId != 0; });
+    QObject::disconnect(connection);
+    if (!seen) {
+        state.SkipWithError("Playback stream never appeared");
+        return;
+    }
+
+    int volume = 0;
+    for (auto _ : state) {
+        volume = (volume + 7) % 101;
+        manager->setStreamVolume(streamId, volume);
+        if (!waitFor([&]() { return !manager->hasPendingCommands(); })) {
+            state.SkipWithError("Command queue did not drain");
+            break;
+        }
+    }
+}
+BENCHMARK(BM_AppFaderToApplied)->Unit(benchmark::kMillisecond);
+
+// ListStreams with a growing number of sink-inputs on the server
+static void BM_ListStreams(benchmark::State &state) {
+    WaveMux::AudioManager *manager = sharedManager(state);
+    if (!manager) {
+        return;
+    }
+    StreamLoad load;
+    load.resize(static_cast<int>(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(manager->listStreams());
+    }
+    state.counters["sink_inputs"] = static_cast<double>(state.range(0));
+}
+BENCHMARK(BM_ListStreams)->Arg(10)->Arg(100)->Arg(500)->Arg(2000)->Unit(benchmark::kMillisecond);
+
+// A `pactl list sink-inputs` dump of this many streams, as libpulse prints it
+static QByteArray sinkInputDump(int streams) {
+    QByteArray dump;
+    for (int i = 1; i <= streams; ++i) {
+        dump += QString("Sink Input #%1\n"
+                        "\tDriver: protocol-native.c\n"
+                        "\tOwner Module: 10\n"
+                        "\tClient: %2\n"
+                        "\tSink: 3\n"
+                        "\tSample Specification: float32le 2ch 48000Hz\n"
+                        "\tChannel Map: front-left,front-right\n"
+                        "\tFormat: pcm, format.sample_format = \"\\\"float32le\\\"\"  format.rate = \"48000\"\n"
+                        "\tCorked: no\n"
+                        "\tMute: no\n"
+                        "\tVolume: front-left: 42598 /  65% / -11.23 dB,   front-right: 42598 /  65% / -11.23 dB\n"
+                        "\t        balance 0.00\n"
+                        "\tBuffer Latency: 20000 usec\n"
+                        "\tSink Latency: 0 usec\n"
+                        "\tResample method: n/a\n"
+                        "\tProperties:\n"
+                        "\t\tmedia.name = \"Playback\"\n"
+                        "\t\tapplication.name = \"App %1\"\n"
+                        "\t\tnative-protocol.peer = \"UNIX socket client\"\n"
+                        "\t\tnative-protocol.version = \"35\"\n"
+                        "\t\tapplication.process.id = \"%2\"\n"
+                        "\t\tapplication.process.user = \"user\"\n"
+                        "\t\tapplication.process.host = \"host\"\n"
+                        "\t\tapplication.process.binary = \"app-%1\"\n"
+                        "\t\tapplication.language = \"C\"\n"
+                        "\t\tmodule-stream-restore.id = \"sink-input-by-application-name:App %1\"\n"
+                        "\n").arg(i).arg(1000 + i).toUtf8();
+    }
+    return dump;
+}
+
+// What listStreams() extracted from a dump before PactlListing: split into
+// lines, trim and slice every line as a QString
+static void BM_ParseSinkInputsLineSplit(benchmark::State &state) {
+    const QString dump = QString::fromUtf8(sinkInputDump(static_cast<int>(state.range(0))));
+    static const QRegularExpression volumeRe("(\\d+)%");
+    for (auto _ : state) {
+        QList<WaveMux::Stream> streams;
+        WaveMux::Stream current;
+        for (const auto &line : dump.split('\n')) {
+            const QString trimmed = line.trimmed();
+            if (trimmed.startsWith("Sink Input #")) {
+                if (current.id > 0) {
+                    streams.append(current);
+                }
+                current = WaveMux::Stream();
+                current.id = trimmed.mid(12).toUInt();
+            } else if (trimmed.startsWith("Volume:")) {
+                auto match = volumeRe.match(trimmed);
+                if (match.hasMatch()) {
+                    current.volume = match.captured(1).toInt();
+                }
+            } else if (trimmed.startsWith("Mute:")) {
+                current.muted = trimmed.endsWith("yes");
+            } else if (trimmed.startsWith("application.name = ")) {
+                current.appName = trimmed.mid(19).remove('"');
+            } else if (trimmed.startsWith("media.name = ")) {
+                current.mediaName = trimmed.mid(13).remove('"');
+            } else if (trimmed.startsWith("application.process.binary = ")) {
+                current.processName = trimmed.mid(29).remove('"');
+            }
+        }
+        if (current.id > 0) {
+            streams.append(current);
+        }
+        benchmark::DoNotOptimize(streams);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ParseSinkInputsLineSplit)->Arg(10)->Arg(100)->Arg(500)->Arg(2000);
+
+// The same extraction through PactlListing (what listStreams() does now)
+static void BM_ParseSinkInputs(benchmark::State &state) {
+    const QByteArray dump = sinkInputDump(static_cast<int>(state.range(0)));
+    auto text = [](std::string_view value) {
+        return QString::fromUtf8(value.data(), static_cast<qsizetype>(value.size()));
+    };
+    for (auto _ : state) {
+        const WaveMux::PactlListing listing(std::string_view(dump.constData(), static_cast<size_t>(dump.size())));
+        QList<WaveMux::Stream> streams;
+        streams.reserve(static_cast<qsizetype>(listing.size()));
+        for (size_t i = 0; i < listing.size(); ++i) {
+            WaveMux::Stream stream;
+            stream.id = listing[i].index;
+            stream.volume = WaveMux::PactlListing::volumePercent(listing.field(i, "Volume")).value_or(100);
+            stream.muted = listing.field(i, "Mute") == "yes";
+            stream.appName = text(listing.property(i, "application.name"));
+            stream.mediaName = text(listing.property(i, "media.name"));
+            stream.processName = text(listing.property(i, "application.process.binary"));
+            streams.append(stream);
+        }
+        benchmark::DoNotOptimize(streams);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ParseSinkInputs)->Arg(10)->Arg(100)->Arg(500)->Arg(2000);
+
+// The routing decision alone (no server work), with the match in last place
+static void BM_RoutingDecision(benchmark::State &state) {
+    WaveMux::AudioManager manager;  // Rules need no initialized server state
+    const int rules = static_cast<int>(state.range(0));
+    for (int i = 0; i < rules - 1; ++i) {
+        manager.addRoutingRule(QString("^bench-app-%1$").arg(i), "game");
+    }
+    manager.addRoutingRule("wavemux-bench-routed", "chat");
+    const QString appName = "wavemux-bench-routed";
+    const QString processName = "pacat";
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(manager.matchRoutingRule(appName, processName));
+    }
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_RoutingDecision)->RangeMultiplier(4)->Range(1, 1024)->Complexity();
+
+// From a client connecting to its stream sitting in the channel a rule picks
+static void BM_NewStreamToRouted(benchmark::State &state) {
+    WaveMux::AudioManager *manager = sharedManager(state);
+    if (!manager) {
+        return;
+    }
+    manager->addRoutingRule("wavemux-bench-routed", "chat");
+    uint32_t streamId = 0;
+    auto connection = QObject::connect(manager, &WaveMux::AudioManager::streamAdded,
+        [&streamId](uint32_t id, const QString &appName) {
+            if (appName == "wavemux-bench-routed") {
+                streamId = id;
+            }
+        });
+
+    for (auto _ : state) {
+        streamId = 0;
+        QElapsedTimer timer;
+        timer.start();
+        auto client = std::make_unique<PlaybackClient>("wavemux-bench-routed");
+        const bool routed = waitFor([&]() {
+            return streamId != 0 && manager->getStreamChannel(streamId) == "chat";
+        });
+        state.SetIterationTime(timer.nsecsElapsed() / 1e9);
+
+        client.reset();
+        const uint32_t removed = streamId;
+        waitFor([&]() { return manager->getStreamChannel(removed).isEmpty(); }, 2000);
+        if (!routed) {
+            state.SkipWithError("Stream was not routed");
+            break;
+        }
+    }
+    QObject::disconnect(connection);
+    manager->removeRoutingRule("wavemux-bench-routed");
+}
+BENCHMARK(BM_NewStreamToRouted)->UseManualTime()->Unit(benchmark::kMillisecond)->Iterations(20);
+
+// Switching the personal mix between two output devices
+static void BM_OutputDeviceSwitch(benchmark::State &state) {
+    WaveMux::AudioManager *manager = sharedManager(state);
+    if (!manager) {
+        return;
+    }
+    for (const auto &sink : OUTPUT_SINKS) {
+        loadNullSink(sink);
+    }
+    const QString previous = manager->getOutputDevice();
+    int next = 0;
+    for (auto _ : state) {
+        if (!manager->setOutputDevice(OUTPUT_SINKS[next])) {
+            state.SkipWithError("setOutputDevice failed");
+            break;
+        }
+        next ^= 1;
+    }
+    manager->setOutputDevice(previous);
+}
+BENCHMARK(BM_OutputDeviceSwitch)->Unit(benchmark::kMillisecond);
+
+int main(int argc, char **argv) {
+    QCoreApplication app(argc, argv);
+    WaveMux::registerMetaTypes();
+    // The manager logs graph changes; keep the report readable
+    QLoggingCategory::setFilterRules("wavemux.*.debug=false\nwavemux.*.info=false");
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+
+    releaseSharedManager();
+    unloadNullSinks();
+    return 0;
+}
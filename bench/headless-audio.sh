@@ -0,0 +1,78 @@
+#!/bin/sh
+# Runs a command against a private, headless PipeWire: its own runtime
+# directory, D-Bus session and pipewire-pulse socket, with WirePlumber's
+# device monitors off so no hardware is touched and a null sink as the only
+# output. The user's own audio session is left alone.
+#
+#   bench/headless-audio.sh ./stress_wavemux --streams 300
+#
+# Exits 77 (skipped) when PipeWire isn't installed.
+set -eu
+
+for tool in pipewire pipewire-pulse wireplumber pactl pacat dbus-run-session; do
+    if ! command -v "$tool" >/dev/null 2>&1; then
+        echo "headless-audio: $tool not found, skipping" >&2
+        exit 77
+    fi
+done
+
+if [ -z "${WAVEMUX_HEADLESS_SESSION:-}" ]; then
+    # Re-run inside a private D-Bus session so WirePlumber can't reach the real one
+    WAVEMUX_HEADLESS_SESSION=1 exec dbus-run-session -- "$0" "$@"
+fi
+
+runtime=$(mktemp -d "${TMPDIR:-/tmp}/wavemux-headless.XXXXXX")
+pids=""
+cleanup() {
+    for pid in $pids; do
+        kill "$pid" 2>/dev/null || true
+    done
+    wait 2>/dev/null || true
+    rm -rf "$runtime"
+}
+trap cleanup EXIT
+trap "exit 130" INT TERM
+
+export XDG_RUNTIME_DIR="$runtime"
+export XDG_CONFIG_HOME="$runtime/config"
+export XDG_STATE_HOME="$runtime/state"
+export PULSE_SERVER="unix:$runtime/pulse/native"
+unset PIPEWIRE_REMOTE PULSE_RUNTIME_PATH
+
+mkdir -p "$XDG_CONFIG_HOME/wireplumber/wireplumber.conf.d"
+cat > "$XDG_CONFIG_HOME/wireplumber/wireplumber.conf.d/50-headless.conf" <<'CONF'
+wireplumber.profiles = {
+  main = {
+    monitor.alsa = disabled
+    monitor.alsa-midi = disabled
+    monitor.bluez = disabled
+    monitor.libcamera = disabled
+    monitor.v4l2 = disabled
+  }
+}
+CONF
+
+pipewire >"$runtime/pipewire.log" 2>&1 &
+pids="$pids $!"
+wireplumber >"$runtime/wireplumber.log" 2>&1 &
+pids="$pids $!"
+pipewire-pulse >"$runtime/pipewire-pulse.log" 2>&1 &
+pids="$pids $!"
+
+tries=0
+until pactl info >/dev/null 2>&1; do
+    tries=$((tries + 1))
+    if [ "$tries" -gt 100 ]; then
+        echo "headless-audio: pipewire-pulse did not come up" >&2
+        cat "$runtime"/*.log >&2
+        exit 1
+    fi
+    sleep 0.1
+done
+
+pactl load-module module-null-sink sink_name=headless_output >/dev/null
+pactl set-default-sink headless_output
+
+status=0
+"$@" || status=$?
+exit "$status"
@@ -0,0 +1,239 @@
+// Offline render: runs the mix graph over per-channel input files and a
+// script of level changes (see RenderScript in offlinerender.h), faster than
+// real time and without an audio server, then checks the mixes against
+// reference files and for clicks. Prints the render speed, so it doubles as
+// a DSP throughput benchmark:
+//
+//   render_wavemux --script bench/render/level-changes.txt --input game=game.wav
+//                  --input chat=sine:1000:0.5 --reference stream=expected.wav --check-clicks
+//
+// Inputs are WAV files (mono is played on both sides) or sine:<hz>[:<amplitude>]
+// tones. Exits 1 if a check fails and 2 for bad arguments or input.
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <string>
+#include <vector>
+#include "offlinerender.h"
+#include "wavfilereader.h"
+#include "wavfilewriter.h"
+
+namespace {
+    constexpr int SAMPLE_RATE = 48000;
+    constexpr double DEFAULT_SECONDS = 10.0;
+    constexpr float DEFAULT_TOLERANCE = 1e-4f;
+
+    struct Options {
+        std::string script;
+        std::map<std::string, std::string> inputs;      // channel -> file or tone
+        std::map<std::string, std::string> references;  // mix -> file
+        std::map<std::string, std::string> outputs;     // mix -> file
+        double seconds = 0.0;                           // 0: as long as the longest input
+        float tolerance = DEFAULT_TOLERANCE;
+        bool checkClicks = false;
+        float clickThreshold = 0.0f;                    // 0: derived from the inputs
+        int repeat = 1;
+    };
+
+    void usage() {
+        std::fprintf(stderr,
+            "usage: render_wavemux [--script FILE] --input CHANNEL=FILE.wav|sine:HZ[:AMP] ...\n"
+            "                      [--seconds N] [--personal OUT.wav] [--stream OUT.wav]\n"
+            "                      [--reference personal|stream=FILE.wav] [--tolerance X]\n"
+            "                      [--check-clicks] [--click-threshold X] [--repeat N]\n");
+    }
+
+    bool splitPair(const std::string &text, std::string *key, std::string *value) {
+        const size_t equals = text.find('=');
+        if (equals == std::string::npos || equals == 0 || equals + 1 == text.size()) {
+            return false;
+        }
+        *key = text.substr(0, equals);
+        *value = text.substr(equals + 1);
+        return true;
+    }
+
+    bool parseOptions(int argc, char **argv, Options *options) {
+        for (int i = 1; i < argc; ++i) {
+            const std::string arg = argv[i];
+            const char *value = i + 1 < argc ? argv[i + 1] : nullptr;
+            std::string key;
+            std::string file;
+            if (arg == "--check-clicks") {
+                options->checkClicks = true;
+                continue;
+            }
+            if (!value) {
+                return false;
+            }
+            ++i;
+            if (arg == "--script") {
+                options->script = value;
+            } else if (arg == "--input" && splitPair(value, &key, &file)) {
+                options->inputs[key] = file;
+            } else if (arg == "--reference" && splitPair(value, &key, &file)
+                       && (key == "personal" || key == "stream")) {
+                options->references[key] = file;
+            } else if (arg == "--personal" || arg == "--stream") {
+                options->outputs[arg.substr(2)] = value;
+            } else if (arg == "--seconds") {
+                options->seconds = std::atof(value);
+            } else if (arg == "--tolerance") {
+                options->tolerance = static_cast<float>(std::atof(value));
+            } else if (arg == "--click-threshold") {
+                options->clickThreshold = static_cast<float>(std::atof(value));
+            } else if (arg == "--repeat") {
+                options->repeat = std::max(1, std::atoi(value));
+            } else {
+                return false;
+            }
+        }
+        return !options->inputs.empty();
+    }
+
+    // Stereo at SAMPLE_RATE, from a file or a tone spec
+    bool loadInput(const std::string &spec, size_t toneFrames, std::vector<float> *samples, std::string *error) {
+        if (spec.rfind("sine:", 0) == 0) {
+            char *end = nullptr;
+            const double frequency = std::strtod(spec.c_str() + 5, &end);
+            const double amplitude = *end == ':' ? std::strtod(end + 1, &end) : 0.5;
+            if (*end != '\0' || frequency <= 0.0) {
+                *error = "bad tone " + spec;
+                return false;
+            }
+            samples->resize(toneFrames * WaveMux::MixGraph::CHANNELS);
+            for (size_t frame = 0; frame < toneFrames; ++frame) {
+                const double phase = 2.0 * M_PI * frequency * frame / SAMPLE_RATE;
+                const float value = static_cast<float>(amplitude * std::sin(phase));
+                (*samples)[frame * 2] = value;
+                (*samples)[frame * 2 + 1] = value;
+            }
+            return true;
+        }
+
+        WaveMux::WavAudio audio;
+        if (!WaveMux::readWavFile(spec, &audio, error)) {
+            return false;
+        }
+        if (audio.sampleRate != SAMPLE_RATE || audio.channels > 2) {
+            *error = spec + ": needs " + std::to_string(SAMPLE_RATE) + " Hz mono or stereo";
+            return false;
+        }
+        if (audio.channels == 2) {
+            *samples = std::move(audio.samples);
+        } else {
+            samples->resize(audio.samples.size() * 2);
+            for (size_t i = 0; i < audio.samples.size(); ++i) {
+                (*samples)[i * 2] = audio.samples[i];
+                (*samples)[i * 2 + 1] = audio.samples[i];
+            }
+        }
+        return true;
+    }
+
+    bool writeOutput(const std::string &path, const std::vector<float> &samples) {
+        WaveMux::WavFileWriter writer;
+        return writer.open(path, SAMPLE_RATE, WaveMux::MixGraph::CHANNELS, false)
+            && writer.write(samples.data(), samples.size()) && writer.close();
+    }
+}
+
+int main(int argc, char **argv) {
+    Options options;
+    if (!parseOptions(argc, argv, &options)) {
+        usage();
+        return 2;
+    }
+
+    WaveMux::RenderScript script;
+    if (!options.script.empty()) {
+        std::ifstream file(options.script);
+        const std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        std::string error;
+        if (!file || !script.parse(text, &error)) {
+            std::fprintf(stderr, "%s: %s\n", options.script.c_str(), file ? error.c_str() : "cannot read");
+            return 2;
+        }
+    }
+
+    const double toneSeconds = options.seconds > 0.0 ? options.seconds : DEFAULT_SECONDS;
+    const size_t toneFrames = static_cast<size_t>(toneSeconds * SAMPLE_RATE);
+    WaveMux::OfflineRenderer renderer(SAMPLE_RATE);
+    float inputRoughness = 0.0f;  // Sum of the inputs' largest second differences
+    for (const auto &[channel, spec] : options.inputs) {
+        std::vector<float> samples;
+        std::string error;
+        if (!loadInput(spec, toneFrames, &samples, &error)) {
+            std::fprintf(stderr, "%s\n", error.c_str());
+            return 2;
+        }
+        inputRoughness += WaveMux::maxSecondDifference(samples);
+        if (!renderer.setInput(channel, std::move(samples))) {
+            std::fprintf(stderr, "unknown channel %s\n", channel.c_str());
+            return 2;
+        }
+    }
+
+    // Each repeat starts from the same levels; the fastest run is reported
+    const size_t frames = static_cast<size_t>(options.seconds * SAMPLE_RATE);
+    WaveMux::OfflineRenderer::Result result;
+    double bestSeconds = 0.0;
+    for (int run = 0; run < options.repeat; ++run) {
+        for (const char *channel : WaveMux::OfflineRenderer::CHANNEL_IDS) {
+            renderer.setLevels(channel, WaveMux::RenderLevels());
+        }
+        renderer.setMasterVolume(100);
+        result = renderer.render(script, frames);
+        if (run == 0 || result.wallSeconds < bestSeconds) {
+            bestSeconds = result.wallSeconds;
+        }
+    }
+    const double audioSeconds = static_cast<double>(result.frames) / SAMPLE_RATE;
+    std::printf("Rendered %.1f s of both mixes in %.3f s (%.0fx real time)\n", audioSeconds, bestSeconds,
+                bestSeconds > 0.0 ? audioSeconds / bestSeconds : 0.0);
+
+    const std::map<std::string, const std::vector<float> *> mixes = {
+        {"personal", &result.personal},
+        {"stream", &result.stream},
+    };
+    for (const auto &[mix, path] : options.outputs) {
+        if (!writeOutput(path, *mixes.at(mix))) {
+            std::fprintf(stderr, "cannot write %s\n", path.c_str());
+            return 2;
+        }
+    }
+
+    bool passed = true;
+    for (const auto &[mix, path] : options.references) {
+        std::vector<float> reference;
+        std::string error;
+        if (!loadInput(path, 0, &reference, &error)) {
+            std::fprintf(stderr, "%s\n", error.c_str());
+            return 2;
+        }
+        const WaveMux::SignalDifference difference = WaveMux::compareSignals(*mixes.at(mix), reference);
+        const bool matched = difference.maxError <= options.tolerance;
+        std::printf("%s vs %s: max error %.2e at %.4f s: %s\n", mix.c_str(), path.c_str(), difference.maxError,
+                    static_cast<double>(difference.frame) / SAMPLE_RATE, matched ? "ok" : "MISMATCH");
+        passed = passed && matched;
+    }
+
+    if (options.checkClicks) {
+        // Level ramps add next to nothing to the inputs' own curvature
+        const float threshold = options.clickThreshold > 0.0f ? options.clickThreshold
+                                                              : std::max(0.01f, 1.5f * inputRoughness);
+        for (const auto &[mix, samples] : mixes) {
+            const std::vector<size_t> clicks = WaveMux::findDiscontinuities(*samples, threshold);
+            std::printf("%s: %zu discontinuities above %.4f\n", mix.c_str(), clicks.size(), threshold);
+            for (size_t i = 0; i < clicks.size() && i < 10; ++i) {
+                std::printf("  at %.4f s\n", static_cast<double>(clicks[i]) / SAMPLE_RATE);
+            }
+            passed = passed && clicks.empty();
+        }
+    }
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,360 @@
+// Stress harness: hundreds of synthetic application streams against an
+// in-process AudioManager, with randomized app and binary names and a
+// configurable churn of short-lived streams on top of long-lived ones. Some
+// of the long-lived streams exist before startup, so syncExistingStreams()
+// runs under load too. Checks that every stream lands on the sink its
+// routing rules pick, and reports routing latency, ListStreams cost, CPU and
+// memory. Meant to run against a private server:
+//
+//   bench/headless-audio.sh ./stress_wavemux --streams 300 --churn 20 --duration 60
+//
+// Exits non-zero if any stream was misrouted.
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QFile>
+#include <QHash>
+#include <QLoggingCategory>
+#include <QProcess>
+#include <QRegularExpression>
+#include <QTimer>
+#include <cstdio>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <random>
+#include <sys/resource.h>
+#include "audiomanager.h"
+#include "stats.h"
+#include "wavemux/types.h"
+
+namespace {
+    // What each synthetic stream looks like and where its rules send it.
+    // "chat" is matched on the binary name, the others on the app name.
+    struct Category {
+        const char *name;
+        const char *binary;
+        const char *expectedChannel;  // Empty: no rule, stays unassigned
+    };
+    const Category CATEGORIES[] = {
+        {"game", "stress-game", "game"},
+        {"chat", "stress-voice", "chat"},
+        {"media", "stress-player", "media"},
+        {"other", "stress-other", ""},
+    };
+    const QList<WaveMux::RoutingRule> RULES = {
+        {"^stress-game-", "game"},
+        {"^stress-voice$", "chat"},
+        {"^stress-media-", "media"},
+    };
+
+    struct SyntheticStream {
+        QString appName;
+        QString expectedChannel;
+        bool longLived = false;
+        std::unique_ptr<QProcess> process;
+        QElapsedTimer age;
+        uint32_t id = 0;  // Sink input, once the manager has seen it
+    };
+
+    double seconds(const timeval &time) {
+        return time.tv_sec + time.tv_usec / 1e6;
+    }
+
+    QString run(const QString &command) {
+        QProcess process;
+        process.start("sh", {"-c", command});
+        process.waitForFinished(30000);
+        return QString::fromUtf8(process.readAllStandardOutput());
+    }
+
+    void raiseFileLimit() {
+        // A QProcess holds a few descriptors; hundreds of clients need more than 1024
+        rlimit limit;
+        if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max) {
+            limit.rlim_cur = limit.rlim_max;
+            setrlimit(RLIMIT_NOFILE, &limit);
+        }
+    }
+
+    QString residentMemory() {
+        QFile status("/proc/self/status");
+        if (status.open(QIODevice::ReadOnly)) {
+            for (const QByteArray &line : status.readAll().split('\n')) {
+                if (line.startsWith("VmRSS:")) {
+                    return QString::fromLatin1(line.mid(6).trimmed());
+                }
+            }
+        }
+        return "?";
+    }
+}
+
+class StressRun : public QObject {
+public:
+    struct Options {
+        int longLived = 200;
+        int preexisting = 100;
+        double churnPerSecond = 20;
+        int maxLifetimeMs = 3000;
+        int durationSeconds = 30;
+        int listIntervalMs = 500;
+        unsigned seed = 1;
+    };
+
+    explicit StressRun(const Options &options)
+        : m_options(options)
+        , m_random(options.seed)
+    {
+        for (const auto &rule : RULES) {
+            m_manager.addRoutingRule(rule.matchPattern, rule.targetChannel);
+        }
+        connect(&m_manager, &WaveMux::AudioManager::streamAdded, this, &StressRun::onStreamAdded);
+    }
+
+    ~StressRun() {
+        m_streams.clear();  // Kills the remaining clients
+        m_manager.shutdown();
+    }
+
+    int exec() {
+        std::printf("Starting %d long-lived streams (%d before startup), %.1f short-lived/s for %d s, seed %u\n",
+                    m_options.longLived, m_options.preexisting, m_options.churnPerSecond,
+                    m_options.durationSeconds, m_options.seed);
+
+        for (int i = 0; i < m_options.preexisting; ++i) {
+            spawn(true);
+        }
+        waitForClients(m_options.preexisting);
+
+        QElapsedTimer startup;
+        startup.start();
+        if (!m_manager.initialize()) {
+            std::fprintf(stderr, "AudioManager failed to initialize\n");
+            return 1;
+        }
+        WaveMux::Stats::histogram("stress.startup").record(static_cast<uint64_t>(startup.nsecsElapsed() / 1000));
+
+        for (int i = m_options.preexisting; i < m_options.longLived; ++i) {
+            spawn(true);
+        }
+
+        QTimer churn;
+        if (m_options.churnPerSecond > 0) {
+            connect(&churn, &QTimer::timeout, this, [this]() { spawnShortLived(); });
+            churn.start(qMax(1, static_cast<int>(1000 / m_options.churnPerSecond)));
+        }
+
+        // What a UI showing the Apps view costs the daemon
+        QTimer list;
+        connect(&list, &QTimer::timeout, this, [this]() {
+            QElapsedTimer timer;
+            timer.start();
+            const auto streams = m_manager.listStreams();
+            WaveMux::Stats::histogram("stress.list-streams").record(static_cast<uint64_t>(timer.nsecsElapsed() / 1000));
+            WaveMux::Stats::histogram("stress.listed-streams", WaveMux::Histogram::Unit::Count).record(streams.size());
+        });
+        list.start(m_options.listIntervalMs);
+
+        QElapsedTimer wall;
+        wall.start();
+        rusage before;
+        getrusage(RUSAGE_SELF, &before);
+        rusage childrenBefore;
+        getrusage(RUSAGE_CHILDREN, &childrenBefore);
+
+        runFor(m_options.durationSeconds * 1000);
+        churn.stop();
+        list.stop();
+
+        // Drop the short-lived streams and let the last events settle
+        for (auto it = m_streams.begin(); it != m_streams.end();) {
+            it = it->second->longLived ? std::next(it) : m_streams.erase(it);
+        }
+        runFor(2000);
+
+        rusage after;
+        getrusage(RUSAGE_SELF, &after);
+        rusage childrenAfter;
+        getrusage(RUSAGE_CHILDREN, &childrenAfter);
+        const double elapsed = wall.elapsed() / 1000.0;
+        const double daemonCpu = seconds(after.ru_utime) + seconds(after.ru_stime)
+                                 - seconds(before.ru_utime) - seconds(before.ru_stime);
+        // Mostly pactl: clients are killed and reaped too, but cost next to nothing
+        const double childCpu = seconds(childrenAfter.ru_utime) + seconds(childrenAfter.ru_stime)
+                                - seconds(childrenBefore.ru_utime) - seconds(childrenBefore.ru_stime);
+
+        const int misplaced = audit();
+
+        std::printf("\nStreams: %d spawned, %d seen by the daemon, %d misrouted, %d long-lived on the wrong sink\n",
+                    m_spawned, m_seen, m_misrouted, misplaced);
+        std::printf("CPU: daemon %.1f%% of one core, spawned tools %.1f%%\n",
+                    100.0 * daemonCpu / elapsed, 100.0 * childCpu / elapsed);
+        std::printf("Memory: %s resident, %ld kB peak\n\n", qPrintable(residentMemory()), after.ru_maxrss);
+        std::fputs(WaveMux::Stats::dump().c_str(), stdout);
+
+        return m_misrouted == 0 && misplaced == 0 ? 0 : 1;
+    }
+
+private:
+    QString spawn(bool longLived) {
+        const Category &category = CATEGORIES[m_random() % std::size(CATEGORIES)];
+        auto stream = std::make_unique<SyntheticStream>();
+        stream->appName = QString("stress-%1-%2-%3").arg(category.name).arg(m_random() & 0xffffff, 6, 16, QChar('0')).arg(m_spawned);
+        stream->expectedChannel = category.expectedChannel;
+        stream->longLived = longLived;
+        stream->process = std::make_unique<QProcess>();
+        stream->process->setStandardOutputFile(QProcess::nullDevice());
+        stream->process->setStandardErrorFile(QProcess::nullDevice());
+        // Nothing is ever written: the stream stays open but idle
+        stream->process->start("pacat", {"--playback", "--raw", "--latency-msec=100",
+                                         "--client-name=" + stream->appName,
+                                         "--stream-name=" + stream->appName,
+                                         QString("--property=application.process.binary=%1").arg(category.binary)});
+        stream->age.start();
+        const QString appName = stream->appName;
+        m_streams[appName] = std::move(stream);
+        ++m_spawned;
+        return appName;
+    }
+
+    void spawnShortLived() {
+        const QString appName = spawn(false);
+        std::uniform_int_distribution<int> lifetime(qMin(500, m_options.maxLifetimeMs), m_options.maxLifetimeMs);
+        QTimer::singleShot(lifetime(m_random), this, [this, appName]() { m_streams.erase(appName); });
+    }
+
+    void onStreamAdded(uint32_t id, const QString &appName) {
+        auto it = m_streams.find(appName);
+        if (it == m_streams.end()) {
+            return;  // Not ours, or already gone
+        }
+        SyntheticStream &stream = *it->second;
+        stream.id = id;
+        ++m_seen;
+        // Routing runs right after this signal, in the same event; check once it's done
+        QTimer::singleShot(0, this, [this, appName, id]() {
+            auto it = m_streams.find(appName);
+            if (it == m_streams.end() || it->second->id != id) {
+                return;
+            }
+            WaveMux::Stats::histogram("stress.route-latency")
+                .record(static_cast<uint64_t>(it->second->age.nsecsElapsed() / 1000));
+            const QString channel = m_manager.getStreamChannel(id);
+            if (channel != it->second->expectedChannel) {
+                std::fprintf(stderr, "Misrouted %s: %s instead of %s\n", qPrintable(appName),
+                             qPrintable(channel.isEmpty() ? "unassigned" : channel),
+                             qPrintable(it->second->expectedChannel.isEmpty() ? "unassigned" : it->second->expectedChannel));
+                ++m_misrouted;
+            }
+        });
+    }
+
+    void waitForClients(int count) {
+        QElapsedTimer timer;
+        timer.start();
+        while (timer.elapsed() < 30000) {
+            const QString output = run("pactl list sink-inputs | grep -c 'application.name = \"stress-'");
+            if (output.trimmed().toInt() >= count) {
+                return;
+            }
+            runFor(100);
+        }
+        std::fprintf(stderr, "Only some of the %d streams showed up before startup\n", count);
+    }
+
+    void runFor(int ms) {
+        QEventLoop loop;
+        QTimer::singleShot(ms, &loop, &QEventLoop::quit);
+        loop.exec();
+    }
+
+    // Where the server actually has each long-lived stream, against the sink
+    // its rules pick (the unassigned sink when none match)
+    int audit() {
+        QHash<QString, QString> sinkNames;  // index -> name
+        for (const QString &line : run("pactl list sinks short").split('\n', Qt::SkipEmptyParts)) {
+            const QStringList fields = line.split('\t');
+            if (fields.size() > 1) {
+                sinkNames.insert(fields[0], fields[1]);
+            }
+        }
+
+        QHash<QString, QString> streamSinks;  // app name -> sink name
+        static const QRegularExpression sinkRe("^\\s*Sink: (\\d+)");
+        static const QRegularExpression appRe("^\\s*application\\.name = \"(stress-[^\"]+)\"");
+        QString sink;
+        for (const QString &line : run("pactl list sink-inputs").split('\n')) {
+            if (line.startsWith("Sink Input #")) {
+                sink.clear();
+            } else if (auto match = sinkRe.match(line); match.hasMatch()) {
+                sink = sinkNames.value(match.captured(1));
+            } else if (auto match = appRe.match(line); match.hasMatch()) {
+                streamSinks.insert(match.captured(1), sink);
+            }
+        }
+
+        int misplaced = 0;
+        for (const auto &entry : m_streams) {
+            const SyntheticStream &stream = *entry.second;
+            const QString expected = stream.expectedChannel.isEmpty()
+                ? QString("wavemux_unassigned") : "wavemux_" + stream.expectedChannel;
+            const QString actual = streamSinks.value(stream.appName, "(missing)");
+            if (actual != expected) {
+                std::fprintf(stderr, "%s is on %s, expected %s\n",
+                             qPrintable(stream.appName), qPrintable(actual), qPrintable(expected));
+                ++misplaced;
+            }
+        }
+        return misplaced;
+    }
+
+    Options m_options;
+    std::mt19937 m_random;
+    WaveMux::AudioManager m_manager;
+    std::map<QString, std::unique_ptr<SyntheticStream>> m_streams;  // By app name
+    int m_spawned = 0;
+    int m_seen = 0;
+    int m_misrouted = 0;
+};
+
+int main(int argc, char **argv) {
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("stress_wavemux");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Routes hundreds of synthetic streams through WaveMux and reports how it copes.");
+    parser.addHelpOption();
+    const QCommandLineOption streamsOption("streams", "Long-lived streams (default 200).", "count", "200");
+    const QCommandLineOption preexistingOption("preexisting", "How many of them exist before startup (default half).", "count");
+    const QCommandLineOption churnOption("churn", "Short-lived streams started per second (default 20).", "rate", "20");
+    const QCommandLineOption lifetimeOption("lifetime", "Longest short-lived stream, in ms (default 3000).", "ms", "3000");
+    const QCommandLineOption durationOption("duration", "Seconds to run (default 30).", "seconds", "30");
+    const QCommandLineOption listOption("list-interval", "ListStreams polling interval, in ms (default 500).", "ms", "500");
+    const QCommandLineOption seedOption("seed", "Random seed for names and lifetimes (default 1).", "seed", "1");
+    parser.addOptions({streamsOption, preexistingOption, churnOption, lifetimeOption, durationOption, listOption, seedOption});
+    parser.process(app);
+
+    StressRun::Options options;
+    options.longLived = qMax(0, parser.value(streamsOption).toInt());
+    options.preexisting = parser.isSet(preexistingOption)
+        ? qBound(0, parser.value(preexistingOption).toInt(), options.longLived) : options.longLived / 2;
+    options.churnPerSecond = qMax(0.0, parser.value(churnOption).toDouble());
+    options.maxLifetimeMs = qMax(100, parser.value(lifetimeOption).toInt());
+    options.durationSeconds = qMax(1, parser.value(durationOption).toInt());
+    options.listIntervalMs = qMax(10, parser.value(listOption).toInt());
+    options.seed = parser.value(seedOption).toUInt();
+
+    if (QProcess::execute("pactl", {"info"}) != 0) {
+        std::fprintf(stderr, "No audio server (pactl info failed)\n");
+        return 77;
+    }
+    raiseFileLimit();
+    WaveMux::registerMetaTypes();
+    // Only problems are of interest here
+    QLoggingCategory::setFilterRules("wavemux.*.debug=false\nwavemux.*.info=false");
+
+    StressRun run(options);
+    return run.exec();
+}
@@ -1,25 +1,270 @@
 #include "audiomanager.h"
+#include "mixengine.h"
+#include "recorder.h"
+#include "commandqueue.h"
+#include "replaybuffer.h"
+#include "spectrummonitor.h"
+#include "latencyprobe.h"
+#include "logging.h"
+#include "pactlparser.h"
+#include "pwtopparser.h"
+#include "stats.h"
+#include "trace.h"
 #include <QProcess>
 #include <QRegularExpression>
 #include <QDebug>
 #include <QTimer>
 #include <QThread>
+#include <QElapsedTimer>
+#include <QDateTime>
+#include <QStandardPaths>
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <memory>
 
 namespace WaveMux {
 
 namespace {
     const QStringList CHANNEL_IDS = {"game", "chat", "media", "aux"};
+    const QString MIC_CHANNEL_ID = "mic";
+    const QString MIC_SUPPRESSED_SOURCE = "wavemux_mic_denoised";
     const QHash<QString, QString> CHANNEL_NAMES = {
         {"game", "Game"},
         {"chat", "Chat"},
         {"media", "Media"},
         {"aux", "AUX"}
     };
+
+    // Loopbacks may follow their sink: if the output device is unplugged the
+    // server moves them instead of unloading them, and failover retargets them
+    QString loopbackCommand(const QString &sourceSink, const QString &targetSink, int latencyMs) {
+        // adjust_time=0 prevents automatic volume adjustments
+        return QString("pactl load-module module-loopback source=%1.monitor sink=%2 "
+                       "latency_msec=%3 source_dont_move=true remix=false adjust_time=0")
+            .arg(sourceSink, targetSink).arg(latencyMs);
+    }
+
+    // "Buffer Latency: 75011 usec" -> 75.011
+    std::optional<double> usecFieldMs(std::string_view field) {
+        const size_t space = field.find(' ');
+        if (field.substr(space == std::string_view::npos ? field.size() : space + 1) != "usec") {
+            return std::nullopt;
+        }
+        const auto usec = PactlListing::toIndex(field.substr(0, space));
+        if (!usec) {
+            return std::nullopt;
+        }
+        return *usec / 1000.0;
+    }
+
+    // Listing type -> NodeLoad::kind
+    QString nodeKind(std::string_view type) {
+        if (type == "Sink") {
+            return "sink";
+        }
+        if (type == "Source") {
+            return "source";
+        }
+        return type == "Sink Input" ? "sink-input" : "source-output";
+    }
+
+    // Stats bucket for a server command: the tool plus, for pactl, its
+    // subcommand ("pactl load-module"), so every operation type gets its own
+    // latency histogram
+    Histogram &backendHistogram(const QString &command) {
+        const QStringList words = command.split(' ', Qt::SkipEmptyParts);
+        QString operation = words.value(0);
+        if (operation == "pactl" && words.size() > 1) {
+            operation += ' ' + words[1];
+        }
+        return Stats::histogram("backend." + operation.toStdString());
+    }
+
+    // Trace event names are only built while tracing is on
+    std::string traceName(const QString &text) {
+        return Trace::isEnabled() ? text.toStdString() : std::string();
+    }
+
+    std::string_view bytesView(const QByteArray &bytes) {
+        return std::string_view(bytes.constData(), static_cast<size_t>(bytes.size()));
+    }
+
+    QString fieldText(std::string_view value) {
+        return QString::fromUtf8(value.data(), static_cast<qsizetype>(value.size()));
+    }
+
+    // Property values come escaped; most have nothing to unescape
+    QString propertyText(std::string_view value) {
+        if (value.find('\\') == std::string_view::npos) {
+            return fieldText(value);
+        }
+        return QString::fromStdString(PactlListing::unescape(value));
+    }
+
+    // A command that never finished either hung or never ran at all (the
+    // tool is missing or not executable); the two need different fixes
+    void reportUnfinished(const QProcess &process, const QString &command) {
+        if (process.error() == QProcess::FailedToStart) {
+            qCWarningLimited(lcCommands) << "Command failed to start:" << command << process.errorString();
+            EventLog::record(EventLog::Code::CommandNotStarted, command.toStdString());
+            Stats::counter("backend.start-failures").add();
+            return;
+        }
+        qCWarningLimited(lcCommands) << "Command timed out:" << command;
+        EventLog::record(EventLog::Code::CommandTimedOut, command.toStdString());
+        Stats::counter("backend.timeouts").add();
+    }
+
+    bool validLimiter(const LimiterSettings &settings) {
+        if (settings.ceilingDb > 0.0f || settings.ceilingDb < -24.0f || settings.releaseMs <= 0.0f) {
+            qCWarning(lcMix) << "Invalid limiter settings: ceiling" << settings.ceilingDb << "release" << settings.releaseMs;
+            return false;
+        }
+        return true;
+    }
+
+    bool validLoudness(const LoudnessSettings &settings) {
+        if (settings.targetLufs > 0.0f || settings.targetLufs < -60.0f || settings.maxGainDb < 0.0f) {
+            qCWarning(lcMix) << "Invalid loudness settings: target" << settings.targetLufs << "max gain" << settings.maxGainDb;
+            return false;
+        }
+        return true;
+    }
+
+    bool validEqBands(const QList<EqBand> &bands) {
+        if (bands.size() > static_cast<int>(Equalizer::MAX_BANDS)) {
+            qCWarning(lcMix) << "Too many EQ bands:" << bands.size();
+            return false;
+        }
+        for (const auto &band : bands) {
+            if (band.frequency < 20.0f || band.frequency > 20000.0f || band.gainDb < -24.0f || band.gainDb > 24.0f
+                || band.q < 0.1f || band.q > 18.0f) {
+                qCWarning(lcMix) << "Invalid EQ band:" << band.frequency << "Hz" << band.gainDb << "dB Q" << band.q;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool validMic(const MicConfig &config) {
+        if (config.source.startsWith("wavemux_")) {
+            qCWarning(lcMix) << "Invalid mic source:" << config.source;
+            return false;
+        }
+        if (config.gate.thresholdDb > 0.0f || config.gate.thresholdDb < -96.0f || config.gate.rangeDb < 0.0f) {
+            qCWarning(lcMix) << "Invalid noise gate settings: threshold" << config.gate.thresholdDb
+                       << "range" << config.gate.rangeDb;
+            return false;
+        }
+        return true;
+    }
+
+    // The settings structs are plain data without operator==
+    bool sameEq(const QList<EqBand> &a, const QList<EqBand> &b) {
+        if (a.size() != b.size()) {
+            return false;
+        }
+        for (int i = 0; i < a.size(); ++i) {
+            if (a[i].type != b[i].type || a[i].enabled != b[i].enabled || a[i].frequency != b[i].frequency ||
+                a[i].gainDb != b[i].gainDb || a[i].q != b[i].q) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool sameDucking(const DuckingConfig &a, const DuckingConfig &b) {
+        return a.settings.enabled == b.settings.enabled && a.settings.depthDb == b.settings.depthDb &&
+               a.settings.thresholdDb == b.settings.thresholdDb && a.settings.attackMs == b.settings.attackMs &&
+               a.settings.releaseMs == b.settings.releaseMs && a.triggerChannel == b.triggerChannel &&
+               a.targetChannels == b.targetChannels;
+    }
+
+    bool sameLimiter(const LimiterSettings &a, const LimiterSettings &b) {
+        return a.enabled == b.enabled && a.ceilingDb == b.ceilingDb && a.releaseMs == b.releaseMs;
+    }
+
+    bool sameLoudness(const LoudnessSettings &a, const LoudnessSettings &b) {
+        return a.enabled == b.enabled && a.targetLufs == b.targetLufs && a.maxGainDb == b.maxGainDb;
+    }
+
+    bool sameMic(const MicConfig &a, const MicConfig &b) {
+        return a.source == b.source && a.suppression == b.suppression &&
+               a.gate.enabled == b.gate.enabled && a.gate.thresholdDb == b.gate.thresholdDb &&
+               a.gate.hysteresisDb == b.gate.hysteresisDb && a.gate.rangeDb == b.gate.rangeDb &&
+               a.gate.attackMs == b.gate.attackMs && a.gate.holdMs == b.gate.holdMs &&
+               a.gate.releaseMs == b.gate.releaseMs;
+    }
+
+    // Runs a read-only command in the background, killed after 5 s. slot
+    // holds it until it is done; done() gets its output, or none and why.
+    void startBackground(QObject *receiver, QProcess *&slot, const QString &name,
+                         const QString &program, const QStringList &arguments, const QString &notFound,
+                         const std::function<void(const QByteArray &, const QString &)> &done) {
+        auto *process = new QProcess(receiver);
+        slot = process;  // Before start(): a failed start reports right away
+        QObject::connect(process, &QProcess::finished, receiver,
+                         [&slot, process, name, done](int exitCode, QProcess::ExitStatus status) {
+            slot = nullptr;
+            process->deleteLater();
+            if (status != QProcess::NormalExit || exitCode != 0) {
+                const QString message = QString::fromUtf8(process->readAllStandardError()).trimmed();
+                done({}, name + " failed" + (message.isEmpty() ? QString() : ": " + message));
+                return;
+            }
+            done(process->readAllStandardOutput(), QString());
+        });
+        QObject::connect(process, &QProcess::errorOccurred, receiver,
+                         [&slot, process, notFound, done](QProcess::ProcessError error) {
+            if (error != QProcess::FailedToStart) {
+                return;  // finished() follows
+            }
+            slot = nullptr;
+            process->deleteLater();
+            done({}, notFound);
+        });
+        QTimer::singleShot(5000, process, [process]() { process->kill(); });
+        process->start(program, arguments);
+    }
+
+    // For shutdown: drops a background command without hearing from it again
+    void stopBackground(QProcess *&process, QObject *receiver) {
+        if (!process) {
+            return;
+        }
+        process->disconnect(receiver);
+        process->kill();
+        process->waitForFinished(1000);
+        delete process;
+        process = nullptr;
+    }
+
+    // Fixed waits for the server to catch up show up in traces as "sleep" spans
+    void settle(unsigned long ms) {
+        const TraceSpan span("sleep", "settle");
+        QThread::msleep(ms);
+    }
 }
 
 AudioManager::AudioManager(QObject *parent)
     : QObject(parent)
 {
+    // Channels exist (with default levels) from the start so the D-Bus API can
+    // answer - and stage changes - while the sinks are still being created
+    for (const auto &id : CHANNEL_IDS) {
+        ChannelState state;
+        state.id = id;
+        state.displayName = CHANNEL_NAMES.value(id);
+        state.sinkName = QString("wavemux_%1").arg(id);
+        m_channels[id] = state;
+    }
+
+    // The mic only feeds the mixes; self-monitoring starts off
+    m_mic.id = MIC_CHANNEL_ID;
+    m_mic.displayName = "Mic";
+    m_mic.personalVolume = 0;
+    m_mic.streamVolume = 100;
 }
 
 AudioManager::~AudioManager() {
@@ -27,27 +272,85 @@ AudioManager::~AudioManager() {
 }
 
 bool AudioManager::runCommand(const QString &command, QString *output) const {
+    if (!output) {
+        return runCommand(command, static_cast<QByteArray *>(nullptr));
+    }
+    QByteArray bytes;
+    const bool success = runCommand(command, &bytes);
+    *output = QString::fromUtf8(bytes);
+    return success;
+}
+
+bool AudioManager::runCommand(const QString &command, QByteArray *output) const {
+    const ScopedTimer timer(backendHistogram(command));
+    const TraceSpan span("backend", traceName(command));
     QProcess process;
     process.start("sh", {"-c", command});
 
     if (!process.waitForFinished(5000)) {
-        qWarning() << "Command timed out:" << command;
+        reportUnfinished(process, command);
         return false;
     }
 
     if (output) {
-        *output = QString::fromUtf8(process.readAllStandardOutput());
+        *output = process.readAllStandardOutput();
     }
 
     if (process.exitCode() != 0) {
-        qWarning() << "Command failed:" << command;
-        qWarning() << "stderr:" << process.readAllStandardError();
+        qCWarningLimited(lcCommands) << "Command failed:" << command << "stderr:" << process.readAllStandardError();
+        EventLog::record(EventLog::Code::CommandFailed, command.toStdString(), process.exitCode());
+        Stats::counter("backend.failures").add();
         return false;
     }
 
     return true;
 }
 
+bool AudioManager::runCommands(const QStringList &commands) const {
+    // Spawn every command at once and wait for all of them, so a batch costs
+    // roughly one pactl round trip instead of one per command. Commands are
+    // started directly (no shell) since they never use shell syntax.
+    QList<QProcess *> processes;
+    for (const auto &command : commands) {
+        QStringList args = QProcess::splitCommand(command);
+        if (args.isEmpty()) {
+            continue;
+        }
+        auto *process = new QProcess();
+        process->setProperty("command", command);
+        process->start(args.takeFirst(), args);
+        processes.append(process);
+    }
+
+    // Each command is timed from the batch start to when it is seen to be
+    // done, which is what the batch cost the caller
+    QElapsedTimer timer;
+    timer.start();
+    const uint64_t traceStart = Trace::now();
+    bool success = true;
+    for (auto *process : processes) {
+        const QString command = process->property("command").toString();
+        if (!process->waitForFinished(5000)) {
+            reportUnfinished(*process, command);
+            success = false;
+        } else if (process->exitCode() != 0) {
+            qCWarningLimited(lcCommands) << "Command failed:" << command
+                                         << "stderr:" << process->readAllStandardError();
+            EventLog::record(EventLog::Code::CommandFailed, command.toStdString(), process->exitCode());
+            Stats::counter("backend.failures").add();
+            success = false;
+        }
+        const uint64_t elapsed = static_cast<uint64_t>(timer.nsecsElapsed() / 1000);
+        backendHistogram(command).record(elapsed);
+        if (Trace::isEnabled()) {
+            Trace::complete("backend", command.toUtf8().constData(), traceStart, elapsed);
+        }
+    }
+    qDeleteAll(processes);
+
+    return success;
+}
+
 bool AudioManager::createVirtualSink(const QString &name, const QString &description) {
     // Replace spaces with dashes for PipeWire compatibility
     QString safeDesc = description;
@@ -65,7 +368,7 @@ bool AudioManager::createVirtualSink(const QString &name, const QString &descrip
         return false;
     }
 
-    qInfo() << "Created virtual sink:" << name << "module:" << output.trimmed();
+    qCInfo(lcAudio) << "Created virtual sink:" << name << "module:" << output.trimmed();
     return true;
 }
 
@@ -131,43 +434,37 @@ bool AudioManager::setSinkMute(const QString &sinkName, bool muted) {
     return runCommand(cmd);
 }
 
-bool AudioManager::createChannels() {
-    for (const auto &id : CHANNEL_IDS) {
-        QString sinkName = QString("wavemux_%1").arg(id);
-        QString description = QString("WaveMux %1").arg(CHANNEL_NAMES.value(id));
+bool AudioManager::createChannel(const QString &id) {
+    QString sinkName = QString("wavemux_%1").arg(id);
+    QString description = QString("WaveMux %1").arg(CHANNEL_NAMES.value(id));
 
-        // Check if sink already exists
-        auto existingInfo = getSinkInfo(sinkName);
-        if (existingInfo) {
-            qInfo() << "Virtual sink already exists:" << sinkName;
-        } else {
-            // Create new sink
-            if (!createVirtualSink(sinkName, description)) {
-                return false;
-            }
+    // Check if sink already exists
+    auto existingInfo = getSinkInfo(sinkName);
+    if (existingInfo) {
+        qCInfo(lcAudio) << "Virtual sink already exists:" << sinkName;
+    } else {
+        // Create new sink
+        if (!createVirtualSink(sinkName, description)) {
+            return false;
         }
+    }
 
-        // Reset volume to 100% with balanced stereo to prevent stream-restore issues
-        setSinkVolume(sinkName, 100);
-
-        auto info = getSinkInfo(sinkName);
-        if (!info) {
-            qWarning() << "Could not get sink info for:" << sinkName;
-            continue;
-        }
+    // Keep the cached state: defaults, or levels staged before the sink existed
+    auto &state = m_channels[id];
+    state.id = id;
+    state.displayName = CHANNEL_NAMES.value(id);
+    state.sinkName = sinkName;
 
-        ChannelState state;
-        state.id = id;
-        state.displayName = CHANNEL_NAMES.value(id);
-        state.sinkName = sinkName;
-        state.sinkIndex = info->index;
-        state.volume = 100;
-        state.muted = false;
-        state.personalVolume = 100;
-        state.streamVolume = 0;
+    // Reset volume with balanced stereo to prevent stream-restore issues
+    setSinkVolume(sinkName, state.volume);
+    setSinkMute(sinkName, state.muted);
 
-        m_channels[id] = state;
+    auto info = getSinkInfo(sinkName);
+    if (!info) {
+        qCWarning(lcAudio) << "Could not get sink info for:" << sinkName;
+        return true;
     }
+    state.sinkIndex = info->index;
 
     return true;
 }
@@ -178,7 +475,7 @@ bool AudioManager::createMixes() {
     // Personal mix = channels routed to headphones
     // Stream mix = OBS captures channel monitors directly
 
-    qInfo() << "Mix routing will be configured in Phase 2 using loopback modules";
+    qCInfo(lcAudio) << "Mix routing will be configured in Phase 2 using loopback modules";
     return true;
 }
 
@@ -186,74 +483,200 @@ void AudioManager::setupRouting() {
     // For MVP, routing is handled by moving sink-inputs
     // The include matrix determines which channels feed into which mixes
     // This will be implemented when we handle stream detection
-    qInfo() << "Routing setup placeholder - will be implemented in Phase 2";
+    qCInfo(lcAudio) << "Routing setup placeholder - will be implemented in Phase 2";
 }
 
-bool AudioManager::initialize() {
-    if (m_initialized) {
+QList<AudioManager::InitializationStage> AudioManager::initializationStages() {
+    QList<InitializationStage> stages;
+
+    // Create the silent unassigned sink first
+    stages.append({"unassigned-sink", [this]() {
+        // Remember current default sink before creating ours
+        runCommand("pactl get-default-sink", &m_originalDefaultSink);
+        m_originalDefaultSink = m_originalDefaultSink.trimmed();
+        qCInfo(lcAudio) << "Current default sink:" << m_originalDefaultSink;
+
+        // This sink captures all audio that isn't routed to a channel
+        if (!createVirtualSink(m_unassignedSinkName, "WaveMux-Unassigned")) {
+            emit error("Failed to create unassigned sink");
+            return false;
+        }
+        // Get the module ID for the unassigned sink
+        QString moduleOutput;
+        if (runCommand(QString("pactl list modules short | grep %1 | cut -f1").arg(m_unassignedSinkName), &moduleOutput)) {
+            m_unassignedSinkModule = moduleOutput.trimmed().toUInt();
+            qCInfo(lcAudio) << "Created unassigned sink, module:" << m_unassignedSinkModule;
+        }
+        // Mute the unassigned sink so it's completely silent
+        setSinkMute(m_unassignedSinkName, true);
         return true;
+    }});
+
+    // One stage per channel sink
+    for (const auto &id : CHANNEL_IDS) {
+        stages.append({"channel-" + id, [this, id]() {
+            if (!createChannel(id)) {
+                emit error("Failed to create channel sinks");
+                return false;
+            }
+            return true;
+        }});
     }
 
-    qInfo() << "Initializing audio manager...";
+    stages.append({"mixes", [this]() {
+        if (!createMixes()) {
+            emit error("Failed to create mix sinks");
+            return false;
+        }
 
-    // Remember current default sink before creating ours
-    QString originalDefault;
-    runCommand("pactl get-default-sink", &originalDefault);
-    originalDefault = originalDefault.trimmed();
-    qInfo() << "Current default sink:" << originalDefault;
+        // Restore original default sink (PipeWire may have changed it)
+        if (!m_originalDefaultSink.isEmpty() && !m_originalDefaultSink.startsWith("wavemux_")) {
+            runCommand(QString("pactl set-default-sink %1").arg(m_originalDefaultSink));
+            qCInfo(lcAudio) << "Restored default sink to:" << m_originalDefaultSink;
+        }
 
-    // Create the silent unassigned sink first
-    // This sink captures all audio that isn't routed to a channel
-    if (!createVirtualSink(m_unassignedSinkName, "WaveMux-Unassigned")) {
-        emit error("Failed to create unassigned sink");
-        return false;
-    }
-    // Get the module ID for the unassigned sink
-    QString moduleOutput;
-    if (runCommand(QString("pactl list modules short | grep %1 | cut -f1").arg(m_unassignedSinkName), &moduleOutput)) {
-        m_unassignedSinkModule = moduleOutput.trimmed().toUInt();
-        qInfo() << "Created unassigned sink, module:" << m_unassignedSinkModule;
-    }
-    // Mute the unassigned sink so it's completely silent
-    setSinkMute(m_unassignedSinkName, true);
+        setupRouting();
+        return true;
+    }});
+
+    // Mix loopbacks for whatever devices were configured (or staged) so far
+    stages.append({"loopbacks", [this]() {
+        updateMicSuppression();
+        if (!m_outputDevice.isEmpty()) {
+            updateLoopbacks();
+        }
+        if (m_streamEnabled && !m_streamOutputDevice.isEmpty()) {
+            updateStreamLoopbacks();
+        }
+        return true;
+    }});
 
-    if (!createChannels()) {
-        emit error("Failed to create channel sinks");
+    stages.append({"stream-monitor", [this]() {
+        // Start monitoring for new audio streams
+        startStreamMonitor();
+
+        m_initialized = true;
+        updateLatencyPolling();
+        qCInfo(lcAudio) << "Audio manager initialized successfully";
+        updateCaptures();
+        emit channelsChanged();
+        return true;
+    }});
+
+    return stages;
+}
+
+bool AudioManager::initialize() {
+    if (m_initialized) {
+        return true;
+    }
+    if (m_initializing) {
+        qCWarning(lcAudio) << "Audio manager initialization already in progress";
         return false;
     }
 
-    if (!createMixes()) {
-        emit error("Failed to create mix sinks");
-        return false;
+    qCInfo(lcAudio) << "Initializing audio manager...";
+
+    m_initializing = true;
+    for (const auto &stage : initializationStages()) {
+        if (!runInitializationStep(stage)) {
+            m_initializing = false;
+            emit initialized(false);
+            return false;
+        }
     }
+    m_initializing = false;
+
+    emit initialized(true);
+    return true;
+}
 
-    // Restore original default sink (PipeWire may have changed it)
-    if (!originalDefault.isEmpty() && !originalDefault.startsWith("wavemux_")) {
-        runCommand(QString("pactl set-default-sink %1").arg(originalDefault));
-        qInfo() << "Restored default sink to:" << originalDefault;
+void AudioManager::initializeAsync() {
+    if (m_initialized) {
+        emit initialized(true);
+        return;
+    }
+    if (m_initializing) {
+        return;
     }
 
-    setupRouting();
+    qCInfo(lcAudio) << "Initializing audio manager in the background...";
 
-    // Start monitoring for new audio streams
-    startStreamMonitor();
+    m_initializing = true;
+    // Even the first stage waits for the event loop, so initialized() is
+    // never emitted before the caller has had a chance to enter exec()
+    const auto stages = initializationStages();
+    QTimer::singleShot(0, this, [this, stages]() {
+        runInitializationStage(stages, 0);
+    });
+}
 
-    m_initialized = true;
-    qInfo() << "Audio manager initialized successfully";
-    emit channelsChanged();
+bool AudioManager::runInitializationStep(const InitializationStage &stage) {
+    const ScopedTimer timer(Stats::histogram("startup." + stage.name.toStdString()));
+    const TraceSpan span("startup", traceName(stage.name));
+    return stage.run();
+}
 
-    return true;
+void AudioManager::runInitializationStage(const QList<InitializationStage> &stages, int index) {
+    if (!m_initializing) {
+        return;  // Shut down while initializing
+    }
+
+    if (index >= stages.size()) {
+        m_initializing = false;
+        emit initialized(true);
+        return;
+    }
+
+    if (!runInitializationStep(stages[index])) {
+        m_initializing = false;
+        emit initialized(false);
+        return;
+    }
+
+    // Yield to the event loop between stages so D-Bus calls keep being answered
+    QTimer::singleShot(0, this, [this, stages, index]() {
+        runInitializationStage(stages, index + 1);
+    });
 }
 
 void AudioManager::shutdown() {
-    if (!m_initialized) {
+    if (!m_initialized && !m_initializing) {
         return;
     }
+    // Cancels any background initialization still in flight
+    m_initializing = false;
+
+    qCInfo(lcAudio) << "Shutting down audio manager...";
+
+    stopRecording();
+    flushPendingCommands();
+    delete m_replay;
+    m_replay = nullptr;
+    delete m_spectrum;
+    m_spectrum = nullptr;
+    for (const auto &save : m_replaySaves) {
+        if (save) {
+            save->wait();
+        }
+    }
+    if (m_alignment) {
+        m_alignment->wait();
+    }
+    if (m_latencyMeasurement) {
+        m_latencyMeasurement->wait();
+    }
 
-    qInfo() << "Shutting down audio manager...";
+    if (m_latencyTimer) {
+        m_latencyTimer->stop();
+    }
+    stopBackground(m_latencyPollProcess, this);
+    stopBackground(m_nodeLoadProcess, this);
+    stopBackground(m_nodeListProcess, this);
 
-    // Stop stream monitor
+    // Stop stream monitor (the device cache is no longer kept current)
     stopStreamMonitor();
+    m_devicesValid = false;
 
     // Remove personal mix loopbacks
     removeAllLoopbacks();
@@ -261,6 +684,12 @@ void AudioManager::shutdown() {
     // Remove stream mix loopbacks
     removeAllStreamLoopbacks();
 
+    if (m_micSuppressionModule > 0) {
+        removeVirtualSink(m_micSuppressionModule);
+        m_micSuppressionModule = 0;
+        m_micSuppressionMaster.clear();
+    }
+
     // Remove channel sinks
     for (const auto &channel : m_channels) {
         if (channel.moduleId > 0) {
@@ -302,16 +731,39 @@ QList<Channel> AudioManager::listChannels() const {
         ch.streamVolume = state.streamVolume;
         result.append(ch);
     }
+    if (!m_micConfig.source.isEmpty()) {
+        Channel mic;
+        mic.id = m_mic.id;
+        mic.displayName = m_mic.displayName;
+        mic.sinkName = m_micConfig.source;
+        mic.volume = m_mic.volume;
+        mic.muted = m_mic.muted;
+        mic.personalVolume = m_mic.personalVolume;
+        mic.streamVolume = m_mic.streamVolume;
+        result.append(mic);
+    }
     return result;
 }
 
 bool AudioManager::setChannelVolume(const QString &channelId, int volume) {
+    if (channelId == MIC_CHANNEL_ID) {
+        ChannelState mic = m_mic;
+        mic.volume = qBound(0, volume, 100);
+        return setMicState(mic);
+    }
     if (!m_channels.contains(channelId)) {
         return false;
     }
 
     volume = qBound(0, volume, 100);
+    EventLog::record(EventLog::Code::ChannelVolume, channelId.toStdString(), volume);
     auto &channel = m_channels[channelId];
+    if (channel.sinkIndex == 0) {
+        // Sink not created yet - the level is applied when it is
+        channel.volume = volume;
+        emit channelsChanged();
+        return true;
+    }
     if (setSinkVolume(channel.sinkName, volume)) {
         channel.volume = volume;
         emit channelsChanged();
@@ -321,11 +773,23 @@ bool AudioManager::setChannelVolume(const QString &channelId, int volume) {
 }
 
 bool AudioManager::setChannelMute(const QString &channelId, bool muted) {
+    if (channelId == MIC_CHANNEL_ID) {
+        ChannelState mic = m_mic;
+        mic.muted = muted;
+        return setMicState(mic);
+    }
     if (!m_channels.contains(channelId)) {
         return false;
     }
 
+    EventLog::record(EventLog::Code::ChannelMute, channelId.toStdString(), muted ? 1 : 0);
     auto &channel = m_channels[channelId];
+    if (channel.sinkIndex == 0) {
+        // Sink not created yet - the mute state is applied when it is
+        channel.muted = muted;
+        emit channelsChanged();
+        return true;
+    }
     if (setSinkMute(channel.sinkName, muted)) {
         channel.muted = muted;
         emit channelsChanged();
@@ -341,6 +805,7 @@ bool AudioManager::setMixVolume(const QString &mixId, int volume) {
 
 bool AudioManager::setMasterVolume(int volume) {
     m_masterVolume = qBound(0, volume, 100);
+    EventLog::record(EventLog::Code::MasterVolume, "", m_masterVolume);
 
     // Master volume affects all loopback volumes
     applyMasterToLoopbacks();
@@ -350,6 +815,9 @@ bool AudioManager::setMasterVolume(int volume) {
 }
 
 void AudioManager::applyMasterToLoopbacks() {
+    syncMixEngine(false);
+    syncMixEngine(true);
+
     // Set volume on all tracked personal mix loopback sink-inputs
     for (auto it = m_loopbackSinkInputs.begin(); it != m_loopbackSinkInputs.end(); ++it) {
         const QString &channelId = it.key();
@@ -370,32 +838,33 @@ void AudioManager::applyMasterToLoopbacks() {
 }
 
 uint32_t AudioManager::findLoopbackSinkInput(uint32_t moduleId) const {
-    // Find the sink-input created by a loopback module
-    QString output;
+    return findLoopbackSinkInputs().value(moduleId);
+}
+
+QHash<uint32_t, uint32_t> AudioManager::findLoopbackSinkInputs() const {
+    // Map every module-owned sink-input in one listing: moduleId -> sink-input ID
+    QHash<uint32_t, uint32_t> result;
+    QByteArray output;
     if (!runCommand("pactl list sink-inputs", &output)) {
-        return 0;
+        return result;
     }
 
-    uint32_t currentId = 0;
-    bool inBlock = false;
-
-    for (const auto &line : output.split('\n')) {
-        QString trimmed = line.trimmed();
-
-        if (trimmed.startsWith("Sink Input #")) {
-            currentId = trimmed.mid(12).toUInt();
-            inBlock = true;
-        }
-
-        if (inBlock && trimmed.contains(QString("module.id = \"%1\"").arg(moduleId))) {
-            return currentId;
+    const PactlListing listing(bytesView(output));
+    for (size_t i = 0; i < listing.size(); ++i) {
+        if (const auto moduleId = PactlListing::toIndex(listing.property(i, "module.id"))) {
+            result.insert(*moduleId, listing[i].index);
         }
     }
 
-    return 0;
+    return result;
 }
 
 bool AudioManager::setChannelPersonalVolume(const QString &channelId, int volume) {
+    if (channelId == MIC_CHANNEL_ID) {
+        ChannelState mic = m_mic;
+        mic.personalVolume = qBound(0, volume, 100);
+        return setMicState(mic);
+    }
     if (!m_channels.contains(channelId)) {
         return false;
     }
@@ -403,9 +872,13 @@ bool AudioManager::setChannelPersonalVolume(const QString &channelId, int volume
     volume = qBound(0, volume, 100);
     auto &channel = m_channels[channelId];
     channel.personalVolume = volume;
+    EventLog::record(EventLog::Code::PersonalVolume, channelId.toStdString(), volume);
 
     // Handle loopback - keep loopback alive, just adjust volume (avoids screech from creation/destruction)
-    if (!m_outputDevice.isEmpty()) {
+    // Before initialization the level is only stored; loopbacks are built with it later
+    if (m_personalEngine) {
+        syncMixEngine(false);
+    } else if (m_initialized && !m_outputDevice.isEmpty()) {
         if (!m_loopbackSinkInputs.contains(channelId)) {
             // No loopback exists yet - create one
             addChannelLoopback(channelId);
@@ -424,6 +897,11 @@ bool AudioManager::setChannelPersonalVolume(const QString &channelId, int volume
 }
 
 bool AudioManager::setChannelStreamVolume(const QString &channelId, int volume) {
+    if (channelId == MIC_CHANNEL_ID) {
+        ChannelState mic = m_mic;
+        mic.streamVolume = qBound(0, volume, 100);
+        return setMicState(mic);
+    }
     if (!m_channels.contains(channelId)) {
         return false;
     }
@@ -431,9 +909,12 @@ bool AudioManager::setChannelStreamVolume(const QString &channelId, int volume)
     volume = qBound(0, volume, 100);
     auto &channel = m_channels[channelId];
     channel.streamVolume = volume;
+    EventLog::record(EventLog::Code::StreamMixVolume, channelId.toStdString(), volume);
 
     // Handle stream loopback - keep loopback alive, just adjust volume (avoids screech from creation/destruction)
-    if (m_streamEnabled && !m_streamOutputDevice.isEmpty()) {
+    if (m_streamEngine) {
+        syncMixEngine(true);
+    } else if (m_initialized && m_streamEnabled && !m_streamOutputDevice.isEmpty()) {
         if (!m_streamLoopbackSinkInputs.contains(channelId)) {
             // No stream loopback exists yet - create one
             addStreamChannelLoopback(channelId);
@@ -452,50 +933,185 @@ bool AudioManager::setChannelStreamVolume(const QString &channelId, int volume)
 }
 
 QList<Device> AudioManager::listOutputDevices() const {
-    QList<Device> devices;
-    QString output;
+    // While the monitor runs, sink add/remove events keep the cache current;
+    // without it there is no way to notice changes, so query every time
+    if (!m_devicesValid || !m_monitorProcess) {
+        refreshDeviceCache();
+    }
+    return m_devices;
+}
+
+void AudioManager::refreshDeviceCache() const {
+    m_devices.clear();
+    m_deviceSinkIndexes.clear();
+    m_devicesValid = false;
 
+    QByteArray output;
     if (!runCommand("pactl list sinks", &output)) {
-        return devices;
+        return;
     }
 
-    Device current;
-    bool inSink = false;
+    const PactlListing listing(bytesView(output));
+    for (size_t i = 0; i < listing.size(); ++i) {
+        Device device;
+        device.id = fieldText(listing.field(i, "Name"));
+        if (listing[i].type != "Sink" || device.id.isEmpty() || device.id.startsWith("wavemux_")) {
+            continue;
+        }
+        device.description = fieldText(listing.field(i, "Description"));
+        device.name = device.description;  // Use description as display name
+        m_devices.append(device);
+        m_deviceSinkIndexes[listing[i].index] = device.id;
+    }
 
-    for (const auto &line : output.split('\n')) {
-        QString trimmed = line.trimmed();
+    m_devicesValid = true;
+}
 
-        if (line.startsWith("Sink #")) {
-            // Save previous device if valid
-            if (inSink && !current.id.isEmpty() && !current.id.startsWith("wavemux_")) {
-                devices.append(current);
-            }
-            current = Device();
-            inSink = true;
+bool AudioManager::isDeviceAvailable(const QString &deviceId) const {
+    for (const auto &device : listOutputDevices()) {
+        if (device.id == deviceId) {
+            return true;
         }
+    }
+    return false;
+}
 
-        if (!inSink) continue;
+QString AudioManager::resolveOutputDevice(bool streamMix) const {
+    const QString &preferred = streamMix ? m_streamOutputDevice : m_outputDevice;
+    const QStringList &fallbacks = streamMix ? m_streamOutputFallbacks : m_outputFallbacks;
 
-        if (trimmed.startsWith("Name:")) {
-            current.id = trimmed.mid(5).trimmed();
-        } else if (trimmed.startsWith("Description:")) {
-            current.description = trimmed.mid(12).trimmed();
-            current.name = current.description;  // Use description as display name
+    if (preferred.isEmpty() || isDeviceAvailable(preferred)) {
+        return preferred;
+    }
+    for (const auto &fallback : fallbacks) {
+        if (isDeviceAvailable(fallback)) {
+            return fallback;
         }
     }
+    // Nothing better is plugged in - keep targeting the preferred device
+    return preferred;
+}
+
+bool AudioManager::setOutputFallbacks(const QString &mixId, const QStringList &deviceIds) {
+    if (mixId != "personal" && mixId != "stream") {
+        return false;
+    }
 
-    // Don't forget the last one
-    if (inSink && !current.id.isEmpty() && !current.id.startsWith("wavemux_")) {
-        devices.append(current);
+    QStringList &fallbacks = mixId == "stream" ? m_streamOutputFallbacks : m_outputFallbacks;
+    if (fallbacks == deviceIds) {
+        return true;
     }
+    fallbacks = deviceIds;
+    qCInfo(lcDevices) << "Fallback devices for" << mixId << "mix:" << deviceIds;
 
-    return devices;
+    // The new list may offer a better device right away
+    failoverOutputs();
+    emit mixesChanged();
+    return true;
+}
+
+QStringList AudioManager::getOutputFallbacks(const QString &mixId) const {
+    if (mixId == "stream") {
+        return m_streamOutputFallbacks;
+    }
+    return mixId == "personal" ? m_outputFallbacks : QStringList();
+}
+
+QString AudioManager::getActiveOutputDevice(const QString &mixId) const {
+    if (mixId == "stream") {
+        return m_activeStreamOutputDevice;
+    }
+    return mixId == "personal" ? m_activeOutputDevice : QString();
+}
+
+void AudioManager::failoverOutputs() {
+    const TraceSpan span("mix", "failoverOutputs");
+    if (!m_initialized) {
+        return;  // Initialization builds the loopbacks for the resolved device
+    }
+
+    const struct { bool streamMix; bool live; } mixes[] = {
+        {false, !m_outputDevice.isEmpty() && (m_personalEngine || !m_loopbackModules.isEmpty())},
+        {true, m_streamEnabled && !m_streamOutputDevice.isEmpty() && (m_streamEngine || !m_streamLoopbackModules.isEmpty())},
+    };
+
+    for (const auto &mix : mixes) {
+        if (!mix.live) {
+            continue;
+        }
+
+        QString target = resolveOutputDevice(mix.streamMix);
+        if (!isDeviceAvailable(target)) {
+            // No configured device left: park the mix on the silent sink rather
+            // than letting the server drop it on whatever is now the default
+            target = m_unassignedSinkName;
+        }
+
+        const QString &current = mix.streamMix ? m_activeStreamOutputDevice : m_activeOutputDevice;
+        if (target != current) {
+            retargetLoopbacks(target, mix.streamMix);
+        }
+    }
+    updateCaptures();
 }
 
+bool AudioManager::retargetLoopbacks(const QString &targetSink, bool streamMix) {
+    auto &modules = streamMix ? m_streamLoopbackModules : m_loopbackModules;
+    auto &sinkInputs = streamMix ? m_streamLoopbackSinkInputs : m_loopbackSinkInputs;
+    QString &active = streamMix ? m_activeStreamOutputDevice : m_activeOutputDevice;
+    const QString mixId = streamMix ? "stream" : "personal";
+
+    qCInfo(lcDevices) << "Retargeting" << mixId << "mix from" << active << "to" << targetSink;
+
+    if (engineFor(streamMix)) {
+        // Only the engine's playback end points at the device
+        active = targetSink;
+        startMixEngine(streamMix);
+        emit activeOutputDeviceChanged(mixId, targetSink);
+        return engineFor(streamMix) != nullptr;
+    }
+
+    // Loopbacks that survived the device change are moved in place, all at
+    // once. Sink-input IDs are resolved again since the server may have
+    // recreated them while moving them off the removed device.
+    const QHash<uint32_t, uint32_t> live = findLoopbackSinkInputs();
+    QStringList moves;
+    bool complete = true;
+    for (auto it = modules.begin(); it != modules.end(); ++it) {
+        const uint32_t sinkInputId = live.value(it.value());
+        if (sinkInputId == 0) {
+            complete = false;
+            break;
+        }
+        sinkInputs[it.key()] = sinkInputId;
+        moves << QString("pactl move-sink-input %1 %2").arg(sinkInputId).arg(targetSink);
+    }
+
+    active = targetSink;
+
+    bool success = true;
+    if (complete) {
+        success = runCommands(moves);
+    } else {
+        // Some loopbacks went away with the device - rebuild the mix on the target
+        qCInfo(lcDevices) << "Loopbacks lost with the device, rebuilding" << mixId << "mix";
+        if (streamMix) {
+            removeAllStreamLoopbacks();
+        } else {
+            removeAllLoopbacks();
+        }
+        buildMixLoopbacks(targetSink, streamMix);
+        success = !modules.isEmpty();
+    }
+
+    emit activeOutputDeviceChanged(mixId, targetSink);
+    return success;
+}
 
 bool AudioManager::setOutputDevice(const QString &deviceId) {
     m_outputDevice = deviceId;
-    qInfo() << "Output device set to:" << deviceId;
+    qCInfo(lcDevices) << "Output device set to:" << deviceId;
+    EventLog::record(EventLog::Code::OutputChanged, deviceId.toStdString(), 0);
     // Update loopbacks to route to the new device
     if (m_initialized) {
         updateLoopbacks();
@@ -516,7 +1132,7 @@ void AudioManager::startStreamMonitor() {
             this, &AudioManager::handleMonitorOutput);
 
     m_monitorProcess->start("pactl", {"subscribe"});
-    qInfo() << "Started stream monitor";
+    qCInfo(lcAudio) << "Started stream monitor";
 }
 
 void AudioManager::syncExistingStreams() {
@@ -528,74 +1144,61 @@ void AudioManager::syncExistingStreams() {
         }
     }
 
-    QString output;
-    if (!runCommand("pactl list sink-inputs short", &output)) {
+    // One full listing covers every stream: sink plus names
+    QByteArray output;
+    if (!runCommand("pactl list sink-inputs", &output)) {
         return;
     }
 
     bool changed = false;
 
-    for (const auto &line : output.split('\n', Qt::SkipEmptyParts)) {
-        auto parts = line.split('\t');
-        if (parts.size() < 2) {
-            continue;
-        }
-
-        bool okStream = false;
-        const uint32_t streamId = parts[0].toUInt(&okStream);
-        if (!okStream) {
-            continue;
-        }
-
-        bool okSink = false;
-        const uint32_t sinkIndex = parts[1].toUInt(&okSink);
-        if (!okSink) {
+    const PactlListing listing(bytesView(output));
+    for (size_t i = 0; i < listing.size(); ++i) {
+        const uint32_t streamId = listing[i].index;
+        const auto sinkIndex = PactlListing::toIndex(listing.field(i, "Sink"));
+        if (!sinkIndex) {
             continue;
         }
 
         // Record existing assignments on our channel sinks
-        if (sinkIndexToChannelId.contains(sinkIndex)) {
-            QString channelId = sinkIndexToChannelId[sinkIndex];
+        if (sinkIndexToChannelId.contains(*sinkIndex)) {
+            QString channelId = sinkIndexToChannelId[*sinkIndex];
             if (m_streamAssignments.value(streamId) != channelId) {
                 m_streamAssignments[streamId] = channelId;
                 changed = true;
             }
-            qInfo() << "Existing stream" << streamId << "on channel" << channelId;
+            qCInfo(lcStreams) << "Existing stream" << streamId << "on channel" << channelId;
             continue;
         }
 
-        auto info = getStreamInfo(streamId);
-        if (!info) {
-            continue;
-        }
+        StreamInfo info;
+        info.id = streamId;
+        info.currentSink = fieldText(listing.field(i, "Sink"));
+        info.appName = propertyText(listing.property(i, "application.name"));
+        info.mediaName = propertyText(listing.property(i, "media.name"));
+        info.processName = propertyText(listing.property(i, "application.process.binary"));
 
         // Skip loopback and system streams
-        if (info->appName.contains("Loopback", Qt::CaseInsensitive) ||
-            info->processName.contains("loopback", Qt::CaseInsensitive) ||
-            (info->appName.isEmpty() && info->processName.isEmpty())) {
+        if (info.appName.contains("Loopback", Qt::CaseInsensitive) ||
+            info.processName.contains("loopback", Qt::CaseInsensitive) ||
+            info.appName == MixEngine::CLIENT_NAME ||
+            (info.appName.isEmpty() && info.processName.isEmpty())) {
             continue;
         }
+        restoreAppVolume(streamId, info);
 
         // Apply routing rules or move to silent sink
-        bool routed = false;
-        for (const auto &rule : m_routingRules) {
-            QRegularExpression re(rule.matchPattern, QRegularExpression::CaseInsensitiveOption);
-            if (re.match(info->appName).hasMatch() || re.match(info->processName).hasMatch()) {
-                moveStreamToChannel(streamId, rule.targetChannel);
-                changed = true;
-                routed = true;
-                break;
-            }
-        }
-
-        if (!routed) {
+        if (const RoutingRule *rule = matchRoutingRule(info.appName, info.processName)) {
+            moveStreamToChannel(streamId, rule->targetChannel);
+            changed = true;
+        } else {
             QString cmd = QString("pactl move-sink-input %1 %2").arg(streamId).arg(m_unassignedSinkName);
             if (runCommand(cmd)) {
                 if (m_streamAssignments.contains(streamId)) {
                     m_streamAssignments.remove(streamId);
                     changed = true;
                 }
-                qInfo() << "Moved stream" << streamId << "(" << info->appName << ") to silent sink";
+                qCInfo(lcStreams) << "Moved stream" << streamId << "(" << info.appName << ") to silent sink";
             }
         }
     }
@@ -611,7 +1214,7 @@ void AudioManager::stopStreamMonitor() {
         m_monitorProcess->waitForFinished(1000);
         delete m_monitorProcess;
         m_monitorProcess = nullptr;
-        qInfo() << "Stopped stream monitor";
+        qCInfo(lcAudio) << "Stopped stream monitor";
     }
 }
 
@@ -620,57 +1223,101 @@ void AudioManager::handleMonitorOutput() {
         QString line = QString::fromUtf8(m_monitorProcess->readLine()).trimmed();
 
         // Parse events like: Event 'new' on sink-input #123
-        // or: Event 'remove' on sink-input #123
-        QRegularExpression re("Event '(\\w+)' on sink-input #(\\d+)");
+        // or: Event 'remove' on sink #45
+        static const QRegularExpression re("Event '(\\w+)' on (sink-input|sink) #(\\d+)");
         auto match = re.match(line);
 
         if (match.hasMatch()) {
+            const TraceSpan span("event", traceName(line));
             QString eventType = match.captured(1);
-            uint32_t streamId = match.captured(2).toUInt();
-            handleStreamEvent(eventType, streamId);
+            uint32_t id = match.captured(3).toUInt();
+            if (match.captured(2) == "sink") {
+                handleSinkEvent(eventType, id);
+            } else {
+                handleStreamEvent(eventType, id);
+            }
+        }
+    }
+}
+
+void AudioManager::handleSinkEvent(const QString &eventType, uint32_t index) {
+    // Failover happens right here, in the same event-loop iteration as the
+    // event, so an unplugged device is replaced before anyone notices
+    if (eventType == "new") {
+        // The event carries only the index; one listing gives name and description
+        refreshDeviceCache();
+        if (!m_deviceSinkIndexes.contains(index)) {
+            return;  // One of our own virtual sinks
         }
+        qCInfo(lcDevices) << "Output device added:" << m_deviceSinkIndexes.value(index);
+        EventLog::record(EventLog::Code::DeviceAdded, m_deviceSinkIndexes.value(index).toStdString());
+    } else if (eventType == "remove") {
+        if (!m_deviceSinkIndexes.contains(index)) {
+            return;
+        }
+        const QString deviceId = m_deviceSinkIndexes.take(index);
+        m_devices.erase(std::remove_if(m_devices.begin(), m_devices.end(),
+                                       [&](const Device &device) { return device.id == deviceId; }),
+                        m_devices.end());
+        qCInfo(lcDevices) << "Output device removed:" << deviceId;
+        EventLog::record(EventLog::Code::DeviceRemoved, deviceId.toStdString());
+    } else {
+        return;  // Volume and port changes don't affect the device list
     }
+
+    failoverOutputs();
+    emit devicesChanged();
 }
 
 void AudioManager::handleStreamEvent(const QString &eventType, uint32_t id) {
     if (eventType == "new") {
+        QElapsedTimer sinceEvent;
+        sinceEvent.start();
         // Small delay to let stream properties settle
-        QTimer::singleShot(100, this, [this, id]() {
+        QTimer::singleShot(100, this, [this, id, sinceEvent]() {
+            const TraceSpan span("event", "route new stream");
             auto info = getStreamInfo(id);
             if (info) {
                 // Skip loopback and system streams
                 if (info->appName.contains("Loopback", Qt::CaseInsensitive) ||
                     info->processName.contains("loopback", Qt::CaseInsensitive) ||
                     info->mediaName.contains("Loopback", Qt::CaseInsensitive) ||
+                    info->appName == MixEngine::CLIENT_NAME ||
                     (info->appName.isEmpty() && info->processName.isEmpty())) {
-                    qDebug() << "Ignoring system/loopback stream:" << id;
+                    qCDebug(lcStreams) << "Ignoring system/loopback stream:" << id;
                     return;
                 }
 
                 // Skip if this is one of our own loopback sink-inputs
                 for (auto it = m_loopbackSinkInputs.begin(); it != m_loopbackSinkInputs.end(); ++it) {
                     if (it.value() == id) {
-                        qDebug() << "Ignoring our own personal loopback:" << id;
+                        qCDebug(lcStreams) << "Ignoring our own personal loopback:" << id;
                         return;
                     }
                 }
                 for (auto it = m_streamLoopbackSinkInputs.begin(); it != m_streamLoopbackSinkInputs.end(); ++it) {
                     if (it.value() == id) {
-                        qDebug() << "Ignoring our own stream loopback:" << id;
+                        qCDebug(lcStreams) << "Ignoring our own stream loopback:" << id;
                         return;
                     }
                 }
 
-                qInfo() << "New stream:" << id << info->appName << info->processName;
+                qCInfo(lcStreams) << "New stream:" << id << info->appName << info->processName;
+                EventLog::record(EventLog::Code::StreamAdded, info->appName.toStdString(), id);
+                restoreAppVolume(id, *info);
                 emit streamAdded(id, info->appName);
 
                 // Apply routing rules
                 applyRoutingRules(id, info->appName, info->processName);
+                Stats::histogram("streams.event-to-route").record(static_cast<uint64_t>(sinceEvent.nsecsElapsed() / 1000));
             }
         });
     } else if (eventType == "remove") {
-        qInfo() << "Stream removed:" << id;
+        qCInfo(lcStreams) << "Stream removed:" << id;
+        EventLog::record(EventLog::Code::StreamRemoved, "", id);
         m_streamAssignments.remove(id);
+        m_streamLevels.remove(id);
+        m_streamApps.remove(id);
         emit streamRemoved(id);
         emit streamsChanged();
     } else if (eventType == "change") {
@@ -679,54 +1326,30 @@ void AudioManager::handleStreamEvent(const QString &eventType, uint32_t id) {
 }
 
 std::optional<StreamInfo> AudioManager::getStreamInfo(uint32_t id) const {
-    QString output;
+    QByteArray output;
     if (!runCommand(QString("pactl list sink-inputs"), &output)) {
         return std::nullopt;
     }
 
-    StreamInfo info;
-    info.id = id;
-    bool foundSinkInput = false;
-    bool inCorrectBlock = false;
-
-    for (const auto &line : output.split('\n')) {
-        QString trimmed = line.trimmed();
-
-        if (trimmed.startsWith("Sink Input #")) {
-            uint32_t currentId = trimmed.mid(12).toUInt();
-            inCorrectBlock = (currentId == id);
-            foundSinkInput = inCorrectBlock;
-        }
-
-        if (!inCorrectBlock) continue;
-
-        if (trimmed.startsWith("Sink:")) {
-            // Extract sink index, then we need to get sink name
-            QRegularExpression sinkRe("Sink: (\\d+)");
-            auto match = sinkRe.match(trimmed);
-            if (match.hasMatch()) {
-                // We'll need another query to get sink name from index
-                // For now store the index as string
-                info.currentSink = match.captured(1);
-            }
-        } else if (trimmed.startsWith("application.name = ")) {
-            info.appName = trimmed.mid(19).remove('"');
-        } else if (trimmed.startsWith("media.name = ")) {
-            info.mediaName = trimmed.mid(13).remove('"');
-        } else if (trimmed.startsWith("application.process.binary = ")) {
-            info.processName = trimmed.mid(29).remove('"');
-        }
+    const PactlListing listing(bytesView(output));
+    const auto object = listing.find(id);
+    if (!object) {
+        return std::nullopt;
     }
 
-    if (foundSinkInput) {
-        return info;
-    }
-    return std::nullopt;
+    StreamInfo info;
+    info.id = id;
+    // Sink index as a string; callers resolve the name when they need it
+    info.currentSink = fieldText(listing.field(*object, "Sink"));
+    info.appName = propertyText(listing.property(*object, "application.name"));
+    info.mediaName = propertyText(listing.property(*object, "media.name"));
+    info.processName = propertyText(listing.property(*object, "application.process.binary"));
+    return info;
 }
 
 QList<Stream> AudioManager::listStreams() const {
     QList<Stream> result;
-    QString output;
+    QByteArray output;
 
     if (!runCommand("pactl list sink-inputs", &output)) {
         return result;
@@ -744,109 +1367,174 @@ QList<Stream> AudioManager::listStreams() const {
         "pw-loopback",
         "module-loopback",
         "PulseAudio Volume Control",
-        "pavucontrol"
+        "pavucontrol",
+        MixEngine::CLIENT_NAME
     };
 
-    Stream current;
-    bool inBlock = false;
-    bool isLoopback = false;
-    QString moduleName;
-
-    for (const auto &line : output.split('\n')) {
-        QString trimmed = line.trimmed();
-
-        if (trimmed.startsWith("Sink Input #")) {
-            // Save previous stream if valid and not filtered
-            if (inBlock && current.id > 0 && !isLoopback) {
-                bool filtered = false;
-                for (const auto &filter : filteredApps) {
-                    if (current.appName.contains(filter, Qt::CaseInsensitive) ||
-                        current.processName.contains(filter, Qt::CaseInsensitive)) {
-                        filtered = true;
-                        break;
-                    }
-                }
-                // Also filter out streams with no app name and no process name (system streams)
-                if (!filtered && (current.appName.isEmpty() && current.processName.isEmpty())) {
-                    filtered = true;
-                }
-                if (!filtered) {
-                    if (m_streamAssignments.contains(current.id)) {
-                        current.assignedChannel = m_streamAssignments[current.id];
-                    }
-                    result.append(current);
-                }
-            }
-            current = Stream();
-            current.id = trimmed.mid(12).toUInt();
-            inBlock = true;
-            isLoopback = false;
-            moduleName.clear();
-        }
-
-        if (!inBlock) continue;
-
-        if (trimmed.startsWith("application.name = ")) {
-            current.appName = trimmed.mid(19).remove('"');
-        } else if (trimmed.startsWith("media.name = ")) {
-            current.mediaName = trimmed.mid(13).remove('"');
-            // Check if media name indicates loopback
-            if (current.mediaName.contains("Loopback", Qt::CaseInsensitive) ||
-                current.mediaName.contains("loopback", Qt::CaseInsensitive)) {
-                isLoopback = true;
-            }
-        } else if (trimmed.startsWith("application.process.binary = ")) {
-            current.processName = trimmed.mid(29).remove('"');
-        } else if (trimmed.startsWith("module-stream-restore.id = ")) {
-            moduleName = trimmed.mid(27).remove('"');
-            // Check if this is a loopback module
-            if (moduleName.contains("module-loopback")) {
-                isLoopback = true;
-            }
-        } else if (trimmed.contains("module.id = ")) {
-            // Check if this sink-input belongs to one of our loopback modules
-            QRegularExpression moduleRe("module\\.id = \"(\\d+)\"");
-            auto match = moduleRe.match(trimmed);
-            if (match.hasMatch()) {
-                uint32_t moduleId = match.captured(1).toUInt();
-                for (auto it = m_loopbackModules.begin(); it != m_loopbackModules.end(); ++it) {
-                    if (it.value() == moduleId) {
-                        isLoopback = true;
-                        break;
-                    }
-                }
-            }
+    // A level we set wins over what the server reports: it may still be queued
+    auto applyStreamLevel = [this](Stream &stream) {
+        auto it = m_streamLevels.constFind(stream.id);
+        if (it != m_streamLevels.constEnd()) {
+            stream.volume = it->volume;
+            stream.muted = it->muted;
         }
-    }
+    };
 
-    // Don't forget the last one
-    if (inBlock && current.id > 0 && !isLoopback) {
-        bool filtered = false;
-        for (const auto &filter : filteredApps) {
-            if (current.appName.contains(filter, Qt::CaseInsensitive) ||
-                current.processName.contains(filter, Qt::CaseInsensitive)) {
-                filtered = true;
-                break;
-            }
+    const PactlListing listing(bytesView(output));
+    for (size_t i = 0; i < listing.size(); ++i) {
+        if (listing[i].index == 0) {
+            continue;
         }
-        // Also filter out streams with no app name and no process name (system streams)
-        if (!filtered && (current.appName.isEmpty() && current.processName.isEmpty())) {
-            filtered = true;
+        Stream stream;
+        stream.id = listing[i].index;
+        stream.appName = propertyText(listing.property(i, "application.name"));
+        stream.processName = propertyText(listing.property(i, "application.process.binary"));
+        stream.mediaName = propertyText(listing.property(i, "media.name"));
+
+        // Loopbacks: by media name, by stream-restore id, or one of our own modules
+        if (stream.mediaName.contains("Loopback", Qt::CaseInsensitive) ||
+            listing.property(i, "module-stream-restore.id").find("module-loopback") != std::string_view::npos) {
+            continue;
         }
-        if (!filtered) {
-            if (m_streamAssignments.contains(current.id)) {
-                current.assignedChannel = m_streamAssignments[current.id];
+        if (const auto moduleId = PactlListing::toIndex(listing.property(i, "module.id"))) {
+            if (std::find(m_loopbackModules.cbegin(), m_loopbackModules.cend(), *moduleId) != m_loopbackModules.cend()) {
+                continue;
             }
-            result.append(current);
         }
+
+        // Streams with no app name and no process name are system streams
+        if (stream.appName.isEmpty() && stream.processName.isEmpty()) {
+            continue;
+        }
+        const bool filtered = std::any_of(filteredApps.cbegin(), filteredApps.cend(), [&](const QString &filter) {
+            return stream.appName.contains(filter, Qt::CaseInsensitive) ||
+                   stream.processName.contains(filter, Qt::CaseInsensitive);
+        });
+        if (filtered) {
+            continue;
+        }
+
+        // "Volume: front-left: 65536 / 100% / 0.00 dB, ..." - first channel
+        if (const auto volume = PactlListing::volumePercent(listing.field(i, "Volume"))) {
+            stream.volume = *volume;
+        }
+        stream.muted = listing.field(i, "Mute") == "yes";
+        stream.assignedChannel = m_streamAssignments.value(stream.id);
+        applyStreamLevel(stream);
+        result.append(stream);
     }
 
     return result;
 }
 
+QString AudioManager::appKeyFor(uint32_t streamId) {
+    auto it = m_streamApps.constFind(streamId);
+    if (it != m_streamApps.constEnd()) {
+        return *it;
+    }
+    // Streams seen before we started watching; looked up once
+    const auto info = getStreamInfo(streamId);
+    if (!info) {
+        return QString();
+    }
+    const QString key = info->processName.isEmpty() ? info->appName : info->processName;
+    m_streamApps[streamId] = key;
+    return key;
+}
+
+void AudioManager::restoreAppVolume(uint32_t streamId, const StreamInfo &info) {
+    const QString key = info.processName.isEmpty() ? info.appName : info.processName;
+    m_streamApps[streamId] = key;
+    auto it = m_appVolumes.constFind(key);
+    if (it != m_appVolumes.constEnd()) {
+        qCInfo(lcStreams) << "Restoring level of" << key << "on stream" << streamId << ":" << it->volume << it->muted;
+        setStreamLevel(streamId, *it);
+    }
+}
+
+bool AudioManager::setStreamLevel(uint32_t streamId, const AppVolume &level) {
+    if (!m_commandQueue) {
+        m_commandQueue = new CommandQueue(this);
+    }
+    const AppVolume previous = m_streamLevels.value(streamId);
+    if (!m_streamLevels.contains(streamId) || previous.volume != level.volume) {
+        m_commandQueue->enqueue(QString("volume:%1").arg(streamId),
+                                QString("pactl set-sink-input-volume %1 %2%").arg(streamId).arg(level.volume));
+    }
+    if (!m_streamLevels.contains(streamId) || previous.muted != level.muted) {
+        m_commandQueue->enqueue(QString("mute:%1").arg(streamId),
+                                QString("pactl set-sink-input-mute %1 %2").arg(streamId).arg(level.muted ? 1 : 0));
+    }
+    m_streamLevels[streamId] = level;
+    return true;
+}
+
+bool AudioManager::setStreamVolume(uint32_t streamId, int volume) {
+    const QString key = appKeyFor(streamId);
+    if (key.isEmpty()) {
+        return false;
+    }
+    AppVolume level = m_streamLevels.value(streamId, m_appVolumes.value(key));
+    level.volume = qBound(0, volume, 100);
+    EventLog::record(EventLog::Code::AppVolume, key.toStdString(), streamId, level.volume);
+    setStreamLevel(streamId, level);
+
+    // Default levels aren't worth remembering
+    if (level.volume == 100 && !level.muted) {
+        m_appVolumes.remove(key);
+    } else {
+        m_appVolumes[key] = level;
+    }
+    emit streamsChanged();
+    emit appVolumesChanged();
+    return true;
+}
+
+bool AudioManager::setStreamMute(uint32_t streamId, bool muted) {
+    const QString key = appKeyFor(streamId);
+    if (key.isEmpty()) {
+        return false;
+    }
+    AppVolume level = m_streamLevels.value(streamId, m_appVolumes.value(key));
+    level.muted = muted;
+    EventLog::record(EventLog::Code::AppMute, key.toStdString(), streamId, muted ? 1 : 0);
+    setStreamLevel(streamId, level);
+
+    if (level.volume == 100 && !level.muted) {
+        m_appVolumes.remove(key);
+    } else {
+        m_appVolumes[key] = level;
+    }
+    emit streamsChanged();
+    emit appVolumesChanged();
+    return true;
+}
+
+void AudioManager::setAppVolumes(const QHash<QString, AppVolume> &volumes) {
+    m_appVolumes = volumes;
+    // Running streams of those apps follow right away; ones we set before go
+    // back to the default level if their app is no longer listed
+    for (auto it = m_streamApps.constBegin(); it != m_streamApps.constEnd(); ++it) {
+        if (m_appVolumes.contains(it.value()) || m_streamLevels.contains(it.key())) {
+            setStreamLevel(it.key(), m_appVolumes.value(it.value()));
+        }
+    }
+    emit appVolumesChanged();
+}
+
+void AudioManager::flushPendingCommands() {
+    if (m_commandQueue) {
+        m_commandQueue->flush();
+    }
+}
+
+bool AudioManager::hasPendingCommands() const {
+    return m_commandQueue && !m_commandQueue->isIdle();
+}
+
 bool AudioManager::moveStreamToChannel(uint32_t streamId, const QString &channelId) {
     if (!m_channels.contains(channelId)) {
-        qWarning() << "Unknown channel:" << channelId;
+        qCWarning(lcStreams) << "Unknown channel:" << channelId;
         return false;
     }
 
@@ -857,7 +1545,8 @@ bool AudioManager::moveStreamToChannel(uint32_t streamId, const QString &channel
 
     if (runCommand(cmd)) {
         m_streamAssignments[streamId] = channelId;
-        qInfo() << "Moved stream" << streamId << "to channel" << channelId;
+        EventLog::record(EventLog::Code::StreamMoved, channelId.toStdString(), streamId);
+        qCInfo(lcStreams) << "Moved stream" << streamId << "to channel" << channelId;
 
         // Auto-create routing rule based on app/process name
         auto streamInfo = getStreamInfo(streamId);
@@ -873,7 +1562,7 @@ bool AudioManager::moveStreamToChannel(uint32_t streamId, const QString &channel
             if (!pattern.isEmpty()) {
                 // Use case-insensitive exact match
                 addRoutingRule(pattern, channelId);
-                qInfo() << "Auto-created routing rule:" << pattern << "->" << channelId;
+                qCInfo(lcStreams) << "Auto-created routing rule:" << pattern << "->" << channelId;
             }
         }
 
@@ -897,7 +1586,8 @@ bool AudioManager::unassignStream(uint32_t streamId) {
 
     if (runCommand(cmd)) {
         m_streamAssignments.remove(streamId);
-        qInfo() << "Unassigned stream" << streamId << "to silent sink";
+        EventLog::record(EventLog::Code::StreamUnassigned, "", streamId);
+        qCInfo(lcStreams) << "Unassigned stream" << streamId << "to silent sink";
         emit streamsChanged();
         return true;
     }
@@ -919,7 +1609,7 @@ void AudioManager::addRoutingRule(const QString &pattern, const QString &channel
     rule.targetChannel = channelId;
     m_routingRules.append(rule);
 
-    qInfo() << "Added routing rule:" << pattern << "->" << channelId;
+    qCInfo(lcStreams) << "Added routing rule:" << pattern << "->" << channelId;
     emit routingRulesChanged();
 }
 
@@ -943,13 +1633,13 @@ QList<RoutingRule> AudioManager::getRoutingRules() const {
 
 void AudioManager::applyRoutingRulesToExistingStreams() {
     if (m_routingRules.isEmpty()) {
-        qInfo() << "No routing rules to apply";
+        qCInfo(lcStreams) << "No routing rules to apply";
         return;
     }
 
-    qInfo() << "Applying routing rules to existing streams...";
+    qCInfo(lcStreams) << "Applying routing rules to existing streams...";
 
-    QString output;
+    QByteArray output;
     if (!runCommand("pactl list sink-inputs", &output)) {
         return;
     }
@@ -961,81 +1651,392 @@ void AudioManager::applyRoutingRulesToExistingStreams() {
         QString mediaName;
     };
 
-    QList<StreamData> streams;
-    StreamData current;
-    bool inBlock = false;
-
-    for (const auto &line : output.split('\n')) {
-        QString trimmed = line.trimmed();
+    const PactlListing listing(bytesView(output));
+    for (size_t i = 0; i < listing.size(); ++i) {
+        StreamData stream;
+        stream.id = listing[i].index;
+        stream.appName = propertyText(listing.property(i, "application.name"));
+        stream.processName = propertyText(listing.property(i, "application.process.binary"));
+        stream.mediaName = propertyText(listing.property(i, "media.name"));
+        if (stream.id == 0 ||
+            stream.appName.contains("Loopback", Qt::CaseInsensitive) ||
+            stream.processName.contains("loopback", Qt::CaseInsensitive) ||
+            stream.mediaName.contains("Loopback", Qt::CaseInsensitive) ||
+            (stream.appName.isEmpty() && stream.processName.isEmpty())) {
+            continue;
+        }
 
-        if (trimmed.startsWith("Sink Input #")) {
-            if (inBlock && current.id > 0) {
-                streams.append(current);
+        const RoutingRule *rule = matchRoutingRule(stream.appName, stream.processName);
+        if (rule && m_channels.contains(rule->targetChannel)) {
+            const auto &channel = m_channels[rule->targetChannel];
+            QString cmd = QString("pactl move-sink-input %1 %2")
+                .arg(stream.id)
+                .arg(channel.sinkName);
+            if (runCommand(cmd)) {
+                m_streamAssignments[stream.id] = rule->targetChannel;
+                qCInfo(lcStreams) << "Routed" << stream.appName << "to" << rule->targetChannel;
             }
-            current = StreamData();
-            current.id = trimmed.mid(12).toUInt();
-            inBlock = true;
         }
+    }
+}
+
+const RoutingRule *AudioManager::matchRoutingRule(const QString &appName, const QString &processName) const {
+    for (const auto &rule : m_routingRules) {
+        QRegularExpression re(rule.matchPattern, QRegularExpression::CaseInsensitiveOption);
+        if (re.match(appName).hasMatch() || re.match(processName).hasMatch()) {
+            return &rule;
+        }
+    }
+    return nullptr;
+}
+
+MixerSnapshot AudioManager::snapshot() const {
+    MixerSnapshot result;
+    result.channels = listChannels();
+    result.masterVolume = m_masterVolume;
+    result.outputDevice = m_outputDevice;
+    result.streamOutputDevice = m_streamOutputDevice;
+    result.outputFallbacks = m_outputFallbacks;
+    result.streamOutputFallbacks = m_streamOutputFallbacks;
+    result.streamEnabled = m_streamEnabled;
+    result.routingRules = m_routingRules;
+    for (const bool streamMix : {false, true}) {
+        MixSettings &mix = streamMix ? result.stream : result.personal;
+        const MixProcessing &processing = processingFor(streamMix);
+        mix.ducking = processing.ducking;
+        mix.limiter = processing.limiter;
+        mix.loudness = processing.loudness;
+        mix.delaysMs = getChannelDelays(streamMix ? "stream" : "personal");
+        mix.adaptiveLatency = latencyPathFor(streamMix).adaptive;
+    }
+    for (const auto &channel : m_channels) {
+        result.channelEq[channel.id] = channel.eq;
+    }
+    result.mic = m_micConfig;
+    result.deviceLatencies = m_deviceLatencies;
+    return result;
+}
+
+bool AudioManager::stageMixSettings(bool streamMix, const MixSettings &settings, bool *latencyChanged) {
+    MixProcessing &processing = processingFor(streamMix);
+    bool changed = false;
+    if (validDucking(settings.ducking) && !sameDucking(settings.ducking, processing.ducking)) {
+        processing.ducking = settings.ducking;
+        changed = true;
+    }
+    if (validLimiter(settings.limiter) && !sameLimiter(settings.limiter, processing.limiter)) {
+        processing.limiter = settings.limiter;
+        changed = true;
+    }
+    if (validLoudness(settings.loudness) && !sameLoudness(settings.loudness, processing.loudness)) {
+        processing.loudness = settings.loudness;
+        changed = true;
+    }
+
+    QHash<QString, int> delays;
+    for (auto it = settings.delaysMs.constBegin(); it != settings.delaysMs.constEnd(); ++it) {
+        if (!m_channels.contains(it.key()) && it.key() != MIC_CHANNEL_ID) {
+            continue;
+        }
+        if (it.value() < 0.0 || it.value() > MixGraph::MAX_DELAY_MS) {
+            qCWarning(lcMix) << "Invalid delay:" << it.value() << "ms";
+            continue;
+        }
+        const int frames = static_cast<int>(std::lround(it.value() * MixEngine::SAMPLE_RATE / 1000.0));
+        if (frames > 0) {
+            delays[it.key()] = frames;
+        }
+    }
+    if (delays != processing.delays) {
+        processing.delays = delays;
+        changed = true;
+    }
+
+    LatencyPath &path = latencyPathFor(streamMix);
+    *latencyChanged = path.adaptive != settings.adaptiveLatency;
+    path.adaptive = settings.adaptiveLatency;
+    return changed;
+}
+
+bool AudioManager::mixNeedsRebuild(bool streamMix, int previousLatencyMs) const {
+    const MixEngine *engine = streamMix ? m_streamEngine : m_personalEngine;
+    if (mixNeedsProcessing(streamMix) != (engine != nullptr)) {
+        return true;  // Switches between loopbacks and the engine
+    }
+    if (engine) {
+        return engine->sources() != mixSources(streamMix);  // The mic joined or left
+    }
+    // Loopbacks only take their latency when they are created
+    const QString &device = streamMix ? m_activeStreamOutputDevice : m_activeOutputDevice;
+    return hasLoopbacks(streamMix) && loopbackLatency(device, streamMix) != previousLatencyMs;
+}
 
-        if (!inBlock) continue;
+bool AudioManager::applySnapshot(const MixerSnapshot &snapshot) {
+    const TraceSpan span("mix", "applySnapshot");
+    QElapsedTimer timer;
+    timer.start();
+
+    // Stage every change against the current state first, so that only the
+    // differences are sent to the server and they go out in parallel waves:
+    //   1. channels that become muted are muted first,
+    //   2. volumes, mix levels and stream moves are applied together,
+    //   3. channels that become unmuted are unmuted last (already at their new level).
+    // No signals are emitted until everything has been applied.
+    QStringList muteCommands;
+    QStringList applyCommands;
+    QStringList unmuteCommands;
+
+    const int masterVolume = qBound(0, snapshot.masterVolume, 100);
+    const bool masterDirty = masterVolume != m_masterVolume;
+    m_masterVolume = masterVolume;
+
+    bool stateDirty = masterDirty ||
+        snapshot.outputDevice != m_outputDevice ||
+        snapshot.streamOutputDevice != m_streamOutputDevice ||
+        snapshot.outputFallbacks != m_outputFallbacks ||
+        snapshot.streamOutputFallbacks != m_streamOutputFallbacks ||
+        snapshot.streamEnabled != m_streamEnabled;
+
+    const bool wasStreamEnabled = m_streamEnabled;
+    m_outputDevice = snapshot.outputDevice;
+    m_streamOutputDevice = snapshot.streamOutputDevice;
+    m_outputFallbacks = snapshot.outputFallbacks;
+    m_streamOutputFallbacks = snapshot.streamOutputFallbacks;
+    m_streamEnabled = snapshot.streamEnabled;
+
+    // Processing, EQ, mic and latency settings are only stored here; the
+    // single rebuild decision below sees the mode each mix ends up in
+    const int personalLatency = loopbackLatency(m_activeOutputDevice, false);
+    const int streamLatency = loopbackLatency(m_activeStreamOutputDevice, true);
+    bool personalLatencyDirty = false;
+    bool streamLatencyDirty = false;
+    bool processingDirty = stageMixSettings(false, snapshot.personal, &personalLatencyDirty);
+    processingDirty = stageMixSettings(true, snapshot.stream, &streamLatencyDirty) || processingDirty;
+
+    QStringList eqChanged;
+    for (auto it = snapshot.channelEq.constBegin(); it != snapshot.channelEq.constEnd(); ++it) {
+        auto channel = m_channels.find(it.key());
+        if (channel != m_channels.end() && validEqBands(it.value()) && !sameEq(channel->eq, it.value())) {
+            channel->eq = it.value();
+            eqChanged << it.key();
+        }
+    }
 
-        if (trimmed.startsWith("application.name = ")) {
-            current.appName = trimmed.mid(19).remove('"');
-        } else if (trimmed.startsWith("media.name = ")) {
-            current.mediaName = trimmed.mid(13).remove('"');
-        } else if (trimmed.startsWith("application.process.binary = ")) {
-            current.processName = trimmed.mid(29).remove('"');
+    const bool micDirty = validMic(snapshot.mic) && !sameMic(snapshot.mic, m_micConfig);
+    if (micDirty) {
+        m_micConfig = snapshot.mic;
+        if (m_initialized) {
+            updateMicSuppression();
+        }
+    }
+    for (const auto &target : snapshot.channels) {
+        if (target.id == MIC_CHANNEL_ID) {
+            // No sink to command: the mix engines pick the levels up below
+            const ChannelState before = m_mic;
+            m_mic.volume = qBound(0, target.volume, 100);
+            m_mic.muted = target.muted;
+            m_mic.personalVolume = qBound(0, target.personalVolume, 100);
+            m_mic.streamVolume = qBound(0, target.streamVolume, 100);
+            stateDirty = stateDirty || before.volume != m_mic.volume || before.muted != m_mic.muted ||
+                         before.personalVolume != m_mic.personalVolume || before.streamVolume != m_mic.streamVolume;
         }
     }
 
-    if (inBlock && current.id > 0) {
-        streams.append(current);
+    if (snapshot.deviceLatencies != m_deviceLatencies) {
+        setDeviceLatencies(snapshot.deviceLatencies);
     }
 
-    for (const auto &stream : streams) {
-        if (stream.appName.contains("Loopback", Qt::CaseInsensitive) ||
-            stream.processName.contains("loopback", Qt::CaseInsensitive) ||
-            stream.mediaName.contains("Loopback", Qt::CaseInsensitive) ||
-            (stream.appName.isEmpty() && stream.processName.isEmpty())) {
+    // Loopbacks are rebuilt (each exactly once) when the device they should
+    // play on changes, some are missing, or the mix changes mode, sources or
+    // loopback latency; otherwise only their levels are adjusted in place
+    const bool personalRebuild = m_initialized && !m_outputDevice.isEmpty() &&
+        (resolveOutputDevice(false) != m_activeOutputDevice || mixRoutingIncomplete(false) ||
+         mixNeedsRebuild(false, personalLatency));
+    const bool streamRebuild = m_initialized && m_streamEnabled && !m_streamOutputDevice.isEmpty() &&
+        (resolveOutputDevice(true) != m_activeStreamOutputDevice || !wasStreamEnabled ||
+         mixRoutingIncomplete(true) || mixNeedsRebuild(true, streamLatency));
+    const bool streamTeardown = wasStreamEnabled && !m_streamEnabled;
+
+    for (const auto &target : snapshot.channels) {
+        if (target.id == MIC_CHANNEL_ID) {
+            continue;
+        }
+        if (!m_channels.contains(target.id)) {
+            qCWarning(lcAudio) << "Snapshot references unknown channel:" << target.id;
             continue;
         }
 
-        for (const auto &rule : m_routingRules) {
-            QRegularExpression re(rule.matchPattern, QRegularExpression::CaseInsensitiveOption);
-            if (re.match(stream.appName).hasMatch() || re.match(stream.processName).hasMatch()) {
-                if (m_channels.contains(rule.targetChannel)) {
-                    const auto &channel = m_channels[rule.targetChannel];
-                    QString cmd = QString("pactl move-sink-input %1 %2")
-                        .arg(stream.id)
-                        .arg(channel.sinkName);
-                    if (runCommand(cmd)) {
-                        m_streamAssignments[stream.id] = rule.targetChannel;
-                        qInfo() << "Routed" << stream.appName << "to" << rule.targetChannel;
-                    }
+        auto &channel = m_channels[target.id];
+        const int volume = qBound(0, target.volume, 100);
+        const int personalVolume = qBound(0, target.personalVolume, 100);
+        const int streamVolume = qBound(0, target.streamVolume, 100);
+
+        if (channel.sinkIndex > 0) {
+            if (target.muted && !channel.muted) {
+                muteCommands << QString("pactl set-sink-mute %1 1").arg(channel.sinkName);
+            } else if (!target.muted && channel.muted) {
+                unmuteCommands << QString("pactl set-sink-mute %1 0").arg(channel.sinkName);
+            }
+
+            if (volume != channel.volume) {
+                applyCommands << QString("pactl set-sink-volume %1 %2%").arg(channel.sinkName).arg(volume);
+            }
+
+            if (!personalRebuild && m_loopbackSinkInputs.contains(target.id) &&
+                (personalVolume != channel.personalVolume || masterDirty)) {
+                int effectiveVolume = (personalVolume * m_masterVolume) / 100;
+                applyCommands << QString("pactl set-sink-input-volume %1 %2%")
+                    .arg(m_loopbackSinkInputs[target.id]).arg(effectiveVolume);
+            }
+
+            if (!streamRebuild && !streamTeardown && m_streamLoopbackSinkInputs.contains(target.id) &&
+                (streamVolume != channel.streamVolume || masterDirty)) {
+                int effectiveVolume = (streamVolume * m_masterVolume) / 100;
+                applyCommands << QString("pactl set-sink-input-volume %1 %2%")
+                    .arg(m_streamLoopbackSinkInputs[target.id]).arg(effectiveVolume);
+            }
+        }
+
+        if (channel.volume != volume || channel.muted != target.muted ||
+            channel.personalVolume != personalVolume || channel.streamVolume != streamVolume) {
+            channel.volume = volume;
+            channel.muted = target.muted;
+            channel.personalVolume = personalVolume;
+            channel.streamVolume = streamVolume;
+            stateDirty = true;
+        }
+    }
+
+    // Routing rules: swap the whole set, then move only the streams whose
+    // target channel differs from where they currently are.
+    bool rulesDirty = snapshot.routingRules.size() != m_routingRules.size();
+    for (int i = 0; !rulesDirty && i < snapshot.routingRules.size(); ++i) {
+        rulesDirty = snapshot.routingRules[i].matchPattern != m_routingRules[i].matchPattern ||
+                     snapshot.routingRules[i].targetChannel != m_routingRules[i].targetChannel;
+    }
+
+    QList<QPair<uint32_t, QString>> moves;
+    if (rulesDirty) {
+        m_routingRules = snapshot.routingRules;
+        stateDirty = true;
+
+        if (m_initialized) {
+            for (const auto &stream : listStreams()) {
+                const RoutingRule *rule = matchRoutingRule(stream.appName, stream.processName);
+                if (rule && m_channels.contains(rule->targetChannel) && stream.assignedChannel != rule->targetChannel) {
+                    applyCommands << QString("pactl move-sink-input %1 %2")
+                        .arg(stream.id).arg(m_channels[rule->targetChannel].sinkName);
+                    moves.append({stream.id, rule->targetChannel});
                 }
+            }
+        }
+    }
+
+    bool success = runCommands(muteCommands);
+    success = runCommands(applyCommands) && success;
+    success = runCommands(unmuteCommands) && success;
+
+    for (const auto &move : moves) {
+        m_streamAssignments[move.first] = move.second;
+    }
+
+    // Processed mixes that stay as they are take their new parameters
+    // directly, and only those that changed
+    for (const bool streamMix : {false, true}) {
+        if (streamMix ? streamRebuild || streamTeardown : personalRebuild) {
+            continue;
+        }
+        syncMixEngine(streamMix);
+        if (processingDirty || micDirty) {
+            syncMixProcessing(streamMix);
+        }
+        for (const auto &channelId : eqChanged) {
+            syncMixEq(streamMix, channelId);
+        }
+    }
+
+    // Loopbacks are created at their final level, so this is the only time they are built
+    if (streamTeardown) {
+        removeAllStreamLoopbacks();
+    }
+    if (personalRebuild) {
+        success = updateLoopbacks() && success;
+    }
+    if (streamRebuild) {
+        success = updateStreamLoopbacks() && success;
+    }
+
+    qCInfo(lcAudio) << "Applied snapshot in" << timer.elapsed() << "ms:"
+            << muteCommands.size() + applyCommands.size() + unmuteCommands.size() << "commands,"
+            << moves.size() << "streams moved,"
+            << "loopbacks rebuilt:" << (personalRebuild ? "personal" : "") << (streamRebuild ? "stream" : "");
+
+    updateCaptures();
+
+    // Settings with their own D-Bus interfaces still announce their changes
+    if (processingDirty) {
+        emit processingChanged();
+    }
+    for (const auto &channelId : eqChanged) {
+        emit equalizerChanged(channelId);
+    }
+    if (micDirty) {
+        emit micChanged();
+    }
+    if (personalLatencyDirty || streamLatencyDirty) {
+        updateLatencyPolling();
+    }
+    if (personalLatencyDirty) {
+        emit latencyChanged("personal");
+    }
+    if (streamLatencyDirty) {
+        emit latencyChanged("stream");
+    }
+    stateDirty = stateDirty || processingDirty || !eqChanged.isEmpty() || micDirty ||
+                 personalLatencyDirty || streamLatencyDirty;
+
+    if (stateDirty || !moves.isEmpty()) {
+        emit snapshotApplied();
+    }
+
+    return success;
+}
+
+bool AudioManager::applyProfile(const Profile &profile) {
+    const TraceSpan span("mix", "applyProfile");
+    // A profile only carries channel levels and rules; devices and master stay as they are
+    MixerSnapshot target = snapshot();
+    for (const auto &profileChannel : profile.channels) {
+        for (auto &channel : target.channels) {
+            if (channel.id == profileChannel.id) {
+                channel.volume = profileChannel.volume;
+                channel.muted = profileChannel.muted;
+                channel.personalVolume = profileChannel.personalVolume;
+                channel.streamVolume = profileChannel.streamVolume;
                 break;
             }
         }
     }
+    target.routingRules = profile.rules;
+
+    qCInfo(lcAudio) << "Switching to profile" << profile.name;
+    EventLog::record(EventLog::Code::ProfileSwitched, profile.name.toStdString());
+    return applySnapshot(target);
 }
 
 void AudioManager::applyRoutingRules(uint32_t streamId, const QString &appName, const QString &processName) {
-    for (const auto &rule : m_routingRules) {
-        QRegularExpression re(rule.matchPattern, QRegularExpression::CaseInsensitiveOption);
-
-        if (re.match(appName).hasMatch() || re.match(processName).hasMatch()) {
-            qInfo() << "Auto-routing stream" << streamId << "to" << rule.targetChannel
-                    << "(matched:" << rule.matchPattern << ")";
-            moveStreamToChannel(streamId, rule.targetChannel);
-            return;
-        }
+    if (const RoutingRule *rule = matchRoutingRule(appName, processName)) {
+        qCInfo(lcStreams) << "Auto-routing stream" << streamId << "to" << rule->targetChannel
+                << "(matched:" << rule->matchPattern << ")";
+        moveStreamToChannel(streamId, rule->targetChannel);
+        return;
     }
 
     // No routing rule matched - move to the silent unassigned sink
     // This ensures unrouted streams don't play through the default output
     QString cmd = QString("pactl move-sink-input %1 %2").arg(streamId).arg(m_unassignedSinkName);
     if (runCommand(cmd)) {
-        qInfo() << "Moved unassigned stream" << streamId << "to silent sink";
+        qCInfo(lcStreams) << "Moved unassigned stream" << streamId << "to silent sink";
     }
 }
 
@@ -1046,7 +2047,7 @@ bool AudioManager::createLoopback(const QString &sourceSink, const QString &targ
     QString output;
     if (runCommand(cmd, &output)) {
         uint32_t moduleId = output.trimmed().toUInt();
-        qInfo() << "Created loopback from" << sourceSink << "to" << targetSink << "module:" << moduleId;
+        qCInfo(lcMix) << "Created loopback from" << sourceSink << "to" << targetSink << "module:" << moduleId;
         return true;
     }
 
@@ -1059,6 +2060,7 @@ bool AudioManager::removeLoopback(uint32_t moduleId) {
 }
 
 void AudioManager::removeAllLoopbacks() {
+    stopMixEngine(false);
     for (auto it = m_loopbackModules.begin(); it != m_loopbackModules.end(); ++it) {
         removeLoopback(it.value());
     }
@@ -1067,81 +2069,113 @@ void AudioManager::removeAllLoopbacks() {
 }
 
 bool AudioManager::updateLoopbacks() {
+    const TraceSpan span("mix", "updateLoopbacks");
     if (m_outputDevice.isEmpty()) {
-        qWarning() << "No output device set, cannot create loopbacks";
+        qCWarning(lcMix) << "No output device set, cannot create loopbacks";
         return false;
     }
 
+    const QString previous = m_activeOutputDevice;
+    m_activeOutputDevice = resolveOutputDevice(false);
+
     // Mute output device before creating loopbacks to prevent startup noise
-    runCommand(QString("pactl set-sink-mute %1 1").arg(m_outputDevice));
+    runCommand(QString("pactl set-sink-mute %1 1").arg(m_activeOutputDevice));
 
     // Remove existing loopbacks
     removeAllLoopbacks();
 
     // Small delay after removing old loopbacks
-    QThread::msleep(50);
+    settle(50);
+
+    if (mixNeedsProcessing(false)) {
+        startMixEngine(false);
+    } else {
+        buildMixLoopbacks(m_activeOutputDevice, false);
+    }
+
+    // Small delay then unmute output device
+    settle(50);
+    runCommand(QString("pactl set-sink-mute %1 0").arg(m_activeOutputDevice));
+
+    if (m_activeOutputDevice != previous) {
+        emit activeOutputDeviceChanged("personal", m_activeOutputDevice);
+    }
+    updateCaptures();
+
+    return true;
+}
+
+void AudioManager::buildMixLoopbacks(const QString &targetSink, bool streamMix) {
+    auto &modules = streamMix ? m_streamLoopbackModules : m_loopbackModules;
+    auto &sinkInputs = streamMix ? m_streamLoopbackSinkInputs : m_loopbackSinkInputs;
+    const char *kind = streamMix ? "stream loopback" : "loopback";
+
+    // The whole mix runs at one latency, fixed until its loopbacks are next built
+    const int latencyMs = loopbackLatency(targetSink, streamMix);
+    latencyPathFor(streamMix).latencyMs = latencyMs;
 
     // Create loopbacks for ALL channels (volume 0% = silent, no screech from create/destroy)
     for (auto it = m_channels.begin(); it != m_channels.end(); ++it) {
         const auto &channel = it.value();
 
-        // Create loopback with adjust_time=0 to prevent automatic volume adjustments
-        QString cmd = QString("pactl load-module module-loopback source=%1.monitor sink=%2 "
-                              "latency_msec=150 source_dont_move=true sink_dont_move=true remix=false adjust_time=0")
-            .arg(channel.sinkName, m_outputDevice);
+        QString cmd = loopbackCommand(channel.sinkName, targetSink, latencyMs);
 
         QString output;
         if (runCommand(cmd, &output)) {
             uint32_t moduleId = output.trimmed().toUInt();
-            m_loopbackModules[channel.id] = moduleId;
-            qInfo() << "Created loopback for" << channel.id << "module:" << moduleId;
-
-            // Find and track the sink-input for this loopback
-            QThread::msleep(100);
-            uint32_t sinkInputId = findLoopbackSinkInput(moduleId);
-            if (sinkInputId > 0) {
-                m_loopbackSinkInputs[channel.id] = sinkInputId;
-                qInfo() << "Loopback" << channel.id << "sink-input:" << sinkInputId;
-
-                // Set volume to 0% and mute to prevent startup noise
-                runCommand(QString("pactl set-sink-input-volume %1 0%").arg(sinkInputId));
-                runCommand(QString("pactl set-sink-input-mute %1 1").arg(sinkInputId));
-            }
+            modules[channel.id] = moduleId;
+            qCInfo(lcMix) << "Created" << kind << "for" << channel.id << "module:" << moduleId;
+            EventLog::record(EventLog::Code::LoopbackCreated, channel.id.toStdString(), moduleId, streamMix ? 1 : 0);
         } else {
-            qWarning() << "Failed to create loopback for" << channel.id;
+            qCWarning(lcMix) << "Failed to create" << kind << "for" << channel.id;
+        }
+    }
+
+    // Let the new sink-inputs appear, then resolve all of them with one listing
+    settle(100);
+    const QHash<uint32_t, uint32_t> moduleSinkInputs = findLoopbackSinkInputs();
+
+    // Set volume to 0% and mute to prevent startup noise
+    QStringList silence;
+    for (auto it = modules.begin(); it != modules.end(); ++it) {
+        uint32_t sinkInputId = moduleSinkInputs.value(it.value());
+        if (sinkInputId > 0) {
+            sinkInputs[it.key()] = sinkInputId;
+            qCInfo(lcMix) << kind << it.key() << "sink-input:" << sinkInputId;
+            silence << QString("pactl set-sink-input-volume %1 0%").arg(sinkInputId)
+                    << QString("pactl set-sink-input-mute %1 1").arg(sinkInputId);
         }
     }
+    runCommands(silence);
 
     // Wait for all loopbacks to fully stabilize
-    QThread::msleep(250);
+    settle(250);
 
     // Set volumes while still muted
-    for (auto it = m_loopbackSinkInputs.begin(); it != m_loopbackSinkInputs.end(); ++it) {
-        const QString &chId = it.key();
-        uint32_t sinkInputId = it.value();
-        if (m_channels.contains(chId)) {
-            int effectiveVolume = (m_channels[chId].personalVolume * m_masterVolume) / 100;
-            runCommand(QString("pactl set-sink-input-volume %1 %2%").arg(sinkInputId).arg(effectiveVolume));
+    QStringList levels;
+    for (auto it = sinkInputs.begin(); it != sinkInputs.end(); ++it) {
+        if (m_channels.contains(it.key())) {
+            const auto &channel = m_channels[it.key()];
+            int mixVolume = streamMix ? channel.streamVolume : channel.personalVolume;
+            int effectiveVolume = (mixVolume * m_masterVolume) / 100;
+            levels << QString("pactl set-sink-input-volume %1 %2%").arg(it.value()).arg(effectiveVolume);
         }
     }
+    runCommands(levels);
 
     // Small delay before unmuting loopbacks
-    QThread::msleep(100);
+    settle(100);
 
     // Unmute all loopback sink-inputs
-    for (auto it = m_loopbackSinkInputs.begin(); it != m_loopbackSinkInputs.end(); ++it) {
-        runCommand(QString("pactl set-sink-input-mute %1 0").arg(it.value()));
+    QStringList unmute;
+    for (auto it = sinkInputs.begin(); it != sinkInputs.end(); ++it) {
+        unmute << QString("pactl set-sink-input-mute %1 0").arg(it.value());
     }
-
-    // Small delay then unmute output device
-    QThread::msleep(50);
-    runCommand(QString("pactl set-sink-mute %1 0").arg(m_outputDevice));
-
-    return true;
+    runCommands(unmute);
 }
 
 bool AudioManager::addChannelLoopback(const QString &channelId) {
-    if (!m_channels.contains(channelId) || m_outputDevice.isEmpty()) {
+    if (!m_channels.contains(channelId) || m_activeOutputDevice.isEmpty()) {
         return false;
     }
 
@@ -1150,19 +2184,22 @@ bool AudioManager::addChannelLoopback(const QString &channelId) {
 
     const auto &channel = m_channels[channelId];
 
-    // Create loopback with adjust_time=0 to prevent automatic volume adjustments
-    QString cmd = QString("pactl load-module module-loopback source=%1.monitor sink=%2 "
-                          "latency_msec=150 source_dont_move=true sink_dont_move=true remix=false adjust_time=0")
-        .arg(channel.sinkName, m_outputDevice);
+    // A missing loopback joins the others at the latency they were built with
+    LatencyPath &path = latencyPathFor(false);
+    if (!hasLoopbacks(false)) {
+        path.latencyMs = loopbackLatency(m_activeOutputDevice, false);
+    }
+    QString cmd = loopbackCommand(channel.sinkName, m_activeOutputDevice, path.latencyMs);
 
     QString output;
     if (runCommand(cmd, &output)) {
         uint32_t moduleId = output.trimmed().toUInt();
         m_loopbackModules[channelId] = moduleId;
-        qInfo() << "Created loopback for" << channelId << "module:" << moduleId;
+        qCInfo(lcMix) << "Created loopback for" << channelId << "module:" << moduleId;
+        EventLog::record(EventLog::Code::LoopbackCreated, channelId.toStdString(), moduleId, 0);
 
         // Find and track the sink-input
-        QThread::msleep(100);
+        settle(100);
         uint32_t sinkInputId = findLoopbackSinkInput(moduleId);
         if (sinkInputId > 0) {
             m_loopbackSinkInputs[channelId] = sinkInputId;
@@ -1172,20 +2209,20 @@ bool AudioManager::addChannelLoopback(const QString &channelId) {
             runCommand(QString("pactl set-sink-input-mute %1 1").arg(sinkInputId));
 
             // Wait for loopback to fully stabilize
-            QThread::msleep(150);
+            settle(150);
 
             // Now set the target volume while still muted
             int effectiveVolume = (channel.personalVolume * m_masterVolume) / 100;
             runCommand(QString("pactl set-sink-input-volume %1 %2%").arg(sinkInputId).arg(effectiveVolume));
 
             // Small delay then unmute
-            QThread::msleep(50);
+            settle(50);
             runCommand(QString("pactl set-sink-input-mute %1 0").arg(sinkInputId));
         }
         return true;
     }
 
-    qWarning() << "Failed to create loopback for" << channelId;
+    qCWarning(lcMix) << "Failed to create loopback for" << channelId;
     return false;
 }
 
@@ -1195,7 +2232,8 @@ bool AudioManager::removeChannelLoopback(const QString &channelId) {
         if (removeLoopback(moduleId)) {
             m_loopbackModules.remove(channelId);
             m_loopbackSinkInputs.remove(channelId);
-            qInfo() << "Removed loopback for" << channelId;
+            qCInfo(lcMix) << "Removed loopback for" << channelId;
+            EventLog::record(EventLog::Code::LoopbackRemoved, channelId.toStdString(), 0);
             return true;
         }
     }
@@ -1204,7 +2242,8 @@ bool AudioManager::removeChannelLoopback(const QString &channelId) {
 
 bool AudioManager::setStreamOutputDevice(const QString &deviceId) {
     m_streamOutputDevice = deviceId;
-    qInfo() << "Stream output device set to:" << deviceId;
+    qCInfo(lcDevices) << "Stream output device set to:" << deviceId;
+    EventLog::record(EventLog::Code::OutputChanged, deviceId.toStdString(), 1);
     // Update stream loopbacks to route to the new device
     if (m_initialized && m_streamEnabled) {
         updateStreamLoopbacks();
@@ -1218,102 +2257,66 @@ bool AudioManager::setStreamEnabled(bool enabled) {
     }
 
     m_streamEnabled = enabled;
-    qInfo() << "Stream enabled:" << enabled;
+    qCInfo(lcMix) << "Stream enabled:" << enabled;
 
     if (enabled) {
         // Create stream loopbacks if we have a stream output device
-        if (!m_streamOutputDevice.isEmpty()) {
+        if (m_initialized && !m_streamOutputDevice.isEmpty()) {
             updateStreamLoopbacks();
         }
     } else {
         // Remove all stream loopbacks
         removeAllStreamLoopbacks();
     }
+    updateCaptures();
 
     return true;
 }
 
 bool AudioManager::updateStreamLoopbacks() {
+    const TraceSpan span("mix", "updateStreamLoopbacks");
     if (m_streamOutputDevice.isEmpty()) {
-        qWarning() << "No stream output device set, cannot create stream loopbacks";
+        qCWarning(lcMix) << "No stream output device set, cannot create stream loopbacks";
         return false;
     }
 
     if (!m_streamEnabled) {
-        qInfo() << "Stream not enabled, skipping stream loopback update";
+        qCInfo(lcMix) << "Stream not enabled, skipping stream loopback update";
         return true;
     }
 
+    const QString previous = m_activeStreamOutputDevice;
+    m_activeStreamOutputDevice = resolveOutputDevice(true);
+
     // Mute stream output device before creating loopbacks to prevent startup noise
-    runCommand(QString("pactl set-sink-mute %1 1").arg(m_streamOutputDevice));
+    runCommand(QString("pactl set-sink-mute %1 1").arg(m_activeStreamOutputDevice));
 
     // Remove existing stream loopbacks
     removeAllStreamLoopbacks();
 
     // Small delay after removing old loopbacks
-    QThread::msleep(50);
-
-    // Create loopbacks for ALL channels (volume 0% = silent, no screech from create/destroy)
-    for (auto it = m_channels.begin(); it != m_channels.end(); ++it) {
-        const auto &channel = it.value();
-
-        // Create loopback with adjust_time=0 to prevent automatic volume adjustments
-        QString cmd = QString("pactl load-module module-loopback source=%1.monitor sink=%2 "
-                              "latency_msec=150 source_dont_move=true sink_dont_move=true remix=false adjust_time=0")
-            .arg(channel.sinkName, m_streamOutputDevice);
+    settle(50);
 
-        QString output;
-        if (runCommand(cmd, &output)) {
-            uint32_t moduleId = output.trimmed().toUInt();
-            m_streamLoopbackModules[channel.id] = moduleId;
-            qInfo() << "Created stream loopback for" << channel.id << "module:" << moduleId;
-
-            // Find and track the sink-input for this loopback
-            QThread::msleep(100);
-            uint32_t sinkInputId = findLoopbackSinkInput(moduleId);
-            if (sinkInputId > 0) {
-                m_streamLoopbackSinkInputs[channel.id] = sinkInputId;
-                qInfo() << "Stream loopback" << channel.id << "sink-input:" << sinkInputId;
-
-                // Set volume to 0% and mute to prevent startup noise
-                runCommand(QString("pactl set-sink-input-volume %1 0%").arg(sinkInputId));
-                runCommand(QString("pactl set-sink-input-mute %1 1").arg(sinkInputId));
-            }
-        } else {
-            qWarning() << "Failed to create stream loopback for" << channel.id;
-        }
+    if (mixNeedsProcessing(true)) {
+        startMixEngine(true);
+    } else {
+        buildMixLoopbacks(m_activeStreamOutputDevice, true);
     }
 
-    // Wait for all loopbacks to fully stabilize
-    QThread::msleep(250);
+    // Small delay then unmute stream output device
+    settle(50);
+    runCommand(QString("pactl set-sink-mute %1 0").arg(m_activeStreamOutputDevice));
 
-    // Set volumes while still muted
-    for (auto it = m_streamLoopbackSinkInputs.begin(); it != m_streamLoopbackSinkInputs.end(); ++it) {
-        const QString &chId = it.key();
-        uint32_t sinkInputId = it.value();
-        if (m_channels.contains(chId)) {
-            int effectiveVolume = (m_channels[chId].streamVolume * m_masterVolume) / 100;
-            runCommand(QString("pactl set-sink-input-volume %1 %2%").arg(sinkInputId).arg(effectiveVolume));
-        }
+    if (m_activeStreamOutputDevice != previous) {
+        emit activeOutputDeviceChanged("stream", m_activeStreamOutputDevice);
     }
-
-    // Small delay before unmuting loopbacks
-    QThread::msleep(100);
-
-    // Unmute all loopback sink-inputs
-    for (auto it = m_streamLoopbackSinkInputs.begin(); it != m_streamLoopbackSinkInputs.end(); ++it) {
-        runCommand(QString("pactl set-sink-input-mute %1 0").arg(it.value()));
-    }
-
-    // Small delay then unmute stream output device
-    QThread::msleep(50);
-    runCommand(QString("pactl set-sink-mute %1 0").arg(m_streamOutputDevice));
+    updateCaptures();
 
     return true;
 }
 
 bool AudioManager::addStreamChannelLoopback(const QString &channelId) {
-    if (!m_channels.contains(channelId) || m_streamOutputDevice.isEmpty() || !m_streamEnabled) {
+    if (!m_channels.contains(channelId) || m_activeStreamOutputDevice.isEmpty() || !m_streamEnabled) {
         return false;
     }
 
@@ -1322,19 +2325,21 @@ bool AudioManager::addStreamChannelLoopback(const QString &channelId) {
 
     const auto &channel = m_channels[channelId];
 
-    // Create loopback with adjust_time=0 to prevent automatic volume adjustments
-    QString cmd = QString("pactl load-module module-loopback source=%1.monitor sink=%2 "
-                          "latency_msec=150 source_dont_move=true sink_dont_move=true remix=false adjust_time=0")
-        .arg(channel.sinkName, m_streamOutputDevice);
+    LatencyPath &path = latencyPathFor(true);
+    if (!hasLoopbacks(true)) {
+        path.latencyMs = loopbackLatency(m_activeStreamOutputDevice, true);
+    }
+    QString cmd = loopbackCommand(channel.sinkName, m_activeStreamOutputDevice, path.latencyMs);
 
     QString output;
     if (runCommand(cmd, &output)) {
         uint32_t moduleId = output.trimmed().toUInt();
         m_streamLoopbackModules[channelId] = moduleId;
-        qInfo() << "Created stream loopback for" << channelId << "module:" << moduleId;
+        qCInfo(lcMix) << "Created stream loopback for" << channelId << "module:" << moduleId;
+        EventLog::record(EventLog::Code::LoopbackCreated, channelId.toStdString(), moduleId, 1);
 
         // Find and track the sink-input
-        QThread::msleep(100);
+        settle(100);
         uint32_t sinkInputId = findLoopbackSinkInput(moduleId);
         if (sinkInputId > 0) {
             m_streamLoopbackSinkInputs[channelId] = sinkInputId;
@@ -1344,20 +2349,20 @@ bool AudioManager::addStreamChannelLoopback(const QString &channelId) {
             runCommand(QString("pactl set-sink-input-mute %1 1").arg(sinkInputId));
 
             // Wait for loopback to fully stabilize
-            QThread::msleep(150);
+            settle(150);
 
             // Now set the target volume while still muted
             int effectiveVolume = (channel.streamVolume * m_masterVolume) / 100;
             runCommand(QString("pactl set-sink-input-volume %1 %2%").arg(sinkInputId).arg(effectiveVolume));
 
             // Small delay then unmute
-            QThread::msleep(50);
+            settle(50);
             runCommand(QString("pactl set-sink-input-mute %1 0").arg(sinkInputId));
         }
         return true;
     }
 
-    qWarning() << "Failed to create stream loopback for" << channelId;
+    qCWarning(lcMix) << "Failed to create stream loopback for" << channelId;
     return false;
 }
 
@@ -1367,7 +2372,8 @@ bool AudioManager::removeStreamChannelLoopback(const QString &channelId) {
         if (removeLoopback(moduleId)) {
             m_streamLoopbackModules.remove(channelId);
             m_streamLoopbackSinkInputs.remove(channelId);
-            qInfo() << "Removed stream loopback for" << channelId;
+            qCInfo(lcMix) << "Removed stream loopback for" << channelId;
+            EventLog::record(EventLog::Code::LoopbackRemoved, channelId.toStdString(), 1);
             return true;
         }
     }
@@ -1375,6 +2381,7 @@ bool AudioManager::removeStreamChannelLoopback(const QString &channelId) {
 }
 
 void AudioManager::removeAllStreamLoopbacks() {
+    stopMixEngine(true);
     for (auto it = m_streamLoopbackModules.begin(); it != m_streamLoopbackModules.end(); ++it) {
         removeLoopback(it.value());
     }
@@ -1382,4 +2389,1373 @@ void AudioManager::removeAllStreamLoopbacks() {
     m_streamLoopbackSinkInputs.clear();
 }
 
+bool AudioManager::setDucking(const QString &mixId, const DuckingConfig &config) {
+    if ((mixId != "personal" && mixId != "stream") || !validDucking(config)) {
+        return false;
+    }
+
+    const bool streamMix = mixId == "stream";
+    processingFor(streamMix).ducking = config;
+    qCInfoLimited(lcMix) << "Ducking for" << mixId << "mix:" << (config.settings.enabled ? "on" : "off")
+            << "trigger" << config.triggerChannel << "targets" << config.targetChannels
+            << "depth" << config.settings.depthDb << "dB";
+
+    updateMixProcessing(streamMix);
+    emit processingChanged();
+    return true;
+}
+
+bool AudioManager::validDucking(const DuckingConfig &config) const {
+    if (!m_channels.contains(config.triggerChannel)) {
+        qCWarning(lcMix) << "Unknown ducking trigger channel:" << config.triggerChannel;
+        return false;
+    }
+    for (const auto &target : config.targetChannels) {
+        if (!m_channels.contains(target) || target == config.triggerChannel) {
+            qCWarning(lcMix) << "Invalid ducking target channel:" << target;
+            return false;
+        }
+    }
+    return true;
+}
+
+DuckingConfig AudioManager::getDucking(const QString &mixId) const {
+    return processingFor(mixId == "stream").ducking;
+}
+
+double AudioManager::getDuckingGainReduction(const QString &mixId) const {
+    const MixEngine *engine = mixId == "stream" ? m_streamEngine : m_personalEngine;
+    return engine ? engine->graph().ducker().gainReductionDb() : 0.0;
+}
+
+bool AudioManager::isMixProcessed(const QString &mixId) const {
+    return (mixId == "stream" ? m_streamEngine : m_personalEngine) != nullptr;
+}
+
+bool AudioManager::hasLoopbacks(bool streamMix) const {
+    return !(streamMix ? m_streamLoopbackModules : m_loopbackModules).isEmpty();
+}
+
+int AudioManager::loopbackLatency(const QString &device, bool streamMix) const {
+    if (!latencyPathFor(streamMix).adaptive) {
+        return DEFAULT_LOOPBACK_LATENCY_MS;
+    }
+    return m_deviceLatencies.value(device, DEFAULT_LOOPBACK_LATENCY_MS);
+}
+
+MixLatencyHealth AudioManager::getLatencyHealth(const QString &mixId) const {
+    const bool streamMix = mixId == "stream";
+    const LatencyPath &path = latencyPathFor(streamMix);
+
+    MixLatencyHealth health;
+    health.device = streamMix ? m_activeStreamOutputDevice : m_activeOutputDevice;
+    health.underruns = path.underruns;
+    health.overruns = path.overruns;
+    health.adaptive = path.adaptive;
+    if (const MixEngine *engine = streamMix ? m_streamEngine : m_personalEngine) {
+        health.mode = "engine";
+        health.latencyMs = engine->playbackLatencyMs();
+        health.bufferMs = path.bufferMs;
+    } else if (hasLoopbacks(streamMix)) {
+        health.mode = "loopback";
+        health.latencyMs = path.latencyMs;
+        health.bufferMs = path.bufferMs;
+    } else {
+        health.mode = "off";
+    }
+    return health;
+}
+
+bool AudioManager::setAdaptiveLatency(const QString &mixId, bool enabled) {
+    if (mixId != "personal" && mixId != "stream") {
+        return false;
+    }
+    const bool streamMix = mixId == "stream";
+    LatencyPath &path = latencyPathFor(streamMix);
+    if (path.adaptive == enabled) {
+        return true;
+    }
+
+    const QString &device = streamMix ? m_activeStreamOutputDevice : m_activeOutputDevice;
+    path.adaptive = enabled;
+    qCInfo(lcLatency) << "Adaptive latency for" << mixId << "mix:" << (enabled ? "on" : "off");
+    updateLatencyPolling();
+
+    // Loopbacks only take their latency when they are created
+    if (m_initialized && !engineFor(streamMix) && hasLoopbacks(streamMix)
+        && loopbackLatency(device, streamMix) != path.latencyMs) {
+        if (streamMix) {
+            updateStreamLoopbacks();
+        } else {
+            updateLoopbacks();
+        }
+    }
+    emit latencyChanged(mixId);
+    return true;
+}
+
+bool AudioManager::isAdaptiveLatency(const QString &mixId) const {
+    return latencyPathFor(mixId == "stream").adaptive;
+}
+
+void AudioManager::setDeviceLatencies(const QHash<QString, int> &latencies) {
+    const LatencyControllerSettings limits;
+    m_deviceLatencies.clear();
+    for (auto it = latencies.constBegin(); it != latencies.constEnd(); ++it) {
+        if (!it.key().isEmpty()) {
+            m_deviceLatencies[it.key()] = qBound(limits.minMs, it.value(), limits.maxMs);
+        }
+    }
+    m_latencyControllers.clear();
+}
+
+void AudioManager::watchLatencyHealth() {
+    const bool polling = m_latencyTimer && m_latencyTimer->isActive();
+    m_latencyWatchUntil = QDateTime::currentMSecsSinceEpoch() + LATENCY_WATCH_MS;
+    updateLatencyPolling();
+    if (!polling && m_initialized) {
+        pollLatency();  // The first answer already has fresh readings
+    }
+}
+
+void AudioManager::updateLatencyPolling() {
+    const bool wanted = m_initialized &&
+        (m_personalLatency.adaptive || m_streamLatency.adaptive ||
+         QDateTime::currentMSecsSinceEpoch() < m_latencyWatchUntil);
+    if (!wanted) {
+        if (m_latencyTimer) {
+            m_latencyTimer->stop();
+        }
+        return;
+    }
+    if (!m_latencyTimer) {
+        m_latencyTimer = new QTimer(this);
+        m_latencyTimer->setInterval(LATENCY_POLL_MS);
+        connect(m_latencyTimer, &QTimer::timeout, this, &AudioManager::pollLatency);
+    }
+    if (!m_latencyTimer->isActive()) {
+        m_latencyTimer->start();
+    }
+}
+
+void AudioManager::pollLatency() {
+    updateLatencyPolling();  // Stops once nobody is watching any more
+    if (m_latencyPollProcess) {
+        return;  // The last listing is still running
+    }
+
+    // One listing covers the loopbacks of both mixes. It runs in the
+    // background: a slow server must not hold up D-Bus calls.
+    if ((m_personalEngine || m_loopbackSinkInputs.isEmpty())
+        && (m_streamEngine || m_streamLoopbackSinkInputs.isEmpty())) {
+        finishLatencyPoll(QByteArray());
+        return;
+    }
+
+    const QString command = "pactl list sink-inputs";
+    m_latencyPollProcess = new QProcess(this);
+    QProcess *process = m_latencyPollProcess;
+    auto started = std::make_shared<QElapsedTimer>();
+    started->start();
+    connect(process, &QProcess::finished, this,
+            [this, process, command, started](int exitCode, QProcess::ExitStatus status) {
+        m_latencyPollProcess = nullptr;
+        process->deleteLater();
+        backendHistogram(command).record(static_cast<uint64_t>(started->nsecsElapsed() / 1000));
+        if (status != QProcess::NormalExit) {
+            reportUnfinished(*process, command);  // Killed after the timeout
+            return;
+        }
+        if (exitCode != 0) {
+            qCWarningLimited(lcCommands) << "Command failed:" << command
+                                         << "stderr:" << process->readAllStandardError().trimmed();
+            Stats::counter("backend.failures").add();
+            return;
+        }
+        finishLatencyPoll(process->readAllStandardOutput());
+    });
+    connect(process, &QProcess::errorOccurred, this, [this, process, command](QProcess::ProcessError error) {
+        if (error != QProcess::FailedToStart) {
+            return;  // finished() follows
+        }
+        reportUnfinished(*process, command);
+        m_latencyPollProcess = nullptr;
+        process->deleteLater();
+    });
+    QTimer::singleShot(5000, process, [process]() { process->kill(); });
+    process->start("pactl", {"list", "sink-inputs"});
+}
+
+void AudioManager::finishLatencyPoll(const QByteArray &sinkInputs) {
+    const ScopedTimer timer(Stats::histogram("latency.poll"));
+    const TraceSpan span("mix", "pollLatency");
+    const PactlListing listing(bytesView(sinkInputs));
+
+    QHash<QString, quint64> deviceXruns;  // Adaptive loopback paths only
+    for (const bool streamMix : {false, true}) {
+        LatencyPath &path = latencyPathFor(streamMix);
+        const QString mixId = streamMix ? "stream" : "personal";
+        const QString &device = streamMix ? m_activeStreamOutputDevice : m_activeOutputDevice;
+        const quint64 before = path.underruns + path.overruns;
+
+        if (MixEngine *engine = engineFor(streamMix)) {
+            const quint64 underruns = engine->underruns();
+            const quint64 overruns = engine->overruns();
+            path.underruns += underruns - path.engineUnderruns;
+            path.overruns += overruns - path.engineOverruns;
+            path.engineUnderruns = underruns;
+            path.engineOverruns = overruns;
+            path.bufferMs = engine->takeMinHeadroomMs();
+            path.fill.clear();
+        } else if (hasLoopbacks(streamMix)) {
+            pollLoopbackFill(path, streamMix ? m_streamLoopbackSinkInputs : m_loopbackSinkInputs,
+                             path.latencyMs, listing);
+        } else {
+            path.bufferMs = -1.0;
+            path.fill.clear();
+            continue;
+        }
+
+        const quint64 xruns = path.underruns + path.overruns - before;
+        if (xruns > 0) {
+            Stats::counter("mix." + mixId.toStdString() + ".xruns").add(xruns);
+            qCWarningLimited(lcLatency) << xruns << "xrun(s) on the" << mixId << "mix path to" << device;
+            EventLog::record(EventLog::Code::Xrun, device.toStdString(), static_cast<int64_t>(xruns), streamMix ? 1 : 0);
+        }
+        if (path.adaptive && !engineFor(streamMix) && !device.isEmpty()) {
+            deviceXruns[device] += xruns;
+        }
+    }
+
+    adaptLatency(deviceXruns);
+}
+
+void AudioManager::pollLoopbackFill(LatencyPath &path, const QHash<QString, uint32_t> &sinkInputs,
+                                    int latencyMs, const PactlListing &listing) {
+    // pactl has no xrun counters, so xruns are inferred from the loopback
+    // queues: one draining to almost nothing has underrun, one grown to twice
+    // its target has overrun. Only the transition out of a healthy fill
+    // counts, so a server that never reports a fill (reads 0) adds nothing.
+    QHash<uint32_t, BufferFill> fill;
+    path.bufferMs = -1.0;
+    for (const uint32_t sinkInputId : sinkInputs) {
+        const auto object = listing.find(sinkInputId);
+        const auto bufferMs = object ? usecFieldMs(listing.field(*object, "Buffer Latency")) : std::nullopt;
+        if (!bufferMs) {
+            continue;
+        }
+        if (path.bufferMs < 0.0 || *bufferMs < path.bufferMs) {
+            path.bufferMs = *bufferMs;
+        }
+
+        BufferFill state = BufferFill::Healthy;
+        if (*bufferMs < latencyMs * 0.1) {
+            state = BufferFill::Low;
+        } else if (*bufferMs > latencyMs * 2.0) {
+            state = BufferFill::High;
+        }
+        if (path.fill.value(sinkInputId, BufferFill::Unknown) == BufferFill::Healthy) {
+            if (state == BufferFill::Low) {
+                ++path.underruns;
+            } else if (state == BufferFill::High) {
+                ++path.overruns;
+            }
+        }
+        fill[sinkInputId] = state;
+    }
+    path.fill = fill;
+}
+
+void AudioManager::adaptLatency(const QHash<QString, quint64> &deviceXruns) {
+    for (auto it = deviceXruns.constBegin(); it != deviceXruns.constEnd(); ++it) {
+        const QString &device = it.key();
+        const int learnedMs = m_deviceLatencies.value(device, DEFAULT_LOOPBACK_LATENCY_MS);
+
+        // The windows only judge the latency the loopbacks run at: while a
+        // step waits for their next rebuild, the controller is left alone
+        bool pending = false;
+        for (const bool streamMix : {false, true}) {
+            const QString &active = streamMix ? m_activeStreamOutputDevice : m_activeOutputDevice;
+            const LatencyPath &path = latencyPathFor(streamMix);
+            pending = pending || (active == device && path.adaptive && !engineFor(streamMix) &&
+                                  hasLoopbacks(streamMix) && path.latencyMs != learnedMs);
+        }
+        if (pending) {
+            continue;
+        }
+
+        auto controller = m_latencyControllers.find(device);
+        if (controller == m_latencyControllers.end()) {
+            // Starts from what this device learned before, and judges the next window
+            controller = m_latencyControllers.insert(device, LatencyController(learnedMs));
+            continue;
+        }
+        if (!controller->update(it.value())) {
+            continue;
+        }
+
+        const int latencyMs = controller->latencyMs();
+        qCInfo(lcLatency) << "Adaptive latency:" << device << (it.value() > 0 ? "raised" : "lowered")
+                          << "to" << latencyMs << "ms from the next loopback rebuild";
+        EventLog::record(EventLog::Code::LatencyChanged, device.toStdString(), latencyMs);
+        m_deviceLatencies[device] = latencyMs;
+        // Rebuilding on the spot would mute the device and hold up the main
+        // thread for every step; the loopbacks pick the value up the next time
+        // they are built anyway (device switch, mode switch, reload)
+        for (const bool streamMix : {false, true}) {
+            const QString &active = streamMix ? m_activeStreamOutputDevice : m_activeOutputDevice;
+            if (active == device && latencyPathFor(streamMix).adaptive && !engineFor(streamMix)) {
+                emit latencyChanged(streamMix ? "stream" : "personal");
+            }
+        }
+    }
+}
+
+void AudioManager::refreshNodeLoad() {
+    if (!m_initialized || m_nodeLoadProcess || m_nodeListProcess) {
+        return;
+    }
+    if (m_nodeLoad.timestamp > 0
+        && QDateTime::currentMSecsSinceEpoch() - m_nodeLoad.timestamp < NODE_LOAD_MAX_AGE_MS) {
+        return;
+    }
+
+    // The profile and the listing that says which nodes are ours run side
+    // by side; the sample is put together once both are in
+    struct Run {
+        QByteArray profile;
+        QByteArray listing;
+        QString error;
+        int pending = 2;
+    };
+    auto run = std::make_shared<Run>();
+    auto finished = [this, run](const QString &error) {
+        if (run->error.isEmpty()) {
+            run->error = error;
+        }
+        if (--run->pending == 0) {
+            finishNodeLoad(run->profile, run->listing, run->error);
+        }
+    };
+
+    // The first batch only covers the cycles since pw-top enabled the
+    // profiler, so take the second (about a second later)
+    startBackground(this, m_nodeLoadProcess, "pw-top", "pw-top", {"--batch-mode", "--iterations", "2"},
+                    "pw-top not found: no PipeWire profiler",
+                    [run, finished](const QByteArray &output, const QString &error) {
+        run->profile = output;
+        finished(error);
+    });
+    // pipewire-pulse lists each object's graph node as object.id
+    startBackground(this, m_nodeListProcess, "pactl list", "sh",
+                    {"-c", "pactl list sinks && pactl list sources && "
+                           "pactl list sink-inputs && pactl list source-outputs"},
+                    "sh not found",
+                    [run, finished](const QByteArray &output, const QString &error) {
+        run->listing = output;
+        finished(error);
+    });
+}
+
+void AudioManager::finishNodeLoad(const QByteArray &profile, const QByteArray &listing, const QString &error) {
+    const ScopedTimer timer(Stats::histogram("nodeload.sample"));
+    const TraceSpan span("mix", "sampleNodeLoad");
+
+    NodeLoadSample sample;
+    sample.timestamp = QDateTime::currentMSecsSinceEpoch();
+    sample.engines = sampleEngineLoad();
+    sample.reason = error;
+
+    bool pipeWire = false;
+    const QHash<uint32_t, OwnedNode> owned = error.isEmpty() ? ownedNodes(listing, &pipeWire)
+                                                             : QHash<uint32_t, OwnedNode>();
+    const PwTopSnapshot snapshot(pipeWire ? bytesView(profile) : std::string_view());
+    if (error.isEmpty() && !pipeWire) {
+        sample.reason = "The audio server is not PipeWire: no per-node data";
+    } else if (error.isEmpty() && snapshot.nodes().empty()) {
+        sample.reason = "pw-top listed no nodes";
+    }
+    sample.available = sample.reason.isEmpty();
+
+    // Followers are listed right after the driver they run under
+    const PwTopSnapshot::Node *driver = nullptr;
+    for (const auto &node : snapshot.nodes()) {
+        if (!node.follower) {
+            driver = &node;
+        }
+        sample.graphBusyUs += node.busyUs.value_or(0.0);
+        sample.graphLoad += node.busyQuantum.value_or(0.0);
+
+        const auto it = owned.constFind(node.id);
+        if (it == owned.constEnd()) {
+            continue;
+        }
+        NodeLoad load;
+        load.nodeId = node.id;
+        load.name = QString::fromStdString(node.name);
+        load.role = it->role;
+        load.kind = it->kind;
+        load.active = node.state == 'R';
+        load.quantum = driver ? driver->quantum : 0;
+        load.rate = driver ? driver->rate : 0;
+        load.busyUs = node.busyUs.value_or(-1.0);
+        load.busyQuantum = node.busyQuantum.value_or(-1.0);
+        load.errors = node.errors;
+        sample.ownBusyUs += node.busyUs.value_or(0.0);
+        sample.ownLoad += node.busyQuantum.value_or(0.0);
+        sample.errors += node.errors;
+        sample.nodes.append(load);
+    }
+    std::sort(sample.nodes.begin(), sample.nodes.end(), [](const NodeLoad &a, const NodeLoad &b) {
+        return a.busyUs > b.busyUs;
+    });
+
+    if (sample.available != m_nodeLoad.available || sample.reason != m_nodeLoad.reason) {
+        if (sample.available) {
+            qCInfo(lcAudio) << "Node load: profiling" << sample.nodes.size() << "WaveMux nodes";
+        } else {
+            qCInfo(lcAudio) << "Node load unavailable:" << sample.reason;
+        }
+    }
+    m_nodeLoad = sample;
+    emit nodeLoadUpdated(m_nodeLoad);
+}
+
+QHash<uint32_t, AudioManager::OwnedNode> AudioManager::ownedNodes(const QByteArray &objects, bool *pipeWire) const {
+    QHash<uint32_t, QString> modules;  // moduleId -> role
+    for (const auto &channel : m_channels) {
+        if (channel.moduleId > 0) {
+            modules[channel.moduleId] = "channel:" + channel.id;
+        }
+    }
+    for (const bool streamMix : {false, true}) {
+        const QString mixId = streamMix ? "stream" : "personal";
+        const uint32_t mixModule = streamMix ? m_streamMixModule : m_personalMixModule;
+        if (mixModule > 0) {
+            modules[mixModule] = "mix:" + mixId;
+        }
+        const auto &loopbacks = streamMix ? m_streamLoopbackModules : m_loopbackModules;
+        for (auto it = loopbacks.constBegin(); it != loopbacks.constEnd(); ++it) {
+            modules[it.value()] = "loopback:" + mixId + ":" + it.key();
+        }
+    }
+    if (m_unassignedSinkModule > 0) {
+        modules[m_unassignedSinkModule] = "unassigned";
+    }
+    if (m_micSuppressionModule > 0) {
+        modules[m_micSuppressionModule] = "mic-filter";
+    }
+
+    const PactlListing listing(bytesView(objects));
+
+    *pipeWire = false;
+    QHash<uint32_t, OwnedNode> nodes;
+    for (size_t i = 0; i < listing.size(); ++i) {
+        const auto nodeId = PactlListing::toIndex(listing.property(i, "object.id"));
+        if (!nodeId) {
+            continue;
+        }
+        *pipeWire = true;
+
+        auto moduleId = PactlListing::toIndex(listing.field(i, "Owner Module"));
+        if (!moduleId) {
+            moduleId = PactlListing::toIndex(listing.property(i, "module.id"));
+        }
+        QString role = moduleId ? modules.value(*moduleId) : QString();
+        if (role.isEmpty()) {
+            // The daemon's own streams: mix engine, probes, spectrum, replay, recorder
+            const QString appName = propertyText(listing.property(i, "application.name"));
+            if (appName.startsWith("wavemux")) {
+                role = appName;
+            }
+        }
+        // A sink's monitor source is the sink's own node
+        if (!role.isEmpty() && !nodes.contains(*nodeId)) {
+            nodes.insert(*nodeId, OwnedNode{role, nodeKind(listing[i].type)});
+        }
+    }
+    return nodes;
+}
+
+QList<EngineLoad> AudioManager::sampleEngineLoad() {
+    // The engines' DSP runs on their own threads, which the server's
+    // profiler doesn't see; they time it themselves
+    QList<EngineLoad> loads;
+    for (const bool streamMix : {false, true}) {
+        const QString mixId = streamMix ? "stream" : "personal";
+        const MixEngine *engine = engineFor(streamMix);
+        if (!engine) {
+            m_engineLoadMarks.remove(mixId);
+            continue;
+        }
+        EngineLoadMark last = m_engineLoadMarks.value(mixId);
+        if (last.engine != engine) {
+            last = EngineLoadMark{engine};
+        }
+        const EngineLoadMark now{engine, engine->processedBlocks(), engine->processNs()};
+        m_engineLoadMarks[mixId] = now;
+
+        EngineLoad load;
+        load.mixId = mixId;
+        load.blocks = now.blocks - last.blocks;
+        if (load.blocks > 0) {
+            load.busyUs = (now.processNs - last.processNs) / 1000.0 / load.blocks;
+            load.load = load.busyUs / (engine->blockFrames() * 1000000.0 / MixEngine::SAMPLE_RATE);
+        }
+        loads.append(load);
+    }
+    return loads;
+}
+
+bool AudioManager::startRecording(const QString &directory) {
+    if (!m_initialized) {
+        qCWarning(lcCapture) << "Cannot record before initialization";
+        return false;
+    }
+    if (m_recorder) {
+        return false;
+    }
+
+    QList<Recorder::Track> tracks;
+    for (const auto &id : CHANNEL_IDS) {
+        tracks.append({id, m_channels.value(id).sinkName + ".monitor"});
+    }
+    if (!m_micConfig.source.isEmpty()) {
+        tracks.append({MIC_CHANNEL_ID, micCaptureSource()});
+    }
+    if (m_streamEnabled && !m_activeStreamOutputDevice.isEmpty()) {
+        // What the Stream mix plays is only available as its device's monitor
+        tracks.append({"stream-mix", m_activeStreamOutputDevice + ".monitor"});
+    }
+
+    const QString target = directory.isEmpty()
+        ? QStandardPaths::writableLocation(QStandardPaths::MusicLocation) + "/WaveMux"
+        : directory;
+    const QString prefix = QDateTime::currentDateTime().toString("yyyyMMdd-HHmmss");
+
+    auto *recorder = new Recorder(tracks, this);
+    if (!recorder->open(target, prefix)) {
+        delete recorder;
+        emit error(QString("Cannot create recording files in %1").arg(target));
+        return false;
+    }
+
+    connect(recorder, &Recorder::failed, this, [this, recorder](const QString &message) {
+        if (m_recorder != recorder) {
+            return;
+        }
+        qCWarning(lcCapture) << "Recording failed:" << message;
+        stopRecording();
+        emit error(QString("Recording stopped: %1").arg(message));
+    });
+
+    m_recorder = recorder;
+    recorder->start(QThread::HighPriority);
+    qCInfo(lcCapture) << "Recording" << tracks.size() << "tracks to" << target;
+    emit recordingChanged(true);
+    return true;
+}
+
+bool AudioManager::stopRecording() {
+    if (!m_recorder) {
+        return false;
+    }
+    m_recorder->stop();
+    qCInfo(lcCapture) << "Recorded" << m_recorder->files();
+    delete m_recorder;
+    m_recorder = nullptr;
+    emit recordingChanged(false);
+    return true;
+}
+
+RecordingStatus AudioManager::recordingStatus() const {
+    RecordingStatus status;
+    if (!m_recorder) {
+        return status;
+    }
+    status.recording = true;
+    status.files = m_recorder->files();
+    status.seconds = static_cast<double>(m_recorder->framesRecorded()) / Recorder::SAMPLE_RATE;
+    status.droppedSeconds = static_cast<double>(m_recorder->droppedFrames()) / Recorder::SAMPLE_RATE;
+    return status;
+}
+
+QString AudioManager::micCaptureSource() const {
+    return m_micSuppressionModule > 0 ? MIC_SUPPRESSED_SOURCE : m_micConfig.source;
+}
+
+void AudioManager::updateCaptures() {
+    updateReplay();
+    updateSpectrumMonitor();
+}
+
+bool AudioManager::setReplay(const ReplaySettings &settings) {
+    if (settings.seconds < 1 || settings.seconds > ReplaySettings::MAX_SECONDS) {
+        return false;
+    }
+    m_replaySettings = settings;
+    qCInfo(lcCapture) << "Replay buffer:" << settings.enabled << settings.seconds << "s"
+            << (settings.channels ? "with channels" : "") << (settings.compact ? "16-bit" : "float");
+    updateReplay();
+    emit replayChanged();
+    return true;
+}
+
+void AudioManager::updateReplay() {
+    QList<ReplayBuffer::Track> tracks;
+    if (m_initialized && m_replaySettings.enabled) {
+        if (m_streamEnabled && !m_activeStreamOutputDevice.isEmpty()) {
+            tracks.append({"stream-mix", m_activeStreamOutputDevice + ".monitor"});
+        }
+        if (m_replaySettings.channels) {
+            for (const auto &id : CHANNEL_IDS) {
+                tracks.append({id, m_channels.value(id).sinkName + ".monitor"});
+            }
+        }
+    }
+
+    auto trackNames = [](const QList<ReplayBuffer::Track> &list) {
+        QStringList names;
+        for (const auto &track : list) {
+            names << track.name;
+        }
+        return names;
+    };
+
+    if (m_replay && (tracks.isEmpty() || trackNames(tracks) != trackNames(m_replay->tracks())
+                     || m_replay->seconds() != m_replaySettings.seconds
+                     || m_replay->isCompact() != m_replaySettings.compact)) {
+        delete m_replay;
+        m_replay = nullptr;
+    }
+    if (tracks.isEmpty()) {
+        return;
+    }
+
+    if (!m_replay) {
+        m_replay = new ReplayBuffer(tracks, m_replaySettings.seconds, m_replaySettings.compact, this);
+        connect(m_replay, &ReplayBuffer::failed, this, [this](const QString &message) {
+            qCWarning(lcCapture) << "Replay buffer:" << message;
+            emit error(QString("Replay buffer stopped: %1").arg(message));
+        });
+        qCInfo(lcCapture) << "Replay buffer holds" << m_replay->memoryBytes() / (1024 * 1024) << "MiB";
+        m_replay->start();
+        return;
+    }
+
+    // Same tracks: only the Stream mix's device can have moved. Restarting
+    // capture keeps the history collected so far.
+    const QList<ReplayBuffer::Track> current = m_replay->tracks();
+    bool retarget = false;
+    for (int i = 0; i < tracks.size(); ++i) {
+        retarget = retarget || tracks[i].source != current[i].source;
+    }
+    if (retarget || m_replay->isFinished()) {
+        m_replay->stop();
+        for (const auto &track : tracks) {
+            m_replay->setSource(track.name, track.source);
+        }
+        m_replay->start();
+    }
+}
+
+bool AudioManager::saveReplay(int seconds, const QString &path) {
+    if (!m_replay) {
+        qCWarning(lcCapture) << "Replay buffer is not running";
+        return false;
+    }
+    if (seconds < 0) {
+        return false;
+    }
+
+    QString target = path;
+    if (target.isEmpty()) {
+        target = QStandardPaths::writableLocation(QStandardPaths::MusicLocation) + "/WaveMux/replay-"
+            + QDateTime::currentDateTime().toString("yyyyMMdd-HHmmss") + ".wav";
+    } else if (!target.endsWith(".wav", Qt::CaseInsensitive)) {
+        target += ".wav";
+    }
+    const double length = seconds == 0 ? m_replay->seconds() : qMin(seconds, m_replay->seconds());
+
+    // The worker only reads the rings (shared, so a settings change mid-save
+    // is harmless); capture never waits for it
+    const ReplayBuffer::Clip clip = m_replay->clip();
+    auto files = std::make_shared<QStringList>();
+    auto success = std::make_shared<bool>(false);
+    QThread *worker = QThread::create([clip, length, target, files, success]() {
+        *success = ReplayBuffer::writeClip(clip, length, target, "stream-mix", files.get());
+    });
+    connect(worker, &QThread::finished, this, [this, worker, files, success]() {
+        m_replaySaves.removeAll(worker);
+        worker->deleteLater();
+        qCInfo(lcCapture) << "Replay saved:" << *files << (*success ? "" : "(with errors)");
+        emit replaySaved(*files, *success);
+    });
+    m_replaySaves.append(worker);
+    worker->start(QThread::LowPriority);
+    return true;
+}
+
+std::optional<SpectrumMonitor::Target> AudioManager::spectrumTarget(const QString &id) const {
+    if (m_channels.contains(id)) {
+        return SpectrumMonitor::Target{id, m_channels.value(id).sinkName + ".monitor"};
+    }
+    if (id == MIC_CHANNEL_ID) {
+        if (m_micConfig.source.isEmpty()) {
+            return std::nullopt;
+        }
+        return SpectrumMonitor::Target{id, micCaptureSource()};
+    }
+    if (id == "personal" || id == "stream") {
+        const QString &device = id == "stream" ? m_activeStreamOutputDevice : m_activeOutputDevice;
+        if (device.isEmpty()) {
+            return std::nullopt;
+        }
+        return SpectrumMonitor::Target{id, device + ".monitor"};
+    }
+    if (id.startsWith("app:")) {
+        bool ok = false;
+        const uint32_t streamId = id.mid(4).toUInt(&ok);
+        if (!ok || streamId == 0) {
+            return std::nullopt;
+        }
+        return SpectrumMonitor::Target{id, QString(), streamId};
+    }
+    return std::nullopt;
+}
+
+bool AudioManager::setSpectrumSubscription(const QString &client, const QStringList &targets) {
+    static const QRegularExpression validTarget("^(game|chat|media|aux|mic|personal|stream|app:[1-9][0-9]*)$");
+    for (const auto &target : targets) {
+        if (!validTarget.match(target).hasMatch()) {
+            qCWarning(lcCapture) << "Unknown spectrum target:" << target;
+            return false;
+        }
+    }
+
+    if (targets.isEmpty()) {
+        m_spectrumSubscribers.remove(client);
+    } else {
+        m_spectrumSubscribers[client] = targets;
+    }
+    updateSpectrumMonitor();
+    return true;
+}
+
+QStringList AudioManager::spectrumTargets() const {
+    QStringList targets;
+    for (const auto &subscribed : m_spectrumSubscribers) {
+        for (const auto &target : subscribed) {
+            if (!targets.contains(target)) {
+                targets << target;
+            }
+        }
+    }
+    return targets;
+}
+
+void AudioManager::updateSpectrumMonitor() {
+    QList<SpectrumMonitor::Target> targets;
+    if (m_initialized) {
+        for (const auto &id : spectrumTargets()) {
+            // Targets that can't be captured right now (no mic, mix off) are left out
+            if (auto target = spectrumTarget(id)) {
+                targets.append(*target);
+            }
+        }
+    }
+
+    auto sameTargets = [](const QList<SpectrumMonitor::Target> &a, const QList<SpectrumMonitor::Target> &b) {
+        if (a.size() != b.size()) {
+            return false;
+        }
+        for (int i = 0; i < a.size(); ++i) {
+            if (a[i].id != b[i].id || a[i].device != b[i].device || a[i].stream != b[i].stream) {
+                return false;
+            }
+        }
+        return true;
+    };
+    if (m_spectrum && sameTargets(targets, m_spectrum->targets()) && m_spectrum->isRunning()) {
+        return;
+    }
+
+    delete m_spectrum;
+    m_spectrum = nullptr;
+    if (targets.isEmpty()) {
+        if (m_spectrumTimer) {
+            m_spectrumTimer->stop();
+        }
+        return;
+    }
+
+    m_spectrum = new SpectrumMonitor(targets, this);
+    connect(m_spectrum, &SpectrumMonitor::failed, this, [](const QString &message) {
+        qCWarningLimited(lcCapture) << "Spectrum feed:" << message;
+    });
+    m_spectrum->start(QThread::LowPriority);
+
+    if (!m_spectrumTimer) {
+        m_spectrumTimer = new QTimer(this);
+        m_spectrumTimer->setInterval(1000 / SpectrumMonitor::UPDATE_HZ);
+        connect(m_spectrumTimer, &QTimer::timeout, this, [this]() {
+            if (!m_spectrum) {
+                return;
+            }
+            const auto updates = m_spectrum->takeUpdates();
+            if (updates.isEmpty()) {
+                return;
+            }
+            QVariantMap bands;
+            for (auto it = updates.constBegin(); it != updates.constEnd(); ++it) {
+                bands[it.key()] = QVariant::fromValue(QList<double>(it->begin(), it->end()));
+            }
+            emit spectrumUpdated(bands);
+        });
+    }
+    m_spectrumTimer->start();
+    qCInfo(lcCapture) << "Spectrum feed for" << spectrumTargets();
+}
+
+QList<Device> AudioManager::listInputDevices() const {
+    QList<Device> devices;
+    QByteArray output;
+    if (!runCommand("pactl list sources", &output)) {
+        return devices;
+    }
+
+    const PactlListing listing(bytesView(output));
+    for (size_t i = 0; i < listing.size(); ++i) {
+        Device device;
+        device.id = fieldText(listing.field(i, "Name"));
+        // Sink monitors and our own sources are not microphones
+        if (listing[i].type != "Source" || device.id.isEmpty() || device.id.endsWith(".monitor") ||
+            device.id.startsWith("wavemux_")) {
+            continue;
+        }
+        device.description = fieldText(listing.field(i, "Description"));
+        device.name = device.description;
+        devices.append(device);
+    }
+
+    return devices;
+}
+
+bool AudioManager::setMic(const MicConfig &config) {
+    if (!validMic(config)) {
+        return false;
+    }
+
+    const bool sourceChanged = config.source != m_micConfig.source;
+    m_micConfig = config;
+    qCInfoLimited(lcMix) << "Mic:" << (config.source.isEmpty() ? "none" : config.source)
+            << "gate" << (config.gate.enabled ? "on" : "off") << config.gate.thresholdDb << "dB"
+            << "suppression" << (config.suppression ? "on" : "off");
+
+    if (m_initialized) {
+        updateMicSuppression();
+    }
+    updateMixProcessing(false);
+    updateMixProcessing(true);
+
+    if (sourceChanged) {
+        updateSpectrumMonitor();
+        emit channelsChanged();  // The mic appears in or leaves the channel list
+    }
+    emit micChanged();
+    return true;
+}
+
+bool AudioManager::setMicState(const ChannelState &state) {
+    m_mic = state;
+    // Its level can take the mic in or out of a mix; otherwise it is just a gain
+    for (const bool streamMix : {false, true}) {
+        if (!updateMixMode(streamMix)) {
+            syncMixEngine(streamMix);
+        }
+    }
+    emit channelsChanged();
+    return true;
+}
+
+void AudioManager::updateMicSuppression() {
+    const bool wanted = m_micConfig.suppression && !m_micConfig.source.isEmpty();
+
+    if (m_micSuppressionModule > 0 && (!wanted || m_micSuppressionMaster != m_micConfig.source)) {
+        removeVirtualSink(m_micSuppressionModule);
+        m_micSuppressionModule = 0;
+        m_micSuppressionMaster.clear();
+    }
+    if (!wanted || m_micSuppressionModule > 0) {
+        return;
+    }
+
+    // RNNoise as a filter source in the server, from the noise-suppression-for-voice
+    // LADSPA plugin; without it the mic is captured unfiltered
+    QString output;
+    const QString cmd = QString("pactl load-module module-ladspa-source source_name=%1 master=%2 "
+                                "plugin=librnnoise_ladspa label=noise_suppressor_mono channels=1")
+        .arg(MIC_SUPPRESSED_SOURCE, m_micConfig.source);
+    if (!runCommand(cmd, &output)) {
+        qCWarning(lcMix) << "Noise suppression unavailable (is the RNNoise LADSPA plugin installed?), using the raw mic";
+        return;
+    }
+    m_micSuppressionModule = output.trimmed().toUInt();
+    m_micSuppressionMaster = m_micConfig.source;
+    qCInfo(lcMix) << "Noise suppression for" << m_micConfig.source << "module:" << m_micSuppressionModule;
+}
+
+bool AudioManager::setChannelEq(const QString &channelId, const QList<EqBand> &bands) {
+    auto it = m_channels.find(channelId);
+    if (it == m_channels.end()) {
+        return false;
+    }
+    if (!validEqBands(bands)) {
+        return false;
+    }
+
+    it->eq = bands;
+    qCInfoLimited(lcMix) << "EQ for" << channelId << "channel:" << bands.size() << "bands";
+
+    for (const bool streamMix : {false, true}) {
+        if (!updateMixMode(streamMix)) {
+            syncMixEq(streamMix, channelId);
+        }
+    }
+    emit equalizerChanged(channelId);
+    return true;
+}
+
+QList<EqBand> AudioManager::getChannelEq(const QString &channelId) const {
+    return m_channels.value(channelId).eq;
+}
+
+bool AudioManager::setLimiter(const QString &mixId, const LimiterSettings &settings) {
+    if (mixId != "personal" && mixId != "stream") {
+        return false;
+    }
+    if (!validLimiter(settings)) {
+        return false;
+    }
+
+    const bool streamMix = mixId == "stream";
+    processingFor(streamMix).limiter = settings;
+    qCInfoLimited(lcMix) << "Limiter for" << mixId << "mix:" << (settings.enabled ? "on" : "off")
+            << "ceiling" << settings.ceilingDb << "dBTP";
+
+    updateMixProcessing(streamMix);
+    emit processingChanged();
+    return true;
+}
+
+LimiterSettings AudioManager::getLimiter(const QString &mixId) const {
+    return processingFor(mixId == "stream").limiter;
+}
+
+bool AudioManager::setLoudness(const QString &mixId, const LoudnessSettings &settings) {
+    if (mixId != "personal" && mixId != "stream") {
+        return false;
+    }
+    if (!validLoudness(settings)) {
+        return false;
+    }
+
+    const bool streamMix = mixId == "stream";
+    processingFor(streamMix).loudness = settings;
+    qCInfoLimited(lcMix) << "Loudness normalization for" << mixId << "mix:" << (settings.enabled ? "on" : "off")
+            << "target" << settings.targetLufs << "LUFS";
+
+    updateMixProcessing(streamMix);
+    emit processingChanged();
+    return true;
+}
+
+LoudnessSettings AudioManager::getLoudness(const QString &mixId) const {
+    return processingFor(mixId == "stream").loudness;
+}
+
+bool AudioManager::setChannelDelay(const QString &mixId, const QString &channelId, double milliseconds) {
+    if (mixId != "personal" && mixId != "stream") {
+        return false;
+    }
+    if (!m_channels.contains(channelId) && channelId != MIC_CHANNEL_ID) {
+        return false;
+    }
+    if (milliseconds < 0.0 || milliseconds > MixGraph::MAX_DELAY_MS) {
+        qCWarning(lcMix) << "Invalid delay:" << milliseconds << "ms";
+        return false;
+    }
+
+    const bool streamMix = mixId == "stream";
+    const int frames = static_cast<int>(std::lround(milliseconds * MixEngine::SAMPLE_RATE / 1000.0));
+    QHash<QString, int> &delays = processingFor(streamMix).delays;
+    if (delays.value(channelId) == frames) {
+        return true;
+    }
+    if (frames > 0) {
+        delays[channelId] = frames;
+    } else {
+        delays.remove(channelId);
+    }
+    qCInfoLimited(lcMix) << "Delay for" << channelId << "in" << mixId << "mix:" << frames << "frames";
+
+    updateMixProcessing(streamMix);
+    emit processingChanged();
+    return true;
+}
+
+QHash<QString, double> AudioManager::getChannelDelays(const QString &mixId) const {
+    QHash<QString, double> delays;
+    const auto &frames = processingFor(mixId == "stream").delays;
+    for (auto it = frames.constBegin(); it != frames.constEnd(); ++it) {
+        delays[it.key()] = it.value() * 1000.0 / MixEngine::SAMPLE_RATE;
+    }
+    return delays;
+}
+
+bool AudioManager::measureAlignment(const QString &mixId) {
+    if (mixId != "personal" && mixId != "stream") {
+        return false;
+    }
+    if (isMeasuringAlignment()) {
+        qCWarning(lcLatency) << "Alignment measurement already running for the" << m_alignmentMix << "mix";
+        return false;
+    }
+    if (isMeasuringLatency()) {
+        qCWarning(lcLatency) << "Cannot measure alignment while a latency measurement is running";
+        return false;
+    }
+    const bool streamMix = mixId == "stream";
+    const QString &device = streamMix ? m_activeStreamOutputDevice : m_activeOutputDevice;
+    if (!m_initialized || device.isEmpty() || (streamMix && !m_streamEnabled)) {
+        qCWarning(lcLatency) << "Cannot measure alignment: the" << mixId << "mix is not playing";
+        return false;
+    }
+
+    // A channel that is silent in the mix can't be heard at its output
+    struct Path {
+        QString channelId;
+        QString sink;
+        int delay;  // Already applied while measuring
+    };
+    QList<Path> paths;
+    for (const auto &id : CHANNEL_IDS) {
+        const ChannelState &channel = m_channels.value(id);
+        if (!channel.muted && (streamMix ? channel.streamVolume : channel.personalVolume) > 0) {
+            paths.append({id, channel.sinkName, processingFor(streamMix).delays.value(id)});
+        }
+    }
+    if (paths.isEmpty()) {
+        return false;
+    }
+
+    m_alignmentMix = mixId;
+    updateMixProcessing(streamMix);
+
+    const QString monitor = device + ".monitor";
+    auto latencies = std::make_shared<QHash<QString, int>>();
+    m_alignment = QThread::create([paths, monitor, latencies]() {
+        settle(300);  // Let a freshly started engine settle
+        for (const auto &path : paths) {
+            const QList<int> runs = LatencyProbe::measure(path.sink, monitor, 3);
+            if (!runs.isEmpty()) {
+                (*latencies)[path.channelId] = LatencyProbe::median(runs) - path.delay;
+            }
+        }
+    });
+    connect(m_alignment, &QThread::finished, this, [this, mixId, streamMix, latencies]() {
+        m_alignment->deleteLater();
+        m_alignmentMix.clear();
+
+        QHash<QString, double> latenciesMs;
+        int slowest = 0;
+        for (auto it = latencies->constBegin(); it != latencies->constEnd(); ++it) {
+            latenciesMs[it.key()] = it.value() * 1000.0 / MixEngine::SAMPLE_RATE;
+            slowest = qMax(slowest, it.value());
+        }
+
+        // Only the measured channels move; the slowest gets no delay
+        const bool success = !latencies->isEmpty();
+        QHash<QString, int> &delays = processingFor(streamMix).delays;
+        const int maxFrames = static_cast<int>(MixGraph::MAX_DELAY_MS * MixEngine::SAMPLE_RATE / 1000);
+        for (auto it = latencies->constBegin(); it != latencies->constEnd(); ++it) {
+            const int frames = qMin(slowest - it.value(), maxFrames);
+            if (frames > 0) {
+                delays[it.key()] = frames;
+            } else {
+                delays.remove(it.key());
+            }
+        }
+        qCInfo(lcLatency) << "Alignment of the" << mixId << "mix: latencies" << latenciesMs << "ms";
+
+        updateMixProcessing(streamMix);
+        emit alignmentMeasured(mixId, latenciesMs, success);
+        emit processingChanged();
+    });
+    m_alignment->start(QThread::LowPriority);
+    qCInfo(lcLatency) << "Measuring alignment of the" << mixId << "mix on" << device;
+    return true;
+}
+
+bool AudioManager::measureLatency(const QString &channelId, const QString &mixId, int runs) {
+    if ((mixId != "personal" && mixId != "stream") || !m_channels.contains(channelId)) {
+        return false;
+    }
+    if (runs < 1 || runs > MAX_LATENCY_RUNS) {
+        qCWarning(lcLatency) << "Invalid latency run count:" << runs;
+        return false;
+    }
+    // Probes playing at the same time would find each other
+    if (isMeasuringLatency() || isMeasuringAlignment()) {
+        qCWarning(lcLatency) << "A latency measurement is already running";
+        return false;
+    }
+    const bool streamMix = mixId == "stream";
+    const QString &device = streamMix ? m_activeStreamOutputDevice : m_activeOutputDevice;
+    if (!m_initialized || device.isEmpty() || (streamMix && !m_streamEnabled)) {
+        qCWarning(lcLatency) << "Cannot measure latency: the" << mixId << "mix is not playing";
+        return false;
+    }
+    const ChannelState &channel = m_channels[channelId];
+    if (channel.muted || (streamMix ? channel.streamVolume : channel.personalVolume) == 0) {
+        qCWarning(lcLatency) << "Cannot measure latency:" << channelId << "is silent in the" << mixId << "mix";
+        return false;
+    }
+
+    auto measurement = std::make_shared<LatencyMeasurement>();
+    measurement->channelId = channelId;
+    measurement->mixId = mixId;
+    measurement->device = device;
+    measurement->mode = engineFor(streamMix) ? "engine" : "loopback";
+
+    const QString sink = channel.sinkName;
+    m_latencyMeasurement = QThread::create([measurement, sink, runs]() {
+        const QString monitor = measurement->device + ".monitor";
+        measurement->path = LatencyProbe::summarize(LatencyProbe::measure(sink, monitor, runs), runs);
+        const int baselineRuns = qMin(runs, 3);
+        measurement->baseline = LatencyProbe::summarize(
+            LatencyProbe::measure(measurement->device, monitor, baselineRuns), baselineRuns);
+    });
+    connect(m_latencyMeasurement, &QThread::finished, this, [this, measurement]() {
+        m_latencyMeasurement->deleteLater();
+        m_latencyMeasurement.clear();
+
+        const bool success = !measurement->path.runsMs.isEmpty();
+        if (success) {
+            Stats::histogram("latency.measured." + measurement->mixId.toStdString())
+                .record(static_cast<uint64_t>(measurement->path.medianMs * 1000.0));
+        }
+        qCInfo(lcLatency) << "Latency of" << measurement->channelId << "in the" << measurement->mixId << "mix:"
+                << measurement->path.medianMs << "ms median," << measurement->path.jitterMs << "ms jitter,"
+                << measurement->path.runsMs.size() << "of" << measurement->path.attempts << "runs; probe overhead"
+                << measurement->baseline.medianMs << "ms";
+        emit latencyMeasured(*measurement, success);
+    });
+    m_latencyMeasurement->start(QThread::LowPriority);
+    qCInfo(lcLatency) << "Measuring latency of" << channelId << "in the" << mixId << "mix on" << device;
+    return true;
+}
+
+MixMeters AudioManager::getMixMeters(const QString &mixId) const {
+    MixMeters meters;
+    const MixEngine *engine = mixId == "stream" ? m_streamEngine : m_personalEngine;
+    if (!engine) {
+        return meters;
+    }
+    const MixGraph &graph = engine->graph();
+    meters.limiterReductionDb = graph.limiter().gainReductionDb();
+    meters.normalizationGainDb = graph.normalizer().gainDb();
+    meters.shortTermLufs = graph.outputMeter().shortTermLufs();
+    meters.momentaryLufs = graph.outputMeter().momentaryLufs();
+    if (const NoiseGate *gate = graph.stripGate(CHANNEL_IDS.size())) {
+        meters.micGateOpen = gate->isOpen();
+        meters.micGateReductionDb = gate->gainReductionDb();
+    }
+    return meters;
+}
+
+bool AudioManager::mixNeedsProcessing(bool streamMix) const {
+    const MixProcessing &processing = processingFor(streamMix);
+    if (processing.ducking.settings.enabled || processing.limiter.enabled || processing.loudness.enabled ||
+        !processing.delays.isEmpty() || micInMix(streamMix)) {
+        return true;
+    }
+    // Alignment is measured on the paths the engine captures
+    if (m_alignmentMix == (streamMix ? "stream" : "personal")) {
+        return true;
+    }
+    for (const auto &channel : m_channels) {
+        for (const auto &band : channel.eq) {
+            if (band.enabled) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool AudioManager::micInMix(bool streamMix) const {
+    return !m_micConfig.source.isEmpty() && (streamMix ? m_mic.streamVolume : m_mic.personalVolume) > 0;
+}
+
+QStringList AudioManager::mixSources(bool streamMix) const {
+    // One graph strip per source: the channels in CHANNEL_IDS order, then the mic
+    QStringList sources;
+    for (const auto &id : CHANNEL_IDS) {
+        sources << m_channels.value(id).sinkName + ".monitor";
+    }
+    if (micInMix(streamMix)) {
+        sources << (m_micSuppressionModule > 0 ? MIC_SUPPRESSED_SOURCE : m_micConfig.source);
+    }
+    return sources;
+}
+
+bool AudioManager::mixRoutingIncomplete(bool streamMix) const {
+    if (streamMix ? m_streamEngine : m_personalEngine) {
+        return false;
+    }
+    const auto &modules = streamMix ? m_streamLoopbackModules : m_loopbackModules;
+    return modules.size() != m_channels.size();
+}
+
+void AudioManager::startMixEngine(bool streamMix) {
+    stopMixEngine(streamMix);
+
+    const QString &target = streamMix ? m_activeStreamOutputDevice : m_activeOutputDevice;
+
+    // Small blocks and buffers keep the mic's trip through the engine short
+    auto *engine = new MixEngine(mixSources(streamMix), target, micInMix(streamMix), this);
+    engineFor(streamMix) = engine;
+    latencyPathFor(streamMix).engineUnderruns = 0;
+    latencyPathFor(streamMix).engineOverruns = 0;
+    syncMixEngine(streamMix);
+    syncMixProcessing(streamMix);
+    for (const auto &id : CHANNEL_IDS) {
+        syncMixEq(streamMix, id);
+    }
+
+    // Without the engine the mix would be silent: fall back to plain loopbacks
+    connect(engine, &MixEngine::failed, this, [this, streamMix, engine](const QString &message) {
+        if (engineFor(streamMix) != engine) {
+            return;
+        }
+        qCWarning(lcMix) << "Mix engine failed:" << message << "- falling back to loopbacks";
+        EventLog::record(EventLog::Code::EngineFailed, "", streamMix ? 1 : 0);
+        stopMixEngine(streamMix);
+        buildMixLoopbacks(streamMix ? m_activeStreamOutputDevice : m_activeOutputDevice, streamMix);
+        emit error(QString("Mix processing stopped: %1").arg(message));
+    });
+
+    engine->start(QThread::TimeCriticalPriority);
+    qCInfo(lcMix) << "Processing" << (streamMix ? "stream" : "personal") << "mix in-process to" << target;
+    EventLog::record(EventLog::Code::EngineStarted, target.toStdString(), streamMix ? 1 : 0);
+}
+
+void AudioManager::stopMixEngine(bool streamMix) {
+    MixEngine *&engine = engineFor(streamMix);
+    if (!engine) {
+        return;
+    }
+    engine->stop();
+    delete engine;
+    engine = nullptr;
+}
+
+void AudioManager::syncMixEngine(bool streamMix) {
+    // Runs on every fader and master move, so it only sets gain targets
+    MixEngine *engine = engineFor(streamMix);
+    if (!engine) {
+        return;
+    }
+
+    MixGraph &graph = engine->graph();
+    for (int strip = 0; strip < CHANNEL_IDS.size(); ++strip) {
+        const auto &channel = m_channels.value(CHANNEL_IDS[strip]);
+        const int mixVolume = streamMix ? channel.streamVolume : channel.personalVolume;
+        graph.setStripGain(strip, percentToGain((mixVolume * m_masterVolume) / 100));
+    }
+
+    const size_t micStrip = CHANNEL_IDS.size();
+    if (graph.stripCount() > micStrip) {
+        // The mic has no sink, so its own volume is applied here as input gain
+        const int mixVolume = streamMix ? m_mic.streamVolume : m_mic.personalVolume;
+        const float gain = m_mic.muted ? 0.0f
+            : percentToGain(m_mic.volume) * percentToGain((mixVolume * m_masterVolume) / 100);
+        graph.setStripGain(micStrip, gain);
+    }
+}
+
+void AudioManager::syncMixProcessing(bool streamMix) {
+    MixEngine *engine = engineFor(streamMix);
+    if (!engine) {
+        return;
+    }
+
+    MixGraph &graph = engine->graph();
+    const MixProcessing &processing = processingFor(streamMix);
+    for (int strip = 0; strip < CHANNEL_IDS.size(); ++strip) {
+        graph.setStripDelay(strip, processing.delays.value(CHANNEL_IDS[strip]));
+    }
+    const size_t micStrip = CHANNEL_IDS.size();
+    if (graph.stripCount() > micStrip) {
+        graph.setStripGate(micStrip, m_micConfig.gate);
+        graph.setStripDelay(micStrip, processing.delays.value(MIC_CHANNEL_ID));
+    }
+
+    uint32_t targetMask = 0;
+    for (const auto &target : processing.ducking.targetChannels) {
+        const int strip = CHANNEL_IDS.indexOf(target);
+        if (strip >= 0) {
+            targetMask |= 1u << strip;
+        }
+    }
+    graph.setDuckingRouting(CHANNEL_IDS.indexOf(processing.ducking.triggerChannel), targetMask);
+    graph.ducker().setSettings(processing.ducking.settings);
+    graph.normalizer().setSettings(processing.loudness);
+    graph.limiter().setSettings(processing.limiter);
+}
+
+void AudioManager::syncMixEq(bool streamMix, const QString &channelId) {
+    // A new EQ makes the audio thread redesign and glide every band of the
+    // strip, so it is only published when the bands actually change
+    MixEngine *engine = engineFor(streamMix);
+    const int strip = CHANNEL_IDS.indexOf(channelId);
+    if (!engine || strip < 0) {
+        return;
+    }
+    const QList<EqBand> bands = m_channels.value(channelId).eq;
+    engine->graph().setStripEq(strip, std::vector<EqBand>(bands.cbegin(), bands.cend()));
+}
+
+bool AudioManager::updateMixMode(bool streamMix) {
+    // Switch the mix between loopbacks and the engine only when it is live
+    // and the mode actually changes
+    const bool live = streamMix
+        ? m_initialized && m_streamEnabled && !m_streamOutputDevice.isEmpty()
+        : m_initialized && !m_outputDevice.isEmpty();
+    if (live && mixNeedsProcessing(streamMix) != (engineFor(streamMix) != nullptr)) {
+        if (streamMix) {
+            updateStreamLoopbacks();
+        } else {
+            updateLoopbacks();
+        }
+        return true;
+    }
+    // An engine captures a fixed set of sources; the mic joining or leaving
+    // the mix means starting it over
+    MixEngine *engine = engineFor(streamMix);
+    if (live && engine && engine->sources() != mixSources(streamMix)) {
+        startMixEngine(streamMix);
+        return true;
+    }
+    return false;
+}
+
+void AudioManager::updateMixProcessing(bool streamMix) {
+    // A rebuilt mix starts out with every parameter; otherwise just push the new ones
+    if (!updateMixMode(streamMix)) {
+        syncMixProcessing(streamMix);
+    }
+}
+
 } // namespace WaveMux
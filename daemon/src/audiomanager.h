@@ -4,13 +4,30 @@
 #include <QHash>
 #include <QString>
 #include <QProcess>
+#include <QPointer>
 #include <optional>
+#include <functional>
 #include "wavemux/types.h"
+#include "dsp/ducker.h"
+#include "dsp/equalizer.h"
+#include "dsp/limiter.h"
+#include "dsp/loudness.h"
+#include "dsp/noisegate.h"
+#include "latencycontroller.h"
+#include "latencyprobe.h"
+#include "spectrummonitor.h"
 
 class QProcess;
+class QTimer;
 
 namespace WaveMux {
 
+class MixEngine;
+class Recorder;
+class CommandQueue;
+class ReplayBuffer;
+class PactlListing;
+
 struct SinkInfo {
     uint32_t index = 0;
     uint32_t moduleId = 0;
@@ -27,6 +44,150 @@ struct StreamInfo {
     QString currentSink;
 };
 
+// Level of one application inside its channel, remembered per binary (or
+// app name) and reapplied whenever the app opens a new stream
+struct AppVolume {
+    int volume = 100;
+    bool muted = false;
+};
+
+// Sidechain ducking within one mix: while the trigger channel is active the
+// target channels are attenuated by settings.depthDb
+struct DuckingConfig {
+    DuckingSettings settings;
+    QString triggerChannel = "chat";
+    QStringList targetChannels = {"game", "media"};
+};
+
+// Capture-side channel (id "mic"): a microphone or any other source, mixed
+// into the Personal and/or Stream mix by the mix engine behind a noise gate
+struct MicConfig {
+    QString source;            // Source name; empty for no mic
+    bool suppression = false;  // RNNoise filter in front of the gate, if the LADSPA plugin is installed
+    NoiseGateSettings gate = {true};
+};
+
+struct RecordingStatus {
+    bool recording = false;
+    QStringList files;          // One WAV per track
+    double seconds = 0.0;
+    double droppedSeconds = 0.0;  // Audio lost because the disk fell behind
+};
+
+// Instant replay: the last `seconds` of the Stream mix (and optionally of
+// each channel) kept in memory, ready to be saved
+struct ReplaySettings {
+    static constexpr int MAX_SECONDS = 300;
+
+    bool enabled = false;
+    int seconds = 60;
+    bool channels = false;  // Also keep game/chat/media/aux as separate tracks
+    bool compact = true;    // 16-bit in memory instead of float
+};
+
+// Live readings from a processed mix's output bus
+struct MixMeters {
+    double limiterReductionDb = 0.0;
+    double normalizationGainDb = 0.0;
+    double shortTermLufs = LoudnessMeter::SILENCE_LUFS;
+    double momentaryLufs = LoudnessMeter::SILENCE_LUFS;
+    bool micGateOpen = false;  // Only meaningful while the mic is in the mix
+    double micGateReductionDb = 0.0;
+};
+
+// Health of one mix's path to its output device. Loopback paths are judged
+// by the fill of their sink-input buffers, engine paths by the engine's own
+// block timing. Xrun counts are totals since the daemon started.
+struct MixLatencyHealth {
+    QString device;
+    QString mode;            // "loopback", "engine" or "off"
+    int latencyMs = 0;       // Buffer latency the path was built with
+    double bufferMs = -1.0;  // Lowest loopback fill, or engine headroom; -1 if unknown
+    quint64 underruns = 0;
+    quint64 overruns = 0;
+    bool adaptive = false;
+};
+
+// Round trip from a channel sink to a mix's output, as measured by
+// AudioManager::measureLatency()
+struct LatencyMeasurement {
+    QString channelId;
+    QString mixId;
+    QString device;
+    QString mode;                     // How the mix ran: "loopback" or "engine"
+    LatencyProbe::Summary path;       // Channel sink -> output device monitor
+    LatencyProbe::Summary baseline;   // Output device -> its monitor: the probe's own overhead
+};
+
+// Profiler reading for one graph node WaveMux created: a channel or mix
+// sink, one side of a loopback, the mic filter or one of the daemon's own
+// streams (mix engine, spectrum, replay...)
+struct NodeLoad {
+    uint32_t nodeId = 0;
+    QString name;             // Node name as pw-top shows it
+    QString role;             // "channel:game", "mix:personal", "loopback:stream:chat", "mic-filter", "wavemux-engine"...
+    QString kind;             // "sink", "source", "sink-input" or "source-output"
+    bool active = false;      // Running in the last graph cycles
+    uint32_t quantum = 0;     // Cycle of the driver it runs under, in frames
+    uint32_t rate = 0;
+    double busyUs = -1.0;     // Processing time per cycle; -1 if the profiler has none
+    double busyQuantum = -1.0;  // The same as a fraction of the cycle
+    quint64 errors = 0;       // Xruns the profiler counted
+};
+
+// DSP time of a mix engine between two samples, measured in the daemon
+struct EngineLoad {
+    QString mixId;
+    double busyUs = 0.0;  // Mean graph processing time per block
+    double load = 0.0;    // Share of the block time spent processing
+    quint64 blocks = 0;
+};
+
+// One sample of WaveMux's share of the audio graph's load. The node data
+// comes from PipeWire's profiler (pw-top); it is unavailable, with a reason,
+// on other servers. Engine loads are always measured.
+struct NodeLoadSample {
+    bool available = false;
+    QString reason;
+    qint64 timestamp = 0;        // ms since the epoch; 0 before the first sample
+    QList<NodeLoad> nodes;
+    double ownBusyUs = 0.0;      // Sums over our nodes...
+    double ownLoad = 0.0;
+    double graphBusyUs = 0.0;    // ...and over every node in the graph
+    double graphLoad = 0.0;
+    quint64 errors = 0;          // Xruns on our nodes
+    QList<EngineLoad> engines;
+};
+
+// Processing and latency settings of one mix within a snapshot
+struct MixSettings {
+    DuckingConfig ducking;
+    LimiterSettings limiter;
+    LoudnessSettings loudness;
+    QHash<QString, double> delaysMs;  // channelId -> delay (only non-zero delays)
+    bool adaptiveLatency = false;
+};
+
+// Complete mixer state, applied as one transaction (startup, profile switch)
+struct MixerSnapshot {
+    QList<Channel> channels;  // id, volume, muted, personalVolume, streamVolume
+    int masterVolume = 100;
+    QString outputDevice;
+    QString streamOutputDevice;
+    QStringList outputFallbacks;        // Tried in order when outputDevice is unplugged
+    QStringList streamOutputFallbacks;
+    bool streamEnabled = false;
+    QList<RoutingRule> routingRules;
+    // Everything that decides how a mix is built travels with the levels, so
+    // each mix is rebuilt (or switched between loopbacks and the engine) at
+    // most once per snapshot
+    MixSettings personal;
+    MixSettings stream;
+    QHash<QString, QList<EqBand>> channelEq;  // channelId -> bands
+    MicConfig mic;
+    QHash<QString, int> deviceLatencies;      // Output device -> learned loopback latency (ms)
+};
+
 class AudioManager : public QObject {
     Q_OBJECT
 
@@ -35,6 +196,9 @@ public:
     ~AudioManager();
 
     bool initialize();
+    // Same stages as initialize(), one per event-loop iteration; emits initialized()
+    void initializeAsync();
+    bool isInitialized() const { return m_initialized; }
     void shutdown();
 
     // Channel management
@@ -50,11 +214,17 @@ public:
     bool setChannelPersonalVolume(const QString &channelId, int volume);
     bool setChannelStreamVolume(const QString &channelId, int volume);
 
-    // Device management
+    // Device management (served from a cache kept current by sink hotplug events)
     QList<Device> listOutputDevices() const;
     bool setOutputDevice(const QString &deviceId);
     QString getOutputDevice() const { return m_outputDevice; }
 
+    // Failover: a mix plays on its preferred device, else on the first
+    // available fallback, and returns to the preferred one when it reappears
+    bool setOutputFallbacks(const QString &mixId, const QStringList &deviceIds);
+    QStringList getOutputFallbacks(const QString &mixId) const;
+    QString getActiveOutputDevice(const QString &mixId) const;
+
     // Master volume
     int getMasterVolume() const { return m_masterVolume; }
 
@@ -64,11 +234,28 @@ public:
     bool unassignStream(uint32_t streamId);
     QString getStreamChannel(uint32_t streamId) const;
 
+    // Per-application levels within a channel. Changes are queued and
+    // coalesced, so these are cheap to call at slider rate.
+    bool setStreamVolume(uint32_t streamId, int volume);
+    bool setStreamMute(uint32_t streamId, bool muted);
+    QHash<QString, AppVolume> getAppVolumes() const { return m_appVolumes; }
+    void setAppVolumes(const QHash<QString, AppVolume> &volumes);
+    // Blocks until queued stream level changes have reached the server
+    void flushPendingCommands();
+    bool hasPendingCommands() const;
+
     // Routing rules
     void addRoutingRule(const QString &pattern, const QString &channelId);
     void removeRoutingRule(const QString &pattern);
     QList<RoutingRule> getRoutingRules() const;
     void applyRoutingRulesToExistingStreams();
+    // The first rule matching the app or process name, or nullptr
+    const RoutingRule *matchRoutingRule(const QString &appName, const QString &processName) const;
+
+    // Batched state application
+    MixerSnapshot snapshot() const;
+    bool applySnapshot(const MixerSnapshot &snapshot);
+    bool applyProfile(const Profile &profile);
 
     // Loopback routing
     bool updateLoopbacks();
@@ -80,7 +267,108 @@ public:
     bool isStreamEnabled() const { return m_streamEnabled; }
     bool updateStreamLoopbacks();
 
+    // In-process mix processing (mixId: "personal" or "stream"). A mix with
+    // any processing enabled is run by a MixEngine instead of loopbacks.
+    bool setDucking(const QString &mixId, const DuckingConfig &config);
+    DuckingConfig getDucking(const QString &mixId) const;
+    double getDuckingGainReduction(const QString &mixId) const;
+    bool isMixProcessed(const QString &mixId) const;
+
+    // Microphone channel. Its levels go through the channel setters with
+    // channel id "mic" (volume is its input gain, personalVolume is
+    // self-monitoring); it is listed with the channels while a source is set.
+    // A mix with the mic in it runs in-process in low-latency mode.
+    QList<Device> listInputDevices() const;
+    bool setMic(const MicConfig &config);
+    MicConfig getMic() const { return m_micConfig; }
+
+    // Multitrack recording: each channel, the mic (when set) and the Stream
+    // mix, one WAV file each. An empty directory means ~/Music/WaveMux.
+    bool startRecording(const QString &directory = QString());
+    bool stopRecording();
+    bool isRecording() const { return m_recorder != nullptr; }
+    RecordingStatus recordingStatus() const;
+
+    // Instant replay. saveReplay() writes the newest `seconds` (0 = all of
+    // it) on a worker thread and reports through replaySaved(); an empty path
+    // means ~/Music/WaveMux/replay-<time>.wav. Channel tracks are written next
+    // to it as <name>-<channel>.wav.
+    bool setReplay(const ReplaySettings &settings);
+    ReplaySettings getReplay() const { return m_replaySettings; }
+    bool isReplayActive() const { return m_replay != nullptr; }
+    bool saveReplay(int seconds, const QString &path = QString());
+
+    // Spectrum feed: SpectrumAnalyzer::BANDS log-spaced bands in dBFS per
+    // target, SpectrumMonitor::UPDATE_HZ times a second. Targets are channel
+    // ids (including "mic"), the mixes "personal" and "stream", and
+    // "app:<streamId>" for one application. It only runs while some client
+    // is subscribed; an empty target list unsubscribes the client.
+    bool setSpectrumSubscription(const QString &client, const QStringList &targets);
+    QStringList spectrumTargets() const;
+
+    // Per-channel parametric EQ (up to Equalizer::MAX_BANDS bands). It shapes
+    // the channel in every mix and makes those mixes run in-process.
+    bool setChannelEq(const QString &channelId, const QList<EqBand> &bands);
+    QList<EqBand> getChannelEq(const QString &channelId) const;
+
+    // Output bus: loudness normalization to a LUFS target, then a true-peak limiter
+    bool setLimiter(const QString &mixId, const LimiterSettings &settings);
+    LimiterSettings getLimiter(const QString &mixId) const;
+    bool setLoudness(const QString &mixId, const LoudnessSettings &settings);
+    LoudnessSettings getLoudness(const QString &mixId) const;
+    MixMeters getMixMeters(const QString &mixId) const;
+
+    // Delay compensation: per-mix delays (channelId includes "mic"), up to
+    // MixGraph::MAX_DELAY_MS, that hold faster channels back so everything in
+    // the mix lines up. A mix with any delay runs in-process.
+    // measureAlignment() plays a short sweep through each audible channel of
+    // the mix, times its arrival at the mix output and sets the delays so
+    // each channel matches the slowest one. It runs in the background and
+    // reports the measured path latencies through alignmentMeasured().
+    bool setChannelDelay(const QString &mixId, const QString &channelId, double milliseconds);
+    QHash<QString, double> getChannelDelays(const QString &mixId) const;
+    bool measureAlignment(const QString &mixId);
+    bool isMeasuringAlignment() const { return !m_alignmentMix.isEmpty(); }
+
+    // Latency of one channel's path through a mix: plays `runs` probe sweeps
+    // into the channel sink and times them at the output device's monitor,
+    // then does the same straight into the device for the probe's own
+    // overhead. The channel must be audible in the mix. Runs in the
+    // background and reports through latencyMeasured().
+    static constexpr int DEFAULT_LATENCY_RUNS = 5;
+    static constexpr int MAX_LATENCY_RUNS = 20;
+    bool measureLatency(const QString &channelId, const QString &mixId, int runs = DEFAULT_LATENCY_RUNS);
+    bool isMeasuringLatency() const { return !m_latencyMeasurement.isNull(); }
+
+    // Output path health, polled every LATENCY_POLL_MS while a mix has
+    // adaptive latency on, and for LATENCY_WATCH_MS after a client last
+    // called watchLatencyHealth(); nothing is polled otherwise. With adaptive
+    // latency on, a mix's loopbacks are built with a latency learned per
+    // output device: lowered while the path stays clean, raised after xruns.
+    // A newly learned value waits for the loopbacks' next rebuild; the
+    // controller never rebuilds them itself.
+    static constexpr int DEFAULT_LOOPBACK_LATENCY_MS = 150;
+    static constexpr int LATENCY_POLL_MS = 2000;
+    static constexpr int LATENCY_WATCH_MS = 30000;
+    void watchLatencyHealth();
+    MixLatencyHealth getLatencyHealth(const QString &mixId) const;
+    bool setAdaptiveLatency(const QString &mixId, bool enabled);
+    bool isAdaptiveLatency(const QString &mixId) const;
+    QHash<QString, int> getDeviceLatencies() const { return m_deviceLatencies; }
+    void setDeviceLatencies(const QHash<QString, int> &latencies);
+
+    // CPU and DSP load of the graph objects WaveMux owns. Sampling is on
+    // demand: refreshNodeLoad() starts one in the background unless the last
+    // is younger than NODE_LOAD_MAX_AGE_MS or one is running, and reports it
+    // through nodeLoadUpdated(). Nothing runs while nobody asks.
+    static constexpr int NODE_LOAD_MAX_AGE_MS = 2000;
+    NodeLoadSample getNodeLoad() const { return m_nodeLoad; }
+    void refreshNodeLoad();
+
 signals:
+    void initialized(bool success);
+    void devicesChanged();
+    void activeOutputDeviceChanged(const QString &mixId, const QString &deviceId);
     void channelsChanged();
     void mixesChanged();
     void streamsChanged();
@@ -88,6 +376,19 @@ signals:
     void streamRemoved(uint32_t streamId);
     void masterVolumeChanged(int volume);
     void routingRulesChanged();
+    void appVolumesChanged();
+    void processingChanged();
+    void equalizerChanged(const QString &channelId);
+    void micChanged();
+    void recordingChanged(bool recording);
+    void replayChanged();
+    void replaySaved(const QStringList &files, bool success);
+    void spectrumUpdated(const QVariantMap &bands);  // target -> list of BANDS levels
+    void alignmentMeasured(const QString &mixId, const QHash<QString, double> &latenciesMs, bool success);
+    void latencyChanged(const QString &mixId);  // Adaptive setting or learned latency
+    void latencyMeasured(const LatencyMeasurement &measurement, bool success);
+    void nodeLoadUpdated(const NodeLoadSample &sample);
+    void snapshotApplied();  // Replaces the individual change signals for a whole snapshot
     void error(const QString &message);
 
 private:
@@ -101,6 +402,7 @@ private:
         bool muted = false;
         int personalVolume = 100;  // 0-100, mix level for personal output
         int streamVolume = 0;      // 0-100, mix level for stream output
+        QList<EqBand> eq;
     };
 
     bool createVirtualSink(const QString &name, const QString &description);
@@ -110,7 +412,16 @@ private:
     bool setSinkMute(const QString &sinkName, bool muted);
 
     bool runCommand(const QString &command, QString *output = nullptr) const;
-    bool createChannels();
+    bool runCommand(const QString &command, QByteArray *output) const;  // Raw output, for PactlListing
+    bool runCommands(const QStringList &commands) const;
+    bool createChannel(const QString &id);
+    struct InitializationStage {
+        QString name;  // Its startup time is recorded as "startup.<name>"
+        std::function<bool()> run;
+    };
+    QList<InitializationStage> initializationStages();
+    bool runInitializationStep(const InitializationStage &stage);
+    void runInitializationStage(const QList<InitializationStage> &stages, int index);
     bool createMixes();
     void setupRouting();
 
@@ -119,9 +430,20 @@ private:
     void stopStreamMonitor();
     void handleMonitorOutput();
     void handleStreamEvent(const QString &eventType, uint32_t id);
+    void handleSinkEvent(const QString &eventType, uint32_t index);
     std::optional<StreamInfo> getStreamInfo(uint32_t id) const;
     void applyRoutingRules(uint32_t streamId, const QString &appName, const QString &processName);
     void syncExistingStreams();
+    QString appKeyFor(uint32_t streamId);
+    bool setStreamLevel(uint32_t streamId, const AppVolume &level);
+    void restoreAppVolume(uint32_t streamId, const StreamInfo &info);
+
+    // Output device cache and failover
+    void refreshDeviceCache() const;
+    bool isDeviceAvailable(const QString &deviceId) const;
+    QString resolveOutputDevice(bool streamMix) const;
+    void failoverOutputs();
+    bool retargetLoopbacks(const QString &targetSink, bool streamMix);
 
     // Loopback management
     bool createLoopback(const QString &sourceSink, const QString &targetSink);
@@ -129,9 +451,92 @@ private:
     void removeAllLoopbacks();
     void applyMasterToLoopbacks();
     uint32_t findLoopbackSinkInput(uint32_t moduleId) const;
+    QHash<uint32_t, uint32_t> findLoopbackSinkInputs() const;
+    void buildMixLoopbacks(const QString &targetSink, bool streamMix);
     bool addChannelLoopback(const QString &channelId);
     bool removeChannelLoopback(const QString &channelId);
 
+    // In-process mixing
+    struct MixProcessing {
+        DuckingConfig ducking;
+        LimiterSettings limiter;
+        LoudnessSettings loudness;
+        QHash<QString, int> delays;  // channelId -> frames (only non-zero delays)
+    };
+    MixProcessing &processingFor(bool streamMix) { return streamMix ? m_streamProcessing : m_personalProcessing; }
+    const MixProcessing &processingFor(bool streamMix) const { return streamMix ? m_streamProcessing : m_personalProcessing; }
+    MixEngine *&engineFor(bool streamMix) { return streamMix ? m_streamEngine : m_personalEngine; }
+    bool validDucking(const DuckingConfig &config) const;
+    // Stores a snapshot's settings for one mix without touching the server;
+    // true if anything changed
+    bool stageMixSettings(bool streamMix, const MixSettings &settings, bool *latencyChanged);
+    bool mixNeedsRebuild(bool streamMix, int previousLatencyMs) const;
+    bool mixNeedsProcessing(bool streamMix) const;
+    bool micInMix(bool streamMix) const;
+    QStringList mixSources(bool streamMix) const;
+    bool setMicState(const ChannelState &state);
+    void updateMicSuppression();
+    bool mixRoutingIncomplete(bool streamMix) const;
+    void startMixEngine(bool streamMix);
+    void stopMixEngine(bool streamMix);
+    // Pushing state into a running engine: levels (every fader move),
+    // processing parameters, and one strip's EQ (only when it changes)
+    void syncMixEngine(bool streamMix);
+    void syncMixProcessing(bool streamMix);
+    void syncMixEq(bool streamMix, const QString &channelId);
+    // Rebuilds the mix or restarts its engine if its settings call for it;
+    // true if it did (the new engine starts with every parameter)
+    bool updateMixMode(bool streamMix);
+    void updateMixProcessing(bool streamMix);
+
+    // Output path health
+    enum class BufferFill { Unknown, Healthy, Low, High };
+    struct LatencyPath {
+        bool adaptive = false;
+        int latencyMs = DEFAULT_LOOPBACK_LATENCY_MS;  // What the loopbacks were last built with
+        QHash<uint32_t, BufferFill> fill;  // Loopback sink-input -> last state
+        double bufferMs = -1.0;
+        quint64 underruns = 0;
+        quint64 overruns = 0;
+        quint64 engineUnderruns = 0;  // Engine counters at the last poll
+        quint64 engineOverruns = 0;
+    };
+    LatencyPath &latencyPathFor(bool streamMix) { return streamMix ? m_streamLatency : m_personalLatency; }
+    const LatencyPath &latencyPathFor(bool streamMix) const { return streamMix ? m_streamLatency : m_personalLatency; }
+    bool hasLoopbacks(bool streamMix) const;
+    int loopbackLatency(const QString &device, bool streamMix) const;
+    void updateLatencyPolling();
+    void pollLatency();
+    void finishLatencyPoll(const QByteArray &sinkInputs);
+    void pollLoopbackFill(LatencyPath &path, const QHash<QString, uint32_t> &sinkInputs, int latencyMs,
+                          const PactlListing &listing);
+    void adaptLatency(const QHash<QString, quint64> &deviceXruns);
+
+    // Graph load
+    struct EngineLoadMark {
+        const MixEngine *engine = nullptr;
+        quint64 blocks = 0;
+        quint64 processNs = 0;
+    };
+    struct OwnedNode {
+        QString role;
+        QString kind;
+    };
+    void finishNodeLoad(const QByteArray &profile, const QByteArray &listing, const QString &error);
+    // Graph node id -> what it is, for every object of ours in a pactl
+    // listing; pipeWire is false if the server gives no node ids
+    QHash<uint32_t, OwnedNode> ownedNodes(const QByteArray &objects, bool *pipeWire) const;
+    QList<EngineLoad> sampleEngineLoad();
+
+    // Starts, retargets or stops the replay buffer to match the settings and
+    // the Stream mix's current device
+    void updateReplay();
+    void updateSpectrumMonitor();
+    // Both of the above, after a device change
+    void updateCaptures();
+    std::optional<SpectrumMonitor::Target> spectrumTarget(const QString &id) const;
+    QString micCaptureSource() const;
+
     // Stream loopback management
     bool addStreamChannelLoopback(const QString &channelId);
     bool removeStreamChannelLoopback(const QString &channelId);
@@ -140,6 +545,10 @@ private:
     QHash<QString, ChannelState> m_channels;
     QHash<uint32_t, QString> m_streamAssignments;  // streamId -> channelId
     QList<RoutingRule> m_routingRules;
+    QHash<QString, AppVolume> m_appVolumes;        // app key -> level (only non-default levels)
+    QHash<uint32_t, AppVolume> m_streamLevels;     // streamId -> level last set by us
+    QHash<uint32_t, QString> m_streamApps;         // streamId -> app key
+    CommandQueue *m_commandQueue = nullptr;
     QHash<QString, uint32_t> m_loopbackModules;    // channelId -> moduleId (personal mix)
     QHash<QString, uint32_t> m_loopbackSinkInputs; // channelId -> sink-input ID (personal mix)
     QHash<QString, uint32_t> m_streamLoopbackModules;    // channelId -> moduleId (stream mix)
@@ -150,10 +559,48 @@ private:
     uint32_t m_personalMixModule = 0;
     uint32_t m_streamMixModule = 0;
     int m_masterVolume = 100;
-    QString m_outputDevice;
+    QString m_outputDevice;             // Preferred (user-chosen) device per mix
     QString m_streamOutputDevice;
+    QStringList m_outputFallbacks;
+    QStringList m_streamOutputFallbacks;
+    QString m_activeOutputDevice;       // Device the mix loopbacks currently target
+    QString m_activeStreamOutputDevice;
+    mutable QList<Device> m_devices;                     // Cached output devices (no wavemux_ sinks)
+    mutable QHash<uint32_t, QString> m_deviceSinkIndexes; // sink index -> device id, for remove events
+    mutable bool m_devicesValid = false;
     bool m_streamEnabled = false;
+    MixProcessing m_personalProcessing;
+    MixProcessing m_streamProcessing;
+    MixEngine *m_personalEngine = nullptr;
+    MixEngine *m_streamEngine = nullptr;
+    Recorder *m_recorder = nullptr;
+    ReplaySettings m_replaySettings;
+    ReplayBuffer *m_replay = nullptr;
+    QList<QPointer<QThread>> m_replaySaves;  // Saves still writing
+    QHash<QString, QStringList> m_spectrumSubscribers;  // client -> targets
+    SpectrumMonitor *m_spectrum = nullptr;
+    QTimer *m_spectrumTimer = nullptr;
+    QTimer *m_latencyTimer = nullptr;
+    QProcess *m_latencyPollProcess = nullptr;  // pactl list sink-inputs, while polling
+    qint64 m_latencyWatchUntil = 0;            // ms since the epoch
+    LatencyPath m_personalLatency;
+    LatencyPath m_streamLatency;
+    QHash<QString, int> m_deviceLatencies;  // Output device -> learned loopback latency (ms)
+    QHash<QString, LatencyController> m_latencyControllers;  // Per output device, while adapting
+    QString m_alignmentMix;                // Mix being measured, if any
+    QPointer<QThread> m_alignment;
+    QPointer<QThread> m_latencyMeasurement;
+    QProcess *m_nodeLoadProcess = nullptr;  // pw-top, while sampling
+    QProcess *m_nodeListProcess = nullptr;  // pactl listing of our objects, while sampling
+    NodeLoadSample m_nodeLoad;
+    QHash<QString, EngineLoadMark> m_engineLoadMarks;  // mixId -> engine counters at the last sample
+    ChannelState m_mic;                    // Levels of the mic channel (no sink)
+    MicConfig m_micConfig;
+    uint32_t m_micSuppressionModule = 0;   // module-ladspa-source in front of the mic
+    QString m_micSuppressionMaster;        // Source that module filters
+    QString m_originalDefaultSink;
     bool m_initialized = false;
+    bool m_initializing = false;
 };
 
 } // namespace WaveMux
@@ -0,0 +1,111 @@
+#include "commandqueue.h"
+#include "logging.h"
+#include "stats.h"
+#include <QProcess>
+#include <QDebug>
+
+namespace WaveMux {
+
+CommandQueue::CommandQueue(QObject *parent)
+    : QObject(parent)
+{
+    m_timer.setSingleShot(true);
+    m_timer.setInterval(FLUSH_DELAY_MS);
+    connect(&m_timer, &QTimer::timeout, this, &CommandQueue::start);
+}
+
+CommandQueue::~CommandQueue() {
+    flush();
+}
+
+void CommandQueue::enqueue(const QString &key, const QString &command) {
+    if (m_pending.contains(key)) {
+        ++m_commandsCoalesced;
+        Stats::counter("commands.coalesced").add();
+    } else {
+        m_order.append(key);
+    }
+    m_pending[key] = command;
+    Stats::histogram("commands.queue-depth", Histogram::Unit::Count).record(static_cast<uint64_t>(m_order.size()));
+
+    // A batch in flight picks the rest up when it finishes
+    if (!m_process && !m_timer.isActive()) {
+        m_timer.start();
+    }
+}
+
+void CommandQueue::start() {
+    if (m_process || m_order.isEmpty()) {
+        return;
+    }
+
+    QStringList commands;
+    for (const auto &key : m_order) {
+        commands << m_pending.value(key);
+    }
+    m_pending.clear();
+    m_order.clear();
+    m_commandsRun += commands.size();
+    Stats::counter("commands.run").add(static_cast<uint64_t>(commands.size()));
+    Stats::histogram("commands.batch-size", Histogram::Unit::Count).record(static_cast<uint64_t>(commands.size()));
+
+    m_batchTimer.start();
+    m_process = new QProcess(this);
+    connect(m_process, &QProcess::finished, this, [this](int exitCode) { onFinished(exitCode); });
+    // A shell that never starts never reports finished() either
+    connect(m_process, &QProcess::errorOccurred, this, [this](QProcess::ProcessError error) {
+        if (error == QProcess::FailedToStart) {
+            onFailedToStart();
+        }
+    });
+    m_process->start("sh", {"-c", commands.join("; ")});
+}
+
+void CommandQueue::onFinished(int exitCode) {
+    Stats::histogram("backend.queued-batch").record(static_cast<uint64_t>(m_batchTimer.nsecsElapsed() / 1000));
+    if (exitCode != 0) {
+        qCWarningLimited(lcCommands) << "Queued audio command failed:" << m_process->readAllStandardError().trimmed();
+        EventLog::record(EventLog::Code::CommandFailed, "queued batch", exitCode);
+        Stats::counter("backend.failures").add();
+    }
+    finishBatch();
+}
+
+void CommandQueue::onFailedToStart() {
+    qCWarningLimited(lcCommands) << "Queued audio commands failed to start:" << m_process->errorString();
+    EventLog::record(EventLog::Code::CommandNotStarted, "queued batch");
+    Stats::counter("backend.start-failures").add();
+    finishBatch();
+}
+
+void CommandQueue::finishBatch() {
+    m_process->deleteLater();
+    m_process = nullptr;
+
+    if (!m_order.isEmpty() && !m_timer.isActive()) {
+        m_timer.start();
+    }
+}
+
+void CommandQueue::flush() {
+    while (!isIdle()) {
+        m_timer.stop();
+        if (!m_process) {
+            start();
+            if (!m_process) {
+                continue;  // Failed to start, already reported
+            }
+        }
+        QProcess *process = m_process;
+        if (!process->waitForFinished(5000)) {
+            process->kill();
+            process->waitForFinished(1000);
+        }
+        if (m_process == process) {
+            onFinished(-1);  // Never reported back
+        }
+    }
+    m_timer.stop();
+}
+
+} // namespace WaveMux
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QStringList>
+#include <QTimer>
+
+class QProcess;
+
+namespace WaveMux {
+
+// Runs audio server commands without blocking the caller, for controls that
+// change many times a second (sliders). Only the latest command per key is
+// kept, and whatever is pending after a short delay goes out in a single
+// shell, so a drag costs a handful of process spawns instead of one per step.
+class CommandQueue : public QObject {
+    Q_OBJECT
+
+public:
+    static constexpr int FLUSH_DELAY_MS = 15;
+
+    explicit CommandQueue(QObject *parent = nullptr);
+    ~CommandQueue();
+
+    // Replaces any pending command with the same key
+    void enqueue(const QString &key, const QString &command);
+    bool isIdle() const { return !m_process && m_order.isEmpty(); }
+
+    // Blocks until everything queued so far has run (shutdown, tests)
+    void flush();
+
+    quint64 commandsRun() const { return m_commandsRun; }
+    quint64 commandsCoalesced() const { return m_commandsCoalesced; }
+
+private:
+    void start();
+    void onFinished(int exitCode);
+    void onFailedToStart();
+    void finishBatch();
+
+    QHash<QString, QString> m_pending;  // key -> latest command
+    QStringList m_order;                // Keys in first-queued order
+    QTimer m_timer;
+    QProcess *m_process = nullptr;      // Batch currently running
+    QElapsedTimer m_batchTimer;
+    quint64 m_commandsRun = 0;
+    quint64 m_commandsCoalesced = 0;
+};
+
+} // namespace WaveMux
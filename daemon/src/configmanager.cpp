@@ -1,6 +1,10 @@
 #include "configmanager.h"
 #include "audiomanager.h"
+#include "logging.h"
+#include "stats.h"
+#include "trace.h"
 #include <QFile>
+#include <QSaveFile>
 #include <QDir>
 #include <QJsonDocument>
 #include <QJsonObject>
@@ -8,9 +12,250 @@
 #include <QStandardPaths>
 #include <QDebug>
 #include <QTimer>
+#include <QElapsedTimer>
+#include <algorithm>
 
 namespace WaveMux {
 
+namespace {
+    QJsonArray rulesToJson(const QList<RoutingRule> &rules) {
+        QJsonArray rulesArray;
+        for (const auto &rule : rules) {
+            QJsonObject ruleObj;
+            ruleObj["pattern"] = rule.matchPattern;
+            ruleObj["channel"] = rule.targetChannel;
+            rulesArray.append(ruleObj);
+        }
+        return rulesArray;
+    }
+
+    QList<RoutingRule> rulesFromJson(const QJsonArray &rulesArray) {
+        QList<RoutingRule> rules;
+        for (const auto &ruleVal : rulesArray) {
+            QJsonObject ruleObj = ruleVal.toObject();
+            RoutingRule rule;
+            rule.matchPattern = ruleObj["pattern"].toString();
+            rule.targetChannel = ruleObj["channel"].toString();
+            rules.append(rule);
+        }
+        return rules;
+    }
+
+    QJsonObject channelToJson(const Channel &ch) {
+        QJsonObject chObj;
+        chObj["id"] = ch.id;
+        chObj["volume"] = ch.volume;
+        chObj["muted"] = ch.muted;
+        chObj["personalVolume"] = ch.personalVolume;
+        chObj["streamVolume"] = ch.streamVolume;
+        return chObj;
+    }
+
+    Channel channelFromJson(const QJsonObject &chObj) {
+        Channel ch;
+        ch.id = chObj["id"].toString();
+        ch.volume = chObj["volume"].toInt(100);
+        ch.muted = chObj["muted"].toBool(false);
+        ch.personalVolume = chObj["personalVolume"].toInt(100);
+        ch.streamVolume = chObj["streamVolume"].toInt(0);
+        return ch;
+    }
+
+    QJsonObject duckingToJson(const DuckingConfig &ducking) {
+        QJsonObject obj;
+        obj["enabled"] = ducking.settings.enabled;
+        obj["trigger"] = ducking.triggerChannel;
+        obj["targets"] = QJsonArray::fromStringList(ducking.targetChannels);
+        obj["depthDb"] = ducking.settings.depthDb;
+        obj["thresholdDb"] = ducking.settings.thresholdDb;
+        obj["attackMs"] = ducking.settings.attackMs;
+        obj["releaseMs"] = ducking.settings.releaseMs;
+        return obj;
+    }
+
+    DuckingConfig duckingFromJson(const QJsonObject &obj) {
+        DuckingConfig ducking;
+        ducking.settings.enabled = obj["enabled"].toBool(false);
+        ducking.triggerChannel = obj["trigger"].toString(ducking.triggerChannel);
+        if (obj.contains("targets")) {
+            ducking.targetChannels.clear();
+            for (const auto &target : obj["targets"].toArray()) {
+                ducking.targetChannels.append(target.toString());
+            }
+        }
+        ducking.settings.depthDb = obj["depthDb"].toDouble(ducking.settings.depthDb);
+        ducking.settings.thresholdDb = obj["thresholdDb"].toDouble(ducking.settings.thresholdDb);
+        ducking.settings.attackMs = obj["attackMs"].toDouble(ducking.settings.attackMs);
+        ducking.settings.releaseMs = obj["releaseMs"].toDouble(ducking.settings.releaseMs);
+        return ducking;
+    }
+
+    QJsonArray eqToJson(const QList<EqBand> &bands) {
+        QJsonArray array;
+        for (const auto &band : bands) {
+            QJsonObject obj;
+            obj["type"] = eqBandTypeName(band.type);
+            obj["enabled"] = band.enabled;
+            obj["frequency"] = band.frequency;
+            obj["gainDb"] = band.gainDb;
+            obj["q"] = band.q;
+            array.append(obj);
+        }
+        return array;
+    }
+
+    QList<EqBand> eqFromJson(const QJsonArray &array) {
+        QList<EqBand> bands;
+        for (const auto &value : array) {
+            QJsonObject obj = value.toObject();
+            EqBand band;
+            const auto type = eqBandTypeFromName(obj["type"].toString().toStdString());
+            if (!type) {
+                continue;  // Written by a newer version
+            }
+            band.type = *type;
+            band.enabled = obj["enabled"].toBool(true);
+            band.frequency = obj["frequency"].toDouble(band.frequency);
+            band.gainDb = obj["gainDb"].toDouble(band.gainDb);
+            band.q = obj["q"].toDouble(band.q);
+            bands.append(band);
+        }
+        return bands;
+    }
+
+    QJsonObject micToJson(const MicConfig &mic) {
+        QJsonObject gate;
+        gate["enabled"] = mic.gate.enabled;
+        gate["thresholdDb"] = mic.gate.thresholdDb;
+        gate["hysteresisDb"] = mic.gate.hysteresisDb;
+        gate["rangeDb"] = mic.gate.rangeDb;
+        gate["attackMs"] = mic.gate.attackMs;
+        gate["holdMs"] = mic.gate.holdMs;
+        gate["releaseMs"] = mic.gate.releaseMs;
+
+        QJsonObject obj;
+        obj["source"] = mic.source;
+        obj["suppression"] = mic.suppression;
+        obj["gate"] = gate;
+        return obj;
+    }
+
+    MicConfig micFromJson(const QJsonObject &obj) {
+        MicConfig mic;
+        mic.source = obj["source"].toString();
+        mic.suppression = obj["suppression"].toBool(false);
+        QJsonObject gate = obj["gate"].toObject();
+        mic.gate.enabled = gate["enabled"].toBool(mic.gate.enabled);
+        mic.gate.thresholdDb = gate["thresholdDb"].toDouble(mic.gate.thresholdDb);
+        mic.gate.hysteresisDb = gate["hysteresisDb"].toDouble(mic.gate.hysteresisDb);
+        mic.gate.rangeDb = gate["rangeDb"].toDouble(mic.gate.rangeDb);
+        mic.gate.attackMs = gate["attackMs"].toDouble(mic.gate.attackMs);
+        mic.gate.holdMs = gate["holdMs"].toDouble(mic.gate.holdMs);
+        mic.gate.releaseMs = gate["releaseMs"].toDouble(mic.gate.releaseMs);
+        return mic;
+    }
+
+    QJsonObject limiterToJson(const LimiterSettings &limiter) {
+        QJsonObject obj;
+        obj["enabled"] = limiter.enabled;
+        obj["ceilingDb"] = limiter.ceilingDb;
+        obj["releaseMs"] = limiter.releaseMs;
+        return obj;
+    }
+
+    LimiterSettings limiterFromJson(const QJsonObject &obj) {
+        LimiterSettings limiter;
+        limiter.enabled = obj["enabled"].toBool(false);
+        limiter.ceilingDb = obj["ceilingDb"].toDouble(limiter.ceilingDb);
+        limiter.releaseMs = obj["releaseMs"].toDouble(limiter.releaseMs);
+        return limiter;
+    }
+
+    QJsonObject loudnessToJson(const LoudnessSettings &loudness) {
+        QJsonObject obj;
+        obj["enabled"] = loudness.enabled;
+        obj["targetLufs"] = loudness.targetLufs;
+        obj["maxGainDb"] = loudness.maxGainDb;
+        return obj;
+    }
+
+    LoudnessSettings loudnessFromJson(const QJsonObject &obj) {
+        LoudnessSettings loudness;
+        loudness.enabled = obj["enabled"].toBool(false);
+        loudness.targetLufs = obj["targetLufs"].toDouble(loudness.targetLufs);
+        loudness.maxGainDb = obj["maxGainDb"].toDouble(loudness.maxGainDb);
+        return loudness;
+    }
+
+    QJsonObject appVolumesToJson(const QHash<QString, AppVolume> &volumes) {
+        QJsonObject obj;
+        for (auto it = volumes.constBegin(); it != volumes.constEnd(); ++it) {
+            QJsonObject level;
+            level["volume"] = it->volume;
+            level["muted"] = it->muted;
+            obj[it.key()] = level;
+        }
+        return obj;
+    }
+
+    QHash<QString, AppVolume> appVolumesFromJson(const QJsonObject &obj) {
+        QHash<QString, AppVolume> volumes;
+        for (auto it = obj.begin(); it != obj.end(); ++it) {
+            QJsonObject level = it.value().toObject();
+            AppVolume volume;
+            volume.volume = qBound(0, level["volume"].toInt(100), 100);
+            volume.muted = level["muted"].toBool(false);
+            volumes[it.key()] = volume;
+        }
+        return volumes;
+    }
+
+    QJsonObject replayToJson(const ReplaySettings &replay) {
+        QJsonObject obj;
+        obj["enabled"] = replay.enabled;
+        obj["seconds"] = replay.seconds;
+        obj["channels"] = replay.channels;
+        obj["compact"] = replay.compact;
+        return obj;
+    }
+
+    ReplaySettings replayFromJson(const QJsonObject &obj) {
+        ReplaySettings replay;
+        replay.enabled = obj["enabled"].toBool(false);
+        replay.seconds = obj["seconds"].toInt(replay.seconds);
+        replay.channels = obj["channels"].toBool(replay.channels);
+        replay.compact = obj["compact"].toBool(replay.compact);
+        return replay;
+    }
+
+    // {"adaptive": {mixId: bool}, "devices": {deviceId: ms}}
+    QJsonObject latencyToJson(AudioManager *manager) {
+        QJsonObject adaptive;
+        for (const QString mixId : {"personal", "stream"}) {
+            adaptive[mixId] = manager->isAdaptiveLatency(mixId);
+        }
+        QJsonObject devices;
+        const QHash<QString, int> latencies = manager->getDeviceLatencies();
+        for (auto it = latencies.constBegin(); it != latencies.constEnd(); ++it) {
+            devices[it.key()] = it.value();
+        }
+        QJsonObject obj;
+        obj["adaptive"] = adaptive;
+        obj["devices"] = devices;
+        return obj;
+    }
+
+    QStringList stringsFromJson(const QJsonArray &array) {
+        QStringList strings;
+        for (const auto &value : array) {
+            if (!value.toString().isEmpty()) {
+                strings.append(value.toString());
+            }
+        }
+        return strings;
+    }
+}
+
 ConfigManager::ConfigManager(AudioManager *manager, QObject *parent)
     : QObject(parent)
     , m_manager(manager)
@@ -20,6 +265,13 @@ ConfigManager::ConfigManager(AudioManager *manager, QObject *parent)
     m_saveTimer->setSingleShot(true);
     m_saveTimer->setInterval(2000);
     connect(m_saveTimer, &QTimer::timeout, this, &ConfigManager::save);
+
+    // Continuous changes (e.g. a long fader drag) keep restarting the debounce
+    // timer, so also force a save at most 10 seconds after the first change
+    m_maxDelayTimer = new QTimer(this);
+    m_maxDelayTimer->setSingleShot(true);
+    m_maxDelayTimer->setInterval(10000);
+    connect(m_maxDelayTimer, &QTimer::timeout, this, &ConfigManager::save);
 }
 
 void ConfigManager::connectAutoSave() {
@@ -27,7 +279,15 @@ void ConfigManager::connectAutoSave() {
     connect(m_manager, &AudioManager::channelsChanged, this, &ConfigManager::onSettingsChanged);
     connect(m_manager, &AudioManager::masterVolumeChanged, this, &ConfigManager::onSettingsChanged);
     connect(m_manager, &AudioManager::routingRulesChanged, this, &ConfigManager::onSettingsChanged);
-    qInfo() << "Auto-save connected";
+    connect(m_manager, &AudioManager::mixesChanged, this, &ConfigManager::onSettingsChanged);
+    connect(m_manager, &AudioManager::processingChanged, this, &ConfigManager::onSettingsChanged);
+    connect(m_manager, &AudioManager::equalizerChanged, this, &ConfigManager::onSettingsChanged);
+    connect(m_manager, &AudioManager::micChanged, this, &ConfigManager::onSettingsChanged);
+    connect(m_manager, &AudioManager::replayChanged, this, &ConfigManager::onSettingsChanged);
+    connect(m_manager, &AudioManager::latencyChanged, this, &ConfigManager::onSettingsChanged);
+    connect(m_manager, &AudioManager::appVolumesChanged, this, &ConfigManager::onSettingsChanged);
+    connect(m_manager, &AudioManager::snapshotApplied, this, &ConfigManager::onSettingsChanged);
+    qCInfo(lcConfig) << "Auto-save connected";
 }
 
 void ConfigManager::onSettingsChanged() {
@@ -37,8 +297,19 @@ void ConfigManager::onSettingsChanged() {
 }
 
 void ConfigManager::scheduleSave() {
+    m_dirty = true;
     // Restart the timer - this debounces rapid changes
     m_saveTimer->start();
+    if (!m_maxDelayTimer->isActive()) {
+        m_maxDelayTimer->start();
+    }
+}
+
+bool ConfigManager::flush() {
+    if (!m_dirty) {
+        return true;
+    }
+    return save();
 }
 
 QString ConfigManager::configPath() const {
@@ -47,27 +318,29 @@ QString ConfigManager::configPath() const {
 }
 
 bool ConfigManager::load() {
+    const TraceSpan span("config", "load");
     QString path = configPath();
     QFile file(path);
 
     if (!file.exists()) {
-        qInfo() << "No config file found at" << path;
+        qCInfo(lcConfig) << "No config file found at" << path;
         return false;
     }
 
     if (!file.open(QIODevice::ReadOnly)) {
-        qWarning() << "Failed to open config file:" << path;
+        qCWarning(lcConfig) << "Failed to open config file:" << path;
         return false;
     }
 
     QByteArray data = file.readAll();
     file.close();
+    m_lastSaved = data;
 
     QJsonParseError error;
     QJsonDocument doc = QJsonDocument::fromJson(data, &error);
 
     if (error.error != QJsonParseError::NoError) {
-        qWarning() << "Failed to parse config:" << error.errorString();
+        qCWarning(lcConfig) << "Failed to parse config:" << error.errorString();
         return false;
     }
 
@@ -76,35 +349,86 @@ bool ConfigManager::load() {
     m_config.setupComplete = root["setupComplete"].toBool(false);
     m_config.outputDevice = root["outputDevice"].toString();
     m_config.streamOutputDevice = root["streamOutputDevice"].toString();
+    m_config.outputFallbacks = stringsFromJson(root["outputFallbacks"].toArray());
+    m_config.streamOutputFallbacks = stringsFromJson(root["streamOutputFallbacks"].toArray());
     m_config.streamEnabled = root["streamEnabled"].toBool(false);
 
     // Load routing rules
-    m_config.routingRules.clear();
-    QJsonArray rulesArray = root["routingRules"].toArray();
-    for (const auto &ruleVal : rulesArray) {
-        QJsonObject ruleObj = ruleVal.toObject();
-        RoutingRule rule;
-        rule.matchPattern = ruleObj["pattern"].toString();
-        rule.targetChannel = ruleObj["channel"].toString();
-        m_config.routingRules.append(rule);
-    }
+    m_config.routingRules = rulesFromJson(root["routingRules"].toArray());
 
     m_channelStates.clear();
     QJsonArray channelsArray = root["channels"].toArray();
     for (const auto &chVal : channelsArray) {
-        QJsonObject chObj = chVal.toObject();
-        QString channelId = chObj["id"].toString();
+        Channel ch = channelFromJson(chVal.toObject());
         ChannelConfig chConfig;
-        chConfig.volume = chObj["volume"].toInt(100);
-        chConfig.muted = chObj["muted"].toBool(false);
-        chConfig.personalVolume = chObj["personalVolume"].toInt(100);
-        chConfig.streamVolume = chObj["streamVolume"].toInt(0);
-        m_channelStates[channelId] = chConfig;
+        chConfig.eq = eqFromJson(chVal.toObject()["eq"].toArray());
+        chConfig.volume = ch.volume;
+        chConfig.muted = ch.muted;
+        chConfig.personalVolume = ch.personalVolume;
+        chConfig.streamVolume = ch.streamVolume;
+        m_channelStates[ch.id] = chConfig;
+    }
+
+    // Load profiles
+    m_config.profiles.clear();
+    QJsonArray profilesArray = root["profiles"].toArray();
+    for (const auto &profileVal : profilesArray) {
+        QJsonObject profileObj = profileVal.toObject();
+        Profile profile;
+        profile.name = profileObj["name"].toString();
+        if (profile.name.isEmpty()) {
+            continue;
+        }
+        for (const auto &chVal : profileObj["channels"].toArray()) {
+            profile.channels.append(channelFromJson(chVal.toObject()));
+        }
+        profile.rules = rulesFromJson(profileObj["routingRules"].toArray());
+        m_config.profiles.append(profile);
     }
+    m_config.activeProfile = root["activeProfile"].toString();
 
     m_masterVolume = root["masterVolume"].toInt(100);
 
-    qInfo() << "Loaded config with" << m_channelStates.size() << "channels," << m_config.routingRules.size() << "rules";
+    m_ducking.clear();
+    QJsonObject duckingObj = root["ducking"].toObject();
+    for (auto it = duckingObj.begin(); it != duckingObj.end(); ++it) {
+        m_ducking[it.key()] = duckingFromJson(it.value().toObject());
+    }
+    m_mic = micFromJson(root["mic"].toObject());
+    m_limiters.clear();
+    QJsonObject limiterObj = root["limiter"].toObject();
+    for (auto it = limiterObj.begin(); it != limiterObj.end(); ++it) {
+        m_limiters[it.key()] = limiterFromJson(it.value().toObject());
+    }
+    m_loudness.clear();
+    QJsonObject loudnessObj = root["loudness"].toObject();
+    for (auto it = loudnessObj.begin(); it != loudnessObj.end(); ++it) {
+        m_loudness[it.key()] = loudnessFromJson(it.value().toObject());
+    }
+    m_delays.clear();
+    QJsonObject delaysObj = root["delays"].toObject();
+    for (auto it = delaysObj.begin(); it != delaysObj.end(); ++it) {
+        const QJsonObject mixObj = it.value().toObject();
+        for (auto ch = mixObj.begin(); ch != mixObj.end(); ++ch) {
+            m_delays[it.key()][ch.key()] = ch.value().toDouble();
+        }
+    }
+    m_replay = replayFromJson(root["replay"].toObject());
+    const QJsonObject latencyObj = root["latency"].toObject();
+    m_adaptiveLatency.clear();
+    const QJsonObject adaptiveObj = latencyObj["adaptive"].toObject();
+    for (auto it = adaptiveObj.begin(); it != adaptiveObj.end(); ++it) {
+        m_adaptiveLatency[it.key()] = it.value().toBool();
+    }
+    m_deviceLatencies.clear();
+    const QJsonObject devicesObj = latencyObj["devices"].toObject();
+    for (auto it = devicesObj.begin(); it != devicesObj.end(); ++it) {
+        m_deviceLatencies[it.key()] = it.value().toInt(AudioManager::DEFAULT_LOOPBACK_LATENCY_MS);
+    }
+    m_appVolumes = appVolumesFromJson(root["appVolumes"].toObject());
+
+    qCInfo(lcConfig) << "Loaded config with" << m_channelStates.size() << "channels," << m_config.routingRules.size() << "rules,"
+            << m_config.profiles.size() << "profiles";
 
     // Prevent auto-save during config application
     m_loading = true;
@@ -117,12 +441,14 @@ bool ConfigManager::load() {
 }
 
 bool ConfigManager::save() {
+    const ScopedTimer timer(Stats::histogram("config.save"));
+    const TraceSpan span("config", "save");
     QString path = configPath();
 
     // Don't save if channels are empty (likely called after shutdown)
     auto channels = m_manager->listChannels();
     if (channels.isEmpty()) {
-        qWarning() << "Skipping save - no channels (daemon likely shutting down)";
+        qCWarning(lcConfig) << "Skipping save - no channels (daemon likely shutting down)";
         return false;
     }
 
@@ -135,6 +461,8 @@ bool ConfigManager::save() {
     // Gather current state from AudioManager
     m_config.outputDevice = m_manager->getOutputDevice();
     m_config.streamOutputDevice = m_manager->getStreamOutputDevice();
+    m_config.outputFallbacks = m_manager->getOutputFallbacks("personal");
+    m_config.streamOutputFallbacks = m_manager->getOutputFallbacks("stream");
     m_config.streamEnabled = m_manager->isStreamEnabled();
     m_config.routingRules = m_manager->getRoutingRules();
 
@@ -142,45 +470,96 @@ bool ConfigManager::save() {
     root["setupComplete"] = m_config.setupComplete;
     root["outputDevice"] = m_config.outputDevice;
     root["streamOutputDevice"] = m_config.streamOutputDevice;
+    root["outputFallbacks"] = QJsonArray::fromStringList(m_config.outputFallbacks);
+    root["streamOutputFallbacks"] = QJsonArray::fromStringList(m_config.streamOutputFallbacks);
     root["streamEnabled"] = m_config.streamEnabled;
 
     // Save routing rules
-    QJsonArray rulesArray;
-    for (const auto &rule : m_config.routingRules) {
-        QJsonObject ruleObj;
-        ruleObj["pattern"] = rule.matchPattern;
-        ruleObj["channel"] = rule.targetChannel;
-        rulesArray.append(ruleObj);
+    root["routingRules"] = rulesToJson(m_config.routingRules);
+
+    // Save mix processing
+    QJsonObject duckingObj;
+    QJsonObject limiterObj;
+    QJsonObject loudnessObj;
+    QJsonObject delaysObj;
+    for (const QString mixId : {"personal", "stream"}) {
+        duckingObj[mixId] = duckingToJson(m_manager->getDucking(mixId));
+        limiterObj[mixId] = limiterToJson(m_manager->getLimiter(mixId));
+        loudnessObj[mixId] = loudnessToJson(m_manager->getLoudness(mixId));
+        const QHash<QString, double> delays = m_manager->getChannelDelays(mixId);
+        QJsonObject mixDelays;
+        for (auto it = delays.constBegin(); it != delays.constEnd(); ++it) {
+            mixDelays[it.key()] = it.value();
+        }
+        delaysObj[mixId] = mixDelays;
     }
-    root["routingRules"] = rulesArray;
+    root["ducking"] = duckingObj;
+    root["limiter"] = limiterObj;
+    root["loudness"] = loudnessObj;
+    root["delays"] = delaysObj;
+    root["mic"] = micToJson(m_manager->getMic());
+    root["replay"] = replayToJson(m_manager->getReplay());
+    root["latency"] = latencyToJson(m_manager);
+    root["appVolumes"] = appVolumesToJson(m_manager->getAppVolumes());
 
     // Save channel states
     QJsonArray channelsArray;
     for (const auto &ch : channels) {
-        QJsonObject chObj;
-        chObj["id"] = ch.id;
-        chObj["volume"] = ch.volume;
-        chObj["muted"] = ch.muted;
-        chObj["personalVolume"] = ch.personalVolume;
-        chObj["streamVolume"] = ch.streamVolume;
+        QJsonObject chObj = channelToJson(ch);
+        const QList<EqBand> eq = m_manager->getChannelEq(ch.id);
+        if (!eq.isEmpty()) {
+            chObj["eq"] = eqToJson(eq);
+        }
         channelsArray.append(chObj);
     }
     root["channels"] = channelsArray;
 
+    // Save profiles
+    QJsonArray profilesArray;
+    for (const auto &profile : m_config.profiles) {
+        QJsonObject profileObj;
+        profileObj["name"] = profile.name;
+        QJsonArray profileChannels;
+        for (const auto &ch : profile.channels) {
+            profileChannels.append(channelToJson(ch));
+        }
+        profileObj["channels"] = profileChannels;
+        profileObj["routingRules"] = rulesToJson(profile.rules);
+        profilesArray.append(profileObj);
+    }
+    root["profiles"] = profilesArray;
+    root["activeProfile"] = m_config.activeProfile;
+
     root["masterVolume"] = m_manager->getMasterVolume();
 
-    QJsonDocument doc(root);
-    QFile file(path);
+    m_saveTimer->stop();
+    m_maxDelayTimer->stop();
 
+    QByteArray data = QJsonDocument(root).toJson(QJsonDocument::Indented);
+    if (data == m_lastSaved && QFile::exists(path)) {
+        qCDebug(lcConfig) << "Config unchanged, skipping write";
+        m_dirty = false;
+        return true;
+    }
+
+    // QSaveFile writes to a temporary file, syncs it and renames it over the
+    // old config on commit(), so a crash mid-write never leaves a truncated file
+    QSaveFile file(path);
     if (!file.open(QIODevice::WriteOnly)) {
-        qWarning() << "Failed to write config file:" << path;
+        qCWarning(lcConfig) << "Failed to write config file:" << path;
         return false;
     }
 
-    file.write(doc.toJson(QJsonDocument::Indented));
-    file.close();
+    file.write(data);
+    if (!file.commit()) {
+        qCWarning(lcConfig) << "Failed to commit config file:" << path << file.errorString();
+        return false;
+    }
 
-    qInfo() << "Saved config to" << path;
+    m_lastSaved = data;
+    m_dirty = false;
+    qCInfo(lcConfig) << "Saved config to" << path;
+    EventLog::record(EventLog::Code::ConfigSaved);
     return true;
 }
 
@@ -190,45 +569,145 @@ void ConfigManager::setSetupComplete(bool complete) {
     emit configChanged();
 }
 
-void ConfigManager::applyConfig() {
-    // Apply channel states first (before setting up loopbacks)
-    for (auto it = m_channelStates.begin(); it != m_channelStates.end(); ++it) {
-        const QString &channelId = it.key();
-        const ChannelConfig &chConfig = it.value();
+bool ConfigManager::saveProfile(const QString &name) {
+    if (name.trimmed().isEmpty()) {
+        return false;
+    }
 
-        m_manager->setChannelVolume(channelId, chConfig.volume);
-        m_manager->setChannelMute(channelId, chConfig.muted);
-        // Set mix volumes (loopbacks will be created when output devices are set)
-        m_manager->setChannelPersonalVolume(channelId, chConfig.personalVolume);
-        m_manager->setChannelStreamVolume(channelId, chConfig.streamVolume);
+    // Capture the current mixer state under this name (replacing any existing profile)
+    Profile profile;
+    profile.name = name.trimmed();
+    profile.channels = m_manager->listChannels();
+    profile.rules = m_manager->getRoutingRules();
+
+    bool replaced = false;
+    for (auto &existing : m_config.profiles) {
+        if (existing.name == profile.name) {
+            existing = profile;
+            replaced = true;
+            break;
+        }
+    }
+    if (!replaced) {
+        m_config.profiles.append(profile);
     }
 
-    // Apply master volume
-    m_manager->setMasterVolume(m_masterVolume);
+    qCInfo(lcConfig) << (replaced ? "Updated profile:" : "Saved profile:") << profile.name;
+    m_config.activeProfile = profile.name;
+    scheduleSave();
+    emit profilesChanged();
+    emit activeProfileChanged(m_config.activeProfile);
+    return true;
+}
 
-    // Apply output device (this creates personal loopbacks)
-    if (!m_config.outputDevice.isEmpty()) {
-        m_manager->setOutputDevice(m_config.outputDevice);
+bool ConfigManager::deleteProfile(const QString &name) {
+    int sizeBefore = m_config.profiles.size();
+    m_config.profiles.erase(
+        std::remove_if(m_config.profiles.begin(), m_config.profiles.end(),
+            [&name](const Profile &profile) {
+                return profile.name == name;
+            }),
+        m_config.profiles.end());
+
+    if (m_config.profiles.size() == sizeBefore) {
+        return false;
     }
 
-    // Apply stream output device
-    if (!m_config.streamOutputDevice.isEmpty()) {
-        m_manager->setStreamOutputDevice(m_config.streamOutputDevice);
+    qCInfo(lcConfig) << "Deleted profile:" << name;
+    if (m_config.activeProfile == name) {
+        m_config.activeProfile.clear();
+        emit activeProfileChanged(m_config.activeProfile);
     }
+    scheduleSave();
+    emit profilesChanged();
+    return true;
+}
 
-    // Apply stream enabled state (this creates stream loopbacks)
-    m_manager->setStreamEnabled(m_config.streamEnabled);
+bool ConfigManager::switchProfile(const QString &name) {
+    const TraceSpan span("config", "switchProfile");
+    for (const auto &profile : m_config.profiles) {
+        if (profile.name != name) {
+            continue;
+        }
 
-    // Apply routing rules
-    for (const auto &rule : m_config.routingRules) {
-        m_manager->addRoutingRule(rule.matchPattern, rule.targetChannel);
+        bool result = m_manager->applyProfile(profile);
+        m_config.activeProfile = name;
+        scheduleSave();
+        emit activeProfileChanged(name);
+        return result;
     }
 
-    // Re-apply routing rules to existing streams (they were moved to silent sink
-    // before config was loaded)
-    m_manager->applyRoutingRulesToExistingStreams();
+    qCWarning(lcConfig) << "Unknown profile:" << name;
+    return false;
+}
+
+void ConfigManager::applyConfig() {
+    const TraceSpan span("config", "applyConfig");
+    // Stage the whole saved state and hand it over as one transaction: channel
+    // levels, master, devices, stream mode, rules and every mix's processing
+    // and latency settings are applied together, so each mix is rebuilt at
+    // most once, at its final level and in its final mode, and a single
+    // change is emitted.
+    MixerSnapshot snapshot = m_manager->snapshot();
+    for (auto &channel : snapshot.channels) {
+        auto it = m_channelStates.constFind(channel.id);
+        if (it == m_channelStates.constEnd()) {
+            continue;
+        }
+        channel.volume = it->volume;
+        channel.muted = it->muted;
+        channel.personalVolume = it->personalVolume;
+        channel.streamVolume = it->streamVolume;
+    }
+    // The mic is only listed while a source is set, which may come with this config
+    const bool micListed = std::any_of(snapshot.channels.cbegin(), snapshot.channels.cend(),
+                                       [](const Channel &channel) { return channel.id == "mic"; });
+    auto mic = m_channelStates.constFind("mic");
+    if (mic != m_channelStates.constEnd() && !micListed) {
+        Channel channel;
+        channel.id = "mic";
+        channel.volume = mic->volume;
+        channel.muted = mic->muted;
+        channel.personalVolume = mic->personalVolume;
+        channel.streamVolume = mic->streamVolume;
+        snapshot.channels.append(channel);
+    }
+    snapshot.masterVolume = m_masterVolume;
+    if (!m_config.outputDevice.isEmpty()) {
+        snapshot.outputDevice = m_config.outputDevice;
+    }
+    if (!m_config.streamOutputDevice.isEmpty()) {
+        snapshot.streamOutputDevice = m_config.streamOutputDevice;
+    }
+    snapshot.outputFallbacks = m_config.outputFallbacks;
+    snapshot.streamOutputFallbacks = m_config.streamOutputFallbacks;
+    snapshot.streamEnabled = m_config.streamEnabled;
+    snapshot.routingRules = m_config.routingRules;
+
+    for (const QString mixId : {"personal", "stream"}) {
+        MixSettings &mix = mixId == "stream" ? snapshot.stream : snapshot.personal;
+        mix.ducking = m_ducking.value(mixId, mix.ducking);
+        mix.limiter = m_limiters.value(mixId, mix.limiter);
+        mix.loudness = m_loudness.value(mixId, mix.loudness);
+        mix.delaysMs = m_delays.value(mixId, mix.delaysMs);
+        mix.adaptiveLatency = m_adaptiveLatency.value(mixId, mix.adaptiveLatency);
+    }
+    for (auto it = m_channelStates.constBegin(); it != m_channelStates.constEnd(); ++it) {
+        if (it.key() != "mic") {
+            snapshot.channelEq[it.key()] = it->eq;
+        }
+    }
+    snapshot.mic = m_mic;
+    snapshot.deviceLatencies = m_deviceLatencies;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    m_manager->setReplay(m_replay);
+    m_manager->setAppVolumes(m_appVolumes);
+    m_manager->applySnapshot(snapshot);
 
-    qInfo() << "Applied config: outputDevice=" << m_config.outputDevice
+    qCInfo(lcConfig) << "Applied config in" << timer.elapsed() << "ms: outputDevice=" << m_config.outputDevice
             << "streamOutputDevice=" << m_config.streamOutputDevice
             << "streamEnabled=" << m_config.streamEnabled
             << "channels=" << m_channelStates.size()
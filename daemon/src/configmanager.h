@@ -5,16 +5,16 @@
 #include <QHash>
 #include <QTimer>
 #include "wavemux/types.h"
+#include "audiomanager.h"
 
 namespace WaveMux {
 
-class AudioManager;
-
 struct ChannelConfig {
     int volume = 100;
     bool muted = false;
     int personalVolume = 100;
     int streamVolume = 0;
+    QList<EqBand> eq;
 };
 
 class ConfigManager : public QObject {
@@ -25,17 +25,29 @@ public:
 
     bool load();
     bool save();
+    // Write pending changes immediately (used on shutdown); no-op if nothing changed
+    bool flush();
+    bool hasPendingChanges() const { return m_dirty; }
 
     bool isSetupComplete() const { return m_config.setupComplete; }
     void setSetupComplete(bool complete);
 
     QString configPath() const;
 
+    // Profiles
+    QList<Profile> profiles() const { return m_config.profiles; }
+    QString activeProfile() const { return m_config.activeProfile; }
+    bool saveProfile(const QString &name);
+    bool deleteProfile(const QString &name);
+    bool switchProfile(const QString &name);
+
     // Call this after AudioManager is initialized to connect auto-save signals
     void connectAutoSave();
 
 signals:
     void configChanged();
+    void profilesChanged();
+    void activeProfileChanged(const QString &name);
 
 private slots:
     void onSettingsChanged();
@@ -48,7 +60,19 @@ private:
     Config m_config;
     QHash<QString, ChannelConfig> m_channelStates;
     int m_masterVolume = 100;
+    QHash<QString, DuckingConfig> m_ducking;  // mixId -> settings
+    QHash<QString, LimiterSettings> m_limiters;
+    QHash<QString, LoudnessSettings> m_loudness;
+    QHash<QString, QHash<QString, double>> m_delays;  // mixId -> channelId -> ms
+    MicConfig m_mic;
+    ReplaySettings m_replay;
+    QHash<QString, bool> m_adaptiveLatency;  // mixId -> adaptive loopback latency
+    QHash<QString, int> m_deviceLatencies;   // Output device -> learned latency (ms)
+    QHash<QString, AppVolume> m_appVolumes;  // app key -> level within its channel
     QTimer *m_saveTimer = nullptr;
+    QTimer *m_maxDelayTimer = nullptr;  // Caps how long a stream of changes can defer a save
+    QByteArray m_lastSaved;             // Last bytes written, to skip no-op rewrites
+    bool m_dirty = false;
     bool m_loading = false;  // Prevent save during load
 };
 
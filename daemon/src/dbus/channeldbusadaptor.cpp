@@ -1,5 +1,6 @@
 #include "channeldbusadaptor.h"
 #include "../audiomanager.h"
+#include "../stats.h"
 
 namespace WaveMux {
 
@@ -12,6 +13,7 @@ ChannelDBusAdaptor::ChannelDBusAdaptor(AudioManager *manager)
 }
 
 QVariantList ChannelDBusAdaptor::ListChannels() {
+    WAVEMUX_TIME_DBUS_CALL();
     QVariantList result;
     for (const auto &ch : m_manager->listChannels()) {
         QVariantMap map;
@@ -28,18 +30,22 @@ QVariantList ChannelDBusAdaptor::ListChannels() {
 }
 
 bool ChannelDBusAdaptor::SetChannelVolume(const QString &channelId, int volume) {
+    WAVEMUX_TIME_DBUS_CALL();
     return m_manager->setChannelVolume(channelId, volume);
 }
 
 bool ChannelDBusAdaptor::SetChannelMute(const QString &channelId, bool muted) {
+    WAVEMUX_TIME_DBUS_CALL();
     return m_manager->setChannelMute(channelId, muted);
 }
 
 bool ChannelDBusAdaptor::SetChannelPersonalVolume(const QString &channelId, int volume) {
+    WAVEMUX_TIME_DBUS_CALL();
     return m_manager->setChannelPersonalVolume(channelId, volume);
 }
 
 bool ChannelDBusAdaptor::SetChannelStreamVolume(const QString &channelId, int volume) {
+    WAVEMUX_TIME_DBUS_CALL();
     return m_manager->setChannelStreamVolume(channelId, volume);
 }
 
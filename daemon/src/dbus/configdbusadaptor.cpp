@@ -1,5 +1,6 @@
 #include "configdbusadaptor.h"
 #include "../audiomanager.h"
+#include "../stats.h"
 #include "../configmanager.h"
 
 namespace WaveMux {
@@ -11,33 +12,53 @@ ConfigDBusAdaptor::ConfigDBusAdaptor(AudioManager *manager, ConfigManager *confi
 {
     connect(m_manager, &AudioManager::error,
             this, &ConfigDBusAdaptor::Error);
+    connect(m_manager, &AudioManager::snapshotApplied,
+            this, &ConfigDBusAdaptor::ConfigApplied);
+    connect(m_manager, &AudioManager::initialized,
+            this, [this](bool success) {
+                if (success) {
+                    emit Ready();
+                }
+            });
 }
 
 bool ConfigDBusAdaptor::SetMasterVolume(int volume) {
+    WAVEMUX_TIME_DBUS_CALL();
     return m_manager->setMasterVolume(volume);
 }
 
 int ConfigDBusAdaptor::GetMasterVolume() {
+    WAVEMUX_TIME_DBUS_CALL();
     return m_manager->getMasterVolume();
 }
 
 bool ConfigDBusAdaptor::IsSetupComplete() {
+    WAVEMUX_TIME_DBUS_CALL();
     return m_config->isSetupComplete();
 }
 
 void ConfigDBusAdaptor::SetSetupComplete(bool complete) {
+    WAVEMUX_TIME_DBUS_CALL();
     m_config->setSetupComplete(complete);
 }
 
 void ConfigDBusAdaptor::SaveConfig() {
+    WAVEMUX_TIME_DBUS_CALL();
     m_config->save();
 }
 
 void ConfigDBusAdaptor::LoadConfig() {
+    WAVEMUX_TIME_DBUS_CALL();
     m_config->load();
 }
 
+bool ConfigDBusAdaptor::IsReady() {
+    WAVEMUX_TIME_DBUS_CALL();
+    return m_manager->isInitialized();
+}
+
 bool ConfigDBusAdaptor::SetStreamEnabled(bool enabled) {
+    WAVEMUX_TIME_DBUS_CALL();
     bool result = m_manager->setStreamEnabled(enabled);
     if (result) {
         emit StreamEnabledChanged(enabled);
@@ -46,6 +67,7 @@ bool ConfigDBusAdaptor::SetStreamEnabled(bool enabled) {
 }
 
 bool ConfigDBusAdaptor::IsStreamEnabled() {
+    WAVEMUX_TIME_DBUS_CALL();
     return m_manager->isStreamEnabled();
 }
 
@@ -31,9 +31,14 @@ public slots:
     void SaveConfig();
     void LoadConfig();
 
+    // Startup (the daemon answers on the bus before the audio graph exists)
+    bool IsReady();
+
 signals:
     void Error(const QString &message);
     void StreamEnabledChanged(bool enabled);
+    void ConfigApplied();  // A whole snapshot (config load, profile switch) was applied
+    void Ready();          // Background initialization finished; channels are live
 
 private:
     AudioManager *m_manager;
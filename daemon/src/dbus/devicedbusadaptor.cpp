@@ -1,5 +1,6 @@
 #include "devicedbusadaptor.h"
 #include "../audiomanager.h"
+#include "../stats.h"
 
 namespace WaveMux {
 
@@ -7,9 +8,14 @@ DeviceDBusAdaptor::DeviceDBusAdaptor(AudioManager *manager)
     : QDBusAbstractAdaptor(manager)
     , m_manager(manager)
 {
+    connect(m_manager, &AudioManager::devicesChanged,
+            this, &DeviceDBusAdaptor::DevicesChanged);
+    connect(m_manager, &AudioManager::activeOutputDeviceChanged,
+            this, &DeviceDBusAdaptor::ActiveOutputDeviceChanged);
 }
 
 QVariantList DeviceDBusAdaptor::ListOutputDevices() {
+    WAVEMUX_TIME_DBUS_CALL();
     QVariantList result;
     for (const auto &dev : m_manager->listOutputDevices()) {
         QVariantMap map;
@@ -22,19 +28,38 @@ QVariantList DeviceDBusAdaptor::ListOutputDevices() {
 }
 
 bool DeviceDBusAdaptor::SetOutputDevice(const QString &deviceId) {
+    WAVEMUX_TIME_DBUS_CALL();
     return m_manager->setOutputDevice(deviceId);
 }
 
 QString DeviceDBusAdaptor::GetOutputDevice() {
+    WAVEMUX_TIME_DBUS_CALL();
     return m_manager->getOutputDevice();
 }
 
 bool DeviceDBusAdaptor::SetStreamOutputDevice(const QString &deviceId) {
+    WAVEMUX_TIME_DBUS_CALL();
     return m_manager->setStreamOutputDevice(deviceId);
 }
 
 QString DeviceDBusAdaptor::GetStreamOutputDevice() {
+    WAVEMUX_TIME_DBUS_CALL();
     return m_manager->getStreamOutputDevice();
 }
 
+bool DeviceDBusAdaptor::SetOutputFallbacks(const QString &mixId, const QStringList &deviceIds) {
+    WAVEMUX_TIME_DBUS_CALL();
+    return m_manager->setOutputFallbacks(mixId, deviceIds);
+}
+
+QStringList DeviceDBusAdaptor::GetOutputFallbacks(const QString &mixId) {
+    WAVEMUX_TIME_DBUS_CALL();
+    return m_manager->getOutputFallbacks(mixId);
+}
+
+QString DeviceDBusAdaptor::GetActiveOutputDevice(const QString &mixId) {
+    WAVEMUX_TIME_DBUS_CALL();
+    return m_manager->getActiveOutputDevice(mixId);
+}
+
 } // namespace WaveMux
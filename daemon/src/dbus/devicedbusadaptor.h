@@ -22,6 +22,15 @@ public slots:
     bool SetStreamOutputDevice(const QString &deviceId);
     QString GetStreamOutputDevice();
 
+    // Failover (mixId: "personal" or "stream")
+    bool SetOutputFallbacks(const QString &mixId, const QStringList &deviceIds);
+    QStringList GetOutputFallbacks(const QString &mixId);
+    QString GetActiveOutputDevice(const QString &mixId);
+
+signals:
+    void DevicesChanged();
+    void ActiveOutputDeviceChanged(const QString &mixId, const QString &deviceId);
+
 private:
     AudioManager *m_manager;
 };
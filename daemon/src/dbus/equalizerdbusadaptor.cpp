@@ -0,0 +1,64 @@
+#include "equalizerdbusadaptor.h"
+#include "../audiomanager.h"
+#include "../logging.h"
+#include "../stats.h"
+#include <QDBusArgument>
+#include <QDebug>
+
+namespace WaveMux {
+
+EqualizerDBusAdaptor::EqualizerDBusAdaptor(AudioManager *manager)
+    : QDBusAbstractAdaptor(manager)
+    , m_manager(manager)
+{
+    connect(m_manager, &AudioManager::equalizerChanged,
+            this, &EqualizerDBusAdaptor::BandsChanged);
+}
+
+bool EqualizerDBusAdaptor::SetBands(const QString &channelId, const QVariantList &bands) {
+    WAVEMUX_TIME_DBUS_CALL();
+    QList<EqBand> parsed;
+    for (const auto &value : bands) {
+        // Maps nested in a variant list arrive still marshalled
+        const QVariantMap map = value.canConvert<QDBusArgument>()
+            ? qdbus_cast<QVariantMap>(value.value<QDBusArgument>())
+            : value.toMap();
+
+        EqBand band;
+        const QString typeName = map.value("type", eqBandTypeName(band.type)).toString();
+        const auto type = eqBandTypeFromName(typeName.toStdString());
+        if (!type) {
+            qCWarning(lcMix) << "Unknown EQ band type:" << typeName;
+            return false;
+        }
+        band.type = *type;
+        band.enabled = map.value("enabled", band.enabled).toBool();
+        band.frequency = map.value("frequency", band.frequency).toFloat();
+        band.gainDb = map.value("gainDb", band.gainDb).toFloat();
+        band.q = map.value("q", band.q).toFloat();
+        parsed.append(band);
+    }
+    return m_manager->setChannelEq(channelId, parsed);
+}
+
+QVariantList EqualizerDBusAdaptor::GetBands(const QString &channelId) {
+    WAVEMUX_TIME_DBUS_CALL();
+    QVariantList result;
+    for (const auto &band : m_manager->getChannelEq(channelId)) {
+        QVariantMap map;
+        map["type"] = QString(eqBandTypeName(band.type));
+        map["enabled"] = band.enabled;
+        map["frequency"] = band.frequency;
+        map["gainDb"] = band.gainDb;
+        map["q"] = band.q;
+        result.append(map);
+    }
+    return result;
+}
+
+int EqualizerDBusAdaptor::MaxBands() {
+    WAVEMUX_TIME_DBUS_CALL();
+    return static_cast<int>(Equalizer::MAX_BANDS);
+}
+
+} // namespace WaveMux
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <QDBusAbstractAdaptor>
+#include <QVariantList>
+
+namespace WaveMux {
+
+class AudioManager;
+
+// Per-channel parametric EQ. A band is a map with keys type ("peak",
+// "lowshelf", "highshelf", "highpass", "lowpass"), enabled, frequency (Hz),
+// gainDb and q; missing keys take their defaults.
+class EqualizerDBusAdaptor : public QDBusAbstractAdaptor {
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "com.wavemux.Equalizer")
+
+public:
+    explicit EqualizerDBusAdaptor(AudioManager *manager);
+
+public slots:
+    bool SetBands(const QString &channelId, const QVariantList &bands);
+    QVariantList GetBands(const QString &channelId);
+    int MaxBands();
+
+signals:
+    void BandsChanged(const QString &channelId);
+
+private:
+    AudioManager *m_manager;
+};
+
+} // namespace WaveMux
@@ -0,0 +1,76 @@
+#include "latencydbusadaptor.h"
+#include "../audiomanager.h"
+#include "../stats.h"
+
+namespace WaveMux {
+
+LatencyDBusAdaptor::LatencyDBusAdaptor(AudioManager *manager)
+    : QDBusAbstractAdaptor(manager)
+    , m_manager(manager)
+{
+    connect(m_manager, &AudioManager::latencyChanged,
+            this, &LatencyDBusAdaptor::LatencyChanged);
+    connect(m_manager, &AudioManager::latencyMeasured, this,
+            [this](const LatencyMeasurement &measurement, bool success) {
+        QVariantList runs;
+        for (const double run : measurement.path.runsMs) {
+            runs.append(run);
+        }
+        QVariantMap result;
+        result["channelId"] = measurement.channelId;
+        result["mixId"] = measurement.mixId;
+        result["device"] = measurement.device;
+        result["mode"] = measurement.mode;
+        result["latencyMs"] = measurement.path.medianMs;
+        result["minMs"] = measurement.path.minMs;
+        result["maxMs"] = measurement.path.maxMs;
+        result["meanMs"] = measurement.path.meanMs;
+        result["jitterMs"] = measurement.path.jitterMs;
+        result["runsMs"] = runs;
+        result["attempts"] = measurement.path.attempts;
+        result["baselineMs"] = measurement.baseline.medianMs;
+        emit LatencyMeasured(result, success);
+    });
+}
+
+QVariantMap LatencyDBusAdaptor::GetLatencyHealth(const QString &mixId) {
+    WAVEMUX_TIME_DBUS_CALL();
+    m_manager->watchLatencyHealth();
+    const MixLatencyHealth health = m_manager->getLatencyHealth(mixId);
+    QVariantMap map;
+    map["device"] = health.device;
+    map["mode"] = health.mode;
+    map["latencyMs"] = health.latencyMs;
+    map["bufferMs"] = health.bufferMs;
+    map["underruns"] = health.underruns;
+    map["overruns"] = health.overruns;
+    map["adaptive"] = health.adaptive;
+    return map;
+}
+
+bool LatencyDBusAdaptor::SetAdaptiveLatency(const QString &mixId, bool enabled) {
+    WAVEMUX_TIME_DBUS_CALL();
+    return m_manager->setAdaptiveLatency(mixId, enabled);
+}
+
+bool LatencyDBusAdaptor::IsAdaptiveLatency(const QString &mixId) {
+    WAVEMUX_TIME_DBUS_CALL();
+    return m_manager->isAdaptiveLatency(mixId);
+}
+
+QVariantMap LatencyDBusAdaptor::GetDeviceLatencies() {
+    WAVEMUX_TIME_DBUS_CALL();
+    const QHash<QString, int> latencies = m_manager->getDeviceLatencies();
+    QVariantMap map;
+    for (auto it = latencies.constBegin(); it != latencies.constEnd(); ++it) {
+        map[it.key()] = it.value();
+    }
+    return map;
+}
+
+bool LatencyDBusAdaptor::MeasureLatency(const QString &channelId, const QString &mixId) {
+    WAVEMUX_TIME_DBUS_CALL();
+    return m_manager->measureLatency(channelId, mixId);
+}
+
+} // namespace WaveMux
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <QDBusAbstractAdaptor>
+#include <QVariantMap>
+
+namespace WaveMux {
+
+class AudioManager;
+
+// Output path health and adaptive latency. mixId is "personal" or "stream".
+class LatencyDBusAdaptor : public QDBusAbstractAdaptor {
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "com.wavemux.Latency")
+
+public:
+    explicit LatencyDBusAdaptor(AudioManager *manager);
+
+public slots:
+    // device, mode ("loopback", "engine", "off"), latencyMs, bufferMs (-1 if
+    // unknown), underruns, overruns, adaptive
+    QVariantMap GetLatencyHealth(const QString &mixId);
+    bool SetAdaptiveLatency(const QString &mixId, bool enabled);
+    bool IsAdaptiveLatency(const QString &mixId);
+    // Output device -> learned loopback latency in milliseconds
+    QVariantMap GetDeviceLatencies();
+
+    // Times channelId's path through the mix with probe sweeps (the channel
+    // must be audible in it). Returns once started; LatencyMeasured reports
+    // channelId, mixId, device, mode, latencyMs (median), minMs, maxMs,
+    // meanMs, jitterMs, runsMs, attempts and baselineMs (the probe's own
+    // playback and capture overhead, included in the others).
+    bool MeasureLatency(const QString &channelId, const QString &mixId);
+
+signals:
+    void LatencyChanged(const QString &mixId);
+    void LatencyMeasured(const QVariantMap &result, bool success);
+
+private:
+    AudioManager *m_manager;
+};
+
+} // namespace WaveMux
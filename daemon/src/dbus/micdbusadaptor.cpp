@@ -0,0 +1,59 @@
+#include "micdbusadaptor.h"
+#include "../audiomanager.h"
+#include "../stats.h"
+
+namespace WaveMux {
+
+MicDBusAdaptor::MicDBusAdaptor(AudioManager *manager)
+    : QDBusAbstractAdaptor(manager)
+    , m_manager(manager)
+{
+    connect(m_manager, &AudioManager::micChanged,
+            this, &MicDBusAdaptor::MicChanged);
+}
+
+QVariantList MicDBusAdaptor::ListInputDevices() {
+    WAVEMUX_TIME_DBUS_CALL();
+    QVariantList result;
+    for (const auto &dev : m_manager->listInputDevices()) {
+        QVariantMap map;
+        map["id"] = dev.id;
+        map["name"] = dev.name;
+        map["description"] = dev.description;
+        result.append(map);
+    }
+    return result;
+}
+
+bool MicDBusAdaptor::SetMic(const QVariantMap &settings) {
+    WAVEMUX_TIME_DBUS_CALL();
+    MicConfig config = m_manager->getMic();
+    config.source = settings.value("source", config.source).toString();
+    config.suppression = settings.value("suppression", config.suppression).toBool();
+    config.gate.enabled = settings.value("gateEnabled", config.gate.enabled).toBool();
+    config.gate.thresholdDb = settings.value("gateThresholdDb", config.gate.thresholdDb).toFloat();
+    config.gate.hysteresisDb = settings.value("gateHysteresisDb", config.gate.hysteresisDb).toFloat();
+    config.gate.rangeDb = settings.value("gateRangeDb", config.gate.rangeDb).toFloat();
+    config.gate.attackMs = settings.value("gateAttackMs", config.gate.attackMs).toFloat();
+    config.gate.holdMs = settings.value("gateHoldMs", config.gate.holdMs).toFloat();
+    config.gate.releaseMs = settings.value("gateReleaseMs", config.gate.releaseMs).toFloat();
+    return m_manager->setMic(config);
+}
+
+QVariantMap MicDBusAdaptor::GetMic() {
+    WAVEMUX_TIME_DBUS_CALL();
+    const MicConfig config = m_manager->getMic();
+    QVariantMap map;
+    map["source"] = config.source;
+    map["suppression"] = config.suppression;
+    map["gateEnabled"] = config.gate.enabled;
+    map["gateThresholdDb"] = config.gate.thresholdDb;
+    map["gateHysteresisDb"] = config.gate.hysteresisDb;
+    map["gateRangeDb"] = config.gate.rangeDb;
+    map["gateAttackMs"] = config.gate.attackMs;
+    map["gateHoldMs"] = config.gate.holdMs;
+    map["gateReleaseMs"] = config.gate.releaseMs;
+    return map;
+}
+
+} // namespace WaveMux
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <QDBusAbstractAdaptor>
+#include <QVariantList>
+#include <QVariantMap>
+
+namespace WaveMux {
+
+class AudioManager;
+
+// Microphone channel. Levels are set through com.wavemux.Channels with
+// channel id "mic". Mic keys: source, suppression, gateEnabled,
+// gateThresholdDb, gateHysteresisDb, gateRangeDb, gateAttackMs, gateHoldMs,
+// gateReleaseMs. Missing keys keep their current value.
+class MicDBusAdaptor : public QDBusAbstractAdaptor {
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "com.wavemux.Mic")
+
+public:
+    explicit MicDBusAdaptor(AudioManager *manager);
+
+public slots:
+    QVariantList ListInputDevices();
+    bool SetMic(const QVariantMap &settings);
+    QVariantMap GetMic();
+
+signals:
+    void MicChanged();
+
+private:
+    AudioManager *m_manager;
+};
+
+} // namespace WaveMux
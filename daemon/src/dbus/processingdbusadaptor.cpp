@@ -0,0 +1,131 @@
+#include "processingdbusadaptor.h"
+#include "../audiomanager.h"
+#include "../stats.h"
+
+namespace WaveMux {
+
+ProcessingDBusAdaptor::ProcessingDBusAdaptor(AudioManager *manager)
+    : QDBusAbstractAdaptor(manager)
+    , m_manager(manager)
+{
+    connect(m_manager, &AudioManager::processingChanged,
+            this, &ProcessingDBusAdaptor::ProcessingChanged);
+    connect(m_manager, &AudioManager::alignmentMeasured, this,
+            [this](const QString &mixId, const QHash<QString, double> &latenciesMs, bool success) {
+        QVariantMap latencies;
+        for (auto it = latenciesMs.constBegin(); it != latenciesMs.constEnd(); ++it) {
+            latencies[it.key()] = it.value();
+        }
+        emit AlignmentMeasured(mixId, latencies, success);
+    });
+}
+
+bool ProcessingDBusAdaptor::SetDucking(const QString &mixId, const QVariantMap &settings) {
+    WAVEMUX_TIME_DBUS_CALL();
+    DuckingConfig config = m_manager->getDucking(mixId);
+    config.settings.enabled = settings.value("enabled", config.settings.enabled).toBool();
+    config.triggerChannel = settings.value("triggerChannel", config.triggerChannel).toString();
+    config.targetChannels = settings.value("targetChannels", config.targetChannels).toStringList();
+    config.settings.depthDb = settings.value("depthDb", config.settings.depthDb).toFloat();
+    config.settings.thresholdDb = settings.value("thresholdDb", config.settings.thresholdDb).toFloat();
+    config.settings.attackMs = settings.value("attackMs", config.settings.attackMs).toFloat();
+    config.settings.releaseMs = settings.value("releaseMs", config.settings.releaseMs).toFloat();
+    return m_manager->setDucking(mixId, config);
+}
+
+QVariantMap ProcessingDBusAdaptor::GetDucking(const QString &mixId) {
+    WAVEMUX_TIME_DBUS_CALL();
+    const DuckingConfig config = m_manager->getDucking(mixId);
+    QVariantMap map;
+    map["enabled"] = config.settings.enabled;
+    map["triggerChannel"] = config.triggerChannel;
+    map["targetChannels"] = config.targetChannels;
+    map["depthDb"] = config.settings.depthDb;
+    map["thresholdDb"] = config.settings.thresholdDb;
+    map["attackMs"] = config.settings.attackMs;
+    map["releaseMs"] = config.settings.releaseMs;
+    return map;
+}
+
+double ProcessingDBusAdaptor::GetDuckingGainReduction(const QString &mixId) {
+    WAVEMUX_TIME_DBUS_CALL();
+    return m_manager->getDuckingGainReduction(mixId);
+}
+
+bool ProcessingDBusAdaptor::IsMixProcessed(const QString &mixId) {
+    WAVEMUX_TIME_DBUS_CALL();
+    return m_manager->isMixProcessed(mixId);
+}
+
+bool ProcessingDBusAdaptor::SetLimiter(const QString &mixId, const QVariantMap &settings) {
+    WAVEMUX_TIME_DBUS_CALL();
+    LimiterSettings limiter = m_manager->getLimiter(mixId);
+    limiter.enabled = settings.value("enabled", limiter.enabled).toBool();
+    limiter.ceilingDb = settings.value("ceilingDb", limiter.ceilingDb).toFloat();
+    limiter.releaseMs = settings.value("releaseMs", limiter.releaseMs).toFloat();
+    return m_manager->setLimiter(mixId, limiter);
+}
+
+QVariantMap ProcessingDBusAdaptor::GetLimiter(const QString &mixId) {
+    WAVEMUX_TIME_DBUS_CALL();
+    const LimiterSettings limiter = m_manager->getLimiter(mixId);
+    QVariantMap map;
+    map["enabled"] = limiter.enabled;
+    map["ceilingDb"] = limiter.ceilingDb;
+    map["releaseMs"] = limiter.releaseMs;
+    return map;
+}
+
+bool ProcessingDBusAdaptor::SetLoudness(const QString &mixId, const QVariantMap &settings) {
+    WAVEMUX_TIME_DBUS_CALL();
+    LoudnessSettings loudness = m_manager->getLoudness(mixId);
+    loudness.enabled = settings.value("enabled", loudness.enabled).toBool();
+    loudness.targetLufs = settings.value("targetLufs", loudness.targetLufs).toFloat();
+    loudness.maxGainDb = settings.value("maxGainDb", loudness.maxGainDb).toFloat();
+    return m_manager->setLoudness(mixId, loudness);
+}
+
+QVariantMap ProcessingDBusAdaptor::GetLoudness(const QString &mixId) {
+    WAVEMUX_TIME_DBUS_CALL();
+    const LoudnessSettings loudness = m_manager->getLoudness(mixId);
+    QVariantMap map;
+    map["enabled"] = loudness.enabled;
+    map["targetLufs"] = loudness.targetLufs;
+    map["maxGainDb"] = loudness.maxGainDb;
+    return map;
+}
+
+QVariantMap ProcessingDBusAdaptor::GetMeters(const QString &mixId) {
+    WAVEMUX_TIME_DBUS_CALL();
+    const MixMeters meters = m_manager->getMixMeters(mixId);
+    QVariantMap map;
+    map["limiterReductionDb"] = meters.limiterReductionDb;
+    map["normalizationGainDb"] = meters.normalizationGainDb;
+    map["shortTermLufs"] = meters.shortTermLufs;
+    map["momentaryLufs"] = meters.momentaryLufs;
+    map["micGateOpen"] = meters.micGateOpen;
+    map["micGateReductionDb"] = meters.micGateReductionDb;
+    return map;
+}
+
+bool ProcessingDBusAdaptor::SetChannelDelay(const QString &mixId, const QString &channelId, double milliseconds) {
+    WAVEMUX_TIME_DBUS_CALL();
+    return m_manager->setChannelDelay(mixId, channelId, milliseconds);
+}
+
+QVariantMap ProcessingDBusAdaptor::GetChannelDelays(const QString &mixId) {
+    WAVEMUX_TIME_DBUS_CALL();
+    QVariantMap map;
+    const QHash<QString, double> delays = m_manager->getChannelDelays(mixId);
+    for (auto it = delays.constBegin(); it != delays.constEnd(); ++it) {
+        map[it.key()] = it.value();
+    }
+    return map;
+}
+
+bool ProcessingDBusAdaptor::MeasureAlignment(const QString &mixId) {
+    WAVEMUX_TIME_DBUS_CALL();
+    return m_manager->measureAlignment(mixId);
+}
+
+} // namespace WaveMux
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <QDBusAbstractAdaptor>
+#include <QVariantMap>
+
+namespace WaveMux {
+
+class AudioManager;
+
+// In-process mix processing. mixId is "personal" or "stream".
+class ProcessingDBusAdaptor : public QDBusAbstractAdaptor {
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "com.wavemux.Processing")
+
+public:
+    explicit ProcessingDBusAdaptor(AudioManager *manager);
+
+public slots:
+    // Ducking keys: enabled, triggerChannel, targetChannels, depthDb,
+    // thresholdDb, attackMs, releaseMs. Missing keys keep their current value.
+    bool SetDucking(const QString &mixId, const QVariantMap &settings);
+    QVariantMap GetDucking(const QString &mixId);
+    double GetDuckingGainReduction(const QString &mixId);
+    bool IsMixProcessed(const QString &mixId);
+
+    // Limiter keys: enabled, ceilingDb (dBTP), releaseMs
+    bool SetLimiter(const QString &mixId, const QVariantMap &settings);
+    QVariantMap GetLimiter(const QString &mixId);
+    // Loudness keys: enabled, targetLufs, maxGainDb
+    bool SetLoudness(const QString &mixId, const QVariantMap &settings);
+    QVariantMap GetLoudness(const QString &mixId);
+    // limiterReductionDb, normalizationGainDb, shortTermLufs, momentaryLufs,
+    // micGateOpen, micGateReductionDb
+    QVariantMap GetMeters(const QString &mixId);
+
+    // Delay compensation. Delays are in milliseconds (sample-accurate);
+    // channelId may be "mic". GetChannelDelays lists non-zero delays only.
+    bool SetChannelDelay(const QString &mixId, const QString &channelId, double milliseconds);
+    QVariantMap GetChannelDelays(const QString &mixId);
+    // Plays a short sweep through each audible channel and sets the delays
+    // that line them up; AlignmentMeasured reports the path latencies (ms)
+    bool MeasureAlignment(const QString &mixId);
+
+signals:
+    void ProcessingChanged();
+    void AlignmentMeasured(const QString &mixId, const QVariantMap &latenciesMs, bool success);
+
+private:
+    AudioManager *m_manager;
+};
+
+} // namespace WaveMux
@@ -0,0 +1,47 @@
+#include "profiledbusadaptor.h"
+#include "../audiomanager.h"
+#include "../stats.h"
+#include "../configmanager.h"
+
+namespace WaveMux {
+
+ProfileDBusAdaptor::ProfileDBusAdaptor(AudioManager *manager, ConfigManager *config)
+    : QDBusAbstractAdaptor(manager)
+    , m_config(config)
+{
+    connect(m_config, &ConfigManager::profilesChanged,
+            this, &ProfileDBusAdaptor::ProfilesChanged);
+    connect(m_config, &ConfigManager::activeProfileChanged,
+            this, &ProfileDBusAdaptor::ActiveProfileChanged);
+}
+
+QStringList ProfileDBusAdaptor::ListProfiles() {
+    WAVEMUX_TIME_DBUS_CALL();
+    QStringList result;
+    for (const auto &profile : m_config->profiles()) {
+        result.append(profile.name);
+    }
+    return result;
+}
+
+QString ProfileDBusAdaptor::GetActiveProfile() {
+    WAVEMUX_TIME_DBUS_CALL();
+    return m_config->activeProfile();
+}
+
+bool ProfileDBusAdaptor::SaveProfile(const QString &name) {
+    WAVEMUX_TIME_DBUS_CALL();
+    return m_config->saveProfile(name);
+}
+
+bool ProfileDBusAdaptor::DeleteProfile(const QString &name) {
+    WAVEMUX_TIME_DBUS_CALL();
+    return m_config->deleteProfile(name);
+}
+
+bool ProfileDBusAdaptor::SwitchProfile(const QString &name) {
+    WAVEMUX_TIME_DBUS_CALL();
+    return m_config->switchProfile(name);
+}
+
+} // namespace WaveMux
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <QDBusAbstractAdaptor>
+#include <QStringList>
+
+namespace WaveMux {
+
+class AudioManager;
+class ConfigManager;
+
+class ProfileDBusAdaptor : public QDBusAbstractAdaptor {
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "com.wavemux.Profiles")
+
+public:
+    explicit ProfileDBusAdaptor(AudioManager *manager, ConfigManager *config);
+
+public slots:
+    QStringList ListProfiles();
+    QString GetActiveProfile();
+    bool SaveProfile(const QString &name);
+    bool DeleteProfile(const QString &name);
+    bool SwitchProfile(const QString &name);
+
+signals:
+    void ProfilesChanged();
+    void ActiveProfileChanged(const QString &name);
+
+private:
+    ConfigManager *m_config;
+};
+
+} // namespace WaveMux
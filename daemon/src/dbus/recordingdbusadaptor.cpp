@@ -0,0 +1,41 @@
+#include "recordingdbusadaptor.h"
+#include "../audiomanager.h"
+#include "../stats.h"
+
+namespace WaveMux {
+
+RecordingDBusAdaptor::RecordingDBusAdaptor(AudioManager *manager)
+    : QDBusAbstractAdaptor(manager)
+    , m_manager(manager)
+{
+    connect(m_manager, &AudioManager::recordingChanged,
+            this, &RecordingDBusAdaptor::RecordingChanged);
+}
+
+bool RecordingDBusAdaptor::StartRecording(const QString &directory) {
+    WAVEMUX_TIME_DBUS_CALL();
+    return m_manager->startRecording(directory);
+}
+
+bool RecordingDBusAdaptor::StopRecording() {
+    WAVEMUX_TIME_DBUS_CALL();
+    return m_manager->stopRecording();
+}
+
+bool RecordingDBusAdaptor::IsRecording() {
+    WAVEMUX_TIME_DBUS_CALL();
+    return m_manager->isRecording();
+}
+
+QVariantMap RecordingDBusAdaptor::GetStatus() {
+    WAVEMUX_TIME_DBUS_CALL();
+    const RecordingStatus status = m_manager->recordingStatus();
+    QVariantMap map;
+    map["recording"] = status.recording;
+    map["files"] = status.files;
+    map["seconds"] = status.seconds;
+    map["droppedSeconds"] = status.droppedSeconds;
+    return map;
+}
+
+} // namespace WaveMux
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <QDBusAbstractAdaptor>
+#include <QVariantMap>
+
+namespace WaveMux {
+
+class AudioManager;
+
+// Multitrack recording of every channel, the mic and the Stream mix
+class RecordingDBusAdaptor : public QDBusAbstractAdaptor {
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "com.wavemux.Recording")
+
+public:
+    explicit RecordingDBusAdaptor(AudioManager *manager);
+
+public slots:
+    // Empty directory: ~/Music/WaveMux
+    bool StartRecording(const QString &directory);
+    bool StopRecording();
+    bool IsRecording();
+    // recording, files, seconds, droppedSeconds
+    QVariantMap GetStatus();
+
+signals:
+    void RecordingChanged(bool recording);
+
+private:
+    AudioManager *m_manager;
+};
+
+} // namespace WaveMux
@@ -0,0 +1,44 @@
+#include "replaydbusadaptor.h"
+#include "../audiomanager.h"
+#include "../stats.h"
+
+namespace WaveMux {
+
+ReplayDBusAdaptor::ReplayDBusAdaptor(AudioManager *manager)
+    : QDBusAbstractAdaptor(manager)
+    , m_manager(manager)
+{
+    connect(m_manager, &AudioManager::replayChanged,
+            this, &ReplayDBusAdaptor::ReplayChanged);
+    connect(m_manager, &AudioManager::replaySaved,
+            this, &ReplayDBusAdaptor::ReplaySaved);
+}
+
+bool ReplayDBusAdaptor::SetReplay(const QVariantMap &settings) {
+    WAVEMUX_TIME_DBUS_CALL();
+    ReplaySettings replay = m_manager->getReplay();
+    replay.enabled = settings.value("enabled", replay.enabled).toBool();
+    replay.seconds = settings.value("seconds", replay.seconds).toInt();
+    replay.channels = settings.value("channels", replay.channels).toBool();
+    replay.compact = settings.value("compact", replay.compact).toBool();
+    return m_manager->setReplay(replay);
+}
+
+QVariantMap ReplayDBusAdaptor::GetReplay() {
+    WAVEMUX_TIME_DBUS_CALL();
+    const ReplaySettings replay = m_manager->getReplay();
+    QVariantMap map;
+    map["enabled"] = replay.enabled;
+    map["seconds"] = replay.seconds;
+    map["channels"] = replay.channels;
+    map["compact"] = replay.compact;
+    map["active"] = m_manager->isReplayActive();
+    return map;
+}
+
+bool ReplayDBusAdaptor::SaveReplay(int seconds, const QString &path) {
+    WAVEMUX_TIME_DBUS_CALL();
+    return m_manager->saveReplay(seconds, path);
+}
+
+} // namespace WaveMux
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <QDBusAbstractAdaptor>
+#include <QStringList>
+#include <QVariantMap>
+
+namespace WaveMux {
+
+class AudioManager;
+
+// Instant replay of the Stream mix. Replay keys: enabled, seconds, channels,
+// compact, active (read-only). Missing keys keep their current value.
+class ReplayDBusAdaptor : public QDBusAbstractAdaptor {
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "com.wavemux.Replay")
+
+public:
+    explicit ReplayDBusAdaptor(AudioManager *manager);
+
+public slots:
+    bool SetReplay(const QVariantMap &settings);
+    QVariantMap GetReplay();
+    // seconds 0: everything buffered; empty path: ~/Music/WaveMux. Returns
+    // once the save has started; ReplaySaved reports the result.
+    bool SaveReplay(int seconds, const QString &path);
+
+signals:
+    void ReplayChanged();
+    void ReplaySaved(const QStringList &files, bool success);
+
+private:
+    AudioManager *m_manager;
+};
+
+} // namespace WaveMux
@@ -0,0 +1,60 @@
+#include "spectrumdbusadaptor.h"
+#include "../audiomanager.h"
+#include "../stats.h"
+#include "../dsp/spectrum.h"
+#include <QDBusConnection>
+#include <QDBusServiceWatcher>
+
+namespace WaveMux {
+
+SpectrumDBusAdaptor::SpectrumDBusAdaptor(AudioManager *manager)
+    : QDBusAbstractAdaptor(manager)
+    , m_manager(manager)
+    , m_watcher(new QDBusServiceWatcher(this))
+{
+    connect(m_manager, &AudioManager::spectrumUpdated,
+            this, &SpectrumDBusAdaptor::SpectrumUpdated);
+
+    m_watcher->setConnection(QDBusConnection::sessionBus());
+    m_watcher->setWatchMode(QDBusServiceWatcher::WatchForUnregistration);
+    connect(m_watcher, &QDBusServiceWatcher::serviceUnregistered, this, [this](const QString &service) {
+        m_watcher->removeWatchedService(service);
+        m_manager->setSpectrumSubscription(service, {});
+    });
+}
+
+bool SpectrumDBusAdaptor::Subscribe(const QStringList &targets, const QDBusMessage &message) {
+    WAVEMUX_TIME_DBUS_CALL();
+    const QString client = message.service();
+    if (!m_manager->setSpectrumSubscription(client, targets)) {
+        return false;
+    }
+    if (targets.isEmpty()) {
+        m_watcher->removeWatchedService(client);
+    } else if (!m_watcher->watchedServices().contains(client)) {
+        m_watcher->addWatchedService(client);
+    }
+    return true;
+}
+
+void SpectrumDBusAdaptor::Unsubscribe(const QDBusMessage &message) {
+    WAVEMUX_TIME_DBUS_CALL();
+    Subscribe({}, message);
+}
+
+int SpectrumDBusAdaptor::BandCount() {
+    WAVEMUX_TIME_DBUS_CALL();
+    return SpectrumAnalyzer::BANDS;
+}
+
+QList<double> SpectrumDBusAdaptor::BandFrequencies() {
+    WAVEMUX_TIME_DBUS_CALL();
+    SpectrumAnalyzer analyzer(SpectrumMonitor::SAMPLE_RATE);
+    QList<double> frequencies;
+    for (size_t band = 0; band < SpectrumAnalyzer::BANDS; ++band) {
+        frequencies.append(analyzer.bandCenter(band));
+    }
+    return frequencies;
+}
+
+} // namespace WaveMux
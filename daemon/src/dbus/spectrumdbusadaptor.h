@@ -0,0 +1,42 @@
+#pragma once
+
+#include <QDBusAbstractAdaptor>
+#include <QDBusMessage>
+#include <QStringList>
+#include <QVariantMap>
+
+class QDBusServiceWatcher;
+
+namespace WaveMux {
+
+class AudioManager;
+
+// Live spectrum of channels, mixes and applications for visualizers.
+// Targets: channel ids ("game", "chat", "media", "aux", "mic"), "personal",
+// "stream" and "app:<streamId>". SpectrumUpdated carries target -> list of
+// BandCount() levels in dBFS, ~30 times a second, and is only computed
+// while at least one client is subscribed. A client that drops off the bus
+// is unsubscribed automatically.
+class SpectrumDBusAdaptor : public QDBusAbstractAdaptor {
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "com.wavemux.Spectrum")
+
+public:
+    explicit SpectrumDBusAdaptor(AudioManager *manager);
+
+public slots:
+    // Replaces the caller's targets; an empty list unsubscribes
+    bool Subscribe(const QStringList &targets, const QDBusMessage &message);
+    void Unsubscribe(const QDBusMessage &message);
+    int BandCount();
+    QList<double> BandFrequencies();  // Center of each band in Hz
+
+signals:
+    void SpectrumUpdated(const QVariantMap &bands);
+
+private:
+    AudioManager *m_manager;
+    QDBusServiceWatcher *m_watcher;
+};
+
+} // namespace WaveMux
@@ -0,0 +1,98 @@
+#include "statsdbusadaptor.h"
+#include "../audiomanager.h"
+#include "../stats.h"
+
+namespace WaveMux {
+
+namespace {
+    QVariantMap nodeLoadToMap(const NodeLoadSample &sample) {
+        QVariantList nodes;
+        for (const auto &node : sample.nodes) {
+            QVariantMap map;
+            map["nodeId"] = node.nodeId;
+            map["name"] = node.name;
+            map["role"] = node.role;
+            map["kind"] = node.kind;
+            map["active"] = node.active;
+            map["quantum"] = node.quantum;
+            map["rate"] = node.rate;
+            map["busyUs"] = node.busyUs;
+            map["busyQuantum"] = node.busyQuantum;
+            map["errors"] = node.errors;
+            nodes.append(map);
+        }
+        QVariantList engines;
+        for (const auto &engine : sample.engines) {
+            QVariantMap map;
+            map["mixId"] = engine.mixId;
+            map["busyUs"] = engine.busyUs;
+            map["load"] = engine.load;
+            map["blocks"] = engine.blocks;
+            engines.append(map);
+        }
+
+        QVariantMap map;
+        map["available"] = sample.available;
+        map["reason"] = sample.reason;
+        map["timestamp"] = sample.timestamp;
+        map["nodes"] = nodes;
+        map["ownBusyUs"] = sample.ownBusyUs;
+        map["ownLoad"] = sample.ownLoad;
+        map["graphBusyUs"] = sample.graphBusyUs;
+        map["graphLoad"] = sample.graphLoad;
+        map["errors"] = sample.errors;
+        map["engines"] = engines;
+        return map;
+    }
+}
+
+StatsDBusAdaptor::StatsDBusAdaptor(AudioManager *manager)
+    : QDBusAbstractAdaptor(manager)
+    , m_manager(manager)
+{
+    connect(m_manager, &AudioManager::nodeLoadUpdated, this, [this](const NodeLoadSample &sample) {
+        emit NodeLoadUpdated(nodeLoadToMap(sample));
+    });
+}
+
+QVariantMap StatsDBusAdaptor::GetHistograms() {
+    QVariantMap map;
+    for (const auto &entry : Stats::histograms()) {
+        const Histogram::Summary summary = entry.second->summary();
+        if (summary.count == 0) {
+            continue;
+        }
+        QVariantMap histogram;
+        histogram["count"] = static_cast<qulonglong>(summary.count);
+        histogram["p50"] = static_cast<qulonglong>(summary.p50);
+        histogram["p99"] = static_cast<qulonglong>(summary.p99);
+        histogram["max"] = static_cast<qulonglong>(summary.max);
+        histogram["mean"] = static_cast<double>(summary.sum) / summary.count;
+        histogram["unit"] = entry.second->unit() == Histogram::Unit::Count ? "count" : "us";
+        map[QString::fromStdString(entry.first)] = histogram;
+    }
+    return map;
+}
+
+QVariantMap StatsDBusAdaptor::GetCounters() {
+    QVariantMap map;
+    for (const auto &entry : Stats::counters()) {
+        map[QString::fromStdString(entry.first)] = static_cast<qulonglong>(entry.second->value());
+    }
+    return map;
+}
+
+QString StatsDBusAdaptor::Dump() {
+    return QString::fromStdString(Stats::dump());
+}
+
+void StatsDBusAdaptor::Reset() {
+    Stats::reset();
+}
+
+QVariantMap StatsDBusAdaptor::GetNodeLoad() {
+    m_manager->refreshNodeLoad();
+    return nodeLoadToMap(m_manager->getNodeLoad());
+}
+
+} // namespace WaveMux
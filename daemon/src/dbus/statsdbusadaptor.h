@@ -0,0 +1,46 @@
+#pragma once
+
+#include <QDBusAbstractAdaptor>
+#include <QVariantMap>
+
+namespace WaveMux {
+
+class AudioManager;
+
+// Daemon performance statistics. Histogram names are grouped by prefix:
+// backend.<operation> (audio server commands), dbus.<method> (service time),
+// streams.event-to-route, commands.* (slider command queue), config.save
+// and startup.<phase>. Times are in microseconds.
+//
+// GetNodeLoad() is the audio graph's side: the profiler's per-node busy
+// time for the objects WaveMux created, against the whole graph.
+class StatsDBusAdaptor : public QDBusAbstractAdaptor {
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "com.wavemux.Stats")
+
+public:
+    explicit StatsDBusAdaptor(AudioManager *manager);
+
+public slots:
+    // name -> {count, p50, p99, max, mean, unit ("us" or "count")}
+    QVariantMap GetHistograms();
+    QVariantMap GetCounters();
+    // The same as a text table (what `wavemuxd --stats` prints)
+    QString Dump();
+    void Reset();
+
+    // The last node load sample: available, reason (why not), timestamp,
+    // nodes (nodeId, name, role, kind, active, quantum, rate, busyUs,
+    // busyQuantum, errors; busiest first), ownBusyUs, ownLoad, graphBusyUs,
+    // graphLoad, errors, and engines (mixId, busyUs, load, blocks). Also
+    // starts a new sample if that one is stale; NodeLoadUpdated reports it.
+    QVariantMap GetNodeLoad();
+
+signals:
+    void NodeLoadUpdated(const QVariantMap &sample);
+
+private:
+    AudioManager *m_manager;
+};
+
+} // namespace WaveMux
@@ -1,5 +1,6 @@
 #include "streamdbusadaptor.h"
 #include "../audiomanager.h"
+#include "../stats.h"
 
 namespace WaveMux {
 
@@ -16,6 +17,7 @@ StreamDBusAdaptor::StreamDBusAdaptor(AudioManager *manager)
 }
 
 QVariantList StreamDBusAdaptor::ListStreams() {
+    WAVEMUX_TIME_DBUS_CALL();
     QVariantList result;
     for (const auto &stream : m_manager->listStreams()) {
         QVariantMap map;
@@ -24,28 +26,59 @@ QVariantList StreamDBusAdaptor::ListStreams() {
         map["mediaName"] = stream.mediaName;
         map["processName"] = stream.processName;
         map["assignedChannel"] = stream.assignedChannel;
+        map["volume"] = stream.volume;
+        map["muted"] = stream.muted;
         result.append(map);
     }
     return result;
 }
 
 bool StreamDBusAdaptor::MoveStreamToChannel(uint streamId, const QString &channelId) {
+    WAVEMUX_TIME_DBUS_CALL();
     return m_manager->moveStreamToChannel(streamId, channelId);
 }
 
 bool StreamDBusAdaptor::UnassignStream(uint streamId) {
+    WAVEMUX_TIME_DBUS_CALL();
     return m_manager->unassignStream(streamId);
 }
 
+bool StreamDBusAdaptor::SetStreamVolume(uint streamId, int volume) {
+    WAVEMUX_TIME_DBUS_CALL();
+    return m_manager->setStreamVolume(streamId, volume);
+}
+
+bool StreamDBusAdaptor::SetStreamMute(uint streamId, bool muted) {
+    WAVEMUX_TIME_DBUS_CALL();
+    return m_manager->setStreamMute(streamId, muted);
+}
+
+QVariantList StreamDBusAdaptor::GetAppVolumes() {
+    WAVEMUX_TIME_DBUS_CALL();
+    QVariantList result;
+    const auto volumes = m_manager->getAppVolumes();
+    for (auto it = volumes.constBegin(); it != volumes.constEnd(); ++it) {
+        QVariantMap map;
+        map["app"] = it.key();
+        map["volume"] = it->volume;
+        map["muted"] = it->muted;
+        result.append(map);
+    }
+    return result;
+}
+
 void StreamDBusAdaptor::AddRoutingRule(const QString &pattern, const QString &channelId) {
+    WAVEMUX_TIME_DBUS_CALL();
     m_manager->addRoutingRule(pattern, channelId);
 }
 
 void StreamDBusAdaptor::RemoveRoutingRule(const QString &pattern) {
+    WAVEMUX_TIME_DBUS_CALL();
     m_manager->removeRoutingRule(pattern);
 }
 
 QVariantList StreamDBusAdaptor::GetRoutingRules() {
+    WAVEMUX_TIME_DBUS_CALL();
     QVariantList result;
     for (const auto &rule : m_manager->getRoutingRules()) {
         QVariantMap map;
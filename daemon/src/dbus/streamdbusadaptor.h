@@ -20,6 +20,12 @@ public slots:
     bool MoveStreamToChannel(uint streamId, const QString &channelId);
     bool UnassignStream(uint streamId);
 
+    // Level of an app within its channel, remembered per app
+    bool SetStreamVolume(uint streamId, int volume);
+    bool SetStreamMute(uint streamId, bool muted);
+    // [{app, volume, muted}] for every app with a remembered level
+    QVariantList GetAppVolumes();
+
     // Routing rules
     void AddRoutingRule(const QString &pattern, const QString &channelId);
     void RemoveRoutingRule(const QString &pattern);
@@ -0,0 +1,54 @@
+#include "tracedbusadaptor.h"
+#include "../audiomanager.h"
+#include "../eventlog.h"
+#include "../logging.h"
+#include "../trace.h"
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QStandardPaths>
+#include <QDebug>
+
+namespace WaveMux {
+
+TraceDBusAdaptor::TraceDBusAdaptor(AudioManager *manager)
+    : QDBusAbstractAdaptor(manager)
+{
+}
+
+void TraceDBusAdaptor::SetTracing(bool enabled) {
+    if (enabled != Trace::isEnabled()) {
+        qCInfo(lcDaemon) << "Tracing" << (enabled ? "enabled" : "disabled");
+    }
+    Trace::setEnabled(enabled);
+}
+
+bool TraceDBusAdaptor::IsTracing() {
+    return Trace::isEnabled();
+}
+
+QString TraceDBusAdaptor::DumpTrace(const QString &path) {
+    QString target = path;
+    if (target.isEmpty()) {
+        const QString directory = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+        QDir().mkpath(directory);
+        target = QDir(directory).filePath(
+            QString("trace-%1.json").arg(QDateTime::currentDateTime().toString("yyyyMMdd-HHmmss")));
+    }
+    if (!Trace::writeChromeJson(QFile::encodeName(target).toStdString())) {
+        qCWarning(lcDaemon) << "Cannot write trace to" << target;
+        return QString();
+    }
+    qCInfo(lcDaemon) << "Wrote" << Trace::eventCount() << "trace events to" << target;
+    return target;
+}
+
+void TraceDBusAdaptor::ClearTrace() {
+    Trace::clear();
+}
+
+QString TraceDBusAdaptor::RecentEvents(uint maxEvents) {
+    return QString::fromStdString(EventLog::text(maxEvents));
+}
+
+} // namespace WaveMux
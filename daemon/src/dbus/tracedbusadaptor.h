@@ -0,0 +1,34 @@
+#pragma once
+
+#include <QDBusAbstractAdaptor>
+#include <QString>
+
+namespace WaveMux {
+
+class AudioManager;
+
+// Activity tracing. While enabled, backend commands, D-Bus handlers, server
+// events, config I/O and settle sleeps are recorded (the newest
+// Trace::CAPACITY events are kept); dumps are Chrome trace JSON, which
+// chrome://tracing and ui.perfetto.dev open directly. Also enabled from
+// startup by WAVEMUX_TRACE=1. The always-on EventLog of recent operations
+// is read here too.
+class TraceDBusAdaptor : public QDBusAbstractAdaptor {
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "com.wavemux.Trace")
+
+public:
+    explicit TraceDBusAdaptor(AudioManager *manager);
+
+public slots:
+    void SetTracing(bool enabled);
+    bool IsTracing();
+    // Writes what has been recorded to path (a file in the cache directory
+    // if empty) and returns the path written, or an empty string on failure
+    QString DumpTrace(const QString &path);
+    void ClearTrace();
+    // The newest maxEvents operations (all that are held if 0), one per line
+    QString RecentEvents(uint maxEvents);
+};
+
+} // namespace WaveMux
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+
+namespace WaveMux {
+
+// Normalized biquad coefficients (a0 == 1)
+struct BiquadCoefficients {
+    float b0 = 1.0f, b1 = 0.0f, b2 = 0.0f;
+    float a1 = 0.0f, a2 = 0.0f;
+};
+
+// One second-order section, transposed direct form II, single channel
+class Biquad {
+public:
+    void setCoefficients(const BiquadCoefficients &coefficients) { m_c = coefficients; }
+    void reset() { m_z1 = m_z2 = 0.0f; }
+
+    float process(float x) {
+        const float y = m_c.b0 * x + m_z1;
+        m_z1 = m_c.b1 * x - m_c.a1 * y + m_z2;
+        m_z2 = m_c.b2 * x - m_c.a2 * y;
+        return y;
+    }
+
+private:
+    BiquadCoefficients m_c;
+    float m_z1 = 0.0f;
+    float m_z2 = 0.0f;
+};
+
+// Left and right sample of one frame in a single vector register (GCC/Clang
+// vector extension: SSE on x86-64, NEON on ARM)
+typedef float StereoFrame __attribute__((vector_size(2 * sizeof(float))));
+
+// Chain of up to MAX_SECTIONS biquads on interleaved stereo. Both channels go
+// through each section together, one frame per vector operation, and the
+// block is run section by section so coefficients and state stay in registers.
+// Inactive sections are skipped and keep a cleared state.
+class StereoBiquadCascade {
+public:
+    static constexpr size_t MAX_SECTIONS = 8;
+
+    void setSection(size_t index, const BiquadCoefficients &c) {
+        Section &s = m_sections[index];
+        s.b0 = StereoFrame{c.b0, c.b0};
+        s.b1 = StereoFrame{c.b1, c.b1};
+        s.b2 = StereoFrame{c.b2, c.b2};
+        s.a1 = StereoFrame{c.a1, c.a1};
+        s.a2 = StereoFrame{c.a2, c.a2};
+    }
+
+    void setSectionActive(size_t index, bool active) {
+        Section &s = m_sections[index];
+        if (!active) {
+            s.z1 = s.z2 = StereoFrame{0.0f, 0.0f};
+        }
+        s.active = active;
+    }
+
+    bool sectionActive(size_t index) const { return m_sections[index].active; }
+
+    void reset() {
+        for (auto &s : m_sections) {
+            s.z1 = s.z2 = StereoFrame{0.0f, 0.0f};
+        }
+    }
+
+    void process(float *samples, size_t frames) {
+        for (auto &s : m_sections) {
+            if (!s.active) {
+                continue;
+            }
+            const StereoFrame b0 = s.b0, b1 = s.b1, b2 = s.b2, a1 = s.a1, a2 = s.a2;
+            StereoFrame z1 = s.z1, z2 = s.z2;
+            float *frame = samples;
+            for (size_t i = 0; i < frames; ++i, frame += 2) {
+                StereoFrame x;
+                std::memcpy(&x, frame, sizeof(x));
+                const StereoFrame y = b0 * x + z1;
+                z1 = b1 * x - a1 * y + z2;
+                z2 = b2 * x - a2 * y;
+                std::memcpy(frame, &y, sizeof(y));
+            }
+            s.z1 = z1;
+            s.z2 = z2;
+        }
+    }
+
+private:
+    struct Section {
+        StereoFrame b0{1.0f, 1.0f}, b1{}, b2{}, a1{}, a2{};
+        StereoFrame z1{}, z2{};
+        bool active = false;
+    };
+
+    Section m_sections[MAX_SECTIONS];
+};
+
+} // namespace WaveMux
@@ -0,0 +1,78 @@
+#include "delayline.h"
+#include <algorithm>
+
+namespace WaveMux {
+
+DelayLine::DelayLine(size_t maxDelayFrames, size_t channels)
+    : m_maxDelay(maxDelayFrames)
+    , m_channels(channels)
+    , m_capacity(maxDelayFrames + MAX_BLOCK_FRAMES)
+    , m_history(m_capacity * channels, 0.0f)
+    , m_fade(MAX_BLOCK_FRAMES * channels)
+{
+}
+
+void DelayLine::setDelay(size_t frames) {
+    m_targetDelay.store(std::min(frames, m_maxDelay), std::memory_order_relaxed);
+}
+
+const float *DelayLine::process(const float *input, size_t frames) {
+    const size_t target = m_targetDelay.load(std::memory_order_relaxed);
+    if (target == 0 && m_delay == 0) {
+        write(input, frames);
+        return input;
+    }
+
+    if (m_output.size() < frames * m_channels) {
+        m_output.resize(frames * m_channels);  // Only grows when the block size grows
+    }
+    for (size_t done = 0; done < frames; done += MAX_BLOCK_FRAMES) {
+        const size_t chunk = std::min(MAX_BLOCK_FRAMES, frames - done);
+        processChunk(input + done * m_channels, m_output.data() + done * m_channels, chunk);
+    }
+    return m_output.data();
+}
+
+void DelayLine::processChunk(const float *input, float *output, size_t frames) {
+    write(input, frames);
+
+    const size_t target = m_targetDelay.load(std::memory_order_relaxed);
+    read(target, output, frames);
+    if (target == m_delay) {
+        return;
+    }
+
+    // Linear crossfade from the old read position to the new one
+    read(m_delay, m_fade.data(), frames);
+    const float step = 1.0f / static_cast<float>(frames);
+    for (size_t frame = 0; frame < frames; ++frame) {
+        const float mix = step * static_cast<float>(frame + 1);
+        for (size_t ch = 0; ch < m_channels; ++ch) {
+            const size_t i = frame * m_channels + ch;
+            output[i] = m_fade[i] + (output[i] - m_fade[i]) * mix;
+        }
+    }
+    m_delay = target;
+}
+
+void DelayLine::write(const float *input, size_t frames) {
+    // Blocks longer than the history only leave their tail behind
+    if (frames > m_capacity) {
+        input += (frames - m_capacity) * m_channels;
+        frames = m_capacity;
+    }
+    const size_t first = std::min(frames, m_capacity - m_writeFrame);
+    std::copy(input, input + first * m_channels, m_history.begin() + m_writeFrame * m_channels);
+    std::copy(input + first * m_channels, input + frames * m_channels, m_history.begin());
+    m_writeFrame = (m_writeFrame + frames) % m_capacity;
+}
+
+void DelayLine::read(size_t delayFrames, float *output, size_t frames) const {
+    // The block just written ends at m_writeFrame; step back over it and the delay
+    const size_t start = (m_writeFrame + m_capacity * 2 - frames - delayFrames) % m_capacity;
+    const size_t first = std::min(frames, m_capacity - start);
+    std::copy(m_history.begin() + start * m_channels, m_history.begin() + (start + first) * m_channels, output);
+    std::copy(m_history.begin(), m_history.begin() + (frames - first) * m_channels, output + first * m_channels);
+}
+
+} // namespace WaveMux
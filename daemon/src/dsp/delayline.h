@@ -0,0 +1,45 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace WaveMux {
+
+// Sample-accurate delay for interleaved frames, to line a faster path up with
+// a slower one. All history is allocated up front for the longest delay. The
+// delay may be changed from any thread; the audio thread crossfades from the
+// old to the new delay over one block instead of jumping.
+class DelayLine {
+public:
+    // Longer blocks are processed in pieces of this size
+    static constexpr size_t MAX_BLOCK_FRAMES = 1024;
+
+    DelayLine(size_t maxDelayFrames, size_t channels);
+
+    size_t maxDelay() const { return m_maxDelay; }
+    void setDelay(size_t frames);  // Clamped to maxDelay()
+    size_t delay() const { return m_targetDelay.load(std::memory_order_relaxed); }
+
+    // Audio thread. Always feeds the history, so a delay switched on later
+    // starts from real audio. Returns the delayed frames: input itself while
+    // the delay is zero, else an internal buffer valid until the next call.
+    const float *process(const float *input, size_t frames);
+
+private:
+    void processChunk(const float *input, float *output, size_t frames);
+    void write(const float *input, size_t frames);
+    void read(size_t delayFrames, float *output, size_t frames) const;
+
+    size_t m_maxDelay;
+    size_t m_channels;
+    size_t m_capacity;  // Frames of history: longest delay plus one chunk
+    std::vector<float> m_history;
+    std::vector<float> m_output;
+    std::vector<float> m_fade;  // Audio thread: old delay's output while crossfading
+    size_t m_writeFrame = 0;
+    size_t m_delay = 0;  // Audio thread: delay applied in the last block
+    std::atomic<size_t> m_targetDelay{0};
+};
+
+} // namespace WaveMux
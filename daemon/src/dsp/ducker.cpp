@@ -0,0 +1,93 @@
+#include "ducker.h"
+#include <algorithm>
+#include <cmath>
+
+namespace WaveMux {
+
+namespace {
+    // Soft knee around the threshold so speech hovering at the threshold
+    // doesn't toggle the ducking on and off
+    constexpr float KNEE_DB = 6.0f;
+    constexpr float SILENCE = 1e-9f;
+}
+
+Ducker::Ducker(float sampleRate)
+    : m_sampleRate(sampleRate)
+    , m_detector(sampleRate, 1.0f, 50.0f)
+{
+}
+
+void Ducker::setSampleRate(float sampleRate) {
+    m_sampleRate = sampleRate;
+    m_detector.setSampleRate(sampleRate);
+    m_appliedAttackMs = -1.0f;  // Recompute coefficients on the next block
+}
+
+void Ducker::setSettings(const DuckingSettings &settings) {
+    m_depthDb.store(std::max(0.0f, settings.depthDb), std::memory_order_relaxed);
+    m_thresholdDb.store(settings.thresholdDb, std::memory_order_relaxed);
+    m_attackMs.store(std::max(0.0f, settings.attackMs), std::memory_order_relaxed);
+    m_releaseMs.store(std::max(0.0f, settings.releaseMs), std::memory_order_relaxed);
+    m_enabled.store(settings.enabled, std::memory_order_release);
+}
+
+DuckingSettings Ducker::settings() const {
+    DuckingSettings settings;
+    settings.enabled = m_enabled.load(std::memory_order_acquire);
+    settings.depthDb = m_depthDb.load(std::memory_order_relaxed);
+    settings.thresholdDb = m_thresholdDb.load(std::memory_order_relaxed);
+    settings.attackMs = m_attackMs.load(std::memory_order_relaxed);
+    settings.releaseMs = m_releaseMs.load(std::memory_order_relaxed);
+    return settings;
+}
+
+void Ducker::reset() {
+    m_detector.reset();
+    m_gainDb = 0.0f;
+    m_reductionDb.store(0.0f, std::memory_order_relaxed);
+}
+
+void Ducker::updateCoefficients(float attackMs, float releaseMs) {
+    if (attackMs == m_appliedAttackMs && releaseMs == m_appliedReleaseMs) {
+        return;
+    }
+    m_attackCoeff = EnvelopeFollower::timeToCoeff(attackMs, m_sampleRate);
+    m_releaseCoeff = EnvelopeFollower::timeToCoeff(releaseMs, m_sampleRate);
+    m_appliedAttackMs = attackMs;
+    m_appliedReleaseMs = releaseMs;
+}
+
+void Ducker::process(const float *trigger, size_t frames, size_t channels, float *gains) {
+    // Snapshot the settings once per block
+    const bool enabled = m_enabled.load(std::memory_order_acquire);
+    const float depthDb = m_depthDb.load(std::memory_order_relaxed);
+    const float thresholdDb = m_thresholdDb.load(std::memory_order_relaxed);
+    updateCoefficients(m_attackMs.load(std::memory_order_relaxed),
+                       m_releaseMs.load(std::memory_order_relaxed));
+
+    for (size_t frame = 0; frame < frames; ++frame) {
+        float level = 0.0f;
+        if (trigger) {
+            for (size_t ch = 0; ch < channels; ++ch) {
+                level = std::max(level, std::fabs(trigger[frame * channels + ch]));
+            }
+        }
+
+        const float envelope = m_detector.process(level);
+        float targetDb = 0.0f;
+        if (enabled) {
+            const float envelopeDb = 20.0f * std::log10(std::max(envelope, SILENCE));
+            const float amount = std::clamp((envelopeDb - thresholdDb) / KNEE_DB + 0.5f, 0.0f, 1.0f);
+            targetDb = -depthDb * amount;
+        }
+
+        // Ducking down uses the attack time, recovering uses the release time
+        const float coeff = targetDb < m_gainDb ? m_attackCoeff : m_releaseCoeff;
+        m_gainDb = targetDb + coeff * (m_gainDb - targetDb);
+        gains[frame] = std::pow(10.0f, m_gainDb / 20.0f);
+    }
+
+    m_reductionDb.store(-m_gainDb, std::memory_order_relaxed);
+}
+
+} // namespace WaveMux
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "envelopefollower.h"
+#include <atomic>
+#include <cstddef>
+
+namespace WaveMux {
+
+struct DuckingSettings {
+    bool enabled = false;
+    float depthDb = 12.0f;       // Attenuation of the targets while the trigger is active
+    float thresholdDb = -40.0f;  // Trigger level (dBFS peak) considered "active"
+    float attackMs = 10.0f;      // How fast targets duck
+    float releaseMs = 400.0f;    // How fast they come back
+};
+
+// Sidechain ducker: follows the trigger signal and produces a per-frame gain
+// for the target signals. Settings may be changed from any thread; they are
+// picked up at the start of the next block.
+class Ducker {
+public:
+    explicit Ducker(float sampleRate = 48000.0f);
+
+    void setSampleRate(float sampleRate);
+    void setSettings(const DuckingSettings &settings);
+    DuckingSettings settings() const;
+    void reset();
+
+    // trigger: interleaved frames x channels (nullptr = silence).
+    // Writes one linear gain per frame into gains.
+    void process(const float *trigger, size_t frames, size_t channels, float *gains);
+
+    // Current attenuation in dB (>= 0), readable from any thread
+    float gainReductionDb() const { return m_reductionDb.load(std::memory_order_relaxed); }
+
+private:
+    void updateCoefficients(float attackMs, float releaseMs);
+
+    std::atomic<bool> m_enabled{false};
+    std::atomic<float> m_depthDb{12.0f};
+    std::atomic<float> m_thresholdDb{-40.0f};
+    std::atomic<float> m_attackMs{10.0f};
+    std::atomic<float> m_releaseMs{400.0f};
+    std::atomic<float> m_reductionDb{0.0f};
+
+    // Audio thread state
+    float m_sampleRate;
+    EnvelopeFollower m_detector;
+    float m_gainDb = 0.0f;
+    float m_appliedAttackMs = -1.0f;
+    float m_appliedReleaseMs = -1.0f;
+    float m_attackCoeff = 0.0f;
+    float m_releaseCoeff = 0.0f;
+};
+
+} // namespace WaveMux
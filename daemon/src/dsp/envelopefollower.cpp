@@ -0,0 +1,33 @@
+#include "envelopefollower.h"
+#include <cmath>
+
+namespace WaveMux {
+
+EnvelopeFollower::EnvelopeFollower(float sampleRate, float attackMs, float releaseMs)
+    : m_sampleRate(sampleRate)
+    , m_attackMs(attackMs)
+    , m_releaseMs(releaseMs)
+{
+    setTimes(attackMs, releaseMs);
+}
+
+void EnvelopeFollower::setSampleRate(float sampleRate) {
+    m_sampleRate = sampleRate;
+    setTimes(m_attackMs, m_releaseMs);
+}
+
+void EnvelopeFollower::setTimes(float attackMs, float releaseMs) {
+    m_attackMs = attackMs;
+    m_releaseMs = releaseMs;
+    m_attackCoeff = timeToCoeff(attackMs, m_sampleRate);
+    m_releaseCoeff = timeToCoeff(releaseMs, m_sampleRate);
+}
+
+float EnvelopeFollower::timeToCoeff(float ms, float sampleRate) {
+    if (ms <= 0.0f || sampleRate <= 0.0f) {
+        return 0.0f;  // Instant
+    }
+    return std::exp(-1.0f / (ms * 0.001f * sampleRate));
+}
+
+} // namespace WaveMux
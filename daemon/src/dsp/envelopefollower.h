@@ -0,0 +1,35 @@
+#pragma once
+
+namespace WaveMux {
+
+// Peak envelope with separate attack and release time constants (one-pole)
+class EnvelopeFollower {
+public:
+    explicit EnvelopeFollower(float sampleRate = 48000.0f, float attackMs = 1.0f, float releaseMs = 50.0f);
+
+    void setSampleRate(float sampleRate);
+    void setTimes(float attackMs, float releaseMs);
+    void reset() { m_envelope = 0.0f; }
+
+    // Feed one rectified sample, returns the current envelope
+    float process(float level) {
+        const float coeff = level > m_envelope ? m_attackCoeff : m_releaseCoeff;
+        m_envelope = level + coeff * (m_envelope - level);
+        return m_envelope;
+    }
+
+    float value() const { return m_envelope; }
+
+    // exp(-1 / (time * sampleRate)): fraction of the distance left after one sample
+    static float timeToCoeff(float ms, float sampleRate);
+
+private:
+    float m_sampleRate;
+    float m_attackMs;
+    float m_releaseMs;
+    float m_attackCoeff = 0.0f;
+    float m_releaseCoeff = 0.0f;
+    float m_envelope = 0.0f;
+};
+
+} // namespace WaveMux
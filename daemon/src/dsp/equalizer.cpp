@@ -0,0 +1,173 @@
+#include "equalizer.h"
+#include <algorithm>
+#include <cmath>
+
+namespace WaveMux {
+
+namespace {
+    // Time constant of parameter changes
+    constexpr float GLIDE_SECONDS = 0.05f;
+    // Closer than this to the target counts as arrived (ratio, dB, ratio)
+    constexpr float FREQUENCY_EPSILON = 1e-3f;
+    constexpr float GAIN_EPSILON = 0.01f;
+    constexpr float Q_EPSILON = 1e-3f;
+}
+
+const char *eqBandTypeName(EqBandType type) {
+    switch (type) {
+    case EqBandType::Peak: return "peak";
+    case EqBandType::LowShelf: return "lowshelf";
+    case EqBandType::HighShelf: return "highshelf";
+    case EqBandType::HighPass: return "highpass";
+    case EqBandType::LowPass: return "lowpass";
+    }
+    return "peak";
+}
+
+std::optional<EqBandType> eqBandTypeFromName(const std::string &name) {
+    for (EqBandType type : {EqBandType::Peak, EqBandType::LowShelf, EqBandType::HighShelf,
+                            EqBandType::HighPass, EqBandType::LowPass}) {
+        if (name == eqBandTypeName(type)) {
+            return type;
+        }
+    }
+    return std::nullopt;
+}
+
+BiquadCoefficients designBiquad(const EqBand &band, float sampleRate) {
+    const double frequency = std::clamp(static_cast<double>(band.frequency), 10.0, 0.45 * sampleRate);
+    const double q = std::clamp(static_cast<double>(band.q), 0.1, 18.0);
+    const double w0 = 2.0 * M_PI * frequency / sampleRate;
+    const double cosW = std::cos(w0);
+    const double alpha = std::sin(w0) / (2.0 * q);
+    const double a = std::pow(10.0, band.gainDb / 40.0);
+    const double sqrtA2Alpha = 2.0 * std::sqrt(a) * alpha;
+
+    double b0 = 1.0, b1 = 0.0, b2 = 0.0, a0 = 1.0, a1 = 0.0, a2 = 0.0;
+    switch (band.type) {
+    case EqBandType::Peak:
+        b0 = 1.0 + alpha * a;
+        b1 = -2.0 * cosW;
+        b2 = 1.0 - alpha * a;
+        a0 = 1.0 + alpha / a;
+        a1 = -2.0 * cosW;
+        a2 = 1.0 - alpha / a;
+        break;
+    case EqBandType::LowShelf:
+        b0 = a * ((a + 1.0) - (a - 1.0) * cosW + sqrtA2Alpha);
+        b1 = 2.0 * a * ((a - 1.0) - (a + 1.0) * cosW);
+        b2 = a * ((a + 1.0) - (a - 1.0) * cosW - sqrtA2Alpha);
+        a0 = (a + 1.0) + (a - 1.0) * cosW + sqrtA2Alpha;
+        a1 = -2.0 * ((a - 1.0) + (a + 1.0) * cosW);
+        a2 = (a + 1.0) + (a - 1.0) * cosW - sqrtA2Alpha;
+        break;
+    case EqBandType::HighShelf:
+        b0 = a * ((a + 1.0) + (a - 1.0) * cosW + sqrtA2Alpha);
+        b1 = -2.0 * a * ((a - 1.0) + (a + 1.0) * cosW);
+        b2 = a * ((a + 1.0) + (a - 1.0) * cosW - sqrtA2Alpha);
+        a0 = (a + 1.0) - (a - 1.0) * cosW + sqrtA2Alpha;
+        a1 = 2.0 * ((a - 1.0) - (a + 1.0) * cosW);
+        a2 = (a + 1.0) - (a - 1.0) * cosW - sqrtA2Alpha;
+        break;
+    case EqBandType::HighPass:
+        b0 = (1.0 + cosW) / 2.0;
+        b1 = -(1.0 + cosW);
+        b2 = (1.0 + cosW) / 2.0;
+        a0 = 1.0 + alpha;
+        a1 = -2.0 * cosW;
+        a2 = 1.0 - alpha;
+        break;
+    case EqBandType::LowPass:
+        b0 = (1.0 - cosW) / 2.0;
+        b1 = 1.0 - cosW;
+        b2 = (1.0 - cosW) / 2.0;
+        a0 = 1.0 + alpha;
+        a1 = -2.0 * cosW;
+        a2 = 1.0 - alpha;
+        break;
+    }
+
+    BiquadCoefficients c;
+    c.b0 = static_cast<float>(b0 / a0);
+    c.b1 = static_cast<float>(b1 / a0);
+    c.b2 = static_cast<float>(b2 / a0);
+    c.a1 = static_cast<float>(a1 / a0);
+    c.a2 = static_cast<float>(a2 / a0);
+    return c;
+}
+
+Equalizer::Equalizer(float sampleRate)
+    : m_sampleRate(sampleRate)
+{
+}
+
+void Equalizer::setBands(const std::vector<EqBand> &bands) {
+    Bands &next = m_pending.back();
+    next.count = std::min(bands.size(), MAX_BANDS);
+    std::copy_n(bands.begin(), next.count, next.bands.begin());
+    m_pending.publish();
+}
+
+const float *Equalizer::process(const float *input, size_t frames) {
+    if (m_pending.update()) {
+        const Bands &bands = m_pending.front();
+        m_activeBands = 0;
+        for (size_t i = 0; i < MAX_BANDS; ++i) {
+            EqBand band = i < bands.count ? bands.bands[i] : EqBand();
+            band.enabled = band.enabled && i < bands.count;
+
+            // A band that was off or changed type starts at its target;
+            // otherwise it glides there from where it is now
+            if (!m_cascade.sectionActive(i) || band.type != m_current[i].type) {
+                m_current[i] = band;
+            }
+            m_current[i].enabled = band.enabled;
+            m_target[i] = band;
+            m_settled[i] = false;
+            m_cascade.setSectionActive(i, band.enabled);
+            m_activeBands += band.enabled ? 1 : 0;
+        }
+    }
+
+    if (m_activeBands == 0) {
+        return input;
+    }
+
+    glide(frames);
+
+    if (m_output.size() < frames * 2) {
+        m_output.resize(frames * 2);  // Only grows when the block size grows
+    }
+    std::copy(input, input + frames * 2, m_output.begin());
+    m_cascade.process(m_output.data(), frames);
+    return m_output.data();
+}
+
+void Equalizer::glide(size_t frames) {
+    const float step = 1.0f - std::exp(-static_cast<float>(frames) / (GLIDE_SECONDS * m_sampleRate));
+
+    for (size_t i = 0; i < MAX_BANDS; ++i) {
+        if (m_settled[i] || !m_target[i].enabled) {
+            continue;
+        }
+        EqBand &current = m_current[i];
+        const EqBand &target = m_target[i];
+
+        // Frequency and Q move geometrically, gain linearly in dB
+        const float frequencyRatio = std::log(target.frequency / current.frequency);
+        const float qRatio = std::log(target.q / current.q);
+        const float gainDiff = target.gainDb - current.gainDb;
+        if (std::abs(frequencyRatio) < FREQUENCY_EPSILON && std::abs(qRatio) < Q_EPSILON
+            && std::abs(gainDiff) < GAIN_EPSILON) {
+            current = target;
+            m_settled[i] = true;
+        } else {
+            current.frequency *= std::exp(frequencyRatio * step);
+            current.q *= std::exp(qRatio * step);
+            current.gainDb += gainDiff * step;
+        }
+        m_cascade.setSection(i, designBiquad(current, m_sampleRate));
+    }
+}
+
+} // namespace WaveMux
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "biquad.h"
+#include "triplebuffer.h"
+#include <array>
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace WaveMux {
+
+enum class EqBandType {
+    Peak,
+    LowShelf,
+    HighShelf,
+    HighPass,
+    LowPass
+};
+
+struct EqBand {
+    EqBandType type = EqBandType::Peak;
+    bool enabled = true;
+    float frequency = 1000.0f;  // Hz: center, shelf midpoint or cutoff
+    float gainDb = 0.0f;        // Ignored by the pass filters
+    float q = 0.707f;
+};
+
+// Stable names for config files and D-Bus: "peak", "lowshelf", "highshelf",
+// "highpass", "lowpass"
+const char *eqBandTypeName(EqBandType type);
+std::optional<EqBandType> eqBandTypeFromName(const std::string &name);
+
+// RBJ cookbook design of one band
+BiquadCoefficients designBiquad(const EqBand &band, float sampleRate);
+
+// Parametric EQ for one stereo signal, up to MAX_BANDS bands in series.
+// Bands are set from the control thread and handed to the audio thread
+// through a triple buffer. Frequency, gain and Q glide to their new values
+// over a few blocks instead of jumping; type changes and toggling a band
+// take effect at the next block.
+class Equalizer {
+public:
+    static constexpr size_t MAX_BANDS = StereoBiquadCascade::MAX_SECTIONS;
+
+    explicit Equalizer(float sampleRate = 48000.0f);
+
+    // Control thread. Bands beyond MAX_BANDS are ignored.
+    void setBands(const std::vector<EqBand> &bands);
+
+    // Audio thread: filters interleaved stereo frames. Returns input
+    // untouched when no band is enabled, else an internal buffer holding
+    // the result (valid until the next call).
+    const float *process(const float *input, size_t frames);
+
+private:
+    struct Bands {
+        std::array<EqBand, MAX_BANDS> bands;
+        size_t count = 0;
+    };
+
+    void glide(size_t frames);
+
+    float m_sampleRate;
+    TripleBuffer<Bands> m_pending;
+
+    // Audio thread state
+    std::array<EqBand, MAX_BANDS> m_target;
+    std::array<EqBand, MAX_BANDS> m_current;
+    std::array<bool, MAX_BANDS> m_settled{};
+    size_t m_activeBands = 0;
+    StereoBiquadCascade m_cascade;
+    std::vector<float> m_output;
+};
+
+} // namespace WaveMux
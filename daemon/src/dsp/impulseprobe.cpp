@@ -0,0 +1,65 @@
+#include "impulseprobe.h"
+#include <algorithm>
+#include <cmath>
+
+namespace WaveMux {
+
+namespace {
+    constexpr double PI = 3.14159265358979323846;
+    constexpr double START_HZ = 500.0;
+    constexpr double END_HZ = 8000.0;
+}
+
+ImpulseProbe::ImpulseProbe(float sampleRate) {
+    const size_t length = static_cast<size_t>(sampleRate * DURATION_MS / 1000.0f);
+    const double duration = length / static_cast<double>(sampleRate);
+    const double rate = std::log(END_HZ / START_HZ);
+    m_signal.resize(length);
+    for (size_t i = 0; i < length; ++i) {
+        // Exponential sweep under a Hann window
+        const double t = i / static_cast<double>(sampleRate);
+        const double phase = 2.0 * PI * START_HZ * duration / rate * (std::exp(t / duration * rate) - 1.0);
+        const double window = 0.5 - 0.5 * std::cos(2.0 * PI * i / (length - 1));
+        m_signal[i] = static_cast<float>(LEVEL * window * std::sin(phase));
+        m_energy += static_cast<double>(m_signal[i]) * m_signal[i];
+    }
+}
+
+std::optional<size_t> ImpulseProbe::find(const float *recording, size_t count) const {
+    const size_t length = m_signal.size();
+    if (count < length) {
+        return std::nullopt;
+    }
+
+    // Running energy of the recording under the probe, for normalization
+    double windowEnergy = 0.0;
+    for (size_t i = 0; i < length; ++i) {
+        windowEnergy += static_cast<double>(recording[i]) * recording[i];
+    }
+
+    std::optional<size_t> best;
+    double bestScore = MIN_SCORE;
+    for (size_t offset = 0; offset + length <= count; ++offset) {
+        if (offset > 0) {
+            const double leaving = recording[offset - 1];
+            const double entering = recording[offset + length - 1];
+            windowEnergy = std::max(0.0, windowEnergy - leaving * leaving + entering * entering);
+        }
+        if (windowEnergy <= 0.0) {
+            continue;
+        }
+
+        float dot = 0.0f;
+        for (size_t i = 0; i < length; ++i) {
+            dot += recording[offset + i] * m_signal[i];
+        }
+        const double score = dot / std::sqrt(m_energy * windowEnergy);
+        if (score > bestScore) {
+            bestScore = score;
+            best = offset;
+        }
+    }
+    return best;
+}
+
+} // namespace WaveMux
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+namespace WaveMux {
+
+// Test signal for latency measurements: a short windowed sweep whose
+// autocorrelation has a single sharp peak, so it can be found to the sample
+// in a recording even under other audio. Mono.
+class ImpulseProbe {
+public:
+    static constexpr float DURATION_MS = 20.0f;
+    static constexpr float LEVEL = 0.5f;  // Peak amplitude
+    // Normalized correlation needed to accept a match (1.0 = exact copy)
+    static constexpr float MIN_SCORE = 0.5f;
+
+    explicit ImpulseProbe(float sampleRate = 48000.0f);
+
+    const std::vector<float> &signal() const { return m_signal; }
+
+    // Sample offset of the probe's start in recording, if it is clearly there
+    std::optional<size_t> find(const float *recording, size_t count) const;
+
+private:
+    std::vector<float> m_signal;
+    double m_energy = 0.0;
+};
+
+} // namespace WaveMux
@@ -0,0 +1,116 @@
+#include "limiter.h"
+#include "envelopefollower.h"
+#include <algorithm>
+#include <cmath>
+
+namespace WaveMux {
+
+Limiter::Limiter(float sampleRate, float lookaheadMs)
+    : m_sampleRate(sampleRate)
+    , m_window(std::max<size_t>(1, static_cast<size_t>(lookaheadMs * 0.001f * sampleRate)))
+    , m_minValues(m_window)
+    , m_minIndexes(m_window)
+    , m_averageRing(m_window)
+    , m_delay(latency() * CHANNELS)
+{
+    reset();
+}
+
+void Limiter::setSettings(const LimiterSettings &settings) {
+    m_ceilingDb.store(std::min(0.0f, settings.ceilingDb), std::memory_order_relaxed);
+    m_releaseMs.store(std::max(1.0f, settings.releaseMs), std::memory_order_relaxed);
+    m_enabled.store(settings.enabled, std::memory_order_release);
+}
+
+LimiterSettings Limiter::settings() const {
+    LimiterSettings settings;
+    settings.enabled = m_enabled.load(std::memory_order_acquire);
+    settings.ceilingDb = m_ceilingDb.load(std::memory_order_relaxed);
+    settings.releaseMs = m_releaseMs.load(std::memory_order_relaxed);
+    return settings;
+}
+
+void Limiter::reset() {
+    m_detector.reset();
+    m_minHead = 0;
+    m_minCount = 0;
+    m_frameIndex = 0;
+    m_releasedGain = 1.0f;
+    std::fill(m_averageRing.begin(), m_averageRing.end(), 1.0f);
+    m_averagePosition = 0;
+    m_averageSum = static_cast<double>(m_window);
+    std::fill(m_delay.begin(), m_delay.end(), 0.0f);
+    m_delayPosition = 0;
+    m_reductionDb.store(0.0f, std::memory_order_relaxed);
+}
+
+float Limiter::pushMinimum(float value) {
+    const size_t capacity = m_window;
+
+    // Drop the entry that left the window
+    if (m_minCount > 0 && m_minIndexes[m_minHead] + m_window <= m_frameIndex) {
+        m_minHead = (m_minHead + 1) % capacity;
+        --m_minCount;
+    }
+    // Drop entries that can never be the minimum again
+    while (m_minCount > 0) {
+        const size_t last = (m_minHead + m_minCount - 1) % capacity;
+        if (m_minValues[last] < value) {
+            break;
+        }
+        --m_minCount;
+    }
+    const size_t slot = (m_minHead + m_minCount) % capacity;
+    m_minValues[slot] = value;
+    m_minIndexes[slot] = m_frameIndex;
+    ++m_minCount;
+    ++m_frameIndex;
+
+    return m_minValues[m_minHead];
+}
+
+void Limiter::process(float *samples, size_t frames) {
+    if (!m_enabled.load(std::memory_order_acquire)) {
+        return;
+    }
+
+    const float ceiling = std::pow(10.0f, m_ceilingDb.load(std::memory_order_relaxed) / 20.0f);
+    const float releaseCoeff = EnvelopeFollower::timeToCoeff(m_releaseMs.load(std::memory_order_relaxed), m_sampleRate);
+    const size_t delayFrames = m_delay.size() / CHANNELS;
+    float minGain = 1.0f;
+
+    for (size_t frame = 0; frame < frames; ++frame) {
+        float *sample = samples + frame * CHANNELS;
+
+        float peak = 0.0f;
+        for (size_t ch = 0; ch < CHANNELS; ++ch) {
+            peak = std::max(peak, m_detector.process(ch, sample[ch]));
+        }
+        const float needed = peak > ceiling ? ceiling / peak : 1.0f;
+
+        // Hold the lowest gain over the lookahead, recover with the release time
+        const float held = pushMinimum(needed);
+        m_releasedGain = held < m_releasedGain ? held : held + releaseCoeff * (m_releasedGain - held);
+
+        // Averaging over the window turns the step into a ramp that ends
+        // exactly when the peak comes out of the delay line
+        m_averageSum += m_releasedGain - m_averageRing[m_averagePosition];
+        m_averageRing[m_averagePosition] = m_releasedGain;
+        m_averagePosition = (m_averagePosition + 1) % m_window;
+        const float gain = std::min(1.0f, static_cast<float>(m_averageSum / m_window));
+        minGain = std::min(minGain, gain);
+
+        float *delayed = &m_delay[m_delayPosition * CHANNELS];
+        for (size_t ch = 0; ch < CHANNELS; ++ch) {
+            const float input = sample[ch];
+            // Final clamp catches what the 4x true-peak estimate under-reads
+            sample[ch] = std::clamp(delayed[ch] * gain, -ceiling, ceiling);
+            delayed[ch] = input;
+        }
+        m_delayPosition = (m_delayPosition + 1) % delayFrames;
+    }
+
+    m_reductionDb.store(-20.0f * std::log10(std::max(minGain, 1e-6f)), std::memory_order_relaxed);
+}
+
+} // namespace WaveMux
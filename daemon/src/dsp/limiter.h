@@ -0,0 +1,69 @@
+#pragma once
+
+#include "truepeak.h"
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace WaveMux {
+
+struct LimiterSettings {
+    bool enabled = false;
+    float ceilingDb = -1.0f;    // Maximum true peak (dBTP)
+    float releaseMs = 100.0f;   // Recovery time after a peak
+};
+
+// Lookahead brickwall limiter on interleaved stereo. Every frame's true peak
+// determines the gain it needs; that gain is held over the lookahead window
+// and then averaged across it, so the gain is already fully down when the
+// (delayed) peak reaches the output - no overshoot, no clicks. Adds
+// latency() frames of delay while enabled.
+class Limiter {
+public:
+    static constexpr size_t CHANNELS = 2;
+
+    explicit Limiter(float sampleRate = 48000.0f, float lookaheadMs = 1.5f);
+
+    void setSettings(const LimiterSettings &settings);  // Any thread
+    LimiterSettings settings() const;
+    void reset();
+
+    size_t latency() const { return m_window - 1 + TruePeakDetector::LATENCY; }
+
+    // In place; frames interleaved stereo frames
+    void process(float *samples, size_t frames);
+
+    float gainReductionDb() const { return m_reductionDb.load(std::memory_order_relaxed); }
+
+private:
+    float pushMinimum(float value);
+
+    std::atomic<bool> m_enabled{false};
+    std::atomic<float> m_ceilingDb{-1.0f};
+    std::atomic<float> m_releaseMs{100.0f};
+    std::atomic<float> m_reductionDb{0.0f};
+
+    float m_sampleRate;
+    size_t m_window;  // Lookahead in frames
+
+    TruePeakDetector m_detector;
+
+    // Sliding-window minimum (monotonic queue over a ring of m_window entries)
+    std::vector<float> m_minValues;
+    std::vector<size_t> m_minIndexes;
+    size_t m_minHead = 0;
+    size_t m_minCount = 0;
+    size_t m_frameIndex = 0;
+
+    // Release smoothing and moving average of the held gain
+    float m_releasedGain = 1.0f;
+    std::vector<float> m_averageRing;
+    size_t m_averagePosition = 0;
+    double m_averageSum = 0.0;
+
+    // Audio delay line (interleaved)
+    std::vector<float> m_delay;
+    size_t m_delayPosition = 0;
+};
+
+} // namespace WaveMux
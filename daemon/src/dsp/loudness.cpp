@@ -0,0 +1,165 @@
+#include "loudness.h"
+#include <algorithm>
+#include <cmath>
+
+namespace WaveMux {
+
+namespace {
+    // Below this the signal counts as silence (BS.1770 absolute gate)
+    constexpr float GATE_LUFS = -50.0f;
+    // Time constant of the normalization gain: slow enough to be inaudible
+    constexpr float NORMALIZER_TIME_SECONDS = 2.0f;
+
+    float meanSquareToLufs(double meanSquare) {
+        if (meanSquare <= 1e-10) {
+            return LoudnessMeter::SILENCE_LUFS;
+        }
+        return std::max(LoudnessMeter::SILENCE_LUFS, static_cast<float>(-0.691 + 10.0 * std::log10(meanSquare)));
+    }
+}
+
+LoudnessMeter::LoudnessMeter(float sampleRate)
+    : m_blockFrames(static_cast<size_t>(sampleRate / 10.0f))
+{
+    // K-weighting for any sample rate (BS.1770 stage 1 high shelf, stage 2 RLB high-pass)
+    const double pi = M_PI;
+    {
+        const double f0 = 1681.974450955533;
+        const double gainDb = 3.999843853973347;
+        const double q = 0.7071752369554196;
+        const double k = std::tan(pi * f0 / sampleRate);
+        const double vh = std::pow(10.0, gainDb / 20.0);
+        const double vb = std::pow(vh, 0.4996667741545416);
+        const double a0 = 1.0 + k / q + k * k;
+        BiquadCoefficients c;
+        c.b0 = static_cast<float>((vh + vb * k / q + k * k) / a0);
+        c.b1 = static_cast<float>(2.0 * (k * k - vh) / a0);
+        c.b2 = static_cast<float>((vh - vb * k / q + k * k) / a0);
+        c.a1 = static_cast<float>(2.0 * (k * k - 1.0) / a0);
+        c.a2 = static_cast<float>((1.0 - k / q + k * k) / a0);
+        for (auto &shelf : m_shelf) {
+            shelf.setCoefficients(c);
+        }
+    }
+    {
+        const double f0 = 38.13547087602444;
+        const double q = 0.5003270373238773;
+        const double k = std::tan(pi * f0 / sampleRate);
+        const double a0 = 1.0 + k / q + k * k;
+        BiquadCoefficients c;
+        c.b0 = 1.0f;
+        c.b1 = -2.0f;
+        c.b2 = 1.0f;
+        c.a1 = static_cast<float>(2.0 * (k * k - 1.0) / a0);
+        c.a2 = static_cast<float>((1.0 - k / q + k * k) / a0);
+        for (auto &highpass : m_highpass) {
+            highpass.setCoefficients(c);
+        }
+    }
+}
+
+void LoudnessMeter::reset() {
+    for (size_t ch = 0; ch < CHANNELS; ++ch) {
+        m_shelf[ch].reset();
+        m_highpass[ch].reset();
+    }
+    m_blockFill = 0;
+    m_blockSum = 0.0;
+    m_blocks.fill(0.0);
+    m_blockPosition = 0;
+    m_blockCount = 0;
+    m_momentary.store(SILENCE_LUFS, std::memory_order_relaxed);
+    m_shortTerm.store(SILENCE_LUFS, std::memory_order_relaxed);
+}
+
+void LoudnessMeter::process(const float *samples, size_t frames) {
+    for (size_t frame = 0; frame < frames; ++frame) {
+        for (size_t ch = 0; ch < CHANNELS; ++ch) {
+            const float weighted = m_highpass[ch].process(m_shelf[ch].process(samples[frame * CHANNELS + ch]));
+            m_blockSum += static_cast<double>(weighted) * weighted;
+        }
+        if (++m_blockFill == m_blockFrames) {
+            finishBlock();
+        }
+    }
+}
+
+void LoudnessMeter::finishBlock() {
+    m_blocks[m_blockPosition] = m_blockSum / static_cast<double>(m_blockFrames);
+    m_blockPosition = (m_blockPosition + 1) % SHORT_TERM_BLOCKS;
+    m_blockCount = std::min(m_blockCount + 1, SHORT_TERM_BLOCKS);
+    m_blockFill = 0;
+    m_blockSum = 0.0;
+
+    // Windows are averaged over the blocks seen so far until they are full
+    double shortTerm = 0.0;
+    double momentary = 0.0;
+    for (size_t i = 0; i < m_blockCount; ++i) {
+        const double block = m_blocks[(m_blockPosition + SHORT_TERM_BLOCKS - 1 - i) % SHORT_TERM_BLOCKS];
+        shortTerm += block;
+        if (i < MOMENTARY_BLOCKS) {
+            momentary += block;
+        }
+    }
+    m_shortTerm.store(meanSquareToLufs(shortTerm / m_blockCount), std::memory_order_relaxed);
+    m_momentary.store(meanSquareToLufs(momentary / std::min(m_blockCount, MOMENTARY_BLOCKS)), std::memory_order_relaxed);
+}
+
+LoudnessNormalizer::LoudnessNormalizer(float sampleRate)
+    : m_sampleRate(sampleRate)
+    , m_meter(sampleRate)
+{
+}
+
+void LoudnessNormalizer::setSettings(const LoudnessSettings &settings) {
+    m_targetLufs.store(settings.targetLufs, std::memory_order_relaxed);
+    m_maxGainDb.store(std::max(0.0f, settings.maxGainDb), std::memory_order_relaxed);
+    m_enabled.store(settings.enabled, std::memory_order_release);
+}
+
+LoudnessSettings LoudnessNormalizer::settings() const {
+    LoudnessSettings settings;
+    settings.enabled = m_enabled.load(std::memory_order_acquire);
+    settings.targetLufs = m_targetLufs.load(std::memory_order_relaxed);
+    settings.maxGainDb = m_maxGainDb.load(std::memory_order_relaxed);
+    return settings;
+}
+
+void LoudnessNormalizer::reset() {
+    m_meter.reset();
+    m_gainDb = 0.0f;
+    m_gainDbReading.store(0.0f, std::memory_order_relaxed);
+}
+
+void LoudnessNormalizer::process(float *samples, size_t frames) {
+    m_meter.process(samples, frames);
+
+    float targetGainDb = 0.0f;
+    if (m_enabled.load(std::memory_order_acquire)) {
+        const float loudness = m_meter.shortTermLufs();
+        const float maxGainDb = m_maxGainDb.load(std::memory_order_relaxed);
+        targetGainDb = loudness > GATE_LUFS
+            ? std::clamp(m_targetLufs.load(std::memory_order_relaxed) - loudness, -maxGainDb, maxGainDb)
+            : m_gainDb;  // Silence: hold
+    }
+
+    // One smoothing step per block, ramped linearly across it
+    const float coeff = std::exp(-static_cast<float>(frames) / (NORMALIZER_TIME_SECONDS * m_sampleRate));
+    const float startGain = std::pow(10.0f, m_gainDb / 20.0f);
+    m_gainDb = targetGainDb + coeff * (m_gainDb - targetGainDb);
+    const float endGain = std::pow(10.0f, m_gainDb / 20.0f);
+    m_gainDbReading.store(m_gainDb, std::memory_order_relaxed);
+
+    if (startGain == 1.0f && endGain == 1.0f) {
+        return;
+    }
+    const float step = (endGain - startGain) / static_cast<float>(frames);
+    for (size_t frame = 0; frame < frames; ++frame) {
+        const float gain = startGain + step * static_cast<float>(frame + 1);
+        for (size_t ch = 0; ch < LoudnessMeter::CHANNELS; ++ch) {
+            samples[frame * LoudnessMeter::CHANNELS + ch] *= gain;
+        }
+    }
+}
+
+} // namespace WaveMux
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "biquad.h"
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+namespace WaveMux {
+
+// EBU R128 / ITU-R BS.1770 loudness of interleaved stereo: K-weighting,
+// mean square over 100 ms blocks, momentary (400 ms) and short-term (3 s)
+// windows. Readings are in LUFS and may be read from any thread.
+class LoudnessMeter {
+public:
+    static constexpr size_t CHANNELS = 2;
+    static constexpr float SILENCE_LUFS = -70.0f;
+
+    explicit LoudnessMeter(float sampleRate = 48000.0f);
+
+    void reset();
+    void process(const float *samples, size_t frames);
+
+    float momentaryLufs() const { return m_momentary.load(std::memory_order_relaxed); }
+    float shortTermLufs() const { return m_shortTerm.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr size_t SHORT_TERM_BLOCKS = 30;  // 3 s
+    static constexpr size_t MOMENTARY_BLOCKS = 4;    // 400 ms
+
+    void finishBlock();
+
+    std::array<Biquad, CHANNELS> m_shelf;
+    std::array<Biquad, CHANNELS> m_highpass;
+
+    size_t m_blockFrames;
+    size_t m_blockFill = 0;
+    double m_blockSum = 0.0;
+    std::array<double, SHORT_TERM_BLOCKS> m_blocks{};
+    size_t m_blockPosition = 0;
+    size_t m_blockCount = 0;
+
+    std::atomic<float> m_momentary{SILENCE_LUFS};
+    std::atomic<float> m_shortTerm{SILENCE_LUFS};
+};
+
+struct LoudnessSettings {
+    bool enabled = false;
+    float targetLufs = -16.0f;  // Short-term loudness the mix is steered towards
+    float maxGainDb = 12.0f;    // Largest boost or cut applied
+};
+
+// Slowly steers the short-term loudness of a signal towards a target. Gain
+// is held during silence so background noise is never pulled up.
+class LoudnessNormalizer {
+public:
+    explicit LoudnessNormalizer(float sampleRate = 48000.0f);
+
+    void setSettings(const LoudnessSettings &settings);  // Any thread
+    LoudnessSettings settings() const;
+    void reset();
+
+    // In place, interleaved stereo. Measures the input even while disabled.
+    void process(float *samples, size_t frames);
+
+    float gainDb() const { return m_gainDbReading.load(std::memory_order_relaxed); }
+    const LoudnessMeter &inputMeter() const { return m_meter; }
+
+private:
+    std::atomic<bool> m_enabled{false};
+    std::atomic<float> m_targetLufs{-16.0f};
+    std::atomic<float> m_maxGainDb{12.0f};
+    std::atomic<float> m_gainDbReading{0.0f};
+
+    float m_sampleRate;
+    LoudnessMeter m_meter;
+    float m_gainDb = 0.0f;
+};
+
+} // namespace WaveMux
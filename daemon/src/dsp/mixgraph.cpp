@@ -0,0 +1,122 @@
+#include "mixgraph.h"
+#include <algorithm>
+
+namespace WaveMux {
+
+MixGraph::MixGraph(size_t strips, float sampleRate)
+    : m_sampleRate(sampleRate)
+    , m_ducker(sampleRate)
+    , m_normalizer(sampleRate)
+    , m_limiter(sampleRate)
+    , m_outputMeter(sampleRate)
+{
+    for (size_t i = 0; i < strips; ++i) {
+        m_strips.push_back(std::make_unique<Strip>(sampleRate));
+    }
+    m_delayed.resize(strips);
+}
+
+void MixGraph::setStripGain(size_t strip, float gain) {
+    if (strip < m_strips.size()) {
+        m_strips[strip]->targetGain.store(std::max(0.0f, gain), std::memory_order_relaxed);
+    }
+}
+
+void MixGraph::setDuckingRouting(int triggerStrip, uint32_t targetMask) {
+    m_duckTargets.store(targetMask, std::memory_order_relaxed);
+    m_triggerStrip.store(triggerStrip, std::memory_order_relaxed);
+}
+
+void MixGraph::setStripEq(size_t strip, const std::vector<EqBand> &bands) {
+    if (strip < m_strips.size()) {
+        m_strips[strip]->eq.setBands(bands);
+    }
+}
+
+void MixGraph::setStripGate(size_t strip, const NoiseGateSettings &settings) {
+    if (strip < m_strips.size()) {
+        m_strips[strip]->gate.setSettings(settings);
+    }
+}
+
+const NoiseGate *MixGraph::stripGate(size_t strip) const {
+    return strip < m_strips.size() ? &m_strips[strip]->gate : nullptr;
+}
+
+void MixGraph::setStripDelay(size_t strip, size_t frames) {
+    if (strip < m_strips.size()) {
+        m_strips[strip]->delay.setDelay(frames);
+    }
+}
+
+size_t MixGraph::stripDelay(size_t strip) const {
+    return strip < m_strips.size() ? m_strips[strip]->delay.delay() : 0;
+}
+
+size_t MixGraph::maxDelayFrames() const {
+    return m_strips.empty() ? 0 : m_strips.front()->delay.maxDelay();
+}
+
+void MixGraph::process(const float *const *inputs, float *output, size_t frames) {
+    if (m_duckGains.size() < frames) {
+        m_duckGains.resize(frames);  // Only grows when the block size grows
+    }
+
+    // The ducker always runs so that it releases smoothly after being disabled
+    const int trigger = m_triggerStrip.load(std::memory_order_relaxed);
+    const uint32_t duckTargets = m_duckTargets.load(std::memory_order_relaxed);
+    const bool validTrigger = trigger >= 0 && static_cast<size_t>(trigger) < m_strips.size();
+
+    // Delays first, for every strip: silent strips keep their history
+    // current, and the ducker keys off the aligned trigger
+    for (size_t s = 0; s < m_strips.size(); ++s) {
+        m_delayed[s] = m_strips[s]->delay.process(inputs[s], frames);
+    }
+
+    m_ducker.process(validTrigger ? m_delayed[trigger] : nullptr, frames, CHANNELS, m_duckGains.data());
+
+    std::fill(output, output + frames * CHANNELS, 0.0f);
+
+    for (size_t s = 0; s < m_strips.size(); ++s) {
+        Strip &strip = *m_strips[s];
+
+        // Level changes ramp linearly across the block (no zipper noise)
+        const float start = strip.gain;
+        const float target = strip.targetGain.load(std::memory_order_relaxed);
+        const float step = (target - start) / static_cast<float>(frames);
+        strip.gain = target;
+
+        const bool ducked = s < 32 && (duckTargets & (1u << s));
+        if (start == 0.0f && target == 0.0f) {
+            continue;  // Silent strip
+        }
+
+        const float *input = m_delayed[s];
+        if (!strip.gate.isBypassed()) {
+            if (strip.gated.size() < frames * CHANNELS) {
+                strip.gated.resize(frames * CHANNELS);
+            }
+            std::copy(input, input + frames * CHANNELS, strip.gated.begin());
+            strip.gate.process(strip.gated.data(), frames, CHANNELS);
+            input = strip.gated.data();
+        }
+        input = strip.eq.process(input, frames);
+
+        for (size_t frame = 0; frame < frames; ++frame) {
+            float gain = start + step * static_cast<float>(frame + 1);
+            if (ducked) {
+                gain *= m_duckGains[frame];
+            }
+            for (size_t ch = 0; ch < CHANNELS; ++ch) {
+                output[frame * CHANNELS + ch] += input[frame * CHANNELS + ch] * gain;
+            }
+        }
+    }
+
+    // Bus: level the loudness first, then catch whatever peaks remain
+    m_normalizer.process(output, frames);
+    m_limiter.process(output, frames);
+    m_outputMeter.process(output, frames);
+}
+
+} // namespace WaveMux
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "delayline.h"
+#include "ducker.h"
+#include "equalizer.h"
+#include "limiter.h"
+#include "loudness.h"
+#include "noisegate.h"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace WaveMux {
+
+// pactl volume percentages are on a cubic scale; the mix engine applies
+// the same curve so a level sounds identical in both routing modes
+inline float percentToGain(int percent) {
+    const float linear = std::clamp(percent, 0, 100) / 100.0f;
+    return linear * linear * linear;
+}
+
+// Processing for one output mix: every channel ("strip") gets its alignment
+// delay, gate, EQ, mix level and optional ducking, then all strips are summed and the bus runs through
+// loudness normalization and the limiter (each optional) and a meter.
+// Audio is interleaved stereo float. Parameters are set from the control
+// thread and picked up by the audio thread at the next block, without locks.
+class MixGraph {
+public:
+    static constexpr size_t CHANNELS = 2;
+    static constexpr float MAX_DELAY_MS = 500.0f;  // Longest per-strip alignment delay
+
+    MixGraph(size_t strips, float sampleRate);
+
+    size_t stripCount() const { return m_strips.size(); }
+    float sampleRate() const { return m_sampleRate; }
+
+    // Control thread
+    void setStripGain(size_t strip, float gain);
+    void setDuckingRouting(int triggerStrip, uint32_t targetMask);
+    void setStripEq(size_t strip, const std::vector<EqBand> &bands);
+    void setStripGate(size_t strip, const NoiseGateSettings &settings);
+    const NoiseGate *stripGate(size_t strip) const;
+    void setStripDelay(size_t strip, size_t frames);
+    size_t stripDelay(size_t strip) const;
+    size_t maxDelayFrames() const;
+    Ducker &ducker() { return m_ducker; }
+    const Ducker &ducker() const { return m_ducker; }
+    LoudnessNormalizer &normalizer() { return m_normalizer; }
+    const LoudnessNormalizer &normalizer() const { return m_normalizer; }
+    Limiter &limiter() { return m_limiter; }
+    const Limiter &limiter() const { return m_limiter; }
+    const LoudnessMeter &outputMeter() const { return m_outputMeter; }
+
+    // Audio thread: inputs[strip] holds frames interleaved stereo frames;
+    // output (same layout) is overwritten with the mix
+    void process(const float *const *inputs, float *output, size_t frames);
+
+private:
+    struct Strip {
+        explicit Strip(float sampleRate)
+            : delay(static_cast<size_t>(sampleRate * MAX_DELAY_MS / 1000.0f), CHANNELS)
+            , gate(sampleRate)
+            , eq(sampleRate)
+        {
+        }
+
+        std::atomic<float> targetGain{0.0f};
+        float gain = 0.0f;  // Audio thread: level reached at the end of the last block
+        DelayLine delay;
+        NoiseGate gate;
+        Equalizer eq;
+        std::vector<float> gated;  // Audio thread: gate output
+    };
+
+    float m_sampleRate;
+    std::vector<std::unique_ptr<Strip>> m_strips;  // Atomics are not movable
+    std::atomic<int> m_triggerStrip{-1};
+    std::atomic<uint32_t> m_duckTargets{0};
+    Ducker m_ducker;
+    std::vector<float> m_duckGains;
+    std::vector<const float *> m_delayed;  // Audio thread: each strip's input after its delay
+    LoudnessNormalizer m_normalizer;
+    Limiter m_limiter;
+    LoudnessMeter m_outputMeter;
+};
+
+} // namespace WaveMux
@@ -0,0 +1,104 @@
+#include "noisegate.h"
+#include <algorithm>
+#include <cmath>
+
+namespace WaveMux {
+
+namespace {
+    float dbToGain(float db) {
+        return std::pow(10.0f, db / 20.0f);
+    }
+}
+
+NoiseGate::NoiseGate(float sampleRate)
+    : m_sampleRate(sampleRate)
+    , m_detector(sampleRate, 0.5f, 20.0f)  // Fast, so the first syllable isn't clipped
+{
+}
+
+void NoiseGate::setSettings(const NoiseGateSettings &settings) {
+    m_thresholdDb.store(settings.thresholdDb, std::memory_order_relaxed);
+    m_hysteresisDb.store(std::max(0.0f, settings.hysteresisDb), std::memory_order_relaxed);
+    m_rangeDb.store(std::max(0.0f, settings.rangeDb), std::memory_order_relaxed);
+    m_attackMs.store(std::max(0.0f, settings.attackMs), std::memory_order_relaxed);
+    m_holdMs.store(std::max(0.0f, settings.holdMs), std::memory_order_relaxed);
+    m_releaseMs.store(std::max(0.0f, settings.releaseMs), std::memory_order_relaxed);
+    m_enabled.store(settings.enabled, std::memory_order_release);
+}
+
+NoiseGateSettings NoiseGate::settings() const {
+    NoiseGateSettings settings;
+    settings.enabled = m_enabled.load(std::memory_order_acquire);
+    settings.thresholdDb = m_thresholdDb.load(std::memory_order_relaxed);
+    settings.hysteresisDb = m_hysteresisDb.load(std::memory_order_relaxed);
+    settings.rangeDb = m_rangeDb.load(std::memory_order_relaxed);
+    settings.attackMs = m_attackMs.load(std::memory_order_relaxed);
+    settings.holdMs = m_holdMs.load(std::memory_order_relaxed);
+    settings.releaseMs = m_releaseMs.load(std::memory_order_relaxed);
+    return settings;
+}
+
+void NoiseGate::reset() {
+    m_detector.reset();
+    m_gateOpen = true;
+    m_holdRemaining = 0;
+    m_gain = 1.0f;
+    m_open.store(true, std::memory_order_relaxed);
+    m_reductionDb.store(0.0f, std::memory_order_relaxed);
+}
+
+bool NoiseGate::isBypassed() const {
+    return !m_enabled.load(std::memory_order_acquire) && m_gain >= 1.0f;
+}
+
+void NoiseGate::process(float *samples, size_t frames, size_t channels) {
+    // Snapshot the settings once per block
+    const bool enabled = m_enabled.load(std::memory_order_acquire);
+    const float openLevel = dbToGain(m_thresholdDb.load(std::memory_order_relaxed));
+    const float closeLevel = openLevel * dbToGain(-m_hysteresisDb.load(std::memory_order_relaxed));
+    const float floor = dbToGain(-m_rangeDb.load(std::memory_order_relaxed));
+    const size_t holdFrames = static_cast<size_t>(m_holdMs.load(std::memory_order_relaxed) * m_sampleRate / 1000.0f);
+    // The gain moves in constant dB steps, so it covers the whole range in
+    // exactly the attack/release time
+    const float rangeDb = m_rangeDb.load(std::memory_order_relaxed);
+    const float attackFrames = std::max(1.0f, m_attackMs.load(std::memory_order_relaxed) * m_sampleRate / 1000.0f);
+    const float releaseFrames = std::max(1.0f, m_releaseMs.load(std::memory_order_relaxed) * m_sampleRate / 1000.0f);
+    const float openStep = dbToGain(rangeDb / attackFrames);
+    const float closeStep = dbToGain(-rangeDb / releaseFrames);
+
+    for (size_t frame = 0; frame < frames; ++frame) {
+        float *frameSamples = samples + frame * channels;
+        float level = 0.0f;
+        for (size_t ch = 0; ch < channels; ++ch) {
+            level = std::max(level, std::fabs(frameSamples[ch]));
+        }
+        const float envelope = m_detector.process(level);
+
+        if (!enabled || envelope >= openLevel) {
+            m_gateOpen = true;
+            m_holdRemaining = holdFrames;
+        } else if (envelope < closeLevel) {
+            if (m_holdRemaining > 0) {
+                --m_holdRemaining;
+            } else {
+                m_gateOpen = false;
+            }
+        }
+
+        // Between the two levels the gate keeps its state
+        if (m_gateOpen) {
+            m_gain = std::min(1.0f, std::max(m_gain, floor) * openStep);
+        } else {
+            m_gain = std::max(floor, m_gain * closeStep);
+        }
+
+        for (size_t ch = 0; ch < channels; ++ch) {
+            frameSamples[ch] *= m_gain;
+        }
+    }
+
+    m_open.store(m_gateOpen, std::memory_order_relaxed);
+    m_reductionDb.store(-20.0f * std::log10(std::max(m_gain, 1e-9f)), std::memory_order_relaxed);
+}
+
+} // namespace WaveMux
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "envelopefollower.h"
+#include <atomic>
+#include <cstddef>
+
+namespace WaveMux {
+
+struct NoiseGateSettings {
+    bool enabled = false;
+    float thresholdDb = -45.0f;   // Opens when the signal (dBFS peak) rises above this
+    float hysteresisDb = 6.0f;    // ... and closes only once it falls this far below
+    float rangeDb = 60.0f;        // Attenuation while closed
+    float attackMs = 1.0f;        // Time to open fully
+    float holdMs = 80.0f;         // Stays open this long after the signal drops
+    float releaseMs = 120.0f;     // Time to close fully
+};
+
+// Downward gate for a microphone: passes speech, silences the background
+// between words. Works in place on interleaved frames. Settings may be
+// changed from any thread; they are picked up at the start of the next block.
+class NoiseGate {
+public:
+    explicit NoiseGate(float sampleRate = 48000.0f);
+
+    void setSettings(const NoiseGateSettings &settings);
+    NoiseGateSettings settings() const;
+    void reset();
+
+    // Audio thread. True while disabled and fully open, i.e. process() would
+    // not change the signal.
+    bool isBypassed() const;
+    void process(float *samples, size_t frames, size_t channels);
+
+    // Readable from any thread
+    bool isOpen() const { return m_open.load(std::memory_order_relaxed); }
+    float gainReductionDb() const { return m_reductionDb.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<bool> m_enabled{false};
+    std::atomic<float> m_thresholdDb{-45.0f};
+    std::atomic<float> m_hysteresisDb{6.0f};
+    std::atomic<float> m_rangeDb{60.0f};
+    std::atomic<float> m_attackMs{1.0f};
+    std::atomic<float> m_holdMs{80.0f};
+    std::atomic<float> m_releaseMs{120.0f};
+    std::atomic<bool> m_open{true};
+    std::atomic<float> m_reductionDb{0.0f};
+
+    // Audio thread state
+    float m_sampleRate;
+    EnvelopeFollower m_detector;
+    bool m_gateOpen = true;
+    size_t m_holdRemaining = 0;
+    float m_gain = 1.0f;
+};
+
+} // namespace WaveMux
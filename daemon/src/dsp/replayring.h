@@ -0,0 +1,108 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace WaveMux {
+
+// Rolling history of the most recent audio for "save the last N seconds".
+// One writer thread keeps appending and overwrites the oldest samples; any
+// other thread can copy out the newest stretch at any time without taking a
+// lock. All storage is allocated up front. Compact rings keep 16-bit samples
+// (half the memory of float), which is plenty for a replay clip.
+class ReplayRing {
+public:
+    // maxWriteSamples bounds a single write(); it is kept as extra headroom
+    // so a reader never returns samples a write in progress is replacing
+    ReplayRing(size_t historySamples, size_t maxWriteSamples, bool compact)
+        : m_history(historySamples)
+        , m_maxWrite(maxWriteSamples)
+        , m_capacity(historySamples + maxWriteSamples)
+        , m_compact(compact)
+    {
+        if (compact) {
+            m_pcm.resize(m_capacity);
+        } else {
+            m_float.resize(m_capacity);
+        }
+    }
+
+    size_t history() const { return m_history; }
+    bool isCompact() const { return m_compact; }
+    size_t memoryBytes() const { return m_pcm.size() * sizeof(int16_t) + m_float.size() * sizeof(float); }
+
+    // Total samples ever written
+    uint64_t written() const { return m_written.load(std::memory_order_acquire); }
+
+    // Writer
+    void write(const float *samples, size_t count) {
+        count = std::min(count, m_maxWrite);
+        const uint64_t position = m_written.load(std::memory_order_relaxed);
+        const size_t at = static_cast<size_t>(position % m_capacity);
+        const size_t first = std::min(count, m_capacity - at);
+        if (m_compact) {
+            std::transform(samples, samples + first, m_pcm.begin() + at, toPcm);
+            std::transform(samples + first, samples + count, m_pcm.begin(), toPcm);
+        } else {
+            std::copy(samples, samples + first, m_float.begin() + at);
+            std::copy(samples + first, samples + count, m_float.begin());
+        }
+        m_written.store(position + count, std::memory_order_release);
+    }
+
+    // Any thread: copies up to maxSamples of the newest history into out,
+    // oldest first, and returns how many were copied
+    size_t snapshot(float *out, size_t maxSamples) const {
+        const uint64_t end = m_written.load(std::memory_order_acquire);
+        size_t count = static_cast<size_t>(std::min<uint64_t>({end, maxSamples, m_history}));
+        const uint64_t start = end - count;
+        copyOut(start, count, out);
+
+        // The writer may have lapped part of what was copied while we were
+        // at it; everything older than one history behind it is suspect
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const uint64_t now = m_written.load(std::memory_order_relaxed);
+        const uint64_t oldestValid = now > m_history ? now - m_history : 0;
+        if (start < oldestValid) {
+            const size_t stale = static_cast<size_t>(std::min<uint64_t>(oldestValid - start, count));
+            std::copy(out + stale, out + count, out);
+            count -= stale;
+        }
+        return count;
+    }
+
+private:
+    static int16_t toPcm(float sample) {
+        return static_cast<int16_t>(std::lrint(std::clamp(sample, -1.0f, 1.0f) * 32767.0f));
+    }
+
+    static float fromPcm(int16_t sample) {
+        return sample * (1.0f / 32767.0f);
+    }
+
+    void copyOut(uint64_t start, size_t count, float *out) const {
+        const size_t at = static_cast<size_t>(start % m_capacity);
+        const size_t first = std::min(count, m_capacity - at);
+        if (m_compact) {
+            std::transform(m_pcm.begin() + at, m_pcm.begin() + at + first, out, fromPcm);
+            std::transform(m_pcm.begin(), m_pcm.begin() + (count - first), out + first, fromPcm);
+        } else {
+            std::copy(m_float.begin() + at, m_float.begin() + at + first, out);
+            std::copy(m_float.begin(), m_float.begin() + (count - first), out + first);
+        }
+    }
+
+    size_t m_history;
+    size_t m_maxWrite;
+    size_t m_capacity;
+    bool m_compact;
+    std::vector<int16_t> m_pcm;
+    std::vector<float> m_float;
+    alignas(64) std::atomic<uint64_t> m_written{0};
+};
+
+} // namespace WaveMux
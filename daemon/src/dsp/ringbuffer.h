@@ -0,0 +1,68 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace WaveMux {
+
+// Lock-free ring buffer for exactly one producer thread and one consumer
+// thread. Neither side ever blocks: write() stores what fits, read() takes
+// what is there. Capacity is rounded up to a power of two.
+template <typename T>
+class SpscRingBuffer {
+public:
+    explicit SpscRingBuffer(size_t minCapacity) {
+        size_t capacity = 1;
+        while (capacity < minCapacity) {
+            capacity <<= 1;
+        }
+        m_buffer.resize(capacity);
+        m_mask = capacity - 1;
+    }
+
+    size_t capacity() const { return m_buffer.size(); }
+
+    // Producer
+    size_t writeAvailable() const {
+        return capacity() - (m_writePos.load(std::memory_order_relaxed) - m_readPos.load(std::memory_order_acquire));
+    }
+
+    size_t write(const T *data, size_t count) {
+        const size_t writePos = m_writePos.load(std::memory_order_relaxed);
+        count = std::min(count, writeAvailable());
+        const size_t start = writePos & m_mask;
+        const size_t first = std::min(count, capacity() - start);
+        std::copy(data, data + first, m_buffer.begin() + start);
+        std::copy(data + first, data + count, m_buffer.begin());
+        m_writePos.store(writePos + count, std::memory_order_release);
+        return count;
+    }
+
+    // Consumer
+    size_t readAvailable() const {
+        return m_writePos.load(std::memory_order_acquire) - m_readPos.load(std::memory_order_relaxed);
+    }
+
+    size_t read(T *data, size_t count) {
+        const size_t readPos = m_readPos.load(std::memory_order_relaxed);
+        count = std::min(count, readAvailable());
+        const size_t start = readPos & m_mask;
+        const size_t first = std::min(count, capacity() - start);
+        std::copy(m_buffer.begin() + start, m_buffer.begin() + start + first, data);
+        std::copy(m_buffer.begin(), m_buffer.begin() + (count - first), data + first);
+        m_readPos.store(readPos + count, std::memory_order_release);
+        return count;
+    }
+
+private:
+    std::vector<T> m_buffer;
+    size_t m_mask = 0;
+    // Each position is written by one side only; separate cache lines keep
+    // the two threads from invalidating each other
+    alignas(64) std::atomic<size_t> m_writePos{0};
+    alignas(64) std::atomic<size_t> m_readPos{0};
+};
+
+} // namespace WaveMux
@@ -0,0 +1,166 @@
+#include "spectrum.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace WaveMux {
+
+namespace {
+    constexpr double PI = 3.14159265358979323846;
+
+    // Four floats per vector operation (GCC/Clang vector extension)
+    typedef float Float4 __attribute__((vector_size(4 * sizeof(float))));
+
+    Float4 load(const float *p) {
+        Float4 v;
+        std::memcpy(&v, p, sizeof(v));
+        return v;
+    }
+
+    void store(float *p, Float4 v) {
+        std::memcpy(p, &v, sizeof(v));
+    }
+
+    // One run of `half` butterflies (a = a + w*b, b = a - w*b), four at a
+    // time once the runs are long enough
+    void butterflies(float *ar, float *ai, float *br, float *bi, const float *wr, const float *wi, size_t half) {
+        size_t j = 0;
+        for (; j + 4 <= half; j += 4) {
+            const Float4 xr = load(br + j), xi = load(bi + j);
+            const Float4 cr = load(wr + j), ci = load(wi + j);
+            const Float4 tr = xr * cr - xi * ci;
+            const Float4 ti = xr * ci + xi * cr;
+            const Float4 yr = load(ar + j), yi = load(ai + j);
+            store(br + j, yr - tr);
+            store(bi + j, yi - ti);
+            store(ar + j, yr + tr);
+            store(ai + j, yi + ti);
+        }
+        for (; j < half; ++j) {
+            const float tr = br[j] * wr[j] - bi[j] * wi[j];
+            const float ti = br[j] * wi[j] + bi[j] * wr[j];
+            br[j] = ar[j] - tr;
+            bi[j] = ai[j] - ti;
+            ar[j] += tr;
+            ai[j] += ti;
+        }
+    }
+}
+
+SpectrumAnalyzer::SpectrumAnalyzer(float sampleRate)
+    : m_sampleRate(sampleRate)
+    , m_window(FFT_SIZE)
+    , m_re(HALF)
+    , m_im(HALF)
+    , m_splitRe(HALF)
+    , m_splitIm(HALF)
+    , m_bitReverse(HALF)
+    , m_power(BINS)
+{
+    for (size_t n = 0; n < FFT_SIZE; ++n) {
+        m_window[n] = static_cast<float>(0.5 - 0.5 * std::cos(2.0 * PI * n / FFT_SIZE));
+    }
+
+    size_t bits = 0;
+    while ((size_t(1) << bits) < HALF) {
+        ++bits;
+    }
+    for (size_t i = 0; i < HALF; ++i) {
+        size_t reversed = 0;
+        for (size_t bit = 0; bit < bits; ++bit) {
+            reversed |= ((i >> bit) & 1) << (bits - 1 - bit);
+        }
+        m_bitReverse[i] = reversed;
+    }
+
+    // Stage with butterflies `half` apart uses exp(-i*pi*j/half), j < half
+    for (size_t half = 1; half < HALF; half <<= 1) {
+        for (size_t j = 0; j < half; ++j) {
+            m_twiddleRe.push_back(static_cast<float>(std::cos(PI * j / half)));
+            m_twiddleIm.push_back(static_cast<float>(-std::sin(PI * j / half)));
+        }
+    }
+
+    for (size_t k = 0; k < HALF; ++k) {
+        m_splitRe[k] = static_cast<float>(std::cos(2.0 * PI * k / FFT_SIZE));
+        m_splitIm[k] = static_cast<float>(-std::sin(2.0 * PI * k / FFT_SIZE));
+    }
+
+    const float binWidth = sampleRate / FFT_SIZE;
+    const float ratio = MAX_FREQUENCY / MIN_FREQUENCY;
+    for (size_t band = 0; band < BANDS; ++band) {
+        const float low = MIN_FREQUENCY * std::pow(ratio, static_cast<float>(band) / BANDS);
+        const float high = MIN_FREQUENCY * std::pow(ratio, static_cast<float>(band + 1) / BANDS);
+        Band b;
+        b.first = std::min(static_cast<size_t>(std::ceil(low / binWidth)), BINS - 1);
+        b.last = std::min(static_cast<size_t>(std::floor(high / binWidth)), BINS - 1);
+        b.position = std::min(std::sqrt(low * high) / binWidth, static_cast<float>(BINS - 1));
+        m_bands.push_back(b);
+    }
+}
+
+float SpectrumAnalyzer::bandCenter(size_t band) const {
+    return m_bands[band].position * m_sampleRate / FFT_SIZE;
+}
+
+void SpectrumAnalyzer::transform() {
+    // Iterative radix-2 decimation in time on bit-reversed input
+    size_t stage = 0;
+    for (size_t half = 1; half < HALF; half <<= 1) {
+        const float *wr = m_twiddleRe.data() + stage;
+        const float *wi = m_twiddleIm.data() + stage;
+        for (size_t start = 0; start < HALF; start += 2 * half) {
+            float *re = m_re.data() + start;
+            float *im = m_im.data() + start;
+            butterflies(re, im, re + half, im + half, wr, wi, half);
+        }
+        stage += half;
+    }
+}
+
+void SpectrumAnalyzer::analyze(const float *samples, float *bandsDb) {
+    // A real signal of N points is packed into N/2 complex ones (even samples
+    // real, odd imaginary) and unpacked afterwards: half the work of a full
+    // complex transform
+    for (size_t n = 0; n < HALF; ++n) {
+        const size_t at = m_bitReverse[n];
+        m_re[at] = samples[2 * n] * m_window[2 * n];
+        m_im[at] = samples[2 * n + 1] * m_window[2 * n + 1];
+    }
+    transform();
+
+    // Hann coherent gain is 1/2, so a full-scale sine peaks at N/4
+    const float scale = 16.0f / (static_cast<float>(FFT_SIZE) * FFT_SIZE);
+    for (size_t k = 0; k <= HALF; ++k) {
+        const size_t a = k % HALF;
+        const size_t b = (HALF - k) % HALF;
+        // Even part E = (Z[k] + conj Z[N/2-k]) / 2, odd part O = (Z[k] - conj Z[N/2-k]) / 2i
+        const float er = 0.5f * (m_re[a] + m_re[b]);
+        const float ei = 0.5f * (m_im[a] - m_im[b]);
+        const float orr = 0.5f * (m_im[a] + m_im[b]);
+        const float oi = -0.5f * (m_re[a] - m_re[b]);
+        const float wr = k < HALF ? m_splitRe[k] : -1.0f;
+        const float wi = k < HALF ? m_splitIm[k] : 0.0f;
+        const float xr = er + orr * wr - oi * wi;
+        const float xi = ei + orr * wi + oi * wr;
+        m_power[k] = (xr * xr + xi * xi) * scale;
+    }
+
+    const float floor = std::pow(10.0f, FLOOR_DB / 10.0f);
+    for (size_t band = 0; band < BANDS; ++band) {
+        const Band &b = m_bands[band];
+        float power = 0.0f;
+        if (b.first <= b.last) {
+            power = *std::max_element(m_power.begin() + b.first, m_power.begin() + b.last + 1);
+        } else {
+            // Narrower than a bin (low end): interpolate between neighbours
+            const size_t below = static_cast<size_t>(b.position);
+            const size_t above = std::min(below + 1, BINS - 1);
+            const float t = b.position - below;
+            power = m_power[below] + (m_power[above] - m_power[below]) * t;
+        }
+        bandsDb[band] = 10.0f * std::log10(std::max(power, floor));
+    }
+}
+
+} // namespace WaveMux
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace WaveMux {
+
+// Display spectrum of a mono signal: a Hann-windowed 1024-point FFT reduced
+// to BANDS log-spaced bands between MIN_FREQUENCY and MAX_FREQUENCY. Each
+// band shows its loudest bin, so a full-scale sine reads 0 dBFS whatever
+// the band width. Not thread-safe; one analyzer per analysis thread.
+class SpectrumAnalyzer {
+public:
+    static constexpr size_t FFT_SIZE = 1024;
+    static constexpr size_t BINS = FFT_SIZE / 2 + 1;
+    static constexpr size_t BANDS = 64;
+    static constexpr float MIN_FREQUENCY = 20.0f;
+    static constexpr float MAX_FREQUENCY = 20000.0f;
+    static constexpr float FLOOR_DB = -120.0f;
+
+    explicit SpectrumAnalyzer(float sampleRate = 48000.0f);
+
+    // samples: the newest FFT_SIZE samples, oldest first. Writes BANDS levels
+    // in dBFS (never below FLOOR_DB).
+    void analyze(const float *samples, float *bandsDb);
+
+    // Power of each bin from the last analyze(), normalized so a full-scale
+    // sine on a bin is 1.0
+    const std::vector<float> &binPowers() const { return m_power; }
+    float bandCenter(size_t band) const;
+
+private:
+    static constexpr size_t HALF = FFT_SIZE / 2;
+
+    void transform();
+
+    float m_sampleRate;
+    std::vector<float> m_window;
+    // Complex FFT of HALF points in split (re/im) arrays, so butterflies run
+    // over contiguous floats, four per vector operation
+    std::vector<float> m_re;
+    std::vector<float> m_im;
+    std::vector<float> m_twiddleRe;  // Per stage, contiguous
+    std::vector<float> m_twiddleIm;
+    std::vector<float> m_splitRe;    // Real-FFT unpacking factors
+    std::vector<float> m_splitIm;
+    std::vector<size_t> m_bitReverse;
+    std::vector<float> m_power;
+    struct Band {
+        size_t first;     // Bin range, inclusive
+        size_t last;
+        float position;   // Fractional bin of the center, for bands narrower than a bin
+    };
+    std::vector<Band> m_bands;
+};
+
+} // namespace WaveMux
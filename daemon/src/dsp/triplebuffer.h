@@ -0,0 +1,40 @@
+#pragma once
+
+#include <atomic>
+
+namespace WaveMux {
+
+// Hands a value of T from one writer thread to one reader thread without
+// locks or tearing. The writer fills back() and publishes it; the reader
+// picks up the most recent published value with update(). Neither side
+// ever waits, and values published in between are simply skipped.
+template <typename T>
+class TripleBuffer {
+public:
+    // Writer thread
+    T &back() { return m_slots[m_back]; }
+    void publish() {
+        m_back = m_middle.exchange(m_back | DIRTY, std::memory_order_acq_rel) & INDEX;
+    }
+
+    // Reader thread: true if front() changed
+    bool update() {
+        if (!(m_middle.load(std::memory_order_acquire) & DIRTY)) {
+            return false;
+        }
+        m_front = m_middle.exchange(m_front, std::memory_order_acq_rel) & INDEX;
+        return true;
+    }
+    const T &front() const { return m_slots[m_front]; }
+
+private:
+    static constexpr int INDEX = 3;
+    static constexpr int DIRTY = 4;
+
+    T m_slots[3];
+    int m_back = 0;
+    std::atomic<int> m_middle{1};
+    int m_front = 2;
+};
+
+} // namespace WaveMux
@@ -0,0 +1,61 @@
+#include "truepeak.h"
+#include <algorithm>
+#include <cmath>
+
+namespace WaveMux {
+
+TruePeakDetector::TruePeakDetector() {
+    // Windowed-sinc interpolator cut off at the original Nyquist frequency,
+    // split into one sub-filter per output phase
+    constexpr size_t taps = OVERSAMPLING * TAPS_PER_PHASE;
+    const double center = (taps - 1) / 2.0;
+    for (size_t n = 0; n < taps; ++n) {
+        const double x = (n - center) / OVERSAMPLING;
+        const double sinc = x == 0.0 ? 1.0 : std::sin(M_PI * x) / (M_PI * x);
+        const double window = 0.5 - 0.5 * std::cos(2.0 * M_PI * (n + 0.5) / taps);  // Hann
+        m_phases[n % OVERSAMPLING][n / OVERSAMPLING] = static_cast<float>(sinc * window);
+    }
+
+    // Unity gain at DC for every phase
+    for (auto &phase : m_phases) {
+        float sum = 0.0f;
+        for (float tap : phase) {
+            sum += tap;
+        }
+        for (float &tap : phase) {
+            tap /= sum;
+        }
+    }
+
+    reset();
+}
+
+void TruePeakDetector::reset() {
+    for (auto &history : m_history) {
+        history.fill(0.0f);
+    }
+    m_position.fill(0);
+}
+
+float TruePeakDetector::process(size_t channel, float sample) {
+    auto &history = m_history[channel];
+    size_t &position = m_position[channel];
+
+    // Newest sample at the lowest index of the contiguous window
+    position = position == 0 ? TAPS_PER_PHASE - 1 : position - 1;
+    history[position] = sample;
+    history[position + TAPS_PER_PHASE] = sample;
+    const float *window = &history[position];
+
+    float peak = 0.0f;
+    for (const auto &phase : m_phases) {
+        float value = 0.0f;
+        for (size_t k = 0; k < TAPS_PER_PHASE; ++k) {
+            value += phase[k] * window[k];
+        }
+        peak = std::max(peak, std::fabs(value));
+    }
+    return peak;
+}
+
+} // namespace WaveMux
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+namespace WaveMux {
+
+// Inter-sample ("true") peak estimate per ITU-R BS.1770: the signal is
+// upsampled 4x with a polyphase FIR and the largest magnitude is reported.
+// Reported peaks lag the input by LATENCY samples.
+class TruePeakDetector {
+public:
+    static constexpr size_t OVERSAMPLING = 4;
+    static constexpr size_t TAPS_PER_PHASE = 12;
+    static constexpr size_t LATENCY = TAPS_PER_PHASE / 2;
+
+    TruePeakDetector();
+
+    void reset();
+
+    // Feed one sample of one channel (channel < MAX_CHANNELS), returns the
+    // largest absolute value among its interpolated points
+    float process(size_t channel, float sample);
+
+    static constexpr size_t MAX_CHANNELS = 2;
+
+private:
+    std::array<std::array<float, TAPS_PER_PHASE>, OVERSAMPLING> m_phases;
+    // History doubled so the newest TAPS_PER_PHASE samples are always contiguous
+    std::array<std::array<float, TAPS_PER_PHASE * 2>, MAX_CHANNELS> m_history;
+    std::array<size_t, MAX_CHANNELS> m_position;
+};
+
+} // namespace WaveMux
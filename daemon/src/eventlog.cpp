@@ -0,0 +1,175 @@
+#include "eventlog.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+
+namespace WaveMux {
+
+namespace {
+    struct Slot {
+        // 2 * index + 1 while being written, 2 * index + 2 once complete
+        std::atomic<uint64_t> sequence{0};
+        EventLog::Event event;
+    };
+
+    Slot g_slots[EventLog::CAPACITY];
+    std::atomic<uint64_t> g_next{0};
+
+    // Name, and how many of a and b the code uses
+    struct CodeInfo {
+        const char *name;
+        int arguments;
+    };
+    constexpr CodeInfo CODES[] = {
+        {"dbus.call", 0},
+        {"channel.volume", 1},
+        {"channel.mute", 1},
+        {"channel.personal", 1},
+        {"channel.stream", 1},
+        {"master.volume", 1},
+        {"app.volume", 2},
+        {"app.mute", 2},
+        {"stream.added", 1},
+        {"stream.removed", 1},
+        {"stream.moved", 1},
+        {"stream.unassigned", 1},
+        {"profile.switched", 0},
+        {"device.added", 0},
+        {"device.removed", 0},
+        {"output.changed", 1},
+        {"loopback.created", 2},
+        {"loopback.removed", 1},
+        {"engine.started", 1},
+        {"engine.failed", 1},
+        {"xrun", 2},
+        {"latency.changed", 1},
+        {"command.failed", 1},
+        {"command.timeout", 0},
+        {"command.nostart", 0},
+        {"config.saved", 0},
+    };
+    static_assert(sizeof(CODES) / sizeof(CODES[0]) == static_cast<size_t>(EventLog::Code::Count),
+                  "every event code needs a name");
+
+    uint32_t threadIndex() {
+        static std::atomic<uint32_t> nextThread{1};
+        thread_local const uint32_t index = nextThread.fetch_add(1, std::memory_order_relaxed);
+        return index;
+    }
+}
+
+void EventLog::record(Code code, const char *subject, int64_t a, int64_t b) {
+    const uint64_t timeUs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+    const uint64_t index = g_next.fetch_add(1, std::memory_order_relaxed);
+    Slot &slot = g_slots[index % CAPACITY];
+    slot.sequence.store(2 * index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.event.timeUs = timeUs;
+    slot.event.thread = threadIndex();
+    slot.event.code = code;
+    slot.event.a = a;
+    slot.event.b = b;
+    std::strncpy(slot.event.subject, subject ? subject : "", SUBJECT_BYTES - 1);
+    slot.event.subject[SUBJECT_BYTES - 1] = '\0';
+    slot.sequence.store(2 * index + 2, std::memory_order_release);
+}
+
+const char *EventLog::codeName(Code code) {
+    const size_t index = static_cast<size_t>(code);
+    return index < static_cast<size_t>(Code::Count) ? CODES[index].name : "unknown";
+}
+
+size_t EventLog::eventCount() {
+    return static_cast<size_t>(std::min<uint64_t>(g_next.load(std::memory_order_relaxed), CAPACITY));
+}
+
+void EventLog::clear() {
+    for (auto &slot : g_slots) {
+        slot.sequence.store(0, std::memory_order_relaxed);
+    }
+    g_next.store(0, std::memory_order_relaxed);
+}
+
+std::vector<EventLog::Event> EventLog::events(size_t maxEvents) {
+    const uint64_t end = g_next.load(std::memory_order_acquire);
+    uint64_t begin = end > CAPACITY ? end - CAPACITY : 0;
+    if (maxEvents > 0 && end - begin > maxEvents) {
+        begin = end - maxEvents;
+    }
+
+    std::vector<Event> result;
+    result.reserve(static_cast<size_t>(end - begin));
+    for (uint64_t index = begin; index < end; ++index) {
+        const Slot &slot = g_slots[index % CAPACITY];
+        if (slot.sequence.load(std::memory_order_acquire) != 2 * index + 2) {
+            continue;  // Still being written, or already overwritten
+        }
+        const Event event = slot.event;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) == 2 * index + 2) {
+            result.push_back(event);
+        }
+    }
+    return result;
+}
+
+std::string EventLog::format(const Event &event) {
+    const std::time_t seconds = static_cast<std::time_t>(event.timeUs / 1000000);
+    std::tm local{};
+    localtime_r(&seconds, &local);
+    char time[16];
+    std::strftime(time, sizeof(time), "%H:%M:%S", &local);
+
+    const size_t index = static_cast<size_t>(event.code);
+    const int arguments = index < static_cast<size_t>(Code::Count) ? CODES[index].arguments : 2;
+    char line[160];
+    int length = std::snprintf(line, sizeof(line), "%s.%06u  t%-2u %-18s", time,
+                               static_cast<unsigned>(event.timeUs % 1000000), event.thread, codeName(event.code));
+    if (event.subject[0] != '\0') {
+        length += std::snprintf(line + length, sizeof(line) - length, " %s", event.subject);
+    }
+    if (arguments >= 1) {
+        length += std::snprintf(line + length, sizeof(line) - length, " %lld", static_cast<long long>(event.a));
+    }
+    if (arguments >= 2) {
+        std::snprintf(line + length, sizeof(line) - length, " %lld", static_cast<long long>(event.b));
+    }
+    return line;
+}
+
+std::string EventLog::text(size_t maxEvents) {
+    std::string out;
+    for (const auto &event : events(maxEvents)) {
+        out += format(event);
+        out += '\n';
+    }
+    return out;
+}
+
+bool RateLimiter::allow(uint64_t nowMs, uint64_t *suppressed) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    *suppressed = 0;
+    if (!m_started || nowMs - m_windowStart >= m_windowMs) {
+        *suppressed = m_suppressed;
+        m_suppressed = 0;
+        m_windowStart = nowMs;
+        m_allowed = 0;
+        m_started = true;
+    }
+    if (m_allowed < m_burst) {
+        ++m_allowed;
+        return true;
+    }
+    ++m_suppressed;
+    return false;
+}
+
+uint64_t RateLimiter::nowMs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+} // namespace WaveMux
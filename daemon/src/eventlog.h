@@ -0,0 +1,103 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace WaveMux {
+
+// Always-on flight recorder: every operation that changes the audio graph or
+// its levels is recorded as a fixed-size binary record into a preallocated
+// ring (the newest CAPACITY are kept), so the last few thousand operations
+// can be reconstructed after an incident even though the hot paths log
+// nothing by default. Recording is lock-free and costs about as much as
+// reading the clock.
+class EventLog {
+public:
+    static constexpr size_t CAPACITY = 4096;    // Events kept
+    static constexpr size_t SUBJECT_BYTES = 48; // Longer subjects are cut
+
+    enum class Code : uint16_t {
+        DBusCall,          // subject: method
+        ChannelVolume,     // subject: channel, a: percent
+        ChannelMute,       // subject: channel, a: 1/0
+        PersonalVolume,    // subject: channel, a: percent
+        StreamMixVolume,   // subject: channel, a: percent
+        MasterVolume,      // a: percent
+        AppVolume,         // subject: app, a: stream, b: percent
+        AppMute,           // subject: app, a: stream, b: 1/0
+        StreamAdded,       // subject: app, a: stream
+        StreamRemoved,     // a: stream
+        StreamMoved,       // subject: channel, a: stream
+        StreamUnassigned,  // a: stream
+        ProfileSwitched,   // subject: profile
+        DeviceAdded,       // subject: device
+        DeviceRemoved,     // subject: device
+        OutputChanged,     // subject: device, a: 1 for the Stream mix
+        LoopbackCreated,   // subject: channel, a: module, b: 1 for the Stream mix
+        LoopbackRemoved,   // subject: channel, a: 1 for the Stream mix
+        EngineStarted,     // subject: target sink, a: 1 for the Stream mix
+        EngineFailed,      // a: 1 for the Stream mix
+        Xrun,              // subject: device, a: count, b: 1 for the Stream mix
+        LatencyChanged,    // subject: device, a: milliseconds
+        CommandFailed,     // subject: command, a: exit code
+        CommandTimedOut,   // subject: command
+        CommandNotStarted, // subject: command
+        ConfigSaved,
+        Count
+    };
+
+    struct Event {
+        uint64_t timeUs = 0;  // Wall clock, microseconds since the epoch
+        uint32_t thread = 0;
+        Code code = Code::DBusCall;
+        int64_t a = 0;
+        int64_t b = 0;
+        char subject[SUBJECT_BYTES] = {};
+    };
+
+    static void record(Code code, const char *subject = "", int64_t a = 0, int64_t b = 0);
+    static void record(Code code, const std::string &subject, int64_t a = 0, int64_t b = 0) {
+        record(code, subject.c_str(), a, b);
+    }
+
+    static const char *codeName(Code code);
+
+    static size_t eventCount();  // Events currently held
+    static void clear();
+    // The newest maxEvents (all if 0), oldest first. Safe while other
+    // threads record; events being overwritten at that moment are left out.
+    static std::vector<Event> events(size_t maxEvents = 0);
+    // One line per event: local time, thread, code, subject and arguments
+    static std::string text(size_t maxEvents = 0);
+    static std::string format(const Event &event);
+};
+
+// Lets through at most `burst` calls per window and counts the rest, for
+// logging from paths that can run thousands of times a second
+class RateLimiter {
+public:
+    RateLimiter(uint32_t burst, uint64_t windowMs) : m_burst(burst), m_windowMs(windowMs) {}
+    RateLimiter(const RateLimiter &) = delete;
+    RateLimiter &operator=(const RateLimiter &) = delete;
+
+    // On the first call allowed in a new window, *suppressed is the number
+    // of calls dropped in the windows before it (0 otherwise)
+    bool allow(uint64_t nowMs, uint64_t *suppressed);
+
+    static uint64_t nowMs();  // Monotonic
+
+private:
+    std::mutex m_mutex;
+    const uint32_t m_burst;
+    const uint64_t m_windowMs;
+    uint64_t m_windowStart = 0;
+    uint32_t m_allowed = 0;
+    uint64_t m_suppressed = 0;
+    bool m_started = false;
+};
+
+} // namespace WaveMux
@@ -0,0 +1,64 @@
+#include "latencycontroller.h"
+#include <algorithm>
+#include <cmath>
+
+namespace WaveMux {
+
+LatencyController::LatencyController(int initialMs, const LatencyControllerSettings &settings)
+    : m_settings(settings)
+    , m_latencyMs(0)
+    , m_floorMs(settings.minMs)
+{
+    m_settings.maxMs = std::max(m_settings.minMs, m_settings.maxMs);
+    m_settings.stepMs = std::max(1, m_settings.stepMs);
+    m_settings.backoff = std::max(1.0, m_settings.backoff);
+    m_latencyMs = clamp(initialMs);
+}
+
+int LatencyController::clamp(int latencyMs) const {
+    return std::clamp(latencyMs, m_settings.minMs, m_settings.maxMs);
+}
+
+void LatencyController::reset(int latencyMs) {
+    m_latencyMs = clamp(latencyMs);
+    m_floorMs = m_settings.minMs;
+    m_stableWindows = 0;
+    m_floorAge = 0;
+    m_holdWindows = 0;
+}
+
+bool LatencyController::update(uint64_t xruns) {
+    const int previous = m_latencyMs;
+
+    if (xruns > 0) {
+        // Don't come back down to what just failed
+        m_floorMs = clamp(std::max(m_floorMs, m_latencyMs + m_settings.stepMs));
+        const int raised = static_cast<int>(std::ceil(m_latencyMs * m_settings.backoff));
+        m_latencyMs = clamp(std::max(raised, m_floorMs));
+        m_stableWindows = 0;
+        m_floorAge = 0;
+        if (m_latencyMs != previous) {
+            m_holdWindows = m_settings.holdWindows;
+        }
+        return m_latencyMs != previous;
+    }
+
+    if (++m_floorAge >= m_settings.floorWindows) {
+        m_floorMs = m_settings.minMs;
+        m_floorAge = 0;
+    }
+    if (m_holdWindows > 0) {
+        --m_holdWindows;
+        return false;
+    }
+    if (++m_stableWindows >= m_settings.stableWindows) {
+        m_stableWindows = 0;
+        m_latencyMs = std::max(m_latencyMs - m_settings.stepMs, std::max(m_floorMs, m_settings.minMs));
+        if (m_latencyMs != previous) {
+            m_holdWindows = m_settings.holdWindows;
+        }
+    }
+    return m_latencyMs != previous;
+}
+
+} // namespace WaveMux
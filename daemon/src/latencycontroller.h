@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+
+namespace WaveMux {
+
+struct LatencyControllerSettings {
+    int minMs = 20;
+    int maxMs = 300;
+    int stepMs = 10;          // Lowered by this much after each stable stretch
+    int stableWindows = 30;   // Windows without xruns before lowering
+    double backoff = 1.5;     // Raised by this factor after an xrun
+    int floorWindows = 900;   // How long a latency that failed stays off limits
+    int holdWindows = 150;    // How long a new latency stands before it is lowered again
+};
+
+// Adaptive buffer latency for one output path. Fed one observation window
+// at a time with the number of xruns seen in it: any xrun backs off
+// multiplicatively and marks the failed latency as a floor; a stable stretch
+// lowers it by one step, never below the floor. The floor lapses after a
+// long stable period so one load spike doesn't pin the latency forever.
+// Every change is held for a while before the next step down, so a path is
+// rebuilt at most every few minutes; xruns still back off at once.
+class LatencyController {
+public:
+    explicit LatencyController(int initialMs, const LatencyControllerSettings &settings = {});
+
+    // Returns true when latencyMs() changed
+    bool update(uint64_t xruns);
+    void reset(int latencyMs);
+
+    int latencyMs() const { return m_latencyMs; }
+    int floorMs() const { return m_floorMs; }
+    const LatencyControllerSettings &settings() const { return m_settings; }
+
+private:
+    int clamp(int latencyMs) const;
+
+    LatencyControllerSettings m_settings;
+    int m_latencyMs;
+    int m_floorMs;
+    int m_stableWindows = 0;
+    int m_floorAge = 0;
+    int m_holdWindows = 0;
+};
+
+} // namespace WaveMux
@@ -0,0 +1,135 @@
+#include "latencyprobe.h"
+#include "logging.h"
+#include "dsp/impulseprobe.h"
+#include <QProcess>
+#include <QElapsedTimer>
+#include <QDebug>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace WaveMux {
+
+namespace {
+    constexpr int WARMUP_MS = 100;  // Capture this long before playing, so the stream is flowing
+    constexpr int TIMEOUT_MS = 5000;
+
+    QStringList formatArguments() {
+        return {"--raw", "--format=float32le", QString("--rate=%1").arg(LatencyProbe::SAMPLE_RATE),
+                "--channels=1", "--latency-msec=10", "--client-name=wavemux-probe"};
+    }
+
+    // Appends whatever the capture has delivered
+    void drain(QProcess &capture, std::vector<float> &recording) {
+        const qint64 samples = capture.bytesAvailable() / static_cast<qint64>(sizeof(float));
+        if (samples > 0) {
+            const size_t at = recording.size();
+            recording.resize(at + samples);
+            capture.read(reinterpret_cast<char *>(recording.data() + at), samples * sizeof(float));
+        }
+    }
+
+    bool captureUntil(QProcess &capture, std::vector<float> &recording, size_t samples, QElapsedTimer &timer) {
+        while (recording.size() < samples) {
+            if (capture.state() != QProcess::Running || timer.elapsed() > TIMEOUT_MS) {
+                return false;
+            }
+            capture.waitForReadyRead(50);
+            drain(capture, recording);
+        }
+        return true;
+    }
+}
+
+std::optional<int> LatencyProbe::measureOnce(const QString &sink, const QString &captureSource) {
+    const ImpulseProbe probe(SAMPLE_RATE);
+
+    QProcess capture;
+    capture.start("parec", QStringList{QString("--device=%1").arg(captureSource)} + formatArguments());
+    if (!capture.waitForStarted(3000)) {
+        qCWarning(lcLatency) << "Latency probe: failed to start parec";
+        return std::nullopt;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    std::vector<float> recording;
+    recording.reserve(SAMPLE_RATE * (WARMUP_MS + CAPTURE_MS) / 1000);
+    if (!captureUntil(capture, recording, SAMPLE_RATE * WARMUP_MS / 1000, timer)) {
+        capture.kill();
+        capture.waitForFinished(1000);
+        return std::nullopt;
+    }
+
+    // Everything captured so far predates the probe
+    drain(capture, recording);
+    const size_t start = recording.size();
+
+    QProcess playback;
+    playback.start("pacat", QStringList{"--playback", QString("--device=%1").arg(sink)} + formatArguments());
+    if (playback.waitForStarted(3000)) {
+        std::vector<float> signal = probe.signal();
+        signal.resize(signal.size() + SAMPLE_RATE / 5, 0.0f);  // Let it play out before pacat drains
+        playback.write(reinterpret_cast<const char *>(signal.data()), signal.size() * sizeof(float));
+        playback.closeWriteChannel();
+    } else {
+        qCWarning(lcLatency) << "Latency probe: failed to start pacat";
+    }
+
+    captureUntil(capture, recording, start + SAMPLE_RATE * CAPTURE_MS / 1000, timer);
+    capture.terminate();
+    playback.waitForFinished(1000);
+    capture.waitForFinished(1000);
+
+    const auto found = probe.find(recording.data() + start, recording.size() - start);
+    if (!found) {
+        return std::nullopt;
+    }
+    return static_cast<int>(*found);
+}
+
+QList<int> LatencyProbe::measure(const QString &sink, const QString &captureSource, int runs) {
+    QList<int> results;
+    for (int run = 0; run < runs; ++run) {
+        if (auto latency = measureOnce(sink, captureSource)) {
+            results.append(*latency);
+        }
+    }
+    return results;
+}
+
+int LatencyProbe::median(QList<int> values) {
+    if (values.isEmpty()) {
+        return 0;
+    }
+    std::sort(values.begin(), values.end());
+    return values[values.size() / 2];
+}
+
+LatencyProbe::Summary LatencyProbe::summarize(const QList<int> &frames, int attempts) {
+    Summary summary;
+    summary.attempts = attempts;
+    if (frames.isEmpty()) {
+        return summary;
+    }
+
+    for (const int run : frames) {
+        summary.runsMs.append(run * 1000.0 / SAMPLE_RATE);
+    }
+    summary.minMs = *std::min_element(summary.runsMs.cbegin(), summary.runsMs.cend());
+    summary.maxMs = *std::max_element(summary.runsMs.cbegin(), summary.runsMs.cend());
+    summary.medianMs = median(frames) * 1000.0 / SAMPLE_RATE;
+    double sum = 0.0;
+    for (const double run : summary.runsMs) {
+        sum += run;
+    }
+    summary.meanMs = sum / summary.runsMs.size();
+    double variance = 0.0;
+    for (const double run : summary.runsMs) {
+        variance += (run - summary.meanMs) * (run - summary.meanMs);
+    }
+    summary.jitterMs = std::sqrt(variance / summary.runsMs.size());
+    return summary;
+}
+
+} // namespace WaveMux
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <QList>
+#include <QString>
+#include <optional>
+
+namespace WaveMux {
+
+// Times how long audio takes from a sink to a capture point: plays an
+// ImpulseProbe sweep into the sink with pacat while recording the capture
+// source with parec, and finds the sweep in the recording. The result also
+// contains the probe's own playback start-up and capture buffering, which is
+// the same for every path, so it is exact for comparing paths and an upper
+// bound on any one of them. Blocking: call from a worker thread.
+class LatencyProbe {
+public:
+    static constexpr int SAMPLE_RATE = 48000;
+    static constexpr int CAPTURE_MS = 1000;  // Longest latency that can be measured
+
+    // Latency of one run in frames; nullopt if the probe never arrived
+    static std::optional<int> measureOnce(const QString &sink, const QString &captureSource);
+
+    // One result per run that arrived, in run order
+    static QList<int> measure(const QString &sink, const QString &captureSource, int runs);
+
+    static int median(QList<int> values);
+
+    // Runs converted to milliseconds and summarized. Jitter is the standard
+    // deviation of the runs that arrived; the rest are zero if none did.
+    struct Summary {
+        int attempts = 0;
+        QList<double> runsMs;
+        double minMs = 0.0;
+        double medianMs = 0.0;
+        double meanMs = 0.0;
+        double maxMs = 0.0;
+        double jitterMs = 0.0;
+    };
+    static Summary summarize(const QList<int> &frames, int attempts);
+};
+
+} // namespace WaveMux
@@ -0,0 +1,35 @@
+#include "logging.h"
+#include "stats.h"
+#include <QDebug>
+
+namespace WaveMux {
+
+Q_LOGGING_CATEGORY(lcDaemon, "wavemux.daemon", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcAudio, "wavemux.audio", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcCommands, "wavemux.commands", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcDevices, "wavemux.devices", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcStreams, "wavemux.streams", QtWarningMsg)
+Q_LOGGING_CATEGORY(lcMix, "wavemux.mix", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcLatency, "wavemux.latency", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcCapture, "wavemux.capture", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcConfig, "wavemux.config", QtInfoMsg)
+
+bool allowLog(const QLoggingCategory &category, QtMsgType type, RateLimiter &limiter) {
+    if (!category.isEnabled(type)) {
+        return false;
+    }
+    uint64_t suppressed = 0;
+    if (!limiter.allow(RateLimiter::nowMs(), &suppressed)) {
+        static Counter &suppressedCounter = Stats::counter("log.suppressed");
+        suppressedCounter.add();
+        return false;
+    }
+    if (suppressed > 0) {
+        QMessageLogger logger;
+        (type == QtWarningMsg ? logger.warning(category) : logger.info(category))
+            << "(" << suppressed << "similar messages suppressed)";
+    }
+    return true;
+}
+
+} // namespace WaveMux
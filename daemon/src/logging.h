@@ -0,0 +1,37 @@
+#pragma once
+
+#include <QLoggingCategory>
+#include "eventlog.h"
+
+namespace WaveMux {
+
+// One category per subsystem, so the journal can be narrowed or widened with
+// QT_LOGGING_RULES (e.g. "wavemux.streams.info=true"). Categories on hot
+// paths only let warnings through by default; what they would have said is
+// still in the EventLog.
+Q_DECLARE_LOGGING_CATEGORY(lcDaemon)    // wavemux.daemon: startup, signals, service manager
+Q_DECLARE_LOGGING_CATEGORY(lcAudio)     // wavemux.audio: graph setup and teardown, profiles
+Q_DECLARE_LOGGING_CATEGORY(lcCommands)  // wavemux.commands: audio server commands
+Q_DECLARE_LOGGING_CATEGORY(lcDevices)   // wavemux.devices: outputs coming and going
+Q_DECLARE_LOGGING_CATEGORY(lcStreams)   // wavemux.streams: app streams and routing (info off)
+Q_DECLARE_LOGGING_CATEGORY(lcMix)       // wavemux.mix: loopbacks, mix engines, processing
+Q_DECLARE_LOGGING_CATEGORY(lcLatency)   // wavemux.latency: xruns, adaptive latency, probes
+Q_DECLARE_LOGGING_CATEGORY(lcCapture)   // wavemux.capture: recording, replay, spectrum
+Q_DECLARE_LOGGING_CATEGORY(lcConfig)    // wavemux.config: config and profile files
+
+// Rate-limited messages: each call site lets through LOG_BURST messages per
+// LOG_WINDOW_MS and drops the rest, counting them into the "log.suppressed"
+// counter and reporting how many it dropped with its next message
+constexpr uint32_t LOG_BURST = 5;
+constexpr uint64_t LOG_WINDOW_MS = 10000;
+
+bool allowLog(const QLoggingCategory &category, QtMsgType type, RateLimiter &limiter);
+
+} // namespace WaveMux
+
+#define WAVEMUX_LOG_LIMITED(category, type, log) \
+    if (static WaveMux::RateLimiter wavemuxLogLimiter(WaveMux::LOG_BURST, WaveMux::LOG_WINDOW_MS); \
+        !WaveMux::allowLog(category(), type, wavemuxLogLimiter)) {} else log(category)
+
+#define qCInfoLimited(category) WAVEMUX_LOG_LIMITED(category, QtInfoMsg, qCInfo)
+#define qCWarningLimited(category) WAVEMUX_LOG_LIMITED(category, QtWarningMsg, qCWarning)
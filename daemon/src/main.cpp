@@ -1,99 +1,327 @@
 #include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDBusArgument>
 #include <QDBusConnection>
+#include <QDBusInterface>
+#include <QDBusReply>
 #include <QDebug>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QFileInfo>
+#include <QTimer>
 #include <csignal>
+#include <cstdio>
+#include <unistd.h>
 #include "wavemux/types.h"
 #include "audiomanager.h"
 #include "configmanager.h"
+#include "logging.h"
+#include "sdnotify.h"
+#include "signalwatcher.h"
+#include "stats.h"
+#include "trace.h"
 #include "dbus/channeldbusadaptor.h"
 #include "dbus/streamdbusadaptor.h"
 #include "dbus/devicedbusadaptor.h"
 #include "dbus/configdbusadaptor.h"
+#include "dbus/profiledbusadaptor.h"
+#include "dbus/processingdbusadaptor.h"
+#include "dbus/equalizerdbusadaptor.h"
+#include "dbus/micdbusadaptor.h"
+#include "dbus/recordingdbusadaptor.h"
+#include "dbus/replaydbusadaptor.h"
+#include "dbus/spectrumdbusadaptor.h"
+#include "dbus/statsdbusadaptor.h"
+#include "dbus/tracedbusadaptor.h"
+#include "dbus/latencydbusadaptor.h"
 
-static WaveMux::AudioManager *g_audioManager = nullptr;
-static WaveMux::ConfigManager *g_configManager = nullptr;
+namespace {
+    // Upper bound for a signal-initiated shutdown. If flushing the config or
+    // unloading modules hangs (e.g. the audio server is gone), SIGALRM's
+    // default action terminates the daemon instead.
+    constexpr unsigned SHUTDOWN_TIMEOUT_SECONDS = 5;
 
-void signalHandler(int signal) {
-    qInfo() << "Received signal" << signal << "- shutting down...";
-    if (g_configManager) {
-        g_configManager->save();
+    // `wavemuxd --stats`: print the running daemon's statistics
+    int printStats() {
+        QDBusInterface stats("com.wavemux.Daemon", "/", "com.wavemux.Stats", QDBusConnection::sessionBus());
+        QDBusReply<QString> reply = stats.call("Dump");
+        if (!reply.isValid()) {
+            std::fprintf(stderr, "Cannot read statistics: %s\n", qPrintable(reply.error().message()));
+            return 1;
+        }
+        std::fputs(qPrintable(reply.value()), stdout);
+        return 0;
     }
-    if (g_audioManager) {
-        g_audioManager->shutdown();
+
+    // `wavemuxd --dump-trace FILE`: have the running daemon write its trace
+    int dumpTrace(const QString &path) {
+        QDBusInterface trace("com.wavemux.Daemon", "/", "com.wavemux.Trace", QDBusConnection::sessionBus());
+        QDBusReply<QString> reply = trace.call("DumpTrace", QFileInfo(path).absoluteFilePath());
+        if (!reply.isValid() || reply.value().isEmpty()) {
+            std::fprintf(stderr, "Cannot dump trace: %s\n",
+                         reply.isValid() ? "the daemon could not write the file" : qPrintable(reply.error().message()));
+            return 1;
+        }
+        std::printf("%s\n", qPrintable(reply.value()));
+        return 0;
+    }
+
+    // `wavemuxd --events`: print the running daemon's recent operations
+    int printEvents() {
+        QDBusInterface trace("com.wavemux.Daemon", "/", "com.wavemux.Trace", QDBusConnection::sessionBus());
+        QDBusReply<QString> reply = trace.call("RecentEvents", 0u);
+        if (!reply.isValid()) {
+            std::fprintf(stderr, "Cannot read events: %s\n", qPrintable(reply.error().message()));
+            return 1;
+        }
+        std::fputs(qPrintable(reply.value()), stdout);
+        return 0;
+    }
+
+    // `wavemuxd --measure-latency CHANNEL[:MIX]`: have the running daemon
+    // time a channel's path through a mix and print the result. With a
+    // limit, a median above it fails, for latency regression checks.
+    class LatencyCommand : public QObject {
+        Q_OBJECT
+
+    public:
+        static constexpr int TIMEOUT_MS = 60000;
+
+        int run(const QString &target, double maxLatencyMs) {
+            m_channelId = target.section(':', 0, 0);
+            const QString mixId = target.section(':', 1, 1).isEmpty() ? QString("personal") : target.section(':', 1, 1);
+
+            QDBusConnection bus = QDBusConnection::sessionBus();
+            bus.connect("com.wavemux.Daemon", "/", "com.wavemux.Latency", "LatencyMeasured",
+                        this, SLOT(onMeasured(QVariantMap,bool)));
+            QDBusInterface latency("com.wavemux.Daemon", "/", "com.wavemux.Latency", bus);
+            QDBusReply<bool> reply = latency.call("MeasureLatency", m_channelId, mixId);
+            if (!reply.isValid() || !reply.value()) {
+                std::fprintf(stderr, "Cannot measure latency: %s\n",
+                             reply.isValid() ? "the daemon refused (is the channel audible in a playing mix?)"
+                                             : qPrintable(reply.error().message()));
+                return 1;
+            }
+
+            QTimer::singleShot(TIMEOUT_MS, &m_loop, &QEventLoop::quit);
+            m_loop.exec();
+            if (m_result.isEmpty()) {
+                std::fprintf(stderr, "Cannot measure latency: no result from the daemon\n");
+                return 1;
+            }
+            if (!m_success) {
+                std::fprintf(stderr, "Cannot measure latency: the probe never reached %s\n",
+                             qPrintable(m_result.value("device").toString()));
+                return 1;
+            }
+
+            QString runs;
+            for (const QVariant &run : qdbus_cast<QVariantList>(m_result.value("runsMs"))) {
+                runs += QString::number(run.toDouble(), 'f', 1) + ' ';
+            }
+            const double median = m_result.value("latencyMs").toDouble();
+            std::printf("%s in the %s mix (%s to %s)\n", qPrintable(m_channelId), qPrintable(mixId),
+                        qPrintable(m_result.value("mode").toString()), qPrintable(m_result.value("device").toString()));
+            std::printf("  runs:     %sms (%d of %d arrived)\n", qPrintable(runs),
+                        static_cast<int>(qdbus_cast<QVariantList>(m_result.value("runsMs")).size()),
+                        m_result.value("attempts").toInt());
+            std::printf("  latency:  %.1f ms median (min %.1f, max %.1f, jitter %.2f)\n", median,
+                        m_result.value("minMs").toDouble(), m_result.value("maxMs").toDouble(),
+                        m_result.value("jitterMs").toDouble());
+            std::printf("  overhead: %.1f ms of that is the probe's own playback and capture\n",
+                        m_result.value("baselineMs").toDouble());
+
+            if (maxLatencyMs > 0.0 && median > maxLatencyMs) {
+                std::fprintf(stderr, "Latency %.1f ms is above the %.1f ms limit\n", median, maxLatencyMs);
+                return 1;
+            }
+            return 0;
+        }
+
+    private slots:
+        void onMeasured(const QVariantMap &result, bool success) {
+            if (result.value("channelId").toString() != m_channelId) {
+                return;  // Someone else's measurement
+            }
+            m_result = result;
+            m_success = success;
+            m_loop.quit();
+        }
+
+    private:
+        QString m_channelId;
+        QVariantMap m_result;
+        bool m_success = false;
+        QEventLoop m_loop;
+    };
+
+    void recordStartupPhase(const char *phase, qint64 milliseconds) {
+        WaveMux::Stats::histogram(std::string("startup.") + phase).record(static_cast<uint64_t>(milliseconds) * 1000);
     }
-    QCoreApplication::quit();
 }
 
 int main(int argc, char *argv[]) {
+    QElapsedTimer startupTimer;
+    startupTimer.start();
+
     QCoreApplication app(argc, argv);
     app.setApplicationName("wavemuxd");
     app.setApplicationVersion("0.1.0");
     app.setOrganizationName("WaveMux");
 
+    QCommandLineParser parser;
+    parser.setApplicationDescription("WaveMux audio mixer daemon");
+    parser.addHelpOption();
+    parser.addVersionOption();
+    const QCommandLineOption statsOption("stats", "Print the running daemon's performance statistics and exit.");
+    parser.addOption(statsOption);
+    const QCommandLineOption dumpTraceOption("dump-trace",
+        "Write the running daemon's activity trace (Chrome trace JSON) to <file> and exit. "
+        "Tracing is enabled with WAVEMUX_TRACE=1 or over D-Bus.", "file");
+    parser.addOption(dumpTraceOption);
+    const QCommandLineOption eventsOption("events",
+        "Print the running daemon's last few thousand operations (level changes, routing, "
+        "graph changes, failed commands) and exit.");
+    parser.addOption(eventsOption);
+    const QCommandLineOption measureLatencyOption("measure-latency",
+        "Have the running daemon measure the latency of <channel> through a mix "
+        "(<channel>:stream for the Stream mix) and exit.", "channel[:mix]");
+    parser.addOption(measureLatencyOption);
+    const QCommandLineOption maxLatencyOption("max-latency",
+        "With --measure-latency: fail if the median latency is above <ms>.", "ms");
+    parser.addOption(maxLatencyOption);
+    parser.process(app);
+    if (parser.isSet(statsOption)) {
+        return printStats();
+    }
+    if (parser.isSet(dumpTraceOption)) {
+        return dumpTrace(parser.value(dumpTraceOption));  // Relative to our directory, not the daemon's
+    }
+    if (parser.isSet(eventsOption)) {
+        return printEvents();
+    }
+    if (parser.isSet(measureLatencyOption)) {
+        LatencyCommand command;
+        return command.run(parser.value(measureLatencyOption), parser.value(maxLatencyOption).toDouble());
+    }
+
+    // Enabled before anything else so startup is traced too
+    if (qEnvironmentVariableIntValue("WAVEMUX_TRACE") != 0) {
+        WaveMux::Trace::setEnabled(true);
+        qCInfo(WaveMux::lcDaemon) << "Tracing enabled (WAVEMUX_TRACE)";
+    }
+
     WaveMux::registerMetaTypes();
 
-    // Setup signal handlers for clean shutdown
-    std::signal(SIGINT, signalHandler);
-    std::signal(SIGTERM, signalHandler);
+    // Setup signal handlers for clean shutdown (handled on the event loop)
+    WaveMux::SignalWatcher signalWatcher({SIGINT, SIGTERM});
 
     // Connect to session bus
     QDBusConnection bus = QDBusConnection::sessionBus();
     if (!bus.isConnected()) {
-        qCritical() << "Cannot connect to D-Bus session bus";
-        return 1;
-    }
-
-    // Register service name
-    if (!bus.registerService("com.wavemux.Daemon")) {
-        qCritical() << "Cannot register D-Bus service - is another instance running?";
+        qCCritical(WaveMux::lcDaemon) << "Cannot connect to D-Bus session bus";
         return 1;
     }
 
-    // Initialize audio manager
+    // Initialize audio manager (no server work yet - channels are only staged)
     WaveMux::AudioManager audioManager;
-    g_audioManager = &audioManager;
 
     // Initialize config manager
     WaveMux::ConfigManager configManager(&audioManager);
-    g_configManager = &configManager;
+
+    QObject::connect(&signalWatcher, &WaveMux::SignalWatcher::signalReceived,
+        [&](int signal) {
+            qCInfo(WaveMux::lcDaemon) << "Received signal" << signal << "- shutting down...";
+            ::alarm(SHUTDOWN_TIMEOUT_SECONDS);
+            WaveMux::sdNotify("STOPPING=1");
+            // One write with everything still pending, then tear down the graph
+            configManager.flush();
+            audioManager.shutdown();
+            QCoreApplication::quit();
+        });
+
+    // Catch any other quit path too (no-op if the signal path already flushed)
+    QObject::connect(&app, &QCoreApplication::aboutToQuit,
+        [&configManager]() {
+            configManager.flush();
+        });
 
     // Create DBus adaptors (one per responsibility)
     new WaveMux::ChannelDBusAdaptor(&audioManager);
     new WaveMux::StreamDBusAdaptor(&audioManager);
     new WaveMux::DeviceDBusAdaptor(&audioManager);
     new WaveMux::ConfigDBusAdaptor(&audioManager, &configManager);
+    new WaveMux::ProfileDBusAdaptor(&audioManager, &configManager);
+    new WaveMux::ProcessingDBusAdaptor(&audioManager);
+    new WaveMux::EqualizerDBusAdaptor(&audioManager);
+    new WaveMux::MicDBusAdaptor(&audioManager);
+    new WaveMux::RecordingDBusAdaptor(&audioManager);
+    new WaveMux::ReplayDBusAdaptor(&audioManager);
+    new WaveMux::SpectrumDBusAdaptor(&audioManager);
+    new WaveMux::StatsDBusAdaptor(&audioManager);
+    new WaveMux::TraceDBusAdaptor(&audioManager);
+    new WaveMux::LatencyDBusAdaptor(&audioManager);
 
     // Register object on DBus
     if (!bus.registerObject("/", &audioManager)) {
-        qCritical() << "Cannot register D-Bus object";
+        qCCritical(WaveMux::lcDaemon) << "Cannot register D-Bus object";
         return 1;
     }
 
     QObject::connect(&audioManager, &WaveMux::AudioManager::error,
         [](const QString &msg) {
-            qCritical() << "Audio error:" << msg;
+            qCCritical(WaveMux::lcDaemon) << "Audio error:" << msg;
         });
 
-    if (!audioManager.initialize()) {
-        qCritical() << "Failed to initialize audio manager";
-        return 1;
-    }
-
-    // Load saved configuration AFTER initialize (channels must exist first)
+    // Load saved configuration before the audio graph exists: the cached
+    // state is staged and the initialization stages create every sink and
+    // loopback directly at its final level
+    const qint64 configStart = startupTimer.elapsed();
     configManager.load();
+    const qint64 configMs = startupTimer.elapsed() - configStart;
+    recordStartupPhase("config-load", configMs);
 
     // Connect auto-save (save settings when they change)
     configManager.connectAutoSave();
 
-    qInfo() << "WaveMux daemon started";
-    qInfo() << "D-Bus service: com.wavemux.Daemon";
-    qInfo() << "Channels:" << audioManager.listChannels().size();
-    qInfo() << "Output devices:" << audioManager.listOutputDevices().size();
-    qInfo() << "Setup complete:" << configManager.isSetupComplete();
+    // Claim the name only now that every interface is in place, so clients
+    // (and D-Bus activation) never see a half-registered daemon
+    if (!bus.registerService("com.wavemux.Daemon")) {
+        qCCritical(WaveMux::lcDaemon) << "Cannot register D-Bus service - is another instance running?";
+        return 1;
+    }
+    qCInfo(WaveMux::lcDaemon) << "D-Bus service: com.wavemux.Daemon (ready for clients after"
+                              << startupTimer.elapsed() << "ms)";
+    recordStartupPhase("dbus-ready", startupTimer.elapsed());
+
+    const qint64 initStart = startupTimer.elapsed();
+    QObject::connect(&audioManager, &WaveMux::AudioManager::initialized,
+        [&, initStart](bool success) {
+            if (!success) {
+                qCCritical(WaveMux::lcDaemon) << "Failed to initialize audio manager";
+                QCoreApplication::exit(1);
+                return;
+            }
+
+            WaveMux::sdNotify("READY=1\nSTATUS=Mixing " +
+                              QByteArray::number(audioManager.listChannels().size()) + " channels");
 
-    int result = app.exec();
+            qCInfo(WaveMux::lcDaemon) << "WaveMux daemon started";
+            qCInfo(WaveMux::lcDaemon) << "Channels:" << audioManager.listChannels().size();
+            qCInfo(WaveMux::lcDaemon) << "Output devices:" << audioManager.listOutputDevices().size();
+            qCInfo(WaveMux::lcDaemon) << "Setup complete:" << configManager.isSetupComplete();
+            qCInfo(WaveMux::lcDaemon) << "Startup took" << startupTimer.elapsed() << "ms (config load:" << configMs
+                    << "ms, audio init:" << startupTimer.elapsed() - initStart << "ms)";
+            recordStartupPhase("audio-init", startupTimer.elapsed() - initStart);
+            recordStartupPhase("total", startupTimer.elapsed());
+        });
 
-    g_configManager = nullptr;
-    g_audioManager = nullptr;
-    return result;
+    // Sinks and loopbacks are created in the background, one stage per
+    // event-loop iteration, while D-Bus calls are already being served
+    WaveMux::sdNotify("STATUS=Creating audio graph");
+    audioManager.initializeAsync();
+
+    return app.exec();
 }
+
+#include "main.moc"
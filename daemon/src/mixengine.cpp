@@ -0,0 +1,162 @@
+#include "mixengine.h"
+#include "logging.h"
+#include <QProcess>
+#include <QDebug>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+namespace WaveMux {
+
+namespace {
+    QStringList formatArguments() {
+        return {"--raw", "--format=float32le",
+                QString("--rate=%1").arg(MixEngine::SAMPLE_RATE),
+                QString("--channels=%1").arg(MixGraph::CHANNELS),
+                QString("--client-name=%1").arg(MixEngine::CLIENT_NAME)};
+    }
+}
+
+MixEngine::MixEngine(const QStringList &sources, const QString &targetSink, bool lowLatency, QObject *parent)
+    : QThread(parent)
+    , m_sources(sources)
+    , m_targetSink(targetSink)
+    , m_lowLatency(lowLatency)
+    , m_graph(sources.size(), SAMPLE_RATE)
+{
+    m_running = true;  // Armed before start(): run() must not undo an early stop()
+}
+
+MixEngine::~MixEngine() {
+    stop();
+}
+
+void MixEngine::stop() {
+    m_running = false;
+    wait();
+}
+
+double MixEngine::takeMinHeadroomMs() {
+    const int64_t maxGapUs = m_maxGapUs.exchange(0, std::memory_order_relaxed);
+    return playbackLatencyMs() - maxGapUs / 1000.0;
+}
+
+bool MixEngine::readBlock(QProcess &process, char *data, qint64 bytes) {
+    while (process.bytesAvailable() < bytes) {
+        if (!m_running || process.state() != QProcess::Running) {
+            return false;
+        }
+        process.waitForReadyRead(100);
+    }
+    return process.read(data, bytes) == bytes;
+}
+
+void MixEngine::run() {
+    // The processes are created here so they belong to this thread
+    const QString captureLatency = QString("--latency-msec=%1").arg(m_lowLatency ? 5 : 10);
+    const QString playbackLatency = QString("--latency-msec=%1").arg(playbackLatencyMs());
+
+    std::vector<std::unique_ptr<QProcess>> captures;
+    for (const auto &source : m_sources) {
+        auto capture = std::make_unique<QProcess>();
+        capture->start("parec", QStringList{QString("--device=%1").arg(source), captureLatency}
+                                + formatArguments());
+        captures.push_back(std::move(capture));
+    }
+
+    QProcess playback;
+    playback.start("pacat", QStringList{"--playback", QString("--device=%1").arg(m_targetSink), playbackLatency}
+                            + formatArguments());
+
+    bool started = playback.waitForStarted(3000);
+    for (auto &capture : captures) {
+        started = capture->waitForStarted(3000) && started;
+    }
+
+    if (!started) {
+        m_running = false;
+        emit failed("Failed to start parec/pacat for mix processing");
+    } else {
+        qCInfo(lcMix) << "Mix engine running:" << m_sources.size() << "sources ->" << m_targetSink
+                << (m_lowLatency ? "(low latency)" : "");
+    }
+
+    const int blockFrames = this->blockFrames();
+    const qint64 blockBytes = blockFrames * MixGraph::CHANNELS * sizeof(float);
+    std::vector<std::vector<float>> inputs(captures.size(), std::vector<float>(blockFrames * MixGraph::CHANNELS));
+    std::vector<const float *> inputPointers;
+    for (const auto &input : inputs) {
+        inputPointers.push_back(input.data());
+    }
+    std::vector<float> output(blockFrames * MixGraph::CHANNELS);
+    std::vector<char> discard;
+
+    using Clock = std::chrono::steady_clock;
+    const auto blockDuration = std::chrono::microseconds(int64_t(blockFrames) * 1000000 / SAMPLE_RATE);
+    const auto underrunGap = std::chrono::milliseconds(playbackLatencyMs()) + blockDuration;
+    Clock::time_point lastWrite;
+
+    // All captures run on the same graph clock, so reading one block from
+    // each in turn keeps them aligned
+    while (m_running) {
+        bool complete = true;
+        for (size_t i = 0; i < captures.size() && complete; ++i) {
+            complete = readBlock(*captures[i], reinterpret_cast<char *>(inputs[i].data()), blockBytes);
+        }
+        if (!complete) {
+            if (m_running) {
+                emit failed("Mix capture stopped unexpectedly");
+            }
+            break;
+        }
+
+        // Fell behind the captures: skip the backlog so latency doesn't keep growing
+        for (auto &capture : captures) {
+            const qint64 backlog = capture->bytesAvailable();
+            if (backlog > OVERRUN_BLOCKS * blockBytes) {
+                const qint64 skip = backlog - backlog % blockBytes;
+                discard.resize(skip);
+                capture->read(discard.data(), skip);
+                m_overruns.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        const auto processStart = Clock::now();
+        m_graph.process(inputPointers.data(), output.data(), blockFrames);
+        const auto now = Clock::now();
+        m_processNs.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(now - processStart).count(),
+                              std::memory_order_relaxed);
+        m_processedBlocks.fetch_add(1, std::memory_order_relaxed);
+
+        if (lastWrite != Clock::time_point()) {
+            const auto gap = now - lastWrite;
+            if (gap > underrunGap) {
+                m_underruns.fetch_add(1, std::memory_order_relaxed);
+            }
+            const int64_t gapUs = std::chrono::duration_cast<std::chrono::microseconds>(gap).count();
+            if (gapUs > m_maxGapUs.load(std::memory_order_relaxed)) {
+                m_maxGapUs.store(gapUs, std::memory_order_relaxed);
+            }
+        }
+        lastWrite = now;
+
+        playback.write(reinterpret_cast<const char *>(output.data()), blockBytes);
+        if (!playback.waitForBytesWritten(100) && playback.state() != QProcess::Running) {
+            emit failed("Mix playback stopped unexpectedly");
+            break;
+        }
+    }
+
+    m_running = false;
+    for (auto &capture : captures) {
+        capture->terminate();
+    }
+    playback.closeWriteChannel();
+    playback.terminate();
+    for (auto &capture : captures) {
+        capture->waitForFinished(1000);
+    }
+    playback.waitForFinished(1000);
+}
+
+} // namespace WaveMux
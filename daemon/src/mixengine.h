@@ -0,0 +1,80 @@
+#pragma once
+
+#include <QThread>
+#include <QString>
+#include <QStringList>
+#include <atomic>
+#include "dsp/mixgraph.h"
+
+class QProcess;
+
+namespace WaveMux {
+
+// Runs one output mix in-process: every source (channel sink monitors, the
+// mic) is captured with parec, processed and summed by a MixGraph, and played
+// to the target device with pacat. Replaces that mix's loopbacks while
+// processing (e.g. ducking) is enabled, so gain changes are applied per block
+// instead of through server round trips. Low-latency mode (used when a mic is
+// in the mix) halves the block and asks the server for shorter buffers.
+class MixEngine : public QThread {
+    Q_OBJECT
+
+public:
+    static constexpr int SAMPLE_RATE = 48000;
+    static constexpr int BLOCK_FRAMES = 256;              // ~5.3 ms
+    static constexpr int LOW_LATENCY_BLOCK_FRAMES = 128;  // ~2.7 ms
+    static constexpr const char *CLIENT_NAME = "wavemux-engine";
+
+    // sources: capture device names, one graph strip each, in order
+    MixEngine(const QStringList &sources, const QString &targetSink, bool lowLatency = false,
+              QObject *parent = nullptr);
+    ~MixEngine();
+
+    QStringList sources() const { return m_sources; }
+    QString targetSink() const { return m_targetSink; }
+    bool isLowLatency() const { return m_lowLatency; }
+    int blockFrames() const { return m_lowLatency ? LOW_LATENCY_BLOCK_FRAMES : BLOCK_FRAMES; }
+    MixGraph &graph() { return m_graph; }
+    const MixGraph &graph() const { return m_graph; }
+    int playbackLatencyMs() const { return m_lowLatency ? 10 : 20; }
+
+    // Xruns since start. An underrun is a gap between two blocks longer than
+    // the playback buffer (pacat ran dry); an overrun is a capture backlog of
+    // more than OVERRUN_BLOCKS blocks, which is skipped to catch up.
+    static constexpr int OVERRUN_BLOCKS = 8;
+    uint64_t underruns() const { return m_underruns.load(std::memory_order_relaxed); }
+    uint64_t overruns() const { return m_overruns.load(std::memory_order_relaxed); }
+    // Smallest playback headroom (buffer minus the longest gap between
+    // blocks) since the last call, in milliseconds; negative after an underrun
+    double takeMinHeadroomMs();
+
+    // DSP time spent in the graph and blocks processed since start; the
+    // difference between two readings over the block time is the engine's
+    // load on its thread
+    uint64_t processedBlocks() const { return m_processedBlocks.load(std::memory_order_relaxed); }
+    uint64_t processNs() const { return m_processNs.load(std::memory_order_relaxed); }
+
+    void stop();
+
+signals:
+    void failed(const QString &message);
+
+protected:
+    void run() override;
+
+private:
+    bool readBlock(QProcess &process, char *data, qint64 bytes);
+
+    QStringList m_sources;
+    QString m_targetSink;
+    bool m_lowLatency;
+    MixGraph m_graph;
+    std::atomic<bool> m_running{false};
+    std::atomic<uint64_t> m_underruns{0};
+    std::atomic<uint64_t> m_overruns{0};
+    std::atomic<int64_t> m_maxGapUs{0};
+    std::atomic<uint64_t> m_processedBlocks{0};
+    std::atomic<uint64_t> m_processNs{0};
+};
+
+} // namespace WaveMux
@@ -0,0 +1,410 @@
+#include "offlinerender.h"
+#include <algorithm>
+#include <chrono>
+#include <charconv>
+#include <cmath>
+#include <cstdlib>
+
+namespace WaveMux {
+
+namespace {
+    constexpr std::string_view WHITESPACE = " \t\r";
+
+    std::vector<std::string_view> tokenize(std::string_view line) {
+        std::vector<std::string_view> tokens;
+        size_t at = 0;
+        while (true) {
+            const size_t start = line.find_first_not_of(WHITESPACE, at);
+            if (start == std::string_view::npos) {
+                break;
+            }
+            at = std::min(line.find_first_of(WHITESPACE, start), line.size());
+            tokens.push_back(line.substr(start, at - start));
+        }
+        return tokens;
+    }
+
+    std::optional<int> parsePercent(std::string_view text) {
+        int value = 0;
+        const auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+        if (result.ec != std::errc() || result.ptr != text.data() + text.size() || value < 0 || value > 100) {
+            return std::nullopt;
+        }
+        return value;
+    }
+
+    std::optional<bool> parseSwitch(std::string_view text) {
+        if (text == "on" || text == "true" || text == "1") {
+            return true;
+        }
+        if (text == "off" || text == "false" || text == "0") {
+            return false;
+        }
+        return std::nullopt;
+    }
+
+    std::optional<double> parseTime(std::string_view text) {
+        const std::string copy(text);
+        char *end = nullptr;
+        const double value = std::strtod(copy.c_str(), &end);
+        if (copy.empty() || end != copy.c_str() + copy.size() || !(value >= 0.0)) {
+            return std::nullopt;
+        }
+        return value;
+    }
+
+    bool isChannel(std::string_view channel) {
+        return std::find(OfflineRenderer::CHANNEL_IDS.begin(), OfflineRenderer::CHANNEL_IDS.end(), channel)
+            != OfflineRenderer::CHANNEL_IDS.end();
+    }
+}
+
+bool RenderScript::parse(std::string_view text, std::string *error) {
+    size_t lineNumber = 0;
+    size_t position = 0;
+    while (position < text.size()) {
+        size_t end = text.find('\n', position);
+        if (end == std::string_view::npos) {
+            end = text.size();
+        }
+        std::string_view line = text.substr(position, end - position);
+        position = end + 1;
+        ++lineNumber;
+
+        line = line.substr(0, line.find('#'));
+        const std::vector<std::string_view> tokens = tokenize(line);
+        if (tokens.empty()) {
+            continue;
+        }
+        const auto fail = [&](const std::string &message) {
+            if (error) {
+                *error = "line " + std::to_string(lineNumber) + ": " + message;
+            }
+            return false;
+        };
+
+        if (tokens[0] == "profile") {
+            if (tokens.size() < 3 || !isChannel(tokens[2])) {
+                return fail("expected: profile <name> <channel> [volume=N] [muted=on|off] [personal=N] [stream=N]");
+            }
+            ProfileLevels levels;
+            levels.channel = std::string(tokens[2]);
+            for (size_t i = 3; i < tokens.size(); ++i) {
+                const size_t equals = tokens[i].find('=');
+                const std::string_view key = tokens[i].substr(0, equals);
+                const std::string_view value = equals == std::string_view::npos ? std::string_view()
+                                                                                 : tokens[i].substr(equals + 1);
+                if (key == "muted") {
+                    levels.muted = parseSwitch(value);
+                    if (!levels.muted) {
+                        return fail("muted must be on or off");
+                    }
+                    continue;
+                }
+                std::optional<int> *field = key == "volume" ? &levels.volume
+                                          : key == "personal" ? &levels.personalVolume
+                                          : key == "stream" ? &levels.streamVolume
+                                          : nullptr;
+                if (!field) {
+                    return fail("unknown profile level '" + std::string(key) + "'");
+                }
+                *field = parsePercent(value);
+                if (!*field) {
+                    return fail(std::string(key) + " must be 0-100");
+                }
+            }
+            addProfile(std::string(tokens[1]), levels);
+            continue;
+        }
+
+        Event event;
+        const auto time = parseTime(tokens[0]);
+        if (!time || tokens.size() < 2) {
+            return fail("expected: <time ms> <command> <arguments>");
+        }
+        event.timeMs = *time;
+        const std::string_view command = tokens[1];
+        if (command == "master") {
+            const auto value = tokens.size() == 3 ? parsePercent(tokens[2]) : std::nullopt;
+            if (!value) {
+                return fail("expected: master <0-100>");
+            }
+            event.command = Command::Master;
+            event.value = *value;
+        } else if (command == "profile") {
+            if (tokens.size() != 3 || !profile(std::string(tokens[2]))) {
+                return fail("expected: profile <name> (defined above)");
+            }
+            event.command = Command::Profile;
+            event.target = std::string(tokens[2]);
+        } else if (command == "mute") {
+            const auto value = tokens.size() == 4 ? parseSwitch(tokens[3]) : std::nullopt;
+            if (!value || !isChannel(tokens[2])) {
+                return fail("expected: mute <channel> on|off");
+            }
+            event.command = Command::Mute;
+            event.target = std::string(tokens[2]);
+            event.value = *value ? 1 : 0;
+        } else if (command == "volume" || command == "personal" || command == "stream") {
+            const auto value = tokens.size() == 4 ? parsePercent(tokens[3]) : std::nullopt;
+            if (!value || !isChannel(tokens[2])) {
+                return fail("expected: " + std::string(command) + " <channel> <0-100>");
+            }
+            event.command = command == "volume" ? Command::Volume
+                          : command == "personal" ? Command::Personal
+                          : Command::Stream;
+            event.target = std::string(tokens[2]);
+            event.value = *value;
+        } else {
+            return fail("unknown command '" + std::string(command) + "'");
+        }
+        add(event);
+    }
+    return true;
+}
+
+void RenderScript::add(const Event &event) {
+    const auto at = std::upper_bound(m_events.begin(), m_events.end(), event.timeMs,
+                                     [](double timeMs, const Event &other) { return timeMs < other.timeMs; });
+    m_events.insert(at, event);
+}
+
+void RenderScript::addProfile(const std::string &name, const ProfileLevels &levels) {
+    m_profiles[name].push_back(levels);
+}
+
+const std::vector<RenderScript::ProfileLevels> *RenderScript::profile(const std::string &name) const {
+    const auto it = m_profiles.find(name);
+    return it != m_profiles.end() ? &it->second : nullptr;
+}
+
+OfflineRenderer::OfflineRenderer(float sampleRate, size_t blockFrames)
+    : m_sampleRate(sampleRate)
+    , m_blockFrames(std::max<size_t>(1, blockFrames))
+    , m_personal(CHANNEL_IDS.size(), sampleRate)
+    , m_stream(CHANNEL_IDS.size(), sampleRate)
+{
+}
+
+int OfflineRenderer::channelIndex(std::string_view channel) const {
+    for (size_t i = 0; i < CHANNEL_IDS.size(); ++i) {
+        if (channel == CHANNEL_IDS[i]) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+bool OfflineRenderer::setInput(const std::string &channel, std::vector<float> samples) {
+    const int index = channelIndex(channel);
+    if (index < 0) {
+        return false;
+    }
+    samples.resize(samples.size() - samples.size() % MixGraph::CHANNELS);
+    m_inputs[index] = std::move(samples);
+    return true;
+}
+
+bool OfflineRenderer::setLevels(const std::string &channel, const RenderLevels &levels) {
+    const int index = channelIndex(channel);
+    if (index < 0) {
+        return false;
+    }
+    m_levels[index] = levels;
+    return true;
+}
+
+RenderLevels OfflineRenderer::levels(const std::string &channel) const {
+    const int index = channelIndex(channel);
+    return index >= 0 ? m_levels[index] : RenderLevels();
+}
+
+bool OfflineRenderer::apply(const RenderScript &script, const RenderScript::Event &event) {
+    using Command = RenderScript::Command;
+    if (event.command == Command::Master) {
+        m_masterVolume = event.value;
+        return true;
+    }
+    if (event.command == Command::Profile) {
+        const auto *profile = script.profile(event.target);
+        if (!profile) {
+            return false;
+        }
+        for (const auto &levels : *profile) {
+            const int index = channelIndex(levels.channel);
+            if (index < 0) {
+                continue;
+            }
+            RenderLevels &target = m_levels[index];
+            target.volume = levels.volume.value_or(target.volume);
+            target.muted = levels.muted.value_or(target.muted);
+            target.personalVolume = levels.personalVolume.value_or(target.personalVolume);
+            target.streamVolume = levels.streamVolume.value_or(target.streamVolume);
+        }
+        return true;
+    }
+
+    const int index = channelIndex(event.target);
+    if (index < 0) {
+        return false;
+    }
+    RenderLevels &target = m_levels[index];
+    switch (event.command) {
+    case Command::Volume:
+        target.volume = event.value;
+        break;
+    case Command::Mute:
+        target.muted = event.value != 0;
+        break;
+    case Command::Personal:
+        target.personalVolume = event.value;
+        break;
+    case Command::Stream:
+        target.streamVolume = event.value;
+        break;
+    default:
+        break;
+    }
+    return true;
+}
+
+void OfflineRenderer::syncGains() {
+    // The same curve and master scaling as AudioManager::syncMixEngine()
+    for (size_t strip = 0; strip < CHANNEL_IDS.size(); ++strip) {
+        const RenderLevels &levels = m_levels[strip];
+        const float channelGain = levels.muted ? 0.0f : percentToGain(levels.volume);
+        m_personal.setStripGain(strip, channelGain * percentToGain((levels.personalVolume * m_masterVolume) / 100));
+        m_stream.setStripGain(strip, channelGain * percentToGain((levels.streamVolume * m_masterVolume) / 100));
+    }
+}
+
+OfflineRenderer::Result OfflineRenderer::render(const RenderScript &script, size_t frames) {
+    using Clock = std::chrono::steady_clock;
+    const auto started = Clock::now();
+
+    if (frames == 0) {
+        for (const auto &input : m_inputs) {
+            frames = std::max(frames, input.size() / MixGraph::CHANNELS);
+        }
+    }
+
+    Result result;
+    result.frames = frames;
+    result.personal.resize(frames * MixGraph::CHANNELS);
+    result.stream.resize(frames * MixGraph::CHANNELS);
+
+    // Inputs are read in place; only a block running past an input's end is copied
+    const size_t blockSamples = m_blockFrames * MixGraph::CHANNELS;
+    std::vector<std::vector<float>> padded(CHANNEL_IDS.size(), std::vector<float>(blockSamples));
+    std::vector<const float *> inputs(CHANNEL_IDS.size());
+    std::vector<float> scratch(blockSamples);
+
+    const auto &events = script.events();
+    size_t next = 0;
+    const auto applyUntil = [&](size_t frame) {
+        bool changed = false;
+        while (next < events.size()
+               && static_cast<size_t>(std::llround(events[next].timeMs * m_sampleRate / 1000.0)) <= frame) {
+            changed = apply(script, events[next++]) || changed;
+        }
+        return changed;
+    };
+
+    // Settle the strips on the opening levels with a silent block, so the
+    // render doesn't start with a fade-in
+    applyUntil(0);
+    syncGains();
+    for (size_t strip = 0; strip < CHANNEL_IDS.size(); ++strip) {
+        std::fill(padded[strip].begin(), padded[strip].end(), 0.0f);
+        inputs[strip] = padded[strip].data();
+    }
+    m_personal.process(inputs.data(), scratch.data(), m_blockFrames);
+    m_stream.process(inputs.data(), scratch.data(), m_blockFrames);
+
+    for (size_t position = 0; position < frames; position += m_blockFrames) {
+        if (applyUntil(position)) {
+            syncGains();
+        }
+        const size_t count = std::min(m_blockFrames, frames - position);
+        const size_t begin = position * MixGraph::CHANNELS;
+        const size_t end = begin + count * MixGraph::CHANNELS;
+        for (size_t strip = 0; strip < CHANNEL_IDS.size(); ++strip) {
+            const std::vector<float> &input = m_inputs[strip];
+            if (input.size() >= end) {
+                inputs[strip] = input.data() + begin;
+                continue;
+            }
+            std::vector<float> &block = padded[strip];
+            std::fill(block.begin(), block.end(), 0.0f);
+            if (input.size() > begin) {
+                std::copy(input.begin() + begin, input.end(), block.begin());
+            }
+            inputs[strip] = block.data();
+        }
+        m_personal.process(inputs.data(), result.personal.data() + begin, count);
+        m_stream.process(inputs.data(), result.stream.data() + begin, count);
+    }
+
+    result.wallSeconds = std::chrono::duration<double>(Clock::now() - started).count();
+    if (result.wallSeconds > 0.0) {
+        result.realtimeFactor = frames / m_sampleRate / result.wallSeconds;
+    }
+    return result;
+}
+
+SignalDifference compareSignals(const std::vector<float> &actual, const std::vector<float> &expected,
+                                size_t channels) {
+    SignalDifference difference;
+    const size_t count = std::max(actual.size(), expected.size());
+    for (size_t i = 0; i < count; ++i) {
+        const float a = i < actual.size() ? actual[i] : 0.0f;
+        const float e = i < expected.size() ? expected[i] : 0.0f;
+        const float error = std::fabs(a - e);
+        if (error > difference.maxError) {
+            difference.maxError = error;
+            difference.frame = i / std::max<size_t>(1, channels);
+        }
+    }
+    return difference;
+}
+
+std::vector<size_t> findDiscontinuities(const std::vector<float> &samples, float threshold, size_t channels,
+                                        size_t holdFrames) {
+    std::vector<size_t> frames;
+    if (channels == 0) {
+        return frames;
+    }
+    const size_t count = samples.size() / channels;
+    bool seen = false;
+    size_t last = 0;
+    for (size_t frame = 2; frame < count; ++frame) {
+        for (size_t ch = 0; ch < channels; ++ch) {
+            const float *sample = samples.data() + frame * channels + ch;
+            const float jump = sample[0] - 2.0f * sample[-static_cast<std::ptrdiff_t>(channels)]
+                             + sample[-2 * static_cast<std::ptrdiff_t>(channels)];
+            if (std::fabs(jump) <= threshold) {
+                continue;
+            }
+            if (!seen || frame - last >= holdFrames) {
+                frames.push_back(frame);
+            }
+            seen = true;
+            last = frame;
+            break;
+        }
+    }
+    return frames;
+}
+
+float maxSecondDifference(const std::vector<float> &samples, size_t channels) {
+    float largest = 0.0f;
+    if (channels == 0) {
+        return largest;
+    }
+    for (size_t i = 2 * channels; i < samples.size(); ++i) {
+        largest = std::max(largest, std::fabs(samples[i] - 2.0f * samples[i - channels] + samples[i - 2 * channels]));
+    }
+    return largest;
+}
+
+} // namespace WaveMux
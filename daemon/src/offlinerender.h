@@ -0,0 +1,142 @@
+#pragma once
+
+#include "dsp/mixgraph.h"
+#include <array>
+#include <cstddef>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace WaveMux {
+
+// Levels of one channel as the daemon holds them, in percent
+struct RenderLevels {
+    int volume = 100;
+    bool muted = false;
+    int personalVolume = 100;
+    int streamVolume = 0;
+};
+
+// Timed control changes for OfflineRenderer, one per line:
+//
+//     # Profiles: a name, a channel, then any of volume, muted, personal, stream
+//     profile quiet game volume=40 personal=100
+//     profile quiet chat muted=on
+//
+//     # <time in ms> <command> <arguments>
+//     0     volume game 80
+//     0     stream chat 100
+//     250   mute chat on
+//     500   personal media 30
+//     750   master 90
+//     1000  profile quiet
+//
+// As in the daemon, switching profiles only sets the levels of the channels
+// the profile names.
+class RenderScript {
+public:
+    enum class Command { Volume, Mute, Personal, Stream, Master, Profile };
+    struct Event {
+        double timeMs = 0.0;
+        Command command = Command::Volume;
+        std::string target;  // Channel id or profile name; empty for master
+        int value = 0;       // Percent, or 1/0 for a mute
+    };
+    struct ProfileLevels {
+        std::string channel;
+        std::optional<int> volume;
+        std::optional<bool> muted;
+        std::optional<int> personalVolume;
+        std::optional<int> streamVolume;
+    };
+
+    // Adds the script's profiles and events; on the first bad line returns
+    // false with "line N: ..." in error
+    bool parse(std::string_view text, std::string *error = nullptr);
+    // Kept in time order; events at the same time stay in the order added
+    void add(const Event &event);
+    void addProfile(const std::string &name, const ProfileLevels &levels);
+
+    const std::vector<Event> &events() const { return m_events; }
+    const std::vector<ProfileLevels> *profile(const std::string &name) const;
+
+private:
+    std::vector<Event> m_events;
+    std::map<std::string, std::vector<ProfileLevels>> m_profiles;
+};
+
+// Renders the Personal and Stream mixes from per-channel input through the
+// MixGraph the mix engine runs, in the engine's block size and as fast as
+// the CPU allows. Script events take effect at the first block boundary at
+// or after their time, as parameter changes do in the engine. Live, the
+// server applies a channel's own volume in front of the engine; here it is
+// folded into the strip gain, so it ramps across a block like the mix
+// levels do. Levels in force at time 0 apply from the first frame.
+class OfflineRenderer {
+public:
+    static constexpr std::array<const char *, 4> CHANNEL_IDS = {"game", "chat", "media", "aux"};
+    static constexpr size_t BLOCK_FRAMES = 256;  // MixEngine::BLOCK_FRAMES
+
+    struct Result {
+        std::vector<float> personal;  // Interleaved stereo
+        std::vector<float> stream;
+        size_t frames = 0;
+        double wallSeconds = 0.0;
+        double realtimeFactor = 0.0;  // Audio seconds rendered per second of CPU time
+    };
+
+    explicit OfflineRenderer(float sampleRate = 48000.0f, size_t blockFrames = BLOCK_FRAMES);
+
+    float sampleRate() const { return m_sampleRate; }
+
+    // Interleaved stereo; channels without input are silent. Both return
+    // false for an unknown channel.
+    bool setInput(const std::string &channel, std::vector<float> samples);
+    bool setLevels(const std::string &channel, const RenderLevels &levels);
+    RenderLevels levels(const std::string &channel) const;
+    void setMasterVolume(int volume) { m_masterVolume = volume; }
+    int masterVolume() const { return m_masterVolume; }
+
+    // For processing (EQ, ducking, limiter...); strip gains are the renderer's
+    MixGraph &graph(bool streamMix) { return streamMix ? m_stream : m_personal; }
+
+    // Renders `frames` frames, or as many as the longest input when 0.
+    // Levels changed by the script stay changed afterwards.
+    Result render(const RenderScript &script = {}, size_t frames = 0);
+
+private:
+    int channelIndex(std::string_view channel) const;
+    bool apply(const RenderScript &script, const RenderScript::Event &event);
+    void syncGains();
+
+    float m_sampleRate;
+    size_t m_blockFrames;
+    std::array<std::vector<float>, CHANNEL_IDS.size()> m_inputs;
+    std::array<RenderLevels, CHANNEL_IDS.size()> m_levels;
+    int m_masterVolume = 100;
+    MixGraph m_personal;
+    MixGraph m_stream;
+};
+
+// Largest difference between a signal and its reference, and the first
+// frame where it occurs. The shorter signal counts as silent past its end.
+struct SignalDifference {
+    float maxError = 0.0f;
+    size_t frame = 0;
+};
+SignalDifference compareSignals(const std::vector<float> &actual, const std::vector<float> &expected,
+                                size_t channels = MixGraph::CHANNELS);
+
+// Frames where a signal jumps: the second difference (how far each sample
+// is from the line through the two before it) exceeds threshold. Smooth
+// audio stays well below it: a full-scale 1 kHz sine reaches 0.017 at
+// 48 kHz, while a gain step reaches the size of the step. Hits closer than
+// holdFrames to the previous one are the same glitch.
+std::vector<size_t> findDiscontinuities(const std::vector<float> &samples, float threshold,
+                                        size_t channels = MixGraph::CHANNELS, size_t holdFrames = 48);
+// Largest second difference in a signal, to derive a threshold from the inputs
+float maxSecondDifference(const std::vector<float> &samples, size_t channels = MixGraph::CHANNELS);
+
+} // namespace WaveMux
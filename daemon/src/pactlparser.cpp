@@ -0,0 +1,205 @@
+#include "pactlparser.h"
+
+namespace WaveMux {
+
+namespace {
+    constexpr std::string_view WHITESPACE = " \t\r";
+
+    std::string_view trim(std::string_view text) {
+        const size_t first = text.find_first_not_of(WHITESPACE);
+        if (first == std::string_view::npos) {
+            return {};
+        }
+        return text.substr(first, text.find_last_not_of(WHITESPACE) - first + 1);
+    }
+
+    // "Sink Input #40" -> type and index
+    bool parseHeader(std::string_view line, std::string_view *type, uint32_t *index) {
+        const size_t hash = line.rfind(" #");
+        if (hash == std::string_view::npos || hash == 0) {
+            return false;
+        }
+        const auto parsed = PactlListing::toIndex(trim(line.substr(hash + 2)));
+        if (!parsed) {
+            return false;
+        }
+        *type = line.substr(0, hash);
+        *index = *parsed;
+        return true;
+    }
+
+    // key = "value" (quotes dropped) or key = value
+    bool parseProperty(std::string_view line, std::string_view *key, std::string_view *value) {
+        const size_t equals = line.find(" = ");
+        if (equals == std::string_view::npos || equals == 0) {
+            return false;
+        }
+        *key = line.substr(0, equals);
+        std::string_view raw = line.substr(equals + 3);
+        // Everything between the outer quotes, so quotes inside the value survive
+        if (raw.size() >= 2 && raw.front() == '"' && raw.back() == '"') {
+            raw = raw.substr(1, raw.size() - 2);
+        }
+        *value = raw;
+        return true;
+    }
+}
+
+PactlListing::PactlListing(std::string_view text) {
+    // A sink input has ~40 entries; one guess avoids most regrowth
+    m_entries.reserve(text.size() / 40);
+
+    bool inObject = false;
+    bool inProperties = false;
+    size_t position = 0;
+    while (position < text.size()) {
+        size_t end = text.find('\n', position);
+        if (end == std::string_view::npos) {
+            end = text.size();
+        }
+        const std::string_view line = text.substr(position, end - position);
+        position = end + 1;
+
+        size_t depth = 0;
+        while (depth < line.size() && line[depth] == '\t') {
+            ++depth;
+        }
+        const std::string_view content = trim(line.substr(depth));
+        if (content.empty()) {
+            continue;
+        }
+
+        if (depth == 0) {
+            if (line.front() == ' ') {
+                continue;  // Continuation of a field ("        balance 0.00")
+            }
+            std::string_view type;
+            uint32_t index = 0;
+            inObject = parseHeader(content, &type, &index);
+            if (inObject) {
+                m_objects.push_back({type, index, m_entries.size(), m_entries.size()});
+            }
+            inProperties = false;
+            continue;
+        }
+        if (!inObject) {
+            continue;
+        }
+        Object &object = m_objects.back();
+
+        if (depth == 1) {
+            inProperties = false;
+            const size_t colon = content.find(':');
+            if (colon == std::string_view::npos || colon == 0) {
+                continue;
+            }
+            const std::string_view key = content.substr(0, colon);
+            const std::string_view value = trim(content.substr(colon + 1));
+            if (key == "Properties" && value.empty()) {
+                inProperties = true;
+                continue;
+            }
+            m_entries.push_back({key, value, false});
+            object.end = m_entries.size();
+        } else if (inProperties && depth == 2) {
+            std::string_view key;
+            std::string_view value;
+            if (parseProperty(content, &key, &value)) {
+                m_entries.push_back({key, value, true});
+                object.end = m_entries.size();
+            }
+        }
+    }
+}
+
+std::string_view PactlListing::lookup(size_t object, std::string_view key, bool property, bool *found) const {
+    const Object &entry = m_objects[object];
+    for (size_t i = entry.begin; i < entry.end; ++i) {
+        if (m_entries[i].property == property && m_entries[i].key == key) {
+            if (found) {
+                *found = true;
+            }
+            return m_entries[i].value;
+        }
+    }
+    if (found) {
+        *found = false;
+    }
+    return {};
+}
+
+std::string_view PactlListing::field(size_t object, std::string_view key) const {
+    return lookup(object, key, false);
+}
+
+std::string_view PactlListing::property(size_t object, std::string_view key) const {
+    return lookup(object, key, true);
+}
+
+bool PactlListing::hasProperty(size_t object, std::string_view key) const {
+    bool found = false;
+    lookup(object, key, true, &found);
+    return found;
+}
+
+std::optional<size_t> PactlListing::find(uint32_t index) const {
+    for (size_t i = 0; i < m_objects.size(); ++i) {
+        if (m_objects[i].index == index) {
+            return i;
+        }
+    }
+    return std::nullopt;
+}
+
+std::optional<uint32_t> PactlListing::toIndex(std::string_view text) {
+    if (text.size() >= 2 && text.front() == '"' && text.back() == '"') {
+        text = text.substr(1, text.size() - 2);  // module.id = "12"
+    }
+    if (text.empty() || text.size() > 10) {
+        return std::nullopt;
+    }
+    uint64_t value = 0;
+    for (const char c : text) {
+        if (c < '0' || c > '9') {
+            return std::nullopt;
+        }
+        value = value * 10 + static_cast<uint64_t>(c - '0');
+    }
+    if (value > UINT32_MAX) {
+        return std::nullopt;
+    }
+    return static_cast<uint32_t>(value);
+}
+
+std::optional<int> PactlListing::volumePercent(std::string_view volume) {
+    const size_t percent = volume.find('%');
+    if (percent == std::string_view::npos) {
+        return std::nullopt;
+    }
+    size_t start = percent;
+    while (start > 0 && volume[start - 1] >= '0' && volume[start - 1] <= '9' && percent - start < 6) {
+        --start;
+    }
+    if (start == percent) {
+        return std::nullopt;
+    }
+    int value = 0;
+    for (size_t i = start; i < percent; ++i) {
+        value = value * 10 + (volume[i] - '0');
+    }
+    return value;
+}
+
+std::string PactlListing::unescape(std::string_view value) {
+    std::string result;
+    result.reserve(value.size());
+    for (size_t i = 0; i < value.size(); ++i) {
+        if (value[i] == '\\' && i + 1 < value.size()) {
+            ++i;
+        }
+        result += value[i];
+    }
+    return result;
+}
+
+} // namespace WaveMux
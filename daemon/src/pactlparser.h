@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace WaveMux {
+
+// A `pactl list <type>` dump, tokenized in one pass into a flat table of
+// views into the text (which must outlive the listing). Each object
+//
+//     Sink Input #40
+//         Sink: 0
+//         Volume: front-left: 65536 / 100% / 0.00 dB, ...
+//         Properties:
+//             application.name = "Firefox"
+//
+// becomes a type ("Sink Input"), an index and a run of entries: its
+// "Key: value" fields and the key = "value" lines of its Properties section.
+// Property values are returned without their quotes but still escaped
+// (libpulse escapes '"' and '\' with a backslash); see unescape(). Anything
+// else (continuation lines, port lists) is skipped, and malformed input
+// yields fewer entries, never an error.
+class PactlListing {
+public:
+    struct Object {
+        std::string_view type;
+        uint32_t index = 0;
+        size_t begin = 0;  // Entry range
+        size_t end = 0;
+    };
+
+    explicit PactlListing(std::string_view text);
+
+    size_t size() const { return m_objects.size(); }
+    const Object &operator[](size_t object) const { return m_objects[object]; }
+    const std::vector<Object> &objects() const { return m_objects; }
+
+    // Empty if the object has no such entry
+    std::string_view field(size_t object, std::string_view key) const;
+    std::string_view property(size_t object, std::string_view key) const;
+    bool hasProperty(size_t object, std::string_view key) const;
+
+    // The object with this index, if listed
+    std::optional<size_t> find(uint32_t index) const;
+
+    // Helpers for values
+    static std::optional<uint32_t> toIndex(std::string_view text);
+    // First "NN%" in a Volume field
+    static std::optional<int> volumePercent(std::string_view volume);
+    static std::string unescape(std::string_view value);
+
+private:
+    struct Entry {
+        std::string_view key;
+        std::string_view value;
+        bool property = false;
+    };
+
+    std::string_view lookup(size_t object, std::string_view key, bool property, bool *found = nullptr) const;
+
+    std::vector<Object> m_objects;
+    std::vector<Entry> m_entries;
+};
+
+} // namespace WaveMux
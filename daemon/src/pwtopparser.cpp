@@ -0,0 +1,136 @@
+#include "pwtopparser.h"
+#include <charconv>
+
+namespace WaveMux {
+
+namespace {
+    constexpr std::string_view WHITESPACE = " \t\r";
+    constexpr size_t FORMAT_WIDTH = 16;  // "%16.16s"
+    constexpr size_t LEADING_COLUMNS = 9;  // S ID QUANT RATE WAIT BUSY W/Q B/Q ERR
+
+    std::string_view trim(std::string_view text) {
+        const size_t first = text.find_first_not_of(WHITESPACE);
+        if (first == std::string_view::npos) {
+            return {};
+        }
+        return text.substr(first, text.find_last_not_of(WHITESPACE) - first + 1);
+    }
+
+    template <typename T>
+    bool parseInteger(std::string_view text, T *value) {
+        const auto result = std::from_chars(text.data(), text.data() + text.size(), *value);
+        return result.ec == std::errc() && result.ptr == text.data() + text.size();
+    }
+
+    // Plain decimals ("0.25"), which is all pw-top prints
+    std::optional<double> parseNumber(std::string_view text) {
+        if (text.empty()) {
+            return std::nullopt;
+        }
+        double value = 0.0;
+        double scale = 0.0;
+        for (const char c : text) {
+            if (c == '.' && scale == 0.0) {
+                scale = 1.0;
+            } else if (c >= '0' && c <= '9') {
+                value = value * 10.0 + (c - '0');
+                scale *= 10.0;
+            } else {
+                return std::nullopt;
+            }
+        }
+        return scale > 0.0 ? value / scale : value;
+    }
+}
+
+PwTopSnapshot::PwTopSnapshot(std::string_view text) {
+    size_t position = 0;
+    while (position < text.size()) {
+        size_t end = text.find('\n', position);
+        if (end == std::string_view::npos) {
+            end = text.size();
+        }
+        const std::string_view line = text.substr(position, end - position);
+        position = end + 1;
+
+        // Split off the fixed columns, remembering where they end
+        std::string_view columns[LEADING_COLUMNS];
+        size_t count = 0;
+        size_t at = 0;
+        while (count < LEADING_COLUMNS) {
+            const size_t start = line.find_first_not_of(WHITESPACE, at);
+            if (start == std::string_view::npos) {
+                break;
+            }
+            at = line.find_first_of(WHITESPACE, start);
+            if (at == std::string_view::npos) {
+                at = line.size();
+            }
+            columns[count++] = line.substr(start, at - start);
+        }
+        if (count >= 2 && columns[0] == "S" && columns[1] == "ID") {
+            m_nodes.clear();  // Header: a newer snapshot starts
+            continue;
+        }
+        if (count < LEADING_COLUMNS || columns[0].size() != 1) {
+            continue;
+        }
+
+        Node node;
+        node.state = columns[0][0];
+        if (!parseInteger(columns[1], &node.id) || !parseInteger(columns[2], &node.quantum)
+            || !parseInteger(columns[3], &node.rate) || !parseInteger(columns[8], &node.errors)) {
+            continue;
+        }
+        node.waitUs = timeUs(columns[4]);
+        node.busyUs = timeUs(columns[5]);
+        node.waitQuantum = parseNumber(columns[6]);
+        node.busyQuantum = parseNumber(columns[7]);
+
+        // Then " FORMAT NAME", the format padded to a fixed width and the
+        // name of a follower prefixed with " + "
+        std::string_view name = line.substr(at);
+        if (name.size() > FORMAT_WIDTH + 1) {
+            name = name.substr(FORMAT_WIDTH + 1);
+        }
+        name = trim(name);
+        if (name.size() >= 2 && name[0] == '+' && name[1] == ' ') {
+            node.follower = true;
+            name = trim(name.substr(2));
+        }
+        node.name = std::string(name);
+        m_nodes.push_back(std::move(node));
+    }
+}
+
+const PwTopSnapshot::Node *PwTopSnapshot::find(uint32_t id) const {
+    for (const auto &node : m_nodes) {
+        if (node.id == id) {
+            return &node;
+        }
+    }
+    return nullptr;
+}
+
+std::optional<double> PwTopSnapshot::timeUs(std::string_view text) {
+    double scale = 0.0;
+    if (text.size() > 2 && text.substr(text.size() - 2) == "us") {
+        scale = 1.0;
+        text.remove_suffix(2);
+    } else if (text.size() > 2 && text.substr(text.size() - 2) == "ms") {
+        scale = 1000.0;
+        text.remove_suffix(2);
+    } else if (text.size() > 1 && text.back() == 's') {
+        scale = 1000000.0;
+        text.remove_suffix(1);
+    } else {
+        return std::nullopt;  // "---" (no data) or "+++" (overflow)
+    }
+    const auto value = parseNumber(text);
+    if (!value) {
+        return std::nullopt;
+    }
+    return *value * scale;
+}
+
+} // namespace WaveMux
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace WaveMux {
+
+// The last snapshot in `pw-top --batch-mode` output: PipeWire's profiler
+// data for every node in the graph, one row each,
+//
+//     S   ID  QUANT   RATE    WAIT    BUSY   W/Q   B/Q  ERR FORMAT           NAME
+//     R   30   1024  48000  12.3us  21.0us  0.01  0.02    0    S16LE 2 48000 alsa_output.pci
+//     R   45      0      0   9.8us   5.2us  0.01  0.00    0    F32LE 2 48000  + wavemux_game
+//
+// where WAIT and BUSY are per graph cycle, W/Q and B/Q are the same as a
+// fraction of the quantum and ERR counts xruns. Followers (driven by another
+// node) are marked with "+". Columns the profiler has no value for ("---")
+// are left unset; malformed rows are skipped.
+class PwTopSnapshot {
+public:
+    struct Node {
+        uint32_t id = 0;
+        char state = 0;             // 'R'unning, 'I'dle, 'S'uspended, ...
+        bool follower = false;
+        uint32_t quantum = 0;       // Frames per cycle (0 for most followers)
+        uint32_t rate = 0;
+        std::optional<double> waitUs;
+        std::optional<double> busyUs;
+        std::optional<double> waitQuantum;
+        std::optional<double> busyQuantum;
+        uint64_t errors = 0;
+        std::string name;
+    };
+
+    explicit PwTopSnapshot(std::string_view text);
+
+    const std::vector<Node> &nodes() const { return m_nodes; }
+    const Node *find(uint32_t id) const;
+
+    // "12.3us", "1.5ms", "2.0s" -> microseconds
+    static std::optional<double> timeUs(std::string_view text);
+
+private:
+    std::vector<Node> m_nodes;
+};
+
+} // namespace WaveMux
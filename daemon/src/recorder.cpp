@@ -0,0 +1,179 @@
+#include "recorder.h"
+#include "logging.h"
+#include <QDir>
+#include <QProcess>
+#include <QDebug>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+namespace WaveMux {
+
+namespace {
+    // Writer wakeup interval while there is little to write
+    constexpr auto WRITER_IDLE = std::chrono::milliseconds(20);
+    // Drained in pieces of this size (per track) while recording
+    constexpr size_t WRITE_CHUNK_SAMPLES = WavFileWriter::BUFFER_BYTES / sizeof(float) / 4;
+}
+
+Recorder::TrackState::TrackState(const Track &track)
+    : track(track)
+    , ring(static_cast<size_t>(BUFFER_SECONDS * SAMPLE_RATE * CHANNELS))
+{
+}
+
+Recorder::Recorder(const QList<Track> &tracks, QObject *parent)
+    : QThread(parent)
+{
+    for (const auto &track : tracks) {
+        m_tracks.push_back(std::make_unique<TrackState>(track));
+    }
+    m_running = true;  // Set before start(), so a stop() that comes first is not undone by run()
+}
+
+Recorder::~Recorder() {
+    stop();
+}
+
+bool Recorder::open(const QString &directory, const QString &prefix) {
+    if (!QDir().mkpath(directory)) {
+        qCWarning(lcCapture) << "Cannot create recording directory:" << directory;
+        return false;
+    }
+
+    m_files.clear();
+    for (auto &state : m_tracks) {
+        const QString path = QDir(directory).filePath(QString("%1-%2.wav").arg(prefix, state->track.name));
+        if (!state->writer.open(path.toStdString(), SAMPLE_RATE, CHANNELS)) {
+            qCWarning(lcCapture) << "Cannot create" << path << ":" << std::strerror(state->writer.lastError());
+            for (auto &opened : m_tracks) {
+                opened->writer.close();
+            }
+            m_files.clear();
+            return false;
+        }
+        m_files << path;
+    }
+    return true;
+}
+
+void Recorder::stop() {
+    m_running = false;
+    wait();
+}
+
+bool Recorder::readBlock(QProcess &process, char *data, qint64 bytes) {
+    while (process.bytesAvailable() < bytes) {
+        if (!m_running || process.state() != QProcess::Running) {
+            return false;
+        }
+        process.waitForReadyRead(100);
+    }
+    return process.read(data, bytes) == bytes;
+}
+
+void Recorder::run() {
+    std::vector<std::unique_ptr<QProcess>> captures;
+    for (const auto &state : m_tracks) {
+        auto capture = std::make_unique<QProcess>();
+        capture->start("parec", {QString("--device=%1").arg(state->track.source), "--raw", "--format=float32le",
+                                 QString("--rate=%1").arg(SAMPLE_RATE), QString("--channels=%1").arg(CHANNELS),
+                                 "--client-name=wavemux-recorder"});
+        captures.push_back(std::move(capture));
+    }
+
+    bool started = true;
+    for (auto &capture : captures) {
+        started = capture->waitForStarted(3000) && started;
+    }
+
+    m_capturing = started;
+    if (!started) {
+        m_running = false;
+        emit failed("Failed to start parec for recording");
+    } else {
+        m_writer = std::thread(&Recorder::writerLoop, this);
+        qCInfo(lcCapture) << "Recording" << m_tracks.size() << "tracks";
+    }
+
+    const size_t blockSamples = BLOCK_FRAMES * CHANNELS;
+    std::vector<float> block(blockSamples);
+
+    // Sources share the server clock, so a block from each in turn keeps the
+    // tracks in step; a track whose ring is full drops the block (the writer
+    // can't keep up) instead of holding up the others
+    while (m_running) {
+        for (size_t i = 0; i < captures.size() && m_running; ++i) {
+            if (!readBlock(*captures[i], reinterpret_cast<char *>(block.data()), blockSamples * sizeof(float))) {
+                if (m_running) {
+                    emit failed(QString("Recording capture of %1 stopped unexpectedly").arg(m_tracks[i]->track.source));
+                    m_running = false;
+                }
+                break;
+            }
+            SpscRingBuffer<float> &ring = m_tracks[i]->ring;
+            if (ring.writeAvailable() >= blockSamples) {
+                ring.write(block.data(), blockSamples);
+            } else {
+                m_droppedFrames.fetch_add(BLOCK_FRAMES, std::memory_order_relaxed);
+            }
+        }
+        m_framesRecorded.fetch_add(BLOCK_FRAMES, std::memory_order_relaxed);
+
+        if (m_writeFailed.load(std::memory_order_relaxed)) {
+            emit failed("Writing the recording failed");
+            break;
+        }
+    }
+
+    m_running = false;
+    for (auto &capture : captures) {
+        capture->terminate();
+    }
+    for (auto &capture : captures) {
+        capture->waitForFinished(1000);
+    }
+
+    // The writer drains what is left and finalizes the files
+    m_capturing = false;
+    if (m_writer.joinable()) {
+        m_writer.join();
+    }
+    for (auto &state : m_tracks) {
+        state->writer.close();
+    }
+    qCInfo(lcCapture) << "Recording stopped:" << m_framesRecorded.load() << "frames," << m_droppedFrames.load()
+                      << "dropped";
+}
+
+void Recorder::writerLoop() {
+    std::vector<float> chunk(WRITE_CHUNK_SAMPLES);
+
+    while (true) {
+        const bool capturing = m_capturing.load(std::memory_order_acquire);
+        bool wrote = false;
+
+        for (auto &state : m_tracks) {
+            // While recording, wait for a full chunk so writes stay large
+            size_t available = state->ring.readAvailable();
+            while (available >= WRITE_CHUNK_SAMPLES || (!capturing && available > 0)) {
+                const size_t count = state->ring.read(chunk.data(), std::min(available, WRITE_CHUNK_SAMPLES));
+                if (!state->writer.write(chunk.data(), count)) {
+                    m_writeFailed = true;
+                    return;
+                }
+                wrote = true;
+                available = state->ring.readAvailable();
+            }
+        }
+
+        if (!capturing) {
+            return;  // Everything captured has been handed to the writers
+        }
+        if (!wrote) {
+            std::this_thread::sleep_for(WRITER_IDLE);
+        }
+    }
+}
+
+} // namespace WaveMux
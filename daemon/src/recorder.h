@@ -0,0 +1,77 @@
+#pragma once
+
+#include <QThread>
+#include <QString>
+#include <QStringList>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "dsp/ringbuffer.h"
+#include "wavfilewriter.h"
+
+class QProcess;
+
+namespace WaveMux {
+
+// Records several sources side by side, one float WAV per source. This
+// thread only captures (parec) and pushes blocks into one SPSC ring per
+// track; a separate writer thread drains the rings and does all disk I/O in
+// large batches, so a slow disk costs ring headroom (a few seconds) rather
+// than stalling capture. Blocks that don't fit are dropped and counted.
+class Recorder : public QThread {
+    Q_OBJECT
+
+public:
+    struct Track {
+        QString name;    // Used in the file name
+        QString source;  // Capture device
+    };
+
+    static constexpr int SAMPLE_RATE = 48000;
+    static constexpr int CHANNELS = 2;
+    static constexpr int BLOCK_FRAMES = 1024;
+    static constexpr double BUFFER_SECONDS = 4.0;  // Per-track ring: how long the disk may stall
+
+    Recorder(const QList<Track> &tracks, QObject *parent = nullptr);
+    ~Recorder();
+
+    // Creates directory and one file per track: <directory>/<prefix>-<track>.wav.
+    // Call before start().
+    bool open(const QString &directory, const QString &prefix);
+    QStringList files() const { return m_files; }
+    void stop();
+
+    // Readable from any thread
+    uint64_t framesRecorded() const { return m_framesRecorded.load(std::memory_order_relaxed); }
+    uint64_t droppedFrames() const { return m_droppedFrames.load(std::memory_order_relaxed); }
+
+signals:
+    void failed(const QString &message);
+
+protected:
+    void run() override;
+
+private:
+    struct TrackState {
+        explicit TrackState(const Track &track);
+
+        Track track;
+        SpscRingBuffer<float> ring;
+        WavFileWriter writer;
+    };
+
+    bool readBlock(QProcess &process, char *data, qint64 bytes);
+    void writerLoop();
+
+    std::vector<std::unique_ptr<TrackState>> m_tracks;
+    QStringList m_files;
+    std::thread m_writer;
+    std::atomic<bool> m_running{false};
+    std::atomic<bool> m_capturing{false};
+    std::atomic<bool> m_writeFailed{false};
+    std::atomic<uint64_t> m_framesRecorded{0};
+    std::atomic<uint64_t> m_droppedFrames{0};
+};
+
+} // namespace WaveMux
@@ -0,0 +1,156 @@
+#include "replaybuffer.h"
+#include "logging.h"
+#include "wavfilewriter.h"
+#include <QDir>
+#include <QFileInfo>
+#include <QProcess>
+#include <QDebug>
+#include <cstring>
+
+namespace WaveMux {
+
+ReplayBuffer::ReplayBuffer(const QList<Track> &tracks, int seconds, bool compact, QObject *parent)
+    : QThread(parent)
+    , m_seconds(seconds)
+    , m_compact(compact)
+{
+    const size_t history = static_cast<size_t>(seconds) * SAMPLE_RATE * CHANNELS;
+    for (const auto &track : tracks) {
+        m_tracks.push_back({track, std::make_shared<ReplayRing>(history, BLOCK_FRAMES * CHANNELS, compact)});
+    }
+    m_running = true;  // Before start(): run() only ever clears it, so an early stop() holds
+}
+
+ReplayBuffer::~ReplayBuffer() {
+    stop();
+}
+
+QList<ReplayBuffer::Track> ReplayBuffer::tracks() const {
+    QList<Track> tracks;
+    for (const auto &state : m_tracks) {
+        tracks.append(state.track);
+    }
+    return tracks;
+}
+
+size_t ReplayBuffer::memoryBytes() const {
+    size_t bytes = 0;
+    for (const auto &state : m_tracks) {
+        bytes += state.ring->memoryBytes();
+    }
+    return bytes;
+}
+
+void ReplayBuffer::setSource(const QString &track, const QString &source) {
+    for (auto &state : m_tracks) {
+        if (state.track.name == track) {
+            state.track.source = source;
+        }
+    }
+}
+
+void ReplayBuffer::stop() {
+    m_running = false;
+    wait();
+    m_running = true;  // Re-armed for the next start() (a new source restarts the thread)
+}
+
+ReplayBuffer::Clip ReplayBuffer::clip() const {
+    Clip clip;
+    for (const auto &state : m_tracks) {
+        clip.names << state.track.name;
+        clip.rings.push_back(state.ring);
+    }
+    return clip;
+}
+
+bool ReplayBuffer::writeClip(const Clip &clip, double seconds, const QString &path,
+                             const QString &primaryTrack, QStringList *files) {
+    const QFileInfo info(path);
+    if (!QDir().mkpath(info.absolutePath())) {
+        qCWarning(lcCapture) << "Cannot create replay directory:" << info.absolutePath();
+        return false;
+    }
+
+    const size_t samples = static_cast<size_t>(seconds * SAMPLE_RATE) * CHANNELS;
+    std::vector<float> buffer(samples);
+    bool success = true;
+
+    for (size_t i = 0; i < clip.rings.size(); ++i) {
+        const QString &name = clip.names[i];
+        const QString file = name == primaryTrack
+            ? info.absoluteFilePath()
+            : info.dir().filePath(QString("%1-%2.wav").arg(info.completeBaseName(), name));
+
+        // Whole frames only; the copy is the only moment the ring is touched
+        const size_t count = clip.rings[i]->snapshot(buffer.data(), samples) / CHANNELS * CHANNELS;
+
+        WavFileWriter writer;
+        if (!writer.open(file.toStdString(), SAMPLE_RATE, CHANNELS)
+                || !writer.write(buffer.data(), count) || !writer.close()) {
+            qCWarning(lcCapture) << "Cannot write replay" << file << ":" << std::strerror(writer.lastError());
+            success = false;
+            continue;
+        }
+        if (files) {
+            files->append(file);
+        }
+    }
+    return success;
+}
+
+bool ReplayBuffer::readBlock(QProcess &process, char *data, qint64 bytes) {
+    while (process.bytesAvailable() < bytes) {
+        if (!m_running || process.state() != QProcess::Running) {
+            return false;
+        }
+        process.waitForReadyRead(100);
+    }
+    return process.read(data, bytes) == bytes;
+}
+
+void ReplayBuffer::run() {
+    std::vector<std::unique_ptr<QProcess>> captures;
+    for (const auto &state : m_tracks) {
+        auto capture = std::make_unique<QProcess>();
+        capture->start("parec", {QString("--device=%1").arg(state.track.source), "--raw", "--format=float32le",
+                                 QString("--rate=%1").arg(SAMPLE_RATE), QString("--channels=%1").arg(CHANNELS),
+                                 "--client-name=wavemux-replay"});
+        captures.push_back(std::move(capture));
+    }
+
+    bool started = true;
+    for (auto &capture : captures) {
+        started = capture->waitForStarted(3000) && started;
+    }
+
+    if (!started) {
+        m_running = false;
+        emit failed("Failed to start parec for the replay buffer");
+    }
+
+    const size_t blockSamples = BLOCK_FRAMES * CHANNELS;
+    std::vector<float> block(blockSamples);
+
+    while (m_running) {
+        for (size_t i = 0; i < captures.size() && m_running; ++i) {
+            if (!readBlock(*captures[i], reinterpret_cast<char *>(block.data()), blockSamples * sizeof(float))) {
+                if (m_running) {
+                    emit failed(QString("Replay capture of %1 stopped unexpectedly").arg(m_tracks[i].track.source));
+                    m_running = false;
+                }
+                break;
+            }
+            m_tracks[i].ring->write(block.data(), blockSamples);
+        }
+    }
+
+    for (auto &capture : captures) {
+        capture->terminate();
+    }
+    for (auto &capture : captures) {
+        capture->waitForFinished(1000);
+    }
+}
+
+} // namespace WaveMux
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <QThread>
+#include <QString>
+#include <QStringList>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include "dsp/replayring.h"
+
+class QProcess;
+
+namespace WaveMux {
+
+// Keeps the last few minutes of one or more sources in memory, ready to be
+// saved like an instant replay. This thread captures (parec) into one
+// preallocated ReplayRing per track; saving copies out of the rings from
+// another thread without pausing capture. The rings survive stop()/start(),
+// so a source can be retargeted (e.g. after device failover) without
+// losing the history.
+class ReplayBuffer : public QThread {
+    Q_OBJECT
+
+public:
+    struct Track {
+        QString name;    // Used in the file name
+        QString source;  // Capture device
+    };
+
+    // What a save needs; shares the rings, so it may outlive the buffer
+    struct Clip {
+        QStringList names;
+        std::vector<std::shared_ptr<const ReplayRing>> rings;
+    };
+
+    static constexpr int SAMPLE_RATE = 48000;
+    static constexpr int CHANNELS = 2;
+    static constexpr int BLOCK_FRAMES = 1024;
+
+    ReplayBuffer(const QList<Track> &tracks, int seconds, bool compact, QObject *parent = nullptr);
+    ~ReplayBuffer();
+
+    QList<Track> tracks() const;
+    int seconds() const { return m_seconds; }
+    bool isCompact() const { return m_compact; }
+    size_t memoryBytes() const;
+
+    // Only while stopped
+    void setSource(const QString &track, const QString &source);
+    void stop();
+
+    Clip clip() const;
+    // Writes the newest `seconds` of each track as float WAV. The track named
+    // primaryTrack goes to path, others next to it as <base>-<track>.wav.
+    // Blocking: call from a worker thread.
+    static bool writeClip(const Clip &clip, double seconds, const QString &path,
+                          const QString &primaryTrack, QStringList *files);
+
+signals:
+    void failed(const QString &message);
+
+protected:
+    void run() override;
+
+private:
+    struct TrackState {
+        Track track;
+        std::shared_ptr<ReplayRing> ring;
+    };
+
+    bool readBlock(QProcess &process, char *data, qint64 bytes);
+
+    std::vector<TrackState> m_tracks;
+    int m_seconds;
+    bool m_compact;
+    std::atomic<bool> m_running{false};
+};
+
+} // namespace WaveMux
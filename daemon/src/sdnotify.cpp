@@ -0,0 +1,47 @@
+#include "sdnotify.h"
+#include "logging.h"
+#include <QDebug>
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace WaveMux {
+
+bool sdNotify(const QByteArray &state) {
+    const QByteArray socketPath = qgetenv("NOTIFY_SOCKET");
+    if (socketPath.isEmpty()) {
+        return false;
+    }
+
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if (static_cast<size_t>(socketPath.size()) >= sizeof(address.sun_path)) {
+        qCWarning(lcDaemon) << "NOTIFY_SOCKET path too long";
+        return false;
+    }
+    std::memcpy(address.sun_path, socketPath.constData(), socketPath.size());
+    // A leading '@' denotes the abstract socket namespace
+    if (address.sun_path[0] == '@') {
+        address.sun_path[0] = '\0';
+    }
+    const socklen_t addressLength = offsetof(sockaddr_un, sun_path) + socketPath.size();
+
+    int fd = ::socket(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        qCWarning(lcDaemon) << "Failed to create notify socket:" << strerror(errno);
+        return false;
+    }
+
+    ssize_t sent = ::sendto(fd, state.constData(), state.size(), MSG_NOSIGNAL,
+                            reinterpret_cast<const sockaddr *>(&address), addressLength);
+    ::close(fd);
+
+    if (sent != state.size()) {
+        qCWarning(lcDaemon) << "Failed to notify service manager:" << strerror(errno);
+        return false;
+    }
+    return true;
+}
+
+} // namespace WaveMux
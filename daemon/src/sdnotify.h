@@ -0,0 +1,12 @@
+#pragma once
+
+#include <QByteArray>
+
+namespace WaveMux {
+
+// Minimal sd_notify(3): sends a state string (e.g. "READY=1") to the service
+// manager via $NOTIFY_SOCKET. Returns false when not running under systemd
+// (no socket set) or when sending fails; callers can safely ignore that.
+bool sdNotify(const QByteArray &state);
+
+} // namespace WaveMux
@@ -0,0 +1,66 @@
+#include "signalwatcher.h"
+#include "logging.h"
+#include <QSocketNotifier>
+#include <QDebug>
+#include <csignal>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace WaveMux {
+
+int SignalWatcher::s_fds[2] = {-1, -1};
+
+SignalWatcher::SignalWatcher(const QList<int> &signalNumbers, QObject *parent)
+    : QObject(parent)
+    , m_signals(signalNumbers)
+{
+    if (::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, s_fds) != 0) {
+        qCWarning(lcDaemon) << "Failed to create signal socketpair:" << strerror(errno);
+        return;
+    }
+    // Never block inside the signal handler, even if the event loop is stalled
+    ::fcntl(s_fds[0], F_SETFL, O_NONBLOCK);
+    ::fcntl(s_fds[1], F_SETFL, O_NONBLOCK);
+
+    m_notifier = new QSocketNotifier(s_fds[1], QSocketNotifier::Read, this);
+    connect(m_notifier, &QSocketNotifier::activated, this, &SignalWatcher::handleReadable);
+
+    struct sigaction action = {};
+    action.sa_handler = &SignalWatcher::handleSignal;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESTART;
+    for (int sig : m_signals) {
+        ::sigaction(sig, &action, nullptr);
+    }
+}
+
+SignalWatcher::~SignalWatcher() {
+    for (int sig : m_signals) {
+        ::signal(sig, SIG_DFL);
+    }
+    if (s_fds[0] >= 0) {
+        ::close(s_fds[0]);
+        ::close(s_fds[1]);
+        s_fds[0] = s_fds[1] = -1;
+    }
+}
+
+void SignalWatcher::handleSignal(int signal) {
+    // Async-signal context: write() is the only thing we do here
+    const unsigned char byte = static_cast<unsigned char>(signal);
+    const int savedErrno = errno;
+    [[maybe_unused]] ssize_t written = ::write(s_fds[0], &byte, 1);
+    errno = savedErrno;
+}
+
+void SignalWatcher::handleReadable() {
+    unsigned char byte = 0;
+    while (::read(s_fds[1], &byte, 1) == 1) {
+        emit signalReceived(byte);
+    }
+}
+
+} // namespace WaveMux
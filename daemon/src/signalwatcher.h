@@ -0,0 +1,38 @@
+#pragma once
+
+#include <QObject>
+#include <QList>
+
+class QSocketNotifier;
+
+namespace WaveMux {
+
+// Turns Unix signals into a Qt signal delivered on the event loop.
+//
+// The async signal handler only writes the signal number into a socketpair
+// (the classic self-pipe trick); everything else - saving config, tearing
+// down sinks - runs later from the event loop where it is safe to do so.
+class SignalWatcher : public QObject {
+    Q_OBJECT
+
+public:
+    explicit SignalWatcher(const QList<int> &signalNumbers, QObject *parent = nullptr);
+    ~SignalWatcher();
+
+    bool isValid() const { return m_notifier != nullptr; }
+
+signals:
+    void signalReceived(int signal);
+
+private slots:
+    void handleReadable();
+
+private:
+    static void handleSignal(int signal);
+
+    static int s_fds[2];
+    QSocketNotifier *m_notifier = nullptr;
+    QList<int> m_signals;
+};
+
+} // namespace WaveMux
@@ -0,0 +1,158 @@
+#include "spectrummonitor.h"
+#include <QProcess>
+#include <QDebug>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+namespace WaveMux {
+
+namespace {
+    // A few analysis periods of headroom
+    constexpr size_t RING_SAMPLES = 8192;
+    constexpr int CAPTURE_IDLE_MS = 5;
+}
+
+SpectrumMonitor::TargetState::TargetState(const Target &target)
+    : target(target)
+    , ring(RING_SAMPLES)
+{
+}
+
+SpectrumMonitor::SpectrumMonitor(const QList<Target> &targets, QObject *parent)
+    : QThread(parent)
+{
+    for (const auto &target : targets) {
+        m_targets.push_back(std::make_unique<TargetState>(target));
+    }
+    m_running = true;  // Set here so a stop() that beats run() isn't lost
+}
+
+SpectrumMonitor::~SpectrumMonitor() {
+    stop();
+}
+
+QList<SpectrumMonitor::Target> SpectrumMonitor::targets() const {
+    QList<Target> targets;
+    for (const auto &state : m_targets) {
+        targets.append(state->target);
+    }
+    return targets;
+}
+
+void SpectrumMonitor::stop() {
+    m_running = false;
+    wait();
+}
+
+QHash<QString, SpectrumMonitor::Bands> SpectrumMonitor::takeUpdates() {
+    QHash<QString, Bands> updates;
+    for (auto &state : m_targets) {
+        if (state->bands.update()) {
+            updates.insert(state->target.id, state->bands.front());
+        }
+    }
+    return updates;
+}
+
+void SpectrumMonitor::run() {
+    std::vector<std::unique_ptr<QProcess>> captures;
+    for (const auto &state : m_targets) {
+        QStringList args = {"--raw", "--format=float32le", QString("--rate=%1").arg(SAMPLE_RATE), "--channels=1",
+                            "--latency-msec=20", "--client-name=wavemux-spectrum"};
+        if (state->target.stream > 0) {
+            args << QString("--monitor-stream=%1").arg(state->target.stream);
+        } else {
+            args << QString("--device=%1").arg(state->target.device);
+        }
+        auto capture = std::make_unique<QProcess>();
+        capture->start("parec", args);
+        captures.push_back(std::move(capture));
+    }
+
+    bool started = true;
+    for (auto &capture : captures) {
+        started = capture->waitForStarted(3000) && started;
+    }
+    if (!started) {
+        emit failed("Failed to start parec for the spectrum feed");
+        return;
+    }
+
+    QThread *analysis = QThread::create([this]() { analysisLoop(); });
+    analysis->start(QThread::IdlePriority);
+
+    // Targets are read as data arrives rather than in lockstep: a paused
+    // application stream delivers nothing and must not hold up the others
+    std::vector<float> block(1024);
+    while (m_running) {
+        bool idle = true;
+        for (size_t i = 0; i < captures.size(); ++i) {
+            QProcess &capture = *captures[i];
+            if (capture.state() != QProcess::Running) {
+                continue;  // Stream went away; its bands simply stop updating
+            }
+            const qint64 samples = qMin<qint64>(capture.bytesAvailable() / sizeof(float), block.size());
+            if (samples == 0) {
+                capture.waitForReadyRead(0);
+                continue;
+            }
+            capture.read(reinterpret_cast<char *>(block.data()), samples * sizeof(float));
+            m_targets[i]->ring.write(block.data(), samples);  // Drops what doesn't fit
+            idle = false;
+        }
+        if (idle) {
+            QThread::msleep(CAPTURE_IDLE_MS);
+        }
+    }
+
+    analysis->wait();
+    delete analysis;
+    for (auto &capture : captures) {
+        capture->terminate();
+    }
+    for (auto &capture : captures) {
+        capture->waitForFinished(1000);
+    }
+}
+
+void SpectrumMonitor::analysisLoop() {
+    constexpr size_t N = SpectrumAnalyzer::FFT_SIZE;
+    const auto period = std::chrono::microseconds(1000000 / UPDATE_HZ);
+
+    SpectrumAnalyzer analyzer(SAMPLE_RATE);
+    std::vector<std::vector<float>> history(m_targets.size(), std::vector<float>(N, 0.0f));
+    std::vector<size_t> positions(m_targets.size(), 0);
+    std::vector<float> chunk(RING_SAMPLES);
+    std::vector<float> window(N);
+
+    auto next = std::chrono::steady_clock::now();
+    while (m_running) {
+        for (size_t i = 0; i < m_targets.size(); ++i) {
+            TargetState &state = *m_targets[i];
+            const size_t fresh = state.ring.read(chunk.data(), chunk.size());
+            if (fresh == 0) {
+                continue;
+            }
+
+            // Keep the newest N samples in a circular history
+            std::vector<float> &samples = history[i];
+            size_t &position = positions[i];
+            for (size_t j = fresh > N ? fresh - N : 0; j < fresh; ++j) {
+                samples[position] = chunk[j];
+                position = (position + 1) % N;
+            }
+            std::copy(samples.begin() + position, samples.end(), window.begin());
+            std::copy(samples.begin(), samples.begin() + position, window.begin() + (N - position));
+
+            analyzer.analyze(window.data(), state.bands.back().data());
+            state.bands.publish();
+        }
+
+        // Skip ticks rather than catching up after a stall
+        next = std::max(next + period, std::chrono::steady_clock::now());
+        std::this_thread::sleep_until(next);
+    }
+}
+
+} // namespace WaveMux
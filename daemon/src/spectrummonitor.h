@@ -0,0 +1,65 @@
+#pragma once
+
+#include <QThread>
+#include <QHash>
+#include <QString>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include "dsp/ringbuffer.h"
+#include "dsp/spectrum.h"
+#include "dsp/triplebuffer.h"
+
+namespace WaveMux {
+
+// Spectrum feed for the UI. This thread captures each target (mono, through
+// parec) and pushes the samples into a lock-free ring; an idle-priority
+// analysis thread drains the rings UPDATE_HZ times a second, analyzes the
+// newest FFT_SIZE samples of each and publishes the bands. Only created
+// while a client is watching.
+class SpectrumMonitor : public QThread {
+    Q_OBJECT
+
+public:
+    struct Target {
+        QString id;
+        QString device;       // Source to capture ...
+        uint32_t stream = 0;  // ... or, if set, this sink input (application stream)
+    };
+    typedef std::array<float, SpectrumAnalyzer::BANDS> Bands;
+
+    static constexpr int SAMPLE_RATE = 48000;
+    static constexpr int UPDATE_HZ = 30;
+
+    explicit SpectrumMonitor(const QList<Target> &targets, QObject *parent = nullptr);
+    ~SpectrumMonitor();
+
+    QList<Target> targets() const;
+    void stop();
+
+    // Reader thread (one only): bands of each target analyzed since the last call
+    QHash<QString, Bands> takeUpdates();
+
+signals:
+    void failed(const QString &message);
+
+protected:
+    void run() override;
+
+private:
+    struct TargetState {
+        explicit TargetState(const Target &target);
+
+        Target target;
+        SpscRingBuffer<float> ring;
+        TripleBuffer<Bands> bands;
+    };
+
+    void analysisLoop();
+
+    std::vector<std::unique_ptr<TargetState>> m_targets;
+    std::atomic<bool> m_running{false};
+};
+
+} // namespace WaveMux
@@ -0,0 +1,245 @@
+#include "stats.h"
+#include <algorithm>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace WaveMux {
+
+namespace {
+    // Each thread sticks to one shard, handed out round-robin
+    size_t shardIndex() {
+        static std::atomic<size_t> nextThread{0};
+        thread_local const size_t index = nextThread.fetch_add(1, std::memory_order_relaxed) % Histogram::SHARDS;
+        return index;
+    }
+
+    struct Registry {
+        std::mutex mutex;
+        std::map<std::string, std::unique_ptr<Histogram>> histograms;
+        std::map<std::string, std::unique_ptr<Counter>> counters;
+    };
+
+    Registry &registry() {
+        static Registry instance;
+        return instance;
+    }
+
+    std::string formatValue(uint64_t value, Histogram::Unit unit) {
+        char text[32];
+        if (unit == Histogram::Unit::Count) {
+            std::snprintf(text, sizeof(text), "%llu", static_cast<unsigned long long>(value));
+        } else if (value < 1000) {
+            std::snprintf(text, sizeof(text), "%llu us", static_cast<unsigned long long>(value));
+        } else if (value < 1000000) {
+            std::snprintf(text, sizeof(text), "%.2f ms", value / 1000.0);
+        } else {
+            std::snprintf(text, sizeof(text), "%.2f s", value / 1000000.0);
+        }
+        return text;
+    }
+}
+
+size_t Histogram::bucketFor(uint64_t value) {
+    // Values below 4 get a bucket each; above, 4 buckets per power of two
+    if (value < 4) {
+        return static_cast<size_t>(value);
+    }
+    const int msb = 63 - __builtin_clzll(value);
+    const size_t quarter = static_cast<size_t>((value >> (msb - 2)) & 3);
+    return std::min(static_cast<size_t>(msb - 1) * 4 + quarter, BUCKETS - 1);
+}
+
+uint64_t Histogram::bucketValue(size_t bucket) {
+    if (bucket < 4) {
+        return bucket;
+    }
+    const int msb = static_cast<int>(bucket / 4) + 1;
+    const uint64_t width = uint64_t(1) << (msb - 2);
+    return (4 + bucket % 4) * width + width / 2;
+}
+
+void Histogram::record(uint64_t value) {
+    Shard &shard = m_shards[shardIndex()];
+    shard.count.fetch_add(1, std::memory_order_relaxed);
+    shard.sum.fetch_add(value, std::memory_order_relaxed);
+    shard.buckets[bucketFor(value)].fetch_add(1, std::memory_order_relaxed);
+    uint64_t max = shard.max.load(std::memory_order_relaxed);
+    while (value > max && !shard.max.compare_exchange_weak(max, value, std::memory_order_relaxed)) {
+    }
+}
+
+Histogram::Summary Histogram::summary() const {
+    Summary summary;
+    std::array<uint64_t, BUCKETS> buckets{};
+    for (const auto &shard : m_shards) {
+        summary.count += shard.count.load(std::memory_order_relaxed);
+        summary.sum += shard.sum.load(std::memory_order_relaxed);
+        summary.max = std::max(summary.max, shard.max.load(std::memory_order_relaxed));
+        for (size_t i = 0; i < BUCKETS; ++i) {
+            buckets[i] += shard.buckets[i].load(std::memory_order_relaxed);
+        }
+    }
+
+    // Percentiles from the bucket counts (which may run slightly ahead of or
+    // behind count while others record)
+    uint64_t total = 0;
+    for (uint64_t bucket : buckets) {
+        total += bucket;
+    }
+    auto percentile = [&](double fraction) -> uint64_t {
+        const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(fraction * total + 0.5));
+        uint64_t seen = 0;
+        for (size_t i = 0; i < BUCKETS; ++i) {
+            seen += buckets[i];
+            if (seen >= rank) {
+                return std::min(bucketValue(i), summary.max);
+            }
+        }
+        return summary.max;
+    };
+    if (total > 0) {
+        summary.p50 = percentile(0.50);
+        summary.p99 = percentile(0.99);
+    }
+    return summary;
+}
+
+void Histogram::reset() {
+    for (auto &shard : m_shards) {
+        shard.count.store(0, std::memory_order_relaxed);
+        shard.sum.store(0, std::memory_order_relaxed);
+        shard.max.store(0, std::memory_order_relaxed);
+        for (auto &bucket : shard.buckets) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+void Counter::add(uint64_t amount) {
+    m_shards[shardIndex()].value.fetch_add(amount, std::memory_order_relaxed);
+}
+
+uint64_t Counter::value() const {
+    uint64_t total = 0;
+    for (const auto &shard : m_shards) {
+        total += shard.value.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+void Counter::reset() {
+    for (auto &shard : m_shards) {
+        shard.value.store(0, std::memory_order_relaxed);
+    }
+}
+
+Histogram &Stats::histogram(const std::string &name, Histogram::Unit unit) {
+    thread_local std::unordered_map<std::string, Histogram *> cache;
+    auto cached = cache.find(name);
+    if (cached != cache.end()) {
+        return *cached->second;
+    }
+
+    Registry &metrics = registry();
+    std::lock_guard<std::mutex> lock(metrics.mutex);
+    auto &slot = metrics.histograms[name];
+    if (!slot) {
+        slot = std::make_unique<Histogram>(unit);
+    }
+    cache.emplace(name, slot.get());
+    return *slot;
+}
+
+Counter &Stats::counter(const std::string &name) {
+    thread_local std::unordered_map<std::string, Counter *> cache;
+    auto cached = cache.find(name);
+    if (cached != cache.end()) {
+        return *cached->second;
+    }
+
+    Registry &metrics = registry();
+    std::lock_guard<std::mutex> lock(metrics.mutex);
+    auto &slot = metrics.counters[name];
+    if (!slot) {
+        slot = std::make_unique<Counter>();
+    }
+    cache.emplace(name, slot.get());
+    return *slot;
+}
+
+std::vector<std::pair<std::string, const Histogram *>> Stats::histograms() {
+    Registry &metrics = registry();
+    std::lock_guard<std::mutex> lock(metrics.mutex);
+    std::vector<std::pair<std::string, const Histogram *>> result;
+    for (const auto &entry : metrics.histograms) {
+        result.emplace_back(entry.first, entry.second.get());
+    }
+    return result;
+}
+
+std::vector<std::pair<std::string, const Counter *>> Stats::counters() {
+    Registry &metrics = registry();
+    std::lock_guard<std::mutex> lock(metrics.mutex);
+    std::vector<std::pair<std::string, const Counter *>> result;
+    for (const auto &entry : metrics.counters) {
+        result.emplace_back(entry.first, entry.second.get());
+    }
+    return result;
+}
+
+void Stats::reset() {
+    Registry &metrics = registry();
+    std::lock_guard<std::mutex> lock(metrics.mutex);
+    for (auto &entry : metrics.histograms) {
+        entry.second->reset();
+    }
+    for (auto &entry : metrics.counters) {
+        entry.second->reset();
+    }
+}
+
+std::string Stats::dump() {
+    std::string out;
+    char line[256];
+
+    const auto allHistograms = histograms();
+    size_t width = 9;
+    for (const auto &entry : allHistograms) {
+        width = std::max(width, entry.first.size());
+    }
+    std::snprintf(line, sizeof(line), "%-*s %8s %10s %10s %10s %10s\n", static_cast<int>(width), "HISTOGRAM",
+                  "COUNT", "P50", "P99", "MAX", "MEAN");
+    out += line;
+    for (const auto &entry : allHistograms) {
+        const Histogram::Summary summary = entry.second->summary();
+        if (summary.count == 0) {
+            continue;
+        }
+        const Histogram::Unit unit = entry.second->unit();
+        std::snprintf(line, sizeof(line), "%-*s %8llu %10s %10s %10s %10s\n", static_cast<int>(width),
+                      entry.first.c_str(), static_cast<unsigned long long>(summary.count),
+                      formatValue(summary.p50, unit).c_str(), formatValue(summary.p99, unit).c_str(),
+                      formatValue(summary.max, unit).c_str(), formatValue(summary.sum / summary.count, unit).c_str());
+        out += line;
+    }
+
+    out += "\n";
+    const auto allCounters = counters();
+    width = 9;
+    for (const auto &entry : allCounters) {
+        width = std::max(width, entry.first.size());
+    }
+    std::snprintf(line, sizeof(line), "%-*s %10s\n", static_cast<int>(width), "COUNTER", "VALUE");
+    out += line;
+    for (const auto &entry : allCounters) {
+        std::snprintf(line, sizeof(line), "%-*s %10llu\n", static_cast<int>(width), entry.first.c_str(),
+                      static_cast<unsigned long long>(entry.second->value()));
+        out += line;
+    }
+    return out;
+}
+
+} // namespace WaveMux
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#include "eventlog.h"
+#include "trace.h"
+
+namespace WaveMux {
+
+// Histogram of non-negative integer samples, usually microseconds. Buckets
+// are a quarter octave wide, so percentiles are within ~10%; count, sum and
+// max are exact. Recording is lock-free and wait-free: each thread adds to
+// one of a few cache-line aligned shards (relaxed atomics), so threads
+// recording at the same time don't contend; summary() merges the shards.
+class Histogram {
+public:
+    enum class Unit { Microseconds, Count };
+
+    static constexpr size_t SHARDS = 8;
+    static constexpr size_t BUCKETS = 160;  // Up to 2^40 (~12 days in microseconds)
+
+    struct Summary {
+        uint64_t count = 0;
+        uint64_t sum = 0;
+        uint64_t max = 0;
+        uint64_t p50 = 0;
+        uint64_t p99 = 0;
+    };
+
+    explicit Histogram(Unit unit = Unit::Microseconds) : m_unit(unit) {}
+    Histogram(const Histogram &) = delete;
+    Histogram &operator=(const Histogram &) = delete;
+
+    Unit unit() const { return m_unit; }
+    void record(uint64_t value);
+    Summary summary() const;
+    void reset();
+
+    static size_t bucketFor(uint64_t value);
+    static uint64_t bucketValue(size_t bucket);  // Middle of the bucket
+
+private:
+    struct alignas(64) Shard {
+        std::atomic<uint64_t> count{0};
+        std::atomic<uint64_t> sum{0};
+        std::atomic<uint64_t> max{0};
+        std::array<std::atomic<uint64_t>, BUCKETS> buckets{};
+    };
+
+    Unit m_unit;
+    std::array<Shard, SHARDS> m_shards;
+};
+
+// Monotonic event counter, sharded like Histogram
+class Counter {
+public:
+    Counter() = default;
+    Counter(const Counter &) = delete;
+    Counter &operator=(const Counter &) = delete;
+
+    void add(uint64_t amount = 1);
+    uint64_t value() const;
+    void reset();
+
+private:
+    struct alignas(64) Shard {
+        std::atomic<uint64_t> value{0};
+    };
+    std::array<Shard, Histogram::SHARDS> m_shards;
+};
+
+// Process-wide registry of named histograms and counters. Metrics are
+// created on first use and never go away, so references stay valid; looking
+// one up only takes the registry lock the first time a thread asks for it.
+class Stats {
+public:
+    static Histogram &histogram(const std::string &name, Histogram::Unit unit = Histogram::Unit::Microseconds);
+    static Counter &counter(const std::string &name);
+
+    // Sorted by name
+    static std::vector<std::pair<std::string, const Histogram *>> histograms();
+    static std::vector<std::pair<std::string, const Counter *>> counters();
+
+    static void reset();
+    // Human-readable table of everything recorded so far
+    static std::string dump();
+};
+
+// Records the lifetime of the scope into a histogram, in microseconds
+class ScopedTimer {
+public:
+    explicit ScopedTimer(Histogram &histogram)
+        : m_histogram(histogram)
+        , m_start(std::chrono::steady_clock::now())
+    {
+    }
+    ~ScopedTimer() {
+        m_histogram.record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - m_start).count()));
+    }
+    ScopedTimer(const ScopedTimer &) = delete;
+    ScopedTimer &operator=(const ScopedTimer &) = delete;
+
+private:
+    Histogram &m_histogram;
+    std::chrono::steady_clock::time_point m_start;
+};
+
+} // namespace WaveMux
+
+// Times the enclosing D-Bus method into the histogram "dbus.<method>",
+// notes the call in the EventLog and, while tracing, records it as a "dbus"
+// span
+#define WAVEMUX_TIME_DBUS_CALL() \
+    static WaveMux::Histogram &dbusCallHistogram = WaveMux::Stats::histogram(std::string("dbus.") + __func__); \
+    WaveMux::EventLog::record(WaveMux::EventLog::Code::DBusCall, __func__); \
+    const WaveMux::ScopedTimer dbusCallTimer(dbusCallHistogram); \
+    const WaveMux::TraceSpan dbusCallSpan("dbus", __func__)
@@ -0,0 +1,190 @@
+#include "trace.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <unistd.h>
+#include <vector>
+
+namespace WaveMux {
+
+std::atomic<bool> Trace::s_enabled{false};
+
+namespace {
+    struct Slot {
+        // 2 * index + 1 while being written, 2 * index + 2 once complete
+        std::atomic<uint64_t> sequence{0};
+        const char *category = nullptr;
+        char phase = 'X';
+        uint32_t thread = 0;
+        uint64_t start = 0;
+        uint64_t duration = 0;
+        char name[Trace::NAME_BYTES] = {};
+    };
+
+    std::atomic<Slot *> g_slots{nullptr};
+    std::atomic<uint64_t> g_next{0};
+    std::mutex g_allocation;
+
+    const std::chrono::steady_clock::time_point g_epoch = std::chrono::steady_clock::now();
+
+    uint32_t threadIndex() {
+        static std::atomic<uint32_t> nextThread{1};
+        thread_local const uint32_t index = nextThread.fetch_add(1, std::memory_order_relaxed);
+        return index;
+    }
+
+    void record(char phase, const char *category, const char *name, uint64_t start, uint64_t duration) {
+        Slot *slots = g_slots.load(std::memory_order_acquire);
+        if (!slots) {
+            return;
+        }
+        const uint64_t index = g_next.fetch_add(1, std::memory_order_relaxed);
+        Slot &slot = slots[index % Trace::CAPACITY];
+        slot.sequence.store(2 * index + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.category = category;
+        slot.phase = phase;
+        slot.thread = threadIndex();
+        slot.start = start;
+        slot.duration = duration;
+        std::strncpy(slot.name, name, Trace::NAME_BYTES - 1);
+        slot.name[Trace::NAME_BYTES - 1] = '\0';
+        slot.sequence.store(2 * index + 2, std::memory_order_release);
+    }
+
+    void appendEscaped(std::string &out, const char *text) {
+        for (const char *c = text; *c; ++c) {
+            switch (*c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(*c) < 0x20) {
+                    out += ' ';
+                } else {
+                    out += *c;
+                }
+            }
+        }
+    }
+}
+
+void Trace::setEnabled(bool enabled) {
+    if (enabled && !g_slots.load(std::memory_order_acquire)) {
+        std::lock_guard<std::mutex> lock(g_allocation);
+        if (!g_slots.load(std::memory_order_relaxed)) {
+            // Never freed: recorders may still hold the pointer
+            g_slots.store(new Slot[CAPACITY], std::memory_order_release);
+        }
+    }
+    s_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+uint64_t Trace::now() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - g_epoch).count());
+}
+
+void Trace::complete(const char *category, const char *name, uint64_t start, uint64_t duration) {
+    record('X', category, name, start, duration);
+}
+
+void Trace::instant(const char *category, const char *name) {
+    if (isEnabled()) {
+        record('i', category, name, now(), 0);
+    }
+}
+
+size_t Trace::eventCount() {
+    return static_cast<size_t>(std::min<uint64_t>(g_next.load(std::memory_order_relaxed), CAPACITY));
+}
+
+void Trace::clear() {
+    Slot *slots = g_slots.load(std::memory_order_acquire);
+    if (!slots) {
+        return;
+    }
+    for (size_t i = 0; i < CAPACITY; ++i) {
+        slots[i].sequence.store(0, std::memory_order_relaxed);
+    }
+    g_next.store(0, std::memory_order_relaxed);
+}
+
+std::string Trace::chromeJson() {
+    struct Event {
+        const char *category;
+        char phase;
+        uint32_t thread;
+        uint64_t start;
+        uint64_t duration;
+        char name[NAME_BYTES];
+    };
+    std::vector<Event> events;
+
+    const Slot *slots = g_slots.load(std::memory_order_acquire);
+    const uint64_t end = g_next.load(std::memory_order_acquire);
+    if (slots) {
+        events.reserve(static_cast<size_t>(std::min<uint64_t>(end, CAPACITY)));
+        for (uint64_t index = end > CAPACITY ? end - CAPACITY : 0; index < end; ++index) {
+            const Slot &slot = slots[index % CAPACITY];
+            if (slot.sequence.load(std::memory_order_acquire) != 2 * index + 2) {
+                continue;  // Still being written, or already overwritten
+            }
+            Event event;
+            event.category = slot.category;
+            event.phase = slot.phase;
+            event.thread = slot.thread;
+            event.start = slot.start;
+            event.duration = slot.duration;
+            std::memcpy(event.name, slot.name, NAME_BYTES);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.load(std::memory_order_relaxed) == 2 * index + 2) {
+                events.push_back(event);
+            }
+        }
+    }
+
+    // Spans are recorded when they end; viewers want them by start time
+    std::stable_sort(events.begin(), events.end(),
+                     [](const Event &a, const Event &b) { return a.start < b.start; });
+
+    const int pid = static_cast<int>(::getpid());
+    std::string out = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    char buffer[160];
+    bool first = true;
+    for (const auto &event : events) {
+        out += first ? "\n" : ",\n";
+        first = false;
+        out += "{\"name\":\"";
+        appendEscaped(out, event.name);
+        out += "\",\"cat\":\"";
+        appendEscaped(out, event.category);
+        if (event.phase == 'X') {
+            std::snprintf(buffer, sizeof(buffer), "\",\"ph\":\"X\",\"ts\":%llu,\"dur\":%llu,\"pid\":%d,\"tid\":%u}",
+                          static_cast<unsigned long long>(event.start),
+                          static_cast<unsigned long long>(event.duration), pid, event.thread);
+        } else {
+            std::snprintf(buffer, sizeof(buffer), "\",\"ph\":\"i\",\"s\":\"t\",\"ts\":%llu,\"pid\":%d,\"tid\":%u}",
+                          static_cast<unsigned long long>(event.start), pid, event.thread);
+        }
+        out += buffer;
+    }
+    out += "\n]}\n";
+    return out;
+}
+
+bool Trace::writeChromeJson(const std::string &path) {
+    const std::string json = chromeJson();
+    FILE *file = std::fopen(path.c_str(), "w");
+    if (!file) {
+        return false;
+    }
+    const bool written = std::fwrite(json.data(), 1, json.size(), file) == json.size();
+    return std::fclose(file) == 0 && written;
+}
+
+} // namespace WaveMux
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace WaveMux {
+
+// Opt-in activity trace: scoped spans (backend commands, D-Bus handlers,
+// event handling, config I/O, sleeps) and instant events are recorded into a
+// preallocated ring, newest overwriting oldest, and exported on demand as
+// Chrome trace JSON (chrome://tracing, ui.perfetto.dev). While disabled a
+// span costs one relaxed atomic load.
+class Trace {
+public:
+    static constexpr size_t CAPACITY = 32768;  // Events kept
+    static constexpr size_t NAME_BYTES = 80;   // Longer names are cut
+
+    // The ring is allocated on first enable and kept afterwards
+    static void setEnabled(bool enabled);
+    static bool isEnabled() { return s_enabled.load(std::memory_order_relaxed); }
+
+    // Microseconds on the trace clock
+    static uint64_t now();
+
+    // category must be a string literal (it is stored by pointer)
+    static void complete(const char *category, const char *name, uint64_t start, uint64_t duration);
+    static void instant(const char *category, const char *name);
+
+    static size_t eventCount();  // Events currently held
+    static void clear();
+    // Everything held, oldest first. Safe while other threads record; events
+    // being overwritten at that moment are left out.
+    static std::string chromeJson();
+    static bool writeChromeJson(const std::string &path);
+
+private:
+    static std::atomic<bool> s_enabled;
+};
+
+// Records its scope as a span when tracing is on
+class TraceSpan {
+public:
+    TraceSpan(const char *category, const char *name)
+        : m_category(Trace::isEnabled() ? category : nullptr)
+    {
+        if (m_category) {
+            m_name = name;
+            m_start = Trace::now();
+        }
+    }
+    TraceSpan(const char *category, const std::string &name) : TraceSpan(category, name.c_str()) {}
+    ~TraceSpan() {
+        if (m_category) {
+            Trace::complete(m_category, m_name.c_str(), m_start, Trace::now() - m_start);
+        }
+    }
+    TraceSpan(const TraceSpan &) = delete;
+    TraceSpan &operator=(const TraceSpan &) = delete;
+
+private:
+    const char *m_category;
+    std::string m_name;
+    uint64_t m_start = 0;
+};
+
+} // namespace WaveMux
@@ -0,0 +1,104 @@
+#include "wavfilereader.h"
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+namespace WaveMux {
+
+namespace {
+    constexpr uint16_t WAVE_FORMAT_PCM = 1;
+    constexpr uint16_t WAVE_FORMAT_IEEE_FLOAT = 3;
+    constexpr uint16_t WAVE_FORMAT_EXTENSIBLE = 0xFFFE;
+
+    uint32_t readU32(const unsigned char *data) {
+        return data[0] | (data[1] << 8) | (data[2] << 16) | (static_cast<uint32_t>(data[3]) << 24);
+    }
+
+    uint16_t readU16(const unsigned char *data) {
+        return static_cast<uint16_t>(data[0] | (data[1] << 8));
+    }
+
+    bool fail(std::string *error, const std::string &message) {
+        if (error) {
+            *error = message;
+        }
+        return false;
+    }
+}
+
+bool readWavFile(const std::string &path, WavAudio *audio, std::string *error) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return fail(error, "cannot open " + path);
+    }
+    const std::vector<unsigned char> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (bytes.size() < 12 || std::memcmp(bytes.data(), "RIFF", 4) != 0 || std::memcmp(bytes.data() + 8, "WAVE", 4) != 0) {
+        return fail(error, path + " is not a WAV file");
+    }
+
+    uint16_t format = 0;
+    uint16_t channels = 0;
+    uint32_t sampleRate = 0;
+    uint16_t bits = 0;
+    const unsigned char *data = nullptr;
+    size_t dataBytes = 0;
+
+    size_t at = 12;
+    while (at + 8 <= bytes.size()) {
+        const unsigned char *chunk = bytes.data() + at;
+        const size_t available = bytes.size() - at - 8;
+        const size_t size = readU32(chunk + 4);
+        if (std::memcmp(chunk, "fmt ", 4) == 0 && size >= 16 && size <= available) {
+            format = readU16(chunk + 8);
+            channels = readU16(chunk + 10);
+            sampleRate = readU32(chunk + 12);
+            bits = readU16(chunk + 22);
+            if (format == WAVE_FORMAT_EXTENSIBLE && size >= 40) {
+                format = readU16(chunk + 32);  // First two bytes of the sub-format GUID
+            }
+        } else if (std::memcmp(chunk, "data", 4) == 0) {
+            data = chunk + 8;
+            dataBytes = size == 0 || size > available ? available : size;
+            break;
+        }
+        at += 8 + size + (size & 1);  // Chunks are word-aligned
+    }
+
+    if (channels == 0 || sampleRate == 0) {
+        return fail(error, path + " has no usable format chunk");
+    }
+    if (!data) {
+        return fail(error, path + " has no audio data");
+    }
+    const bool floats = format == WAVE_FORMAT_IEEE_FLOAT && bits == 32;
+    if (!floats && !(format == WAVE_FORMAT_PCM && (bits == 16 || bits == 24 || bits == 32))) {
+        return fail(error, path + ": unsupported sample format " + std::to_string(format) + "/"
+                           + std::to_string(bits) + " bit");
+    }
+
+    const size_t sampleBytes = bits / 8;
+    const size_t count = dataBytes / sampleBytes / channels * channels;
+    audio->sampleRate = static_cast<int>(sampleRate);
+    audio->channels = channels;
+    audio->samples.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        const unsigned char *sample = data + i * sampleBytes;
+        if (floats) {
+            const uint32_t raw = readU32(sample);
+            std::memcpy(&audio->samples[i], &raw, sizeof(float));
+        } else if (bits == 16) {
+            audio->samples[i] = static_cast<int16_t>(readU16(sample)) / 32768.0f;
+        } else if (bits == 24) {
+            // Shift into the top of an int32 so the sign comes along
+            const int32_t value = static_cast<int32_t>(
+                (static_cast<uint32_t>(sample[0]) << 8) | (sample[1] << 16) | (static_cast<uint32_t>(sample[2]) << 24));
+            audio->samples[i] = static_cast<float>(value / 2147483648.0);
+        } else {
+            audio->samples[i] = static_cast<float>(static_cast<int32_t>(readU32(sample)) / 2147483648.0);
+        }
+    }
+    return true;
+}
+
+} // namespace WaveMux
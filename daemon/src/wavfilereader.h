@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace WaveMux {
+
+// A whole WAV file in memory, as interleaved float samples
+struct WavAudio {
+    int sampleRate = 0;
+    int channels = 0;
+    std::vector<float> samples;
+
+    size_t frames() const { return channels > 0 ? samples.size() / channels : 0; }
+};
+
+// Reads 16, 24 and 32-bit integer PCM and 32-bit float WAV files (plain or
+// WAVE_FORMAT_EXTENSIBLE), skipping chunks it doesn't need, such as the
+// padding WavFileWriter puts in front of the data. A data size left unset
+// by a writer that didn't finish means "to the end of the file". Returns
+// false with a message for anything else.
+bool readWavFile(const std::string &path, WavAudio *audio, std::string *error = nullptr);
+
+} // namespace WaveMux
@@ -0,0 +1,182 @@
+#include "wavfilewriter.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <limits>
+#include <unistd.h>
+
+namespace WaveMux {
+
+namespace {
+    constexpr uint16_t WAVE_FORMAT_IEEE_FLOAT = 3;
+
+    void putU16(char *at, uint16_t value) {
+        at[0] = static_cast<char>(value & 0xff);
+        at[1] = static_cast<char>(value >> 8);
+    }
+
+    void putU32(char *at, uint32_t value) {
+        for (int i = 0; i < 4; ++i) {
+            at[i] = static_cast<char>((value >> (8 * i)) & 0xff);
+        }
+    }
+
+    uint32_t clampU32(uint64_t value) {
+        // Past 4 GiB the sizes can't be represented; most readers then read to EOF
+        return static_cast<uint32_t>(std::min<uint64_t>(value, std::numeric_limits<uint32_t>::max()));
+    }
+}
+
+WavFileWriter::WavFileWriter() = default;
+
+WavFileWriter::~WavFileWriter() {
+    close();
+}
+
+bool WavFileWriter::open(const std::string &path, int sampleRate, int channels, bool direct) {
+    close();
+
+    m_fd = -1;
+    m_direct = false;
+    if (direct) {
+        m_fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC | O_DIRECT, 0644);
+        m_direct = m_fd >= 0;
+    }
+    if (m_fd < 0) {
+        // tmpfs and some others refuse O_DIRECT
+        m_fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    }
+    if (m_fd < 0) {
+        m_error = errno;
+        return false;
+    }
+
+    m_buffer = static_cast<char *>(std::aligned_alloc(ALIGNMENT, BUFFER_BYTES));
+    if (!m_buffer) {
+        m_error = ENOMEM;
+        ::close(m_fd);
+        m_fd = -1;
+        return false;
+    }
+
+    m_sampleRate = sampleRate;
+    m_channels = channels;
+    m_dataBytes = 0;
+    m_error = 0;
+
+    // Placeholder header; the real sizes are written by close()
+    fillHeader(m_buffer);
+    m_buffered = HEADER_BYTES;
+    return true;
+}
+
+bool WavFileWriter::write(const float *samples, size_t count) {
+    if (m_fd < 0) {
+        return false;
+    }
+
+    const char *data = reinterpret_cast<const char *>(samples);
+    size_t bytes = count * sizeof(float);
+    while (bytes > 0) {
+        const size_t chunk = std::min(bytes, BUFFER_BYTES - m_buffered);
+        std::memcpy(m_buffer + m_buffered, data, chunk);
+        m_buffered += chunk;
+        m_dataBytes += chunk;
+        data += chunk;
+        bytes -= chunk;
+
+        if (m_buffered == BUFFER_BYTES && !flush(BUFFER_BYTES)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool WavFileWriter::flush(size_t bytes) {
+    const bool ok = writeAll(m_buffer, bytes);
+    m_buffered = 0;
+    return ok;
+}
+
+bool WavFileWriter::writeAll(const char *data, size_t bytes) {
+    while (bytes > 0) {
+        const ssize_t written = ::write(m_fd, data, bytes);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            m_error = errno;
+            return false;
+        }
+        data += written;
+        bytes -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+bool WavFileWriter::close() {
+    if (m_fd < 0) {
+        return true;
+    }
+
+    // The tail is generally not a whole number of pages, which O_DIRECT
+    // can't write: finish without it
+    if (m_direct) {
+        ::fcntl(m_fd, F_SETFL, ::fcntl(m_fd, F_GETFL) & ~O_DIRECT);
+        m_direct = false;
+    }
+
+    bool ok = m_buffered == 0 || flush(m_buffered);
+
+    char header[HEADER_BYTES];
+    fillHeader(header);
+    if (::pwrite(m_fd, header, HEADER_BYTES, 0) != static_cast<ssize_t>(HEADER_BYTES)) {
+        m_error = errno;
+        ok = false;
+    }
+
+    if (::close(m_fd) != 0) {
+        m_error = errno;
+        ok = false;
+    }
+    m_fd = -1;
+    std::free(m_buffer);
+    m_buffer = nullptr;
+    return ok;
+}
+
+void WavFileWriter::fillHeader(char *header) const {
+    // RIFF, fmt (IEEE float), fact, JUNK padding to one page, then data
+    std::memset(header, 0, HEADER_BYTES);
+    const uint16_t blockAlign = static_cast<uint16_t>(m_channels * sizeof(float));
+
+    std::memcpy(header, "RIFF", 4);
+    putU32(header + 4, clampU32(HEADER_BYTES - 8 + m_dataBytes));
+    std::memcpy(header + 8, "WAVE", 4);
+
+    std::memcpy(header + 12, "fmt ", 4);
+    putU32(header + 16, 18);
+    putU16(header + 20, WAVE_FORMAT_IEEE_FLOAT);
+    putU16(header + 22, static_cast<uint16_t>(m_channels));
+    putU32(header + 24, static_cast<uint32_t>(m_sampleRate));
+    putU32(header + 28, static_cast<uint32_t>(m_sampleRate) * blockAlign);
+    putU16(header + 32, blockAlign);
+    putU16(header + 34, 32);
+    putU16(header + 36, 0);
+
+    std::memcpy(header + 38, "fact", 4);
+    putU32(header + 42, 4);
+    putU32(header + 46, clampU32(blockAlign ? m_dataBytes / blockAlign : 0));
+
+    const size_t junkStart = 50;
+    const size_t dataStart = HEADER_BYTES - 8;
+    std::memcpy(header + junkStart, "JUNK", 4);
+    putU32(header + junkStart + 4, static_cast<uint32_t>(dataStart - junkStart - 8));
+
+    std::memcpy(header + dataStart, "data", 4);
+    putU32(header + dataStart + 4, clampU32(m_dataBytes));
+}
+
+} // namespace WaveMux
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace WaveMux {
+
+// Writes 32-bit float WAV files with large, page-aligned writes. The header
+// is padded to one page so that the audio data starts page-aligned, which
+// lets the file be opened with O_DIRECT (bypassing the page cache) where the
+// filesystem supports it. Sizes in the header are filled in by close().
+class WavFileWriter {
+public:
+    static constexpr size_t ALIGNMENT = 4096;
+    static constexpr size_t HEADER_BYTES = ALIGNMENT;
+    static constexpr size_t BUFFER_BYTES = 1 << 20;  // One write() per MiB
+
+    WavFileWriter();
+    ~WavFileWriter();
+    WavFileWriter(const WavFileWriter &) = delete;
+    WavFileWriter &operator=(const WavFileWriter &) = delete;
+
+    bool open(const std::string &path, int sampleRate, int channels, bool direct = true);
+    bool isOpen() const { return m_fd >= 0; }
+    bool isDirect() const { return m_direct; }
+
+    // Interleaved samples (count = frames * channels)
+    bool write(const float *samples, size_t count);
+    bool close();
+
+    uint64_t dataBytes() const { return m_dataBytes; }
+    int lastError() const { return m_error; }  // errno of the last failure
+
+private:
+    bool flush(size_t bytes);
+    bool writeAll(const char *data, size_t bytes);
+    void fillHeader(char *header) const;
+
+    int m_fd = -1;
+    bool m_direct = false;
+    int m_sampleRate = 0;
+    int m_channels = 0;
+    char *m_buffer = nullptr;   // ALIGNMENT-aligned staging buffer
+    size_t m_buffered = 0;
+    uint64_t m_dataBytes = 0;
+    int m_error = 0;
+};
+
+} // namespace WaveMux
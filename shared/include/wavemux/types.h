@@ -2,6 +2,7 @@
 
 #include <QString>
 #include <QList>
+#include <QStringList>
 #include <QDBusArgument>
 
 namespace WaveMux {
@@ -22,6 +23,8 @@ struct Stream {
     QString mediaName;
     QString processName;
     QString assignedChannel;
+    int volume = 100;  // 0-100, level within its channel
+    bool muted = false;
 };
 
 struct RoutingRule {
@@ -45,6 +48,8 @@ struct Config {
     bool setupComplete = false;
     QString outputDevice;
     QString streamOutputDevice;
+    QStringList outputFallbacks;        // Used in order when outputDevice is unplugged
+    QStringList streamOutputFallbacks;
     bool streamEnabled = false;
     QString activeProfile;
     QList<Profile> profiles;
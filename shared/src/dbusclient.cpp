@@ -15,6 +15,14 @@ namespace {
         }
         return v.toMap();
     }
+
+    QVariantList extractMapList(const QVariant &v) {
+        QVariantList list;
+        for (const QVariant &item : qdbus_cast<QVariantList>(v)) {
+            list.append(extractMap(item));
+        }
+        return list;
+    }
 }
 
 namespace WaveMux {
@@ -41,6 +49,9 @@ bool DBusClient::connectToDaemon() {
     m_streamInterface = new QDBusInterface(service, path, "com.wavemux.Streams", QDBusConnection::sessionBus(), this);
     m_deviceInterface = new QDBusInterface(service, path, "com.wavemux.Devices", QDBusConnection::sessionBus(), this);
     m_configInterface = new QDBusInterface(service, path, "com.wavemux.Config", QDBusConnection::sessionBus(), this);
+    m_profileInterface = new QDBusInterface(service, path, "com.wavemux.Profiles", QDBusConnection::sessionBus(), this);
+    m_spectrumInterface = new QDBusInterface(service, path, "com.wavemux.Spectrum", QDBusConnection::sessionBus(), this);
+    m_statsInterface = new QDBusInterface(service, path, "com.wavemux.Stats", QDBusConnection::sessionBus(), this);
 
     if (!m_channelInterface->isValid()) {
         qWarning() << "Failed to connect to WaveMux daemon:" << m_channelInterface->lastError().message();
@@ -60,11 +71,36 @@ bool DBusClient::connectToDaemon() {
     QDBusConnection::sessionBus().connect(service, path, "com.wavemux.Streams",
         "StreamRemoved", this, SLOT(onStreamRemoved(uint)));
 
+    // Connect signals from Devices interface
+    QDBusConnection::sessionBus().connect(service, path, "com.wavemux.Devices",
+        "DevicesChanged", this, SLOT(onDevicesChanged()));
+    QDBusConnection::sessionBus().connect(service, path, "com.wavemux.Devices",
+        "ActiveOutputDeviceChanged", this, SLOT(onActiveOutputDeviceChanged(QString,QString)));
+
     // Connect signals from Config interface
     QDBusConnection::sessionBus().connect(service, path, "com.wavemux.Config",
         "Error", this, SLOT(onError(QString)));
     QDBusConnection::sessionBus().connect(service, path, "com.wavemux.Config",
         "StreamEnabledChanged", this, SLOT(onStreamEnabledChanged(bool)));
+    QDBusConnection::sessionBus().connect(service, path, "com.wavemux.Config",
+        "ConfigApplied", this, SLOT(onConfigApplied()));
+    // Channels only get live sinks once the daemon's background init is done
+    QDBusConnection::sessionBus().connect(service, path, "com.wavemux.Config",
+        "Ready", this, SLOT(onConfigApplied()));
+
+    // Connect signals from Profiles interface
+    QDBusConnection::sessionBus().connect(service, path, "com.wavemux.Profiles",
+        "ProfilesChanged", this, SLOT(onProfilesChanged()));
+    QDBusConnection::sessionBus().connect(service, path, "com.wavemux.Profiles",
+        "ActiveProfileChanged", this, SLOT(onActiveProfileChanged(QString)));
+
+    // Connect signals from Spectrum interface
+    QDBusConnection::sessionBus().connect(service, path, "com.wavemux.Spectrum",
+        "SpectrumUpdated", this, SLOT(onSpectrumUpdated(QVariantMap)));
+
+    // Connect signals from Stats interface
+    QDBusConnection::sessionBus().connect(service, path, "com.wavemux.Stats",
+        "NodeLoadUpdated", this, SLOT(onNodeLoadUpdated(QVariantMap)));
 
     m_connected = true;
     emit connectedChanged();
@@ -85,10 +121,18 @@ void DBusClient::disconnectFromDaemon() {
     delete m_streamInterface;
     delete m_deviceInterface;
     delete m_configInterface;
+    delete m_profileInterface;
+    delete m_spectrumInterface;
+    delete m_statsInterface;
     m_channelInterface = nullptr;
     m_streamInterface = nullptr;
     m_deviceInterface = nullptr;
     m_configInterface = nullptr;
+    m_profileInterface = nullptr;
+    m_spectrumInterface = nullptr;
+    m_statsInterface = nullptr;
+    m_spectrum.clear();
+    m_dspLoad.clear();
     m_connected = false;
     emit connectedChanged();
 }
@@ -99,6 +143,7 @@ void DBusClient::refresh() {
     fetchStreams();
     fetchDevices();
     fetchConfig();
+    fetchProfiles();
 }
 
 void DBusClient::fetchChannels() {
@@ -108,7 +153,7 @@ void DBusClient::fetchChannels() {
         return;
     }
 
-    m_channels.clear();
+    QList<Channel> channels;
     for (const auto &item : reply.value()) {
         QVariantMap map = extractMap(item);
         Channel ch;
@@ -119,8 +164,9 @@ void DBusClient::fetchChannels() {
         ch.muted = map["muted"].toBool();
         ch.personalVolume = map["personalVolume"].toInt();
         ch.streamVolume = map["streamVolume"].toInt();
-        m_channels.append(ch);
+        channels.append(ch);
     }
+    m_channels.setItems(channels);
     emit channelsChanged();
 }
 
@@ -131,7 +177,7 @@ void DBusClient::fetchStreams() {
         return;
     }
 
-    m_streams.clear();
+    QList<Stream> streams;
     for (const auto &item : reply.value()) {
         QVariantMap map = extractMap(item);
         Stream stream;
@@ -140,8 +186,11 @@ void DBusClient::fetchStreams() {
         stream.mediaName = map["mediaName"].toString();
         stream.processName = map["processName"].toString();
         stream.assignedChannel = map["assignedChannel"].toString();
-        m_streams.append(stream);
+        stream.volume = map.value("volume", 100).toInt();
+        stream.muted = map["muted"].toBool();
+        streams.append(stream);
     }
+    m_streams.setItems(streams);
     emit streamsChanged();
 }
 
@@ -149,15 +198,16 @@ void DBusClient::fetchDevices() {
     // Output devices
     QDBusReply<QVariantList> outReply = m_deviceInterface->call("ListOutputDevices");
     if (outReply.isValid()) {
-        m_outputDevices.clear();
+        QList<Device> devices;
         for (const auto &item : outReply.value()) {
             QVariantMap map = extractMap(item);
             Device dev;
             dev.id = map["id"].toString();
             dev.name = map["name"].toString();
             dev.description = map["description"].toString();
-            m_outputDevices.append(dev);
+            devices.append(dev);
         }
+        m_outputDevices.setItems(devices);
     } else {
         qWarning() << "Failed to list output devices:" << outReply.error().message();
     }
@@ -206,6 +256,17 @@ void DBusClient::fetchConfig() {
         }
     }
 
+    // Devices the mixes actually play on (differ from the above while failed over)
+    QDBusReply<QString> activeReply = m_deviceInterface->call("GetActiveOutputDevice", QString("personal"));
+    QDBusReply<QString> activeStreamReply = m_deviceInterface->call("GetActiveOutputDevice", QString("stream"));
+    if (activeReply.isValid() && activeStreamReply.isValid()) {
+        if (m_activeOutputDevice != activeReply.value() || m_activeStreamOutputDevice != activeStreamReply.value()) {
+            m_activeOutputDevice = activeReply.value();
+            m_activeStreamOutputDevice = activeStreamReply.value();
+            emit activeOutputDeviceChanged();
+        }
+    }
+
     // Stream enabled
     QDBusReply<bool> streamEnabledReply = m_configInterface->call("IsStreamEnabled");
     if (streamEnabledReply.isValid()) {
@@ -217,6 +278,24 @@ void DBusClient::fetchConfig() {
     }
 }
 
+void DBusClient::fetchProfiles() {
+    QDBusReply<QStringList> listReply = m_profileInterface->call("ListProfiles");
+    if (listReply.isValid()) {
+        if (m_profiles != listReply.value()) {
+            m_profiles = listReply.value();
+            emit profilesChanged();
+        }
+    } else {
+        qWarning() << "Failed to list profiles:" << listReply.error().message();
+    }
+
+    QDBusReply<QString> activeReply = m_profileInterface->call("GetActiveProfile");
+    if (activeReply.isValid() && activeReply.value() != m_activeProfile) {
+        m_activeProfile = activeReply.value();
+        emit activeProfileChanged();
+    }
+}
+
 bool DBusClient::setChannelVolume(const QString &channelId, int volume) {
     qDebug() << "DBusClient::setChannelVolume called:" << channelId << volume;
     if (!m_connected) {
@@ -230,13 +309,21 @@ bool DBusClient::setChannelVolume(const QString &channelId, int volume) {
     // Send to daemon
     QDBusReply<bool> reply = m_channelInterface->call("SetChannelVolume", channelId, volume);
     qDebug() << "DBus reply valid:" << reply.isValid() << "value:" << (reply.isValid() ? reply.value() : false);
-    return reply.isValid() && reply.value();
+    if (!reply.isValid() || !reply.value()) {
+        return false;
+    }
+    updateChannel(channelId, [volume](Channel &channel) { channel.volume = qBound(0, volume, 100); });
+    return true;
 }
 
 bool DBusClient::setChannelMute(const QString &channelId, bool muted) {
     if (!m_connected) return false;
     QDBusReply<bool> reply = m_channelInterface->call("SetChannelMute", channelId, muted);
-    return reply.isValid() && reply.value();
+    if (!reply.isValid() || !reply.value()) {
+        return false;
+    }
+    updateChannel(channelId, [muted](Channel &channel) { channel.muted = muted; });
+    return true;
 }
 
 bool DBusClient::setChannelPersonalVolume(const QString &channelId, int volume) {
@@ -244,7 +331,11 @@ bool DBusClient::setChannelPersonalVolume(const QString &channelId, int volume)
     // Set debounce timestamp to ignore incoming channelsChanged signals during drag
     m_lastVolumeChangeTime = QDateTime::currentMSecsSinceEpoch();
     QDBusReply<bool> reply = m_channelInterface->call("SetChannelPersonalVolume", channelId, volume);
-    return reply.isValid() && reply.value();
+    if (!reply.isValid() || !reply.value()) {
+        return false;
+    }
+    updateChannel(channelId, [volume](Channel &channel) { channel.personalVolume = qBound(0, volume, 100); });
+    return true;
 }
 
 bool DBusClient::setChannelStreamVolume(const QString &channelId, int volume) {
@@ -252,7 +343,11 @@ bool DBusClient::setChannelStreamVolume(const QString &channelId, int volume) {
     // Set debounce timestamp to ignore incoming channelsChanged signals during drag
     m_lastVolumeChangeTime = QDateTime::currentMSecsSinceEpoch();
     QDBusReply<bool> reply = m_channelInterface->call("SetChannelStreamVolume", channelId, volume);
-    return reply.isValid() && reply.value();
+    if (!reply.isValid() || !reply.value()) {
+        return false;
+    }
+    updateChannel(channelId, [volume](Channel &channel) { channel.streamVolume = qBound(0, volume, 100); });
+    return true;
 }
 
 bool DBusClient::moveStreamToChannel(uint streamId, const QString &channelId) {
@@ -267,6 +362,26 @@ bool DBusClient::unassignStream(uint streamId) {
     return reply.isValid() && reply.value();
 }
 
+bool DBusClient::setStreamVolume(uint streamId, int volume) {
+    if (!m_connected) return false;
+    QDBusReply<bool> reply = m_streamInterface->call("SetStreamVolume", streamId, volume);
+    if (!reply.isValid() || !reply.value()) {
+        return false;
+    }
+    updateStream(streamId, [volume](Stream &stream) { stream.volume = qBound(0, volume, 100); });
+    return true;
+}
+
+bool DBusClient::setStreamMute(uint streamId, bool muted) {
+    if (!m_connected) return false;
+    QDBusReply<bool> reply = m_streamInterface->call("SetStreamMute", streamId, muted);
+    if (!reply.isValid() || !reply.value()) {
+        return false;
+    }
+    updateStream(streamId, [muted](Stream &stream) { stream.muted = muted; });
+    return true;
+}
+
 void DBusClient::addRoutingRule(const QString &pattern, const QString &channelId) {
     if (!m_connected) return;
     m_streamInterface->call("AddRoutingRule", pattern, channelId);
@@ -308,6 +423,18 @@ void DBusClient::setStreamOutputDevice(const QString &deviceId) {
     emit streamOutputDeviceChanged();
 }
 
+bool DBusClient::setOutputFallbacks(const QString &mixId, const QStringList &deviceIds) {
+    if (!m_connected) return false;
+    QDBusReply<bool> reply = m_deviceInterface->call("SetOutputFallbacks", mixId, deviceIds);
+    return reply.isValid() && reply.value();
+}
+
+QStringList DBusClient::outputFallbacks(const QString &mixId) {
+    if (!m_connected) return {};
+    QDBusReply<QStringList> reply = m_deviceInterface->call("GetOutputFallbacks", mixId);
+    return reply.isValid() ? reply.value() : QStringList();
+}
+
 void DBusClient::setStreamEnabled(bool enabled) {
     if (!m_connected) return;
     m_configInterface->call("SetStreamEnabled", enabled);
@@ -334,6 +461,24 @@ void DBusClient::saveConfig() {
     m_configInterface->call("SaveConfig");
 }
 
+bool DBusClient::switchProfile(const QString &name) {
+    if (!m_connected) return false;
+    QDBusReply<bool> reply = m_profileInterface->call("SwitchProfile", name);
+    return reply.isValid() && reply.value();
+}
+
+bool DBusClient::saveProfile(const QString &name) {
+    if (!m_connected) return false;
+    QDBusReply<bool> reply = m_profileInterface->call("SaveProfile", name);
+    return reply.isValid() && reply.value();
+}
+
+bool DBusClient::deleteProfile(const QString &name) {
+    if (!m_connected) return false;
+    QDBusReply<bool> reply = m_profileInterface->call("DeleteProfile", name);
+    return reply.isValid() && reply.value();
+}
+
 void DBusClient::onChannelsChanged() {
     // Skip if we recently changed volume (debounce to prevent UI jitter during dragging)
     qint64 now = QDateTime::currentMSecsSinceEpoch();
@@ -354,7 +499,10 @@ void DBusClient::onStreamAdded(uint streamId, const QString &appName) {
 
 void DBusClient::onStreamRemoved(uint streamId) {
     emit streamRemoved(streamId);
-    fetchStreams();
+    // Nothing to ask the daemon: drop the row
+    if (m_streams.removeItem(QString::number(streamId))) {
+        emit streamsChanged();
+    }
 }
 
 void DBusClient::onError(const QString &message) {
@@ -366,9 +514,103 @@ void DBusClient::onStreamEnabledChanged(bool enabled) {
     emit streamEnabledChanged();
 }
 
+void DBusClient::onDevicesChanged() {
+    fetchDevices();
+}
+
+void DBusClient::onActiveOutputDeviceChanged(const QString &mixId, const QString &deviceId) {
+    if (mixId == "stream") {
+        m_activeStreamOutputDevice = deviceId;
+    } else {
+        m_activeOutputDevice = deviceId;
+    }
+    emit activeOutputDeviceChanged();
+}
+
+void DBusClient::onConfigApplied() {
+    // Many things changed at once - refetch everything in one go
+    refresh();
+}
+
+void DBusClient::onProfilesChanged() {
+    fetchProfiles();
+}
+
+void DBusClient::onActiveProfileChanged(const QString &name) {
+    if (m_activeProfile != name) {
+        m_activeProfile = name;
+        emit activeProfileChanged();
+    }
+}
+
+bool DBusClient::subscribeSpectrum(const QStringList &targets) {
+    if (!m_connected) return false;
+    QDBusReply<bool> reply = m_spectrumInterface->call("Subscribe", targets);
+    return reply.isValid() && reply.value();
+}
+
+void DBusClient::unsubscribeSpectrum() {
+    if (!m_connected) return;
+    m_spectrumInterface->call("Unsubscribe");
+    m_spectrum.clear();
+    emit spectrumChanged();
+}
+
+void DBusClient::onSpectrumUpdated(const QVariantMap &bands) {
+    // Only the targets that changed are sent; keep the rest
+    for (auto it = bands.constBegin(); it != bands.constEnd(); ++it) {
+        const QList<double> levels = qdbus_cast<QList<double>>(it.value());
+        QVariantList list;
+        list.reserve(levels.size());
+        for (double level : levels) {
+            list.append(level);
+        }
+        m_spectrum[it.key()] = list;
+    }
+    emit spectrumChanged();
+}
+
+void DBusClient::refreshDspLoad() {
+    if (!m_connected) return;
+    QDBusReply<QVariantMap> reply = m_statsInterface->call("GetNodeLoad");
+    if (reply.isValid()) {
+        onNodeLoadUpdated(reply.value());
+    }
+}
+
+void DBusClient::onNodeLoadUpdated(const QVariantMap &sample) {
+    // Nested lists arrive as D-Bus arguments, which QML can't read
+    m_dspLoad = sample;
+    m_dspLoad["nodes"] = extractMapList(sample.value("nodes"));
+    m_dspLoad["engines"] = extractMapList(sample.value("engines"));
+    emit dspLoadChanged();
+}
+
+void DBusClient::updateChannel(const QString &channelId, const std::function<void(Channel &)> &change) {
+    const int row = m_channels.indexOf(channelId);
+    if (row < 0) {
+        return;
+    }
+    Channel channel = m_channels.items().at(row);
+    change(channel);
+    m_channels.setItem(channel);
+    emit channelsChanged();
+}
+
+void DBusClient::updateStream(uint streamId, const std::function<void(Stream &)> &change) {
+    const int row = m_streams.indexOf(streamId);
+    if (row < 0) {
+        return;
+    }
+    Stream stream = m_streams.items().at(row);
+    change(stream);
+    m_streams.setItem(stream);
+    emit streamsChanged();
+}
+
 QVariantList DBusClient::channelsVariant() const {
     QVariantList result;
-    for (const auto &ch : m_channels) {
+    for (const auto &ch : m_channels.items()) {
         QVariantMap map;
         map["id"] = ch.id;
         map["displayName"] = ch.displayName;
@@ -384,13 +626,15 @@ QVariantList DBusClient::channelsVariant() const {
 
 QVariantList DBusClient::streamsVariant() const {
     QVariantList result;
-    for (const auto &stream : m_streams) {
+    for (const auto &stream : m_streams.items()) {
         QVariantMap map;
         map["id"] = stream.id;
         map["appName"] = stream.appName;
         map["mediaName"] = stream.mediaName;
         map["processName"] = stream.processName;
         map["assignedChannel"] = stream.assignedChannel;
+        map["volume"] = stream.volume;
+        map["muted"] = stream.muted;
         result.append(map);
     }
     return result;
@@ -398,7 +642,7 @@ QVariantList DBusClient::streamsVariant() const {
 
 QVariantList DBusClient::outputDevicesVariant() const {
     QVariantList result;
-    for (const auto &dev : m_outputDevices) {
+    for (const auto &dev : m_outputDevices.items()) {
         QVariantMap map;
         map["id"] = dev.id;
         map["name"] = dev.name;
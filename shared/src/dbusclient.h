@@ -5,7 +5,9 @@
 #include <QDBusConnection>
 #include <QVariantList>
 #include <QVariantMap>
+#include <functional>
 #include "wavemux/types.h"
+#include "listmodels.h"
 
 namespace WaveMux {
 
@@ -16,10 +18,20 @@ class DBusClient : public QObject {
     Q_PROPERTY(QVariantList channels READ channelsVariant NOTIFY channelsChanged)
     Q_PROPERTY(QVariantList streams READ streamsVariant NOTIFY streamsChanged)
     Q_PROPERTY(QVariantList outputDevices READ outputDevicesVariant NOTIFY devicesChanged)
+    // The same lists as models for views: rows are updated in place
+    Q_PROPERTY(WaveMux::ChannelModel *channelModel READ channelModel CONSTANT)
+    Q_PROPERTY(WaveMux::StreamModel *streamModel READ streamModel CONSTANT)
+    Q_PROPERTY(WaveMux::DeviceModel *deviceModel READ deviceModel CONSTANT)
     Q_PROPERTY(QString outputDevice READ outputDevice WRITE setOutputDevice NOTIFY outputDeviceChanged)
     Q_PROPERTY(QString streamOutputDevice READ streamOutputDevice WRITE setStreamOutputDevice NOTIFY streamOutputDeviceChanged)
+    Q_PROPERTY(QString activeOutputDevice READ activeOutputDevice NOTIFY activeOutputDeviceChanged)
+    Q_PROPERTY(QString activeStreamOutputDevice READ activeStreamOutputDevice NOTIFY activeOutputDeviceChanged)
     Q_PROPERTY(bool streamEnabled READ isStreamEnabled WRITE setStreamEnabled NOTIFY streamEnabledChanged)
     Q_PROPERTY(int masterVolume READ masterVolume WRITE setMasterVolume NOTIFY masterVolumeChanged)
+    Q_PROPERTY(QStringList profiles READ profiles NOTIFY profilesChanged)
+    Q_PROPERTY(QString activeProfile READ activeProfile NOTIFY activeProfileChanged)
+    Q_PROPERTY(QVariantMap spectrum READ spectrum NOTIFY spectrumChanged)
+    Q_PROPERTY(QVariantMap dspLoad READ dspLoad NOTIFY dspLoadChanged)
 
 public:
     explicit DBusClient(QObject *parent = nullptr);
@@ -28,19 +40,31 @@ public:
     bool isConnected() const { return m_connected; }
     bool isSetupComplete() const { return m_setupComplete; }
 
-    QList<Channel> channels() const { return m_channels; }
-    QList<Stream> streams() const { return m_streams; }
-    QList<Device> outputDevices() const { return m_outputDevices; }
+    QList<Channel> channels() const { return m_channels.items(); }
+    QList<Stream> streams() const { return m_streams.items(); }
+    QList<Device> outputDevices() const { return m_outputDevices.items(); }
 
     // QML-friendly variants
     QVariantList channelsVariant() const;
     QVariantList streamsVariant() const;
     QVariantList outputDevicesVariant() const;
 
+    ChannelModel *channelModel() { return &m_channels; }
+    StreamModel *streamModel() { return &m_streams; }
+    DeviceModel *deviceModel() { return &m_outputDevices; }
+
     QString outputDevice() const { return m_outputDevice; }
     QString streamOutputDevice() const { return m_streamOutputDevice; }
+    QString activeOutputDevice() const { return m_activeOutputDevice; }
+    QString activeStreamOutputDevice() const { return m_activeStreamOutputDevice; }
     bool isStreamEnabled() const { return m_streamEnabled; }
     int masterVolume() const { return m_masterVolume; }
+    QStringList profiles() const { return m_profiles; }
+    QString activeProfile() const { return m_activeProfile; }
+    // Target -> list of band levels in dBFS, while subscribed
+    QVariantMap spectrum() const { return m_spectrum; }
+    // Last graph load sample (see com.wavemux.Stats GetNodeLoad)
+    QVariantMap dspLoad() const { return m_dspLoad; }
 
 public slots:
     bool connectToDaemon();
@@ -55,6 +79,8 @@ public slots:
     // Stream operations
     bool moveStreamToChannel(uint streamId, const QString &channelId);
     bool unassignStream(uint streamId);
+    bool setStreamVolume(uint streamId, int volume);
+    bool setStreamMute(uint streamId, bool muted);
 
     // Routing rules
     void addRoutingRule(const QString &pattern, const QString &channelId);
@@ -64,6 +90,8 @@ public slots:
     // Device selection
     void setOutputDevice(const QString &deviceId);
     void setStreamOutputDevice(const QString &deviceId);
+    bool setOutputFallbacks(const QString &mixId, const QStringList &deviceIds);
+    QStringList outputFallbacks(const QString &mixId);
 
     // Stream mode
     void setStreamEnabled(bool enabled);
@@ -75,6 +103,18 @@ public slots:
     void setSetupComplete(bool complete);
     void saveConfig();
 
+    // Profiles
+    bool switchProfile(const QString &name);
+    bool saveProfile(const QString &name);
+    bool deleteProfile(const QString &name);
+
+    // Spectrum feed (see com.wavemux.Spectrum for target names)
+    bool subscribeSpectrum(const QStringList &targets);
+    void unsubscribeSpectrum();
+
+    // Fetches the last load sample and asks the daemon for a fresh one
+    void refreshDspLoad();
+
     // Refresh data from daemon
     void refresh();
 
@@ -86,8 +126,13 @@ signals:
     void devicesChanged();
     void outputDeviceChanged();
     void streamOutputDeviceChanged();
+    void activeOutputDeviceChanged();
     void streamEnabledChanged();
     void masterVolumeChanged();
+    void profilesChanged();
+    void activeProfileChanged();
+    void spectrumChanged();
+    void dspLoadChanged();
     void streamAdded(uint streamId, const QString &appName);
     void streamRemoved(uint streamId);
     void error(const QString &message);
@@ -99,28 +144,49 @@ private slots:
     void onStreamRemoved(uint streamId);
     void onError(const QString &message);
     void onStreamEnabledChanged(bool enabled);
+    void onDevicesChanged();
+    void onActiveOutputDeviceChanged(const QString &mixId, const QString &deviceId);
+    void onConfigApplied();
+    void onProfilesChanged();
+    void onActiveProfileChanged(const QString &name);
+    void onSpectrumUpdated(const QVariantMap &bands);
+    void onNodeLoadUpdated(const QVariantMap &sample);
 
 private:
     void fetchChannels();
     void fetchStreams();
     void fetchDevices();
     void fetchConfig();
+    void fetchProfiles();
+    // Applies a change the daemon accepted to our copy right away, so only
+    // that row updates instead of waiting for the next listing
+    void updateChannel(const QString &channelId, const std::function<void(Channel &)> &change);
+    void updateStream(uint streamId, const std::function<void(Stream &)> &change);
 
     // Separate interfaces for each DBus adaptor
     QDBusInterface *m_channelInterface = nullptr;
     QDBusInterface *m_streamInterface = nullptr;
     QDBusInterface *m_deviceInterface = nullptr;
     QDBusInterface *m_configInterface = nullptr;
+    QDBusInterface *m_profileInterface = nullptr;
+    QDBusInterface *m_spectrumInterface = nullptr;
+    QDBusInterface *m_statsInterface = nullptr;
 
     bool m_connected = false;
     bool m_setupComplete = false;
-    QList<Channel> m_channels;
-    QList<Stream> m_streams;
-    QList<Device> m_outputDevices;
+    ChannelModel m_channels;
+    StreamModel m_streams;
+    DeviceModel m_outputDevices;
     QString m_outputDevice;
     QString m_streamOutputDevice;
+    QString m_activeOutputDevice;
+    QString m_activeStreamOutputDevice;
     bool m_streamEnabled = false;
     int m_masterVolume = 100;
+    QStringList m_profiles;
+    QString m_activeProfile;
+    QVariantMap m_spectrum;
+    QVariantMap m_dspLoad;
 
     // Debounce channel updates during user interaction
     qint64 m_lastVolumeChangeTime = 0;
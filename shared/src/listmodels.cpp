@@ -0,0 +1,84 @@
+#include "listmodels.h"
+
+namespace WaveMux {
+
+QVariantMap KeyedListModelBase::get(int row) const {
+    QVariantMap result;
+    if (row < 0 || row >= rowCount()) {
+        return result;
+    }
+    const auto roles = roleNames();
+    for (auto it = roles.constBegin(); it != roles.constEnd(); ++it) {
+        result[QString::fromUtf8(it.value())] = data(index(row), it.key());
+    }
+    return result;
+}
+
+QHash<int, QByteArray> ChannelModel::roleNames() const {
+    return {
+        {IdRole, "channelId"},
+        {DisplayNameRole, "displayName"},
+        {SinkNameRole, "sinkName"},
+        {VolumeRole, "volume"},
+        {MutedRole, "muted"},
+        {PersonalVolumeRole, "personalVolume"},
+        {StreamVolumeRole, "streamVolume"},
+    };
+}
+
+QVariant ChannelModel::roleData(const Channel &channel, int role) const {
+    switch (role) {
+    case IdRole: return channel.id;
+    case DisplayNameRole: return channel.displayName;
+    case SinkNameRole: return channel.sinkName;
+    case VolumeRole: return channel.volume;
+    case MutedRole: return channel.muted;
+    case PersonalVolumeRole: return channel.personalVolume;
+    case StreamVolumeRole: return channel.streamVolume;
+    default: return QVariant();
+    }
+}
+
+QHash<int, QByteArray> StreamModel::roleNames() const {
+    return {
+        {IdRole, "streamId"},
+        {AppNameRole, "appName"},
+        {MediaNameRole, "mediaName"},
+        {ProcessNameRole, "processName"},
+        {AssignedChannelRole, "assignedChannel"},
+        {VolumeRole, "volume"},
+        {MutedRole, "muted"},
+    };
+}
+
+QVariant StreamModel::roleData(const Stream &stream, int role) const {
+    switch (role) {
+    case IdRole: return stream.id;
+    case AppNameRole: return stream.appName;
+    case MediaNameRole: return stream.mediaName;
+    case ProcessNameRole: return stream.processName;
+    case AssignedChannelRole: return stream.assignedChannel;
+    case VolumeRole: return stream.volume;
+    case MutedRole: return stream.muted;
+    default: return QVariant();
+    }
+}
+
+QHash<int, QByteArray> DeviceModel::roleNames() const {
+    return {
+        {IdRole, "deviceId"},
+        {NameRole, "name"},
+        {DescriptionRole, "description"},
+    };
+}
+
+QVariant DeviceModel::roleData(const Device &device, int role) const {
+    switch (role) {
+    case IdRole: return device.id;
+    case NameRole: return device.name;
+    case DescriptionRole: return device.description;
+    default: return QVariant();
+    }
+}
+
+} // namespace WaveMux
@@ -0,0 +1,214 @@
+#pragma once
+
+#include <QAbstractListModel>
+#include <QList>
+#include <QSet>
+#include <QVariantMap>
+#include "wavemux/types.h"
+
+namespace WaveMux {
+
+// What QML sees of every list model: a row count and lookups by key
+class KeyedListModelBase : public QAbstractListModel {
+    Q_OBJECT
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+
+public:
+    using QAbstractListModel::QAbstractListModel;
+
+    int count() const { return rowCount(); }
+    // Row of the item with this id, or -1
+    Q_INVOKABLE int indexOf(const QVariant &key) const { return rowOf(key.toString()); }
+    // Every role of a row by name (empty for a bad row)
+    Q_INVOKABLE QVariantMap get(int row) const;
+
+signals:
+    void countChanged();
+
+protected:
+    virtual int rowOf(const QString &key) const = 0;
+};
+
+// Rows keyed by item id. A new list from the daemon is applied as the
+// difference to the current one: removed and added items become row
+// removals and insertions, reordered ones row moves, and changed ones a
+// dataChanged for just the roles that differ. Views keep their delegates
+// (and whatever state they hold) for every item that is still there.
+template <typename T>
+class KeyedListModel : public KeyedListModelBase {
+public:
+    using KeyedListModelBase::KeyedListModelBase;
+
+    const QList<T> &items() const { return m_items; }
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override {
+        return parent.isValid() ? 0 : static_cast<int>(m_items.size());
+    }
+
+    QVariant data(const QModelIndex &index, int role) const override {
+        if (!checkIndex(index, CheckIndexOption::IndexIsValid | CheckIndexOption::ParentIsInvalid)) {
+            return QVariant();
+        }
+        return roleData(m_items.at(index.row()), role);
+    }
+
+    void setItems(const QList<T> &items) {
+        const int before = rowCount();
+
+        QSet<QString> keys;
+        for (const T &item : items) {
+            keys.insert(keyOf(item));
+        }
+        for (int row = rowCount() - 1; row >= 0; --row) {
+            if (!keys.contains(keyOf(m_items.at(row)))) {
+                beginRemoveRows(QModelIndex(), row, row);
+                m_items.removeAt(row);
+                endRemoveRows();
+            }
+        }
+
+        // Rows before `position` already match the new list
+        for (int position = 0; position < items.size(); ++position) {
+            const T &item = items.at(position);
+            int row = -1;
+            for (int candidate = position; candidate < m_items.size(); ++candidate) {
+                if (keyOf(m_items.at(candidate)) == keyOf(item)) {
+                    row = candidate;
+                    break;
+                }
+            }
+            if (row < 0) {
+                beginInsertRows(QModelIndex(), position, position);
+                m_items.insert(position, item);
+                endInsertRows();
+                continue;
+            }
+            if (row != position) {
+                beginMoveRows(QModelIndex(), row, row, QModelIndex(), position);
+                m_items.move(row, position);
+                endMoveRows();
+            }
+            replace(position, item);
+        }
+
+        if (rowCount() != before) {
+            emit countChanged();
+        }
+    }
+
+    // Replaces the item with the same key; false if there is none
+    bool setItem(const T &item) {
+        const int row = rowOf(keyOf(item));
+        if (row < 0) {
+            return false;
+        }
+        replace(row, item);
+        return true;
+    }
+
+    bool removeItem(const QString &key) {
+        const int row = rowOf(key);
+        if (row < 0) {
+            return false;
+        }
+        beginRemoveRows(QModelIndex(), row, row);
+        m_items.removeAt(row);
+        endRemoveRows();
+        emit countChanged();
+        return true;
+    }
+
+protected:
+    virtual QString keyOf(const T &item) const = 0;
+    virtual QVariant roleData(const T &item, int role) const = 0;
+
+    int rowOf(const QString &key) const override {
+        for (int row = 0; row < m_items.size(); ++row) {
+            if (keyOf(m_items.at(row)) == key) {
+                return row;
+            }
+        }
+        return -1;
+    }
+
+private:
+    void replace(int row, const T &item) {
+        QList<int> changed;
+        const auto roles = roleNames();
+        for (auto it = roles.constBegin(); it != roles.constEnd(); ++it) {
+            if (roleData(m_items.at(row), it.key()) != roleData(item, it.key())) {
+                changed.append(it.key());
+            }
+        }
+        m_items[row] = item;
+        if (!changed.isEmpty()) {
+            emit dataChanged(index(row), index(row), changed);
+        }
+    }
+
+    QList<T> m_items;
+};
+
+class ChannelModel : public KeyedListModel<Channel> {
+    Q_OBJECT
+
+public:
+    enum Role {
+        IdRole = Qt::UserRole + 1,
+        DisplayNameRole,
+        SinkNameRole,
+        VolumeRole,
+        MutedRole,
+        PersonalVolumeRole,
+        StreamVolumeRole,
+    };
+
+    using KeyedListModel::KeyedListModel;
+    QHash<int, QByteArray> roleNames() const override;
+
+protected:
+    QString keyOf(const Channel &channel) const override { return channel.id; }
+    QVariant roleData(const Channel &channel, int role) const override;
+};
+
+class StreamModel : public KeyedListModel<Stream> {
+    Q_OBJECT
+
+public:
+    enum Role {
+        IdRole = Qt::UserRole + 1,
+        AppNameRole,
+        MediaNameRole,
+        ProcessNameRole,
+        AssignedChannelRole,
+        VolumeRole,
+        MutedRole,
+    };
+
+    using KeyedListModel::KeyedListModel;
+    QHash<int, QByteArray> roleNames() const override;
+
+protected:
+    QString keyOf(const Stream &stream) const override { return QString::number(stream.id); }
+    QVariant roleData(const Stream &stream, int role) const override;
+};
+
+class DeviceModel : public KeyedListModel<Device> {
+    Q_OBJECT
+
+public:
+    enum Role {
+        IdRole = Qt::UserRole + 1,
+        NameRole,
+        DescriptionRole,
+    };
+
+    using KeyedListModel::KeyedListModel;
+    QHash<int, QByteArray> roleNames() const override;
+
+protected:
+    QString keyOf(const Device &device) const override { return device.id; }
+    QVariant roleData(const Device &device, int role) const override;
+};
+
+} // namespace WaveMux
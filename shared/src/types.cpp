@@ -36,7 +36,9 @@ QDBusArgument& operator<<(QDBusArgument& arg, const Stream& stream) {
         << stream.appName
         << stream.mediaName
         << stream.processName
-        << stream.assignedChannel;
+        << stream.assignedChannel
+        << stream.volume
+        << stream.muted;
     arg.endStructure();
     return arg;
 }
@@ -47,7 +49,9 @@ const QDBusArgument& operator>>(const QDBusArgument& arg, Stream& stream) {
         >> stream.appName
         >> stream.mediaName
         >> stream.processName
-        >> stream.assignedChannel;
+        >> stream.assignedChannel
+        >> stream.volume
+        >> stream.muted;
     arg.endStructure();
     return arg;
 }
@@ -0,0 +1,27 @@
+// libFuzzer target for the pactl listing parser: any byte string must parse
+// without reading out of bounds, and every lookup must stay inside it.
+//
+//   cmake -DWAVEMUX_FUZZ=ON -DCMAKE_CXX_COMPILER=clang++ ..
+//   ./fuzz_pactlparser -max_len=4096 ../tests/fuzz/corpus
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include "pactlparser.h"
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+    const std::string_view text(reinterpret_cast<const char *>(data), size);
+    const WaveMux::PactlListing listing(text);
+    for (size_t i = 0; i < listing.size(); ++i) {
+        const auto &object = listing[i];
+        if (object.begin > object.end || object.type.empty() ||
+            object.type.data() < text.data() || object.type.data() + object.type.size() > text.data() + text.size()) {
+            __builtin_trap();
+        }
+        WaveMux::PactlListing::volumePercent(listing.field(i, "Volume"));
+        WaveMux::PactlListing::toIndex(listing.field(i, "Sink"));
+        WaveMux::PactlListing::toIndex(listing.property(i, "module.id"));
+        WaveMux::PactlListing::unescape(listing.property(i, "application.name"));
+        listing.find(object.index);
+    }
+    return 0;
+}
@@ -1,8 +1,16 @@
 #include <gtest/gtest.h>
 #include <QCoreApplication>
+#include <QDir>
+#include <QFileInfo>
+#include <QTemporaryDir>
+#include <QEventLoop>
 #include <QProcess>
 #include <QThread>
+#include <QTimer>
+#include <optional>
 #include "audiomanager.h"
+#include "dsp/mixgraph.h"
+#include "stats.h"
 #include "wavemux/types.h"
 
 class AudioManagerTest : public ::testing::Test {
@@ -38,6 +46,20 @@ protected:
         process.waitForFinished(5000);
     }
 
+    // Null sink standing in for a hardware device (removed by cleanupSinks)
+    QString loadTestDevice(const QString &name) {
+        QProcess process;
+        process.start("pactl", {"load-module", "module-null-sink", "sink_name=" + name});
+        process.waitForFinished(5000);
+        return QString::fromUtf8(process.readAllStandardOutput()).trimmed();
+    }
+
+    void processEvents(int ms) {
+        QEventLoop loop;
+        QTimer::singleShot(ms, &loop, &QEventLoop::quit);
+        loop.exec();
+    }
+
     QString getDefaultSink() {
         QProcess process;
         process.start("pactl", {"get-default-sink"});
@@ -58,6 +80,61 @@ TEST_F(AudioManagerTest, Initialize) {
     EXPECT_TRUE(sinkExists("wavemux_aux"));
 }
 
+TEST_F(AudioManagerTest, ListChannelsBeforeInitialize) {
+    // Channels are known (with defaults) before any sink exists
+    auto channels = manager->listChannels();
+    EXPECT_EQ(channels.size(), 4);
+    EXPECT_FALSE(manager->isInitialized());
+    EXPECT_FALSE(sinkExists("wavemux_game"));
+}
+
+TEST_F(AudioManagerTest, SettingsBeforeInitializeAreApplied) {
+    EXPECT_TRUE(manager->setChannelVolume("game", 40));
+    EXPECT_TRUE(manager->setChannelMute("chat", true));
+
+    EXPECT_TRUE(manager->initialize());
+
+    for (const auto &ch : manager->listChannels()) {
+        if (ch.id == "game") {
+            EXPECT_EQ(ch.volume, 40);
+        } else if (ch.id == "chat") {
+            EXPECT_TRUE(ch.muted);
+        }
+    }
+
+    QProcess process;
+    process.start("pactl", {"get-sink-volume", "wavemux_game"});
+    process.waitForFinished(5000);
+    EXPECT_TRUE(QString::fromUtf8(process.readAllStandardOutput()).contains("40%"));
+
+    process.start("pactl", {"get-sink-mute", "wavemux_chat"});
+    process.waitForFinished(5000);
+    EXPECT_TRUE(QString::fromUtf8(process.readAllStandardOutput()).contains("yes"));
+}
+
+TEST_F(AudioManagerTest, InitializeAsyncEmitsInitialized) {
+    bool done = false;
+    bool result = false;
+    QEventLoop loop;
+    QObject::connect(manager, &WaveMux::AudioManager::initialized,
+        [&](bool success) {
+            done = true;
+            result = success;
+            loop.quit();
+        });
+
+    manager->initializeAsync();
+    EXPECT_FALSE(done);  // Nothing happens before the event loop runs
+
+    QTimer::singleShot(15000, &loop, &QEventLoop::quit);
+    loop.exec();
+
+    EXPECT_TRUE(done);
+    EXPECT_TRUE(result);
+    EXPECT_TRUE(manager->isInitialized());
+    EXPECT_TRUE(sinkExists("wavemux_aux"));
+}
+
 TEST_F(AudioManagerTest, InitializeTwice) {
     EXPECT_TRUE(manager->initialize());
     EXPECT_TRUE(manager->initialize());
@@ -201,6 +278,323 @@ TEST_F(AudioManagerTest, ListOutputDevices) {
     }
 }
 
+TEST_F(AudioManagerTest, OutputFallbacksRejectUnknownMix) {
+    EXPECT_FALSE(manager->setOutputFallbacks("invalid", {"some_sink"}));
+    EXPECT_TRUE(manager->setOutputFallbacks("personal", {"some_sink"}));
+    EXPECT_EQ(manager->getOutputFallbacks("personal"), QStringList({"some_sink"}));
+}
+
+TEST_F(AudioManagerTest, FailoverFollowsHotplug) {
+    EXPECT_TRUE(manager->initialize());
+
+    // Two fake output devices; "headset" gets unplugged and replugged
+    QString headsetModule = loadTestDevice("test_headset_dev");
+    QString speakerModule = loadTestDevice("test_speakers_dev");
+    ASSERT_FALSE(headsetModule.isEmpty());
+    ASSERT_FALSE(speakerModule.isEmpty());
+    processEvents(500);
+
+    EXPECT_TRUE(manager->setOutputDevice("test_headset_dev"));
+    EXPECT_TRUE(manager->setOutputFallbacks("personal", {"missing_dev", "test_speakers_dev"}));
+    EXPECT_EQ(manager->getActiveOutputDevice("personal"), "test_headset_dev");
+
+    QProcess::execute("pactl", {"unload-module", headsetModule});
+    processEvents(1000);
+    EXPECT_EQ(manager->getActiveOutputDevice("personal"), "test_speakers_dev");
+
+    loadTestDevice("test_headset_dev");
+    processEvents(1000);
+    EXPECT_EQ(manager->getActiveOutputDevice("personal"), "test_headset_dev");
+}
+
+TEST_F(AudioManagerTest, SetDuckingValidatesChannels) {
+    WaveMux::DuckingConfig config;
+    config.triggerChannel = "chat";
+    config.targetChannels = {"game", "media"};
+    EXPECT_TRUE(manager->setDucking("personal", config));
+    EXPECT_FALSE(manager->setDucking("invalid", config));
+
+    config.triggerChannel = "invalid";
+    EXPECT_FALSE(manager->setDucking("stream", config));
+
+    config.triggerChannel = "chat";
+    config.targetChannels = {"chat"};  // A channel can't duck itself
+    EXPECT_FALSE(manager->setDucking("stream", config));
+}
+
+TEST_F(AudioManagerTest, StreamBusValidatesSettings) {
+    WaveMux::LimiterSettings limiter;
+    limiter.enabled = true;
+    EXPECT_TRUE(manager->setLimiter("stream", limiter));
+    EXPECT_FALSE(manager->setLimiter("invalid", limiter));
+    limiter.ceilingDb = 3.0f;  // Above full scale
+    EXPECT_FALSE(manager->setLimiter("stream", limiter));
+
+    WaveMux::LoudnessSettings loudness;
+    EXPECT_TRUE(manager->setLoudness("stream", loudness));
+    loudness.maxGainDb = -1.0f;
+    EXPECT_FALSE(manager->setLoudness("stream", loudness));
+
+    // Meters read silence while no engine runs the mix
+    auto meters = manager->getMixMeters("personal");
+    EXPECT_DOUBLE_EQ(meters.limiterReductionDb, 0.0);
+    EXPECT_DOUBLE_EQ(meters.shortTermLufs, WaveMux::LoudnessMeter::SILENCE_LUFS);
+}
+
+TEST_F(AudioManagerTest, ChannelEqValidatesBands) {
+    WaveMux::EqBand band;
+    band.type = WaveMux::EqBandType::HighPass;
+    band.frequency = 80.0f;
+    EXPECT_TRUE(manager->setChannelEq("chat", {band}));
+    EXPECT_EQ(manager->getChannelEq("chat").size(), 1);
+    EXPECT_FALSE(manager->setChannelEq("invalid", {band}));
+
+    band.gainDb = 40.0f;  // Out of range
+    EXPECT_FALSE(manager->setChannelEq("chat", {band}));
+
+    QList<WaveMux::EqBand> tooMany;
+    for (size_t i = 0; i <= WaveMux::Equalizer::MAX_BANDS; ++i) {
+        tooMany.append(WaveMux::EqBand());
+    }
+    EXPECT_FALSE(manager->setChannelEq("chat", tooMany));
+    EXPECT_EQ(manager->getChannelEq("chat").size(), 1);  // Unchanged
+}
+
+TEST_F(AudioManagerTest, MicUsesChannelModel) {
+    auto hasMic = [this]() {
+        for (const auto &channel : manager->listChannels()) {
+            if (channel.id == "mic") {
+                return true;
+            }
+        }
+        return false;
+    };
+    EXPECT_FALSE(hasMic());
+
+    WaveMux::MicConfig mic;
+    mic.source = "alsa_input.test-mic";
+    EXPECT_TRUE(manager->setMic(mic));
+    EXPECT_TRUE(hasMic());
+    EXPECT_TRUE(manager->getMic().gate.enabled);
+
+    EXPECT_TRUE(manager->setChannelStreamVolume("mic", 80));
+    EXPECT_TRUE(manager->setChannelMute("mic", true));
+    for (const auto &channel : manager->listChannels()) {
+        if (channel.id == "mic") {
+            EXPECT_EQ(channel.streamVolume, 80);
+            EXPECT_EQ(channel.personalVolume, 0);  // No self-monitoring by default
+            EXPECT_TRUE(channel.muted);
+        }
+    }
+
+    mic.source = "wavemux_game";  // Our own sinks are not microphones
+    EXPECT_FALSE(manager->setMic(mic));
+
+    EXPECT_TRUE(manager->setMic(WaveMux::MicConfig()));
+    EXPECT_FALSE(hasMic());
+}
+
+TEST_F(AudioManagerTest, DuckingRunsMixInProcess) {
+    EXPECT_TRUE(manager->initialize());
+
+    auto devices = manager->listOutputDevices();
+    if (devices.isEmpty()) {
+        GTEST_SKIP() << "No output devices available";
+    }
+    manager->setOutputDevice(devices[0].id);
+    EXPECT_FALSE(manager->isMixProcessed("personal"));
+
+    WaveMux::DuckingConfig config;
+    config.settings.enabled = true;
+    EXPECT_TRUE(manager->setDucking("personal", config));
+    EXPECT_TRUE(manager->isMixProcessed("personal"));
+    EXPECT_FALSE(manager->isMixProcessed("stream"));
+    EXPECT_TRUE(manager->getDucking("personal").settings.enabled);
+
+    config.settings.enabled = false;
+    EXPECT_TRUE(manager->setDucking("personal", config));
+    EXPECT_FALSE(manager->isMixProcessed("personal"));
+}
+
+TEST_F(AudioManagerTest, ChannelDelaysRunMixInProcess) {
+    EXPECT_FALSE(manager->setChannelDelay("personal", "bogus", 10.0));
+    EXPECT_FALSE(manager->setChannelDelay("nowhere", "game", 10.0));
+    EXPECT_FALSE(manager->setChannelDelay("stream", "chat", -1.0));
+    EXPECT_FALSE(manager->setChannelDelay("stream", "chat", WaveMux::MixGraph::MAX_DELAY_MS + 1.0));
+    EXPECT_FALSE(manager->measureAlignment("personal"));  // Not playing yet
+
+    EXPECT_TRUE(manager->initialize());
+    auto devices = manager->listOutputDevices();
+    if (devices.isEmpty()) {
+        GTEST_SKIP() << "No output devices available";
+    }
+    manager->setOutputDevice(devices[0].id);
+    EXPECT_FALSE(manager->isMixProcessed("personal"));
+
+    // Rounded to whole frames: 48 frames per millisecond
+    EXPECT_TRUE(manager->setChannelDelay("personal", "game", 12.51));
+    EXPECT_TRUE(manager->isMixProcessed("personal"));
+    EXPECT_FALSE(manager->isMixProcessed("stream"));
+    EXPECT_DOUBLE_EQ(manager->getChannelDelays("personal").value("game"), 600.0 / 48.0);
+    EXPECT_TRUE(manager->getChannelDelays("stream").isEmpty());
+
+    EXPECT_TRUE(manager->setChannelDelay("personal", "game", 0.0));
+    EXPECT_TRUE(manager->getChannelDelays("personal").isEmpty());
+    EXPECT_FALSE(manager->isMixProcessed("personal"));
+}
+
+TEST_F(AudioManagerTest, MeasuresChannelLatency) {
+    EXPECT_FALSE(manager->measureLatency("game", "personal"));  // Not playing yet
+
+    loadTestDevice("test_latency_dev");
+    EXPECT_TRUE(manager->initialize());
+    EXPECT_TRUE(manager->setOutputDevice("test_latency_dev"));
+    EXPECT_FALSE(manager->measureLatency("bogus", "personal"));
+    EXPECT_FALSE(manager->measureLatency("game", "nowhere"));
+    EXPECT_FALSE(manager->measureLatency("game", "personal", 0));
+    EXPECT_FALSE(manager->measureLatency("game", "stream"));  // Stream mix is off
+    EXPECT_TRUE(manager->setChannelMute("chat", true));
+    EXPECT_FALSE(manager->measureLatency("chat", "personal"));
+
+    std::optional<WaveMux::LatencyMeasurement> result;
+    bool success = false;
+    QEventLoop loop;
+    QObject::connect(manager, &WaveMux::AudioManager::latencyMeasured,
+                     [&](const WaveMux::LatencyMeasurement &measurement, bool ok) {
+        result = measurement;
+        success = ok;
+        loop.quit();
+    });
+    ASSERT_TRUE(manager->measureLatency("game", "personal", 3));
+    EXPECT_TRUE(manager->isMeasuringLatency());
+    EXPECT_FALSE(manager->measureLatency("media", "personal"));
+    EXPECT_FALSE(manager->measureAlignment("personal"));
+    QTimer::singleShot(30000, &loop, &QEventLoop::quit);
+    loop.exec();
+
+    // Null sinks run on the server's clock, so this is a latency regression
+    // check that needs no hardware
+    ASSERT_TRUE(result.has_value());
+    ASSERT_TRUE(success);
+    EXPECT_FALSE(manager->isMeasuringLatency());
+    EXPECT_EQ(result->device, "test_latency_dev");
+    EXPECT_EQ(result->mode, "loopback");
+    EXPECT_EQ(result->path.attempts, 3);
+    EXPECT_FALSE(result->path.runsMs.isEmpty());
+    EXPECT_LE(result->path.minMs, result->path.medianMs);
+    EXPECT_LE(result->path.medianMs, result->path.maxMs);
+    EXPECT_GE(result->path.jitterMs, 0.0);
+    // The loopback adds its buffer on top of the probe's own overhead
+    EXPECT_GT(result->path.medianMs, result->baseline.medianMs);
+    EXPECT_LT(result->path.medianMs, WaveMux::LatencyProbe::CAPTURE_MS);
+}
+
+TEST_F(AudioManagerTest, RecordingWritesOneFilePerTrack) {
+    EXPECT_FALSE(manager->startRecording(QDir::tempPath()));
+    EXPECT_TRUE(manager->initialize());
+
+    QTemporaryDir directory;
+    ASSERT_TRUE(directory.isValid());
+    EXPECT_TRUE(manager->startRecording(directory.path()));
+    EXPECT_TRUE(manager->isRecording());
+    EXPECT_FALSE(manager->startRecording(directory.path()));
+    processEvents(300);
+
+    auto status = manager->recordingStatus();
+    EXPECT_TRUE(status.recording);
+    EXPECT_EQ(status.files.size(), 4);
+
+    EXPECT_TRUE(manager->stopRecording());
+    EXPECT_FALSE(manager->isRecording());
+    EXPECT_FALSE(manager->stopRecording());
+    for (const auto &file : status.files) {
+        EXPECT_TRUE(QFileInfo::exists(file)) << file.toStdString();
+    }
+}
+
+TEST_F(AudioManagerTest, ReplayFollowsSettings) {
+    WaveMux::ReplaySettings replay;
+    replay.seconds = 0;
+    EXPECT_FALSE(manager->setReplay(replay));
+    replay.seconds = WaveMux::ReplaySettings::MAX_SECONDS + 1;
+    EXPECT_FALSE(manager->setReplay(replay));
+
+    replay.seconds = 5;
+    replay.enabled = true;
+    replay.channels = true;
+    EXPECT_TRUE(manager->setReplay(replay));
+    EXPECT_FALSE(manager->isReplayActive());  // Starts with the audio manager
+    EXPECT_FALSE(manager->saveReplay(5));
+
+    EXPECT_TRUE(manager->initialize());
+    EXPECT_TRUE(manager->isReplayActive());
+    processEvents(300);
+
+    QTemporaryDir directory;
+    ASSERT_TRUE(directory.isValid());
+    bool done = false;
+    bool result = false;
+    QStringList files;
+    QEventLoop loop;
+    QObject::connect(manager, &WaveMux::AudioManager::replaySaved,
+        [&](const QStringList &saved, bool success) {
+            done = true;
+            result = success;
+            files = saved;
+            loop.quit();
+        });
+
+    EXPECT_TRUE(manager->saveReplay(0, directory.filePath("clip.wav")));
+    QTimer::singleShot(5000, &loop, &QEventLoop::quit);
+    loop.exec();
+
+    EXPECT_TRUE(done);
+    EXPECT_TRUE(result);
+    EXPECT_EQ(files.size(), 4);  // Channels only: no Stream mix set up
+    EXPECT_TRUE(QFileInfo::exists(directory.filePath("clip-game.wav")));
+
+    replay.enabled = false;
+    EXPECT_TRUE(manager->setReplay(replay));
+    EXPECT_FALSE(manager->isReplayActive());
+}
+
+TEST_F(AudioManagerTest, SpectrumFeedFollowsSubscribers) {
+    EXPECT_FALSE(manager->setSpectrumSubscription("ui", {"game", "bogus"}));
+    EXPECT_FALSE(manager->setSpectrumSubscription("ui", {"app:x"}));
+    EXPECT_TRUE(manager->spectrumTargets().isEmpty());
+
+    EXPECT_TRUE(manager->initialize());
+    EXPECT_TRUE(manager->setSpectrumSubscription("ui", {"game", "media"}));
+    EXPECT_TRUE(manager->setSpectrumSubscription("meter", {"game"}));
+    EXPECT_EQ(manager->spectrumTargets().size(), 2);
+
+    QVariantMap bands;
+    QEventLoop loop;
+    QObject::connect(manager, &WaveMux::AudioManager::spectrumUpdated,
+        [&](const QVariantMap &update) {
+            bands = update;
+            loop.quit();
+        });
+    QTimer::singleShot(3000, &loop, &QEventLoop::quit);
+    loop.exec();
+
+    ASSERT_TRUE(bands.contains("game"));
+    EXPECT_EQ(bands.value("game").value<QList<double>>().size(), WaveMux::SpectrumAnalyzer::BANDS);
+
+    EXPECT_TRUE(manager->setSpectrumSubscription("ui", {}));
+    EXPECT_TRUE(manager->setSpectrumSubscription("meter", {}));
+    EXPECT_TRUE(manager->spectrumTargets().isEmpty());
+}
+
+TEST_F(AudioManagerTest, RecordsBackendAndStartupStats) {
+    WaveMux::Stats::reset();  // Earlier tests in this process count too
+    EXPECT_TRUE(manager->initialize());
+
+    EXPECT_GE(WaveMux::Stats::histogram("backend.pactl load-module").summary().count, 5u);
+    EXPECT_EQ(WaveMux::Stats::histogram("startup.channel-game").summary().count, 1u);
+    EXPECT_NE(WaveMux::Stats::dump().find("backend.pactl load-module"), std::string::npos);
+}
+
 TEST_F(AudioManagerTest, DefaultSinkPreserved) {
     QString originalDefault = getDefaultSink();
 
@@ -241,6 +635,14 @@ TEST_F(AudioManagerTest, MoveStreamInvalidId) {
     EXPECT_FALSE(manager->moveStreamToChannel(999999, "game"));
 }
 
+TEST_F(AudioManagerTest, StreamVolumeInvalidId) {
+    EXPECT_TRUE(manager->initialize());
+
+    EXPECT_FALSE(manager->setStreamVolume(999999, 50));
+    EXPECT_FALSE(manager->setStreamMute(999999, true));
+    EXPECT_TRUE(manager->getAppVolumes().isEmpty());
+}
+
 TEST_F(AudioManagerTest, MoveStreamInvalidChannel) {
     EXPECT_TRUE(manager->initialize());
 
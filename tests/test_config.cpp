@@ -2,9 +2,11 @@
 #include <QCoreApplication>
 #include <QDir>
 #include <QFile>
+#include <QFileInfo>
 #include <QStandardPaths>
 #include "audiomanager.h"
 #include "configmanager.h"
+#include "eventlog.h"
 #include "wavemux/types.h"
 
 class ConfigManagerTest : public ::testing::Test {
@@ -135,6 +137,363 @@ TEST_F(ConfigManagerTest, SaveChannelStates) {
     EXPECT_TRUE(data.contains("game"));
 }
 
+TEST_F(ConfigManagerTest, OutputFallbacksPersistAcrossLoad) {
+    EXPECT_TRUE(manager->initialize());
+    EXPECT_TRUE(manager->setOutputFallbacks("personal", {"usb_headset", "speakers"}));
+    EXPECT_TRUE(manager->setOutputFallbacks("stream", {"speakers"}));
+    EXPECT_TRUE(config->save());
+
+    EXPECT_TRUE(manager->setOutputFallbacks("personal", {}));
+    EXPECT_TRUE(config->load());
+
+    EXPECT_EQ(manager->getOutputFallbacks("personal"), QStringList({"usb_headset", "speakers"}));
+    EXPECT_EQ(manager->getOutputFallbacks("stream"), QStringList({"speakers"}));
+}
+
+TEST_F(ConfigManagerTest, DuckingPersistsAcrossLoad) {
+    EXPECT_TRUE(manager->initialize());
+
+    WaveMux::DuckingConfig ducking;
+    ducking.triggerChannel = "chat";
+    ducking.targetChannels = {"game"};
+    ducking.settings.depthDb = 18.0f;
+    ducking.settings.releaseMs = 250.0f;
+    EXPECT_TRUE(manager->setDucking("stream", ducking));
+    EXPECT_TRUE(config->save());
+
+    EXPECT_TRUE(manager->setDucking("stream", WaveMux::DuckingConfig()));
+    EXPECT_TRUE(config->load());
+
+    auto loaded = manager->getDucking("stream");
+    EXPECT_EQ(loaded.targetChannels, QStringList({"game"}));
+    EXPECT_FLOAT_EQ(loaded.settings.depthDb, 18.0f);
+    EXPECT_FLOAT_EQ(loaded.settings.releaseMs, 250.0f);
+}
+
+TEST_F(ConfigManagerTest, StreamBusPersistsAcrossLoad) {
+    EXPECT_TRUE(manager->initialize());
+
+    WaveMux::LimiterSettings limiter;
+    limiter.ceilingDb = -2.0f;
+    WaveMux::LoudnessSettings loudness;
+    loudness.targetLufs = -14.0f;
+    EXPECT_TRUE(manager->setLimiter("stream", limiter));
+    EXPECT_TRUE(manager->setLoudness("stream", loudness));
+    EXPECT_TRUE(config->save());
+
+    EXPECT_TRUE(manager->setLimiter("stream", WaveMux::LimiterSettings()));
+    EXPECT_TRUE(manager->setLoudness("stream", WaveMux::LoudnessSettings()));
+    EXPECT_TRUE(config->load());
+
+    EXPECT_FLOAT_EQ(manager->getLimiter("stream").ceilingDb, -2.0f);
+    EXPECT_FLOAT_EQ(manager->getLoudness("stream").targetLufs, -14.0f);
+}
+
+TEST_F(ConfigManagerTest, ChannelEqPersistsAcrossLoad) {
+    EXPECT_TRUE(manager->initialize());
+
+    WaveMux::EqBand rumble;
+    rumble.type = WaveMux::EqBandType::HighPass;
+    rumble.frequency = 90.0f;
+    WaveMux::EqBand presence;
+    presence.frequency = 3000.0f;
+    presence.gainDb = -4.0f;
+    presence.q = 2.0f;
+    EXPECT_TRUE(manager->setChannelEq("chat", {rumble, presence}));
+    EXPECT_TRUE(config->save());
+
+    EXPECT_TRUE(manager->setChannelEq("chat", {}));
+    EXPECT_TRUE(config->load());
+
+    auto loaded = manager->getChannelEq("chat");
+    ASSERT_EQ(loaded.size(), 2);
+    EXPECT_EQ(loaded[0].type, WaveMux::EqBandType::HighPass);
+    EXPECT_FLOAT_EQ(loaded[0].frequency, 90.0f);
+    EXPECT_FLOAT_EQ(loaded[1].gainDb, -4.0f);
+    EXPECT_FLOAT_EQ(loaded[1].q, 2.0f);
+    EXPECT_TRUE(manager->getChannelEq("game").isEmpty());
+}
+
+TEST_F(ConfigManagerTest, MicPersistsAcrossLoad) {
+    EXPECT_TRUE(manager->initialize());
+
+    WaveMux::MicConfig mic;
+    mic.source = "alsa_input.test-mic";
+    mic.gate.thresholdDb = -50.0f;
+    EXPECT_TRUE(manager->setMic(mic));
+    EXPECT_TRUE(manager->setChannelStreamVolume("mic", 70));
+    EXPECT_TRUE(config->save());
+
+    EXPECT_TRUE(manager->setMic(WaveMux::MicConfig()));
+    EXPECT_TRUE(manager->setChannelStreamVolume("mic", 100));
+    EXPECT_TRUE(config->load());
+
+    EXPECT_EQ(manager->getMic().source, "alsa_input.test-mic");
+    EXPECT_FLOAT_EQ(manager->getMic().gate.thresholdDb, -50.0f);
+    for (const auto &channel : manager->listChannels()) {
+        if (channel.id == "mic") {
+            EXPECT_EQ(channel.streamVolume, 70);
+        }
+    }
+}
+
+TEST_F(ConfigManagerTest, ReplayPersistsAcrossLoad) {
+    EXPECT_TRUE(manager->initialize());
+
+    WaveMux::ReplaySettings replay;
+    replay.seconds = 30;
+    replay.channels = true;
+    replay.compact = false;
+    EXPECT_TRUE(manager->setReplay(replay));
+    EXPECT_TRUE(config->save());
+
+    EXPECT_TRUE(manager->setReplay(WaveMux::ReplaySettings()));
+    EXPECT_TRUE(config->load());
+
+    EXPECT_FALSE(manager->getReplay().enabled);
+    EXPECT_EQ(manager->getReplay().seconds, 30);
+    EXPECT_TRUE(manager->getReplay().channels);
+    EXPECT_FALSE(manager->getReplay().compact);
+}
+
+TEST_F(ConfigManagerTest, DelaysPersistAcrossLoad) {
+    EXPECT_TRUE(manager->initialize());
+
+    EXPECT_TRUE(manager->setChannelDelay("stream", "chat", 25.0));
+    EXPECT_TRUE(manager->setChannelDelay("stream", "mic", 40.0));
+    EXPECT_TRUE(config->save());
+
+    EXPECT_TRUE(manager->setChannelDelay("stream", "chat", 0.0));
+    EXPECT_TRUE(manager->setChannelDelay("stream", "mic", 0.0));
+    EXPECT_TRUE(config->load());
+
+    const auto delays = manager->getChannelDelays("stream");
+    EXPECT_EQ(delays.size(), 2);
+    EXPECT_DOUBLE_EQ(delays.value("chat"), 25.0);
+    EXPECT_DOUBLE_EQ(delays.value("mic"), 40.0);
+    EXPECT_TRUE(manager->getChannelDelays("personal").isEmpty());
+}
+
+TEST_F(ConfigManagerTest, AppVolumesPersistAcrossLoad) {
+    EXPECT_TRUE(manager->initialize());
+
+    WaveMux::AppVolume quiet;
+    quiet.volume = 40;
+    WaveMux::AppVolume muted;
+    muted.muted = true;
+    manager->setAppVolumes({{"firefox", quiet}, {"Discord", muted}});
+    EXPECT_TRUE(config->save());
+
+    manager->setAppVolumes({});
+    EXPECT_TRUE(config->load());
+
+    const auto volumes = manager->getAppVolumes();
+    ASSERT_EQ(volumes.size(), 2);
+    EXPECT_EQ(volumes.value("firefox").volume, 40);
+    EXPECT_FALSE(volumes.value("firefox").muted);
+    EXPECT_TRUE(volumes.value("Discord").muted);
+}
+
+TEST_F(ConfigManagerTest, FlushWritesPendingChanges) {
+    EXPECT_TRUE(manager->initialize());
+    config->connectAutoSave();
+
+    EXPECT_FALSE(config->hasPendingChanges());
+    manager->setChannelVolume("game", 55);
+    EXPECT_TRUE(config->hasPendingChanges());
+
+    EXPECT_TRUE(config->flush());
+    EXPECT_FALSE(config->hasPendingChanges());
+    EXPECT_TRUE(QFile::exists(testConfigPath));
+}
+
+TEST_F(ConfigManagerTest, SaveLeavesNoTemporaryFiles) {
+    EXPECT_TRUE(manager->initialize());
+
+    EXPECT_TRUE(config->save());
+    manager->setChannelVolume("chat", 20);
+    EXPECT_TRUE(config->save());
+
+    QDir dir = QFileInfo(testConfigPath).dir();
+    QStringList entries = dir.entryList({"config.json*"}, QDir::Files | QDir::Hidden);
+    EXPECT_EQ(entries, QStringList{"config.json"});
+}
+
+TEST_F(ConfigManagerTest, LoadAppliesConfigAsOneSnapshot) {
+    EXPECT_TRUE(manager->initialize());
+
+    manager->setChannelVolume("game", 60);
+    manager->setMasterVolume(70);
+    manager->addRoutingRule("discord", "chat");
+    EXPECT_TRUE(config->save());
+
+    // Reset live state so the load has something to apply
+    manager->setChannelVolume("game", 100);
+    manager->setMasterVolume(100);
+    manager->removeRoutingRule("discord");
+
+    int snapshots = 0;
+    int ruleChanges = 0;
+    QObject::connect(manager, &WaveMux::AudioManager::snapshotApplied, [&]() { ++snapshots; });
+    QObject::connect(manager, &WaveMux::AudioManager::routingRulesChanged, [&]() { ++ruleChanges; });
+
+    WaveMux::ConfigManager config2(manager);
+    EXPECT_TRUE(config2.load());
+
+    EXPECT_EQ(snapshots, 1);
+    EXPECT_EQ(ruleChanges, 0);
+    EXPECT_EQ(manager->getMasterVolume(), 70);
+    EXPECT_EQ(manager->getRoutingRules().size(), 1);
+    for (const auto &ch : manager->listChannels()) {
+        if (ch.id == "game") {
+            EXPECT_EQ(ch.volume, 60);
+        }
+    }
+}
+
+TEST_F(ConfigManagerTest, LoadBuildsEachMixOnce) {
+    EXPECT_TRUE(manager->initialize());
+    auto devices = manager->listOutputDevices();
+    if (devices.isEmpty()) {
+        GTEST_SKIP() << "No output devices available";
+    }
+    manager->setOutputDevice(devices[0].id);
+
+    WaveMux::DuckingConfig ducking;
+    ducking.settings.enabled = true;
+    WaveMux::LimiterSettings limiter;
+    limiter.enabled = true;
+    WaveMux::EqBand rumble;
+    rumble.type = WaveMux::EqBandType::HighPass;
+    rumble.frequency = 90.0f;
+    EXPECT_TRUE(manager->setDucking("personal", ducking));
+    EXPECT_TRUE(manager->setLimiter("personal", limiter));
+    EXPECT_TRUE(manager->setChannelEq("chat", {rumble}));
+    EXPECT_TRUE(manager->setChannelDelay("personal", "game", 5.0));
+    EXPECT_TRUE(config->save());
+
+    // Back to plain loopbacks, so the load has to switch the mix over
+    EXPECT_TRUE(manager->setDucking("personal", WaveMux::DuckingConfig()));
+    EXPECT_TRUE(manager->setLimiter("personal", WaveMux::LimiterSettings()));
+    EXPECT_TRUE(manager->setChannelEq("chat", {}));
+    EXPECT_TRUE(manager->setChannelDelay("personal", "game", 0.0));
+    ASSERT_FALSE(manager->isMixProcessed("personal"));
+
+    WaveMux::EventLog::clear();
+    WaveMux::ConfigManager config2(manager);
+    EXPECT_TRUE(config2.load());
+
+    int enginesStarted = 0;
+    int loopbacksCreated = 0;
+    for (const auto &event : WaveMux::EventLog::events()) {
+        if (event.code == WaveMux::EventLog::Code::EngineStarted && event.a == 0) {
+            ++enginesStarted;
+        } else if (event.code == WaveMux::EventLog::Code::LoopbackCreated && event.b == 0) {
+            ++loopbacksCreated;
+        }
+    }
+    EXPECT_EQ(enginesStarted, 1);
+    EXPECT_EQ(loopbacksCreated, 0);
+    EXPECT_TRUE(manager->isMixProcessed("personal"));
+    EXPECT_TRUE(manager->getDucking("personal").settings.enabled);
+    EXPECT_EQ(manager->getChannelEq("chat").size(), 1);
+}
+
+// =============================================================================
+// Profiles
+// =============================================================================
+
+TEST_F(ConfigManagerTest, SaveProfileCapturesState) {
+    EXPECT_TRUE(manager->initialize());
+
+    manager->setChannelVolume("game", 80);
+    manager->addRoutingRule("discord", "chat");
+
+    EXPECT_TRUE(config->saveProfile("Gaming"));
+
+    auto profiles = config->profiles();
+    ASSERT_EQ(profiles.size(), 1);
+    EXPECT_EQ(profiles[0].name, "Gaming");
+    EXPECT_EQ(profiles[0].channels.size(), 4);
+    EXPECT_EQ(profiles[0].rules.size(), 1);
+    EXPECT_EQ(config->activeProfile(), "Gaming");
+}
+
+TEST_F(ConfigManagerTest, SaveProfileRejectsEmptyName) {
+    EXPECT_FALSE(config->saveProfile("  "));
+    EXPECT_TRUE(config->profiles().isEmpty());
+}
+
+TEST_F(ConfigManagerTest, SwitchProfileAppliesChannelsAndRules) {
+    EXPECT_TRUE(manager->initialize());
+
+    manager->setChannelVolume("game", 100);
+    manager->setChannelMute("chat", false);
+    manager->addRoutingRule("steam", "game");
+    EXPECT_TRUE(config->saveProfile("Gaming"));
+
+    manager->setChannelVolume("game", 40);
+    manager->setChannelMute("chat", true);
+    manager->removeRoutingRule("steam");
+    manager->addRoutingRule("obs", "aux");
+    EXPECT_TRUE(config->saveProfile("Streaming"));
+
+    EXPECT_TRUE(config->switchProfile("Gaming"));
+    EXPECT_EQ(config->activeProfile(), "Gaming");
+
+    for (const auto &ch : manager->listChannels()) {
+        if (ch.id == "game") {
+            EXPECT_EQ(ch.volume, 100);
+        } else if (ch.id == "chat") {
+            EXPECT_FALSE(ch.muted);
+        }
+    }
+
+    auto rules = manager->getRoutingRules();
+    ASSERT_EQ(rules.size(), 1);
+    EXPECT_EQ(rules[0].matchPattern, "steam");
+}
+
+TEST_F(ConfigManagerTest, SwitchUnknownProfileFails) {
+    EXPECT_TRUE(manager->initialize());
+    EXPECT_FALSE(config->switchProfile("DoesNotExist"));
+}
+
+TEST_F(ConfigManagerTest, DeleteProfile) {
+    EXPECT_TRUE(manager->initialize());
+
+    EXPECT_TRUE(config->saveProfile("Music"));
+    EXPECT_TRUE(config->deleteProfile("Music"));
+    EXPECT_TRUE(config->profiles().isEmpty());
+    EXPECT_TRUE(config->activeProfile().isEmpty());
+    EXPECT_FALSE(config->deleteProfile("Music"));
+}
+
+TEST_F(ConfigManagerTest, ProfilesPersistAcrossLoad) {
+    EXPECT_TRUE(manager->initialize());
+
+    manager->setChannelVolume("media", 30);
+    EXPECT_TRUE(config->saveProfile("Music"));
+    EXPECT_TRUE(config->save());
+
+    WaveMux::ConfigManager config2(manager);
+    EXPECT_TRUE(config2.load());
+
+    auto profiles = config2.profiles();
+    ASSERT_EQ(profiles.size(), 1);
+    EXPECT_EQ(profiles[0].name, "Music");
+    EXPECT_EQ(config2.activeProfile(), "Music");
+
+    bool found = false;
+    for (const auto &ch : profiles[0].channels) {
+        if (ch.id == "media") {
+            EXPECT_EQ(ch.volume, 30);
+            found = true;
+        }
+    }
+    EXPECT_TRUE(found);
+}
+
 int main(int argc, char **argv) {
     QCoreApplication app(argc, argv);
     ::testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,667 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "dsp/delayline.h"
+#include "dsp/envelopefollower.h"
+#include "dsp/ducker.h"
+#include "dsp/equalizer.h"
+#include "dsp/impulseprobe.h"
+#include "dsp/mixgraph.h"
+#include "dsp/noisegate.h"
+#include "dsp/spectrum.h"
+#include "dsp/triplebuffer.h"
+
+namespace {
+    constexpr float SAMPLE_RATE = 48000.0f;
+    constexpr size_t BLOCK = 256;
+
+    std::vector<float> constantBlock(float value, size_t frames = BLOCK) {
+        return std::vector<float>(frames * WaveMux::MixGraph::CHANNELS, value);
+    }
+
+    float toDb(float gain) {
+        return 20.0f * std::log10(gain);
+    }
+}
+
+TEST(EnvelopeFollowerTest, RisesAndFalls) {
+    WaveMux::EnvelopeFollower follower(SAMPLE_RATE, 1.0f, 50.0f);
+    for (int i = 0; i < 480; ++i) {  // 10 ms, i.e. 10 attack time constants
+        follower.process(1.0f);
+    }
+    EXPECT_NEAR(follower.value(), 1.0f, 0.001f);
+
+    for (int i = 0; i < 2400; ++i) {  // 50 ms = one release time constant
+        follower.process(0.0f);
+    }
+    EXPECT_NEAR(follower.value(), std::exp(-1.0f), 0.01f);
+}
+
+TEST(DuckerTest, DisabledLeavesUnityGain) {
+    WaveMux::Ducker ducker(SAMPLE_RATE);
+    auto trigger = constantBlock(0.5f);
+    std::vector<float> gains(BLOCK);
+    ducker.process(trigger.data(), BLOCK, 2, gains.data());
+
+    for (float gain : gains) {
+        EXPECT_FLOAT_EQ(gain, 1.0f);
+    }
+    EXPECT_FLOAT_EQ(ducker.gainReductionDb(), 0.0f);
+}
+
+TEST(DuckerTest, DucksByDepthWhileTriggerActive) {
+    WaveMux::Ducker ducker(SAMPLE_RATE);
+    WaveMux::DuckingSettings settings;
+    settings.enabled = true;
+    settings.depthDb = 12.0f;
+    settings.thresholdDb = -40.0f;
+    settings.attackMs = 5.0f;
+    settings.releaseMs = 100.0f;
+    ducker.setSettings(settings);
+
+    auto trigger = constantBlock(0.5f);  // ~-6 dBFS, far above threshold
+    std::vector<float> gains(BLOCK);
+    for (int block = 0; block < 40; ++block) {  // ~200 ms
+        ducker.process(trigger.data(), BLOCK, 2, gains.data());
+    }
+    EXPECT_NEAR(toDb(gains.back()), -12.0f, 0.1f);
+    EXPECT_NEAR(ducker.gainReductionDb(), 12.0f, 0.1f);
+}
+
+TEST(DuckerTest, QuietTriggerDoesNotDuck) {
+    WaveMux::Ducker ducker(SAMPLE_RATE);
+    WaveMux::DuckingSettings settings;
+    settings.enabled = true;
+    settings.thresholdDb = -40.0f;
+    ducker.setSettings(settings);
+
+    auto trigger = constantBlock(0.001f);  // -60 dBFS
+    std::vector<float> gains(BLOCK);
+    for (int block = 0; block < 20; ++block) {
+        ducker.process(trigger.data(), BLOCK, 2, gains.data());
+    }
+    EXPECT_NEAR(gains.back(), 1.0f, 1e-4f);
+}
+
+TEST(DuckerTest, ReleasesAfterTriggerStops) {
+    WaveMux::Ducker ducker(SAMPLE_RATE);
+    WaveMux::DuckingSettings settings;
+    settings.enabled = true;
+    settings.attackMs = 5.0f;
+    settings.releaseMs = 50.0f;
+    ducker.setSettings(settings);
+
+    auto loud = constantBlock(0.5f);
+    std::vector<float> gains(BLOCK);
+    for (int block = 0; block < 20; ++block) {
+        ducker.process(loud.data(), BLOCK, 2, gains.data());
+    }
+    EXPECT_GT(ducker.gainReductionDb(), 10.0f);
+
+    for (int block = 0; block < 200; ++block) {  // ~1 s of silence
+        ducker.process(nullptr, BLOCK, 2, gains.data());
+    }
+    EXPECT_LT(ducker.gainReductionDb(), 0.1f);
+}
+
+TEST(MixGraphTest, SumsStripsWithGains) {
+    WaveMux::MixGraph graph(2, SAMPLE_RATE);
+    graph.setStripGain(0, 1.0f);
+    graph.setStripGain(1, 0.5f);
+
+    auto a = constantBlock(0.2f);
+    auto b = constantBlock(0.4f);
+    const float *inputs[] = {a.data(), b.data()};
+    auto output = constantBlock(0.0f);
+
+    graph.process(inputs, output.data(), BLOCK);  // Ramps from 0 to the target
+    graph.process(inputs, output.data(), BLOCK);  // Settled
+
+    for (float sample : output) {
+        EXPECT_NEAR(sample, 0.2f + 0.2f, 1e-6f);
+    }
+}
+
+TEST(MixGraphTest, GainChangesRampWithoutSteps) {
+    WaveMux::MixGraph graph(1, SAMPLE_RATE);
+    auto input = constantBlock(1.0f);
+    const float *inputs[] = {input.data()};
+    auto output = constantBlock(0.0f);
+
+    graph.setStripGain(0, 1.0f);
+    graph.process(inputs, output.data(), BLOCK);
+
+    // First frame is one step up, last frame reaches the target
+    EXPECT_NEAR(output.front(), 1.0f / BLOCK, 1e-6f);
+    EXPECT_NEAR(output.back(), 1.0f, 1e-6f);
+    for (size_t frame = 1; frame < BLOCK; ++frame) {
+        EXPECT_GE(output[frame * 2], output[(frame - 1) * 2]);
+    }
+}
+
+TEST(MixGraphTest, DucksOnlyTargetStrips) {
+    WaveMux::MixGraph graph(3, SAMPLE_RATE);
+    for (size_t strip = 0; strip < 3; ++strip) {
+        graph.setStripGain(strip, 1.0f);
+    }
+    WaveMux::DuckingSettings settings;
+    settings.enabled = true;
+    settings.depthDb = 20.0f;
+    settings.attackMs = 1.0f;
+    graph.ducker().setSettings(settings);
+    graph.setDuckingRouting(1, 1u << 0);  // Strip 1 (chat) ducks strip 0 (game)
+
+    auto game = constantBlock(0.5f);
+    auto chat = constantBlock(0.0f);
+    auto media = constantBlock(0.0f);
+    const float *inputs[] = {game.data(), chat.data(), media.data()};
+    auto output = constantBlock(0.0f);
+
+    graph.process(inputs, output.data(), BLOCK);
+    graph.process(inputs, output.data(), BLOCK);
+    EXPECT_NEAR(output.back(), 0.5f, 1e-4f);  // Chat silent: no ducking
+
+    std::fill(chat.begin(), chat.end(), 0.5f);
+    for (int block = 0; block < 20; ++block) {
+        graph.process(inputs, output.data(), BLOCK);
+    }
+    // Game ducked by 20 dB (x0.1), chat passes through untouched
+    EXPECT_NEAR(output.back(), 0.05f + 0.5f, 1e-3f);
+}
+
+namespace {
+    // Stereo sine, same signal in both channels
+    std::vector<float> sineBlock(float amplitude, float frequency, size_t frames, size_t &phase) {
+        std::vector<float> block(frames * 2);
+        for (size_t frame = 0; frame < frames; ++frame, ++phase) {
+            const float value = amplitude * std::sin(2.0f * static_cast<float>(M_PI) * frequency * phase / SAMPLE_RATE);
+            block[frame * 2] = value;
+            block[frame * 2 + 1] = value;
+        }
+        return block;
+    }
+}
+
+TEST(LimiterTest, DisabledPassesThroughWithoutDelay) {
+    WaveMux::Limiter limiter(SAMPLE_RATE);
+    auto block = constantBlock(1.5f);
+    limiter.process(block.data(), BLOCK);
+    EXPECT_FLOAT_EQ(block.front(), 1.5f);
+}
+
+TEST(LimiterTest, KeepsTruePeakBelowCeiling) {
+    WaveMux::Limiter limiter(SAMPLE_RATE);
+    WaveMux::LimiterSettings settings;
+    settings.enabled = true;
+    settings.ceilingDb = -1.0f;
+    limiter.setSettings(settings);
+
+    const float ceiling = std::pow(10.0f, -1.0f / 20.0f);
+    WaveMux::TruePeakDetector meter;
+    size_t phase = 0;
+    float outputPeak = 0.0f;
+    for (int block = 0; block < 100; ++block) {
+        auto samples = sineBlock(2.0f, 3000.0f, BLOCK, phase);  // +6 dBFS
+        limiter.process(samples.data(), BLOCK);
+        for (size_t frame = 0; frame < BLOCK; ++frame) {
+            outputPeak = std::max(outputPeak, meter.process(0, samples[frame * 2]));
+        }
+    }
+    EXPECT_LE(outputPeak, ceiling * 1.03f);  // 4x oversampling may under-read slightly
+    EXPECT_GT(outputPeak, ceiling * 0.9f);   // ... but the signal isn't crushed
+    EXPECT_GT(limiter.gainReductionDb(), 6.0f);
+}
+
+TEST(LimiterTest, DelaysByLatency) {
+    WaveMux::Limiter limiter(SAMPLE_RATE);
+    WaveMux::LimiterSettings settings;
+    settings.enabled = true;
+    limiter.setSettings(settings);
+
+    std::vector<float> samples(BLOCK * 2, 0.0f);
+    samples[0] = 0.5f;  // Below the ceiling: passes unchanged, only delayed
+    samples[1] = 0.5f;
+    limiter.process(samples.data(), BLOCK);
+
+    ASSERT_LT(limiter.latency(), BLOCK);
+    EXPECT_NEAR(samples[limiter.latency() * 2], 0.5f, 1e-6f);
+    EXPECT_FLOAT_EQ(samples[0], 0.0f);
+}
+
+TEST(LoudnessMeterTest, ReadsSineLoudness) {
+    // A 1 kHz sine of amplitude A in both channels reads about 20*log10(A) LUFS
+    WaveMux::LoudnessMeter meter(SAMPLE_RATE);
+    size_t phase = 0;
+    for (int block = 0; block < 600; ++block) {  // ~3.2 s
+        auto samples = sineBlock(0.1f, 1000.0f, BLOCK, phase);
+        meter.process(samples.data(), BLOCK);
+    }
+    EXPECT_NEAR(meter.shortTermLufs(), -20.0f, 0.2f);
+    EXPECT_NEAR(meter.momentaryLufs(), -20.0f, 0.2f);
+}
+
+TEST(LoudnessMeterTest, SilenceReadsFloor) {
+    WaveMux::LoudnessMeter meter(SAMPLE_RATE);
+    auto silence = constantBlock(0.0f);
+    for (int block = 0; block < 100; ++block) {
+        meter.process(silence.data(), BLOCK);
+    }
+    EXPECT_FLOAT_EQ(meter.shortTermLufs(), WaveMux::LoudnessMeter::SILENCE_LUFS);
+}
+
+TEST(LoudnessNormalizerTest, SteersTowardsTarget) {
+    WaveMux::LoudnessNormalizer normalizer(SAMPLE_RATE);
+    WaveMux::LoudnessSettings settings;
+    settings.enabled = true;
+    settings.targetLufs = -24.0f;
+    settings.maxGainDb = 12.0f;
+    normalizer.setSettings(settings);
+
+    size_t phase = 0;
+    for (int block = 0; block < 3000; ++block) {  // 16 s
+        auto samples = sineBlock(0.01f, 1000.0f, BLOCK, phase);  // -40 LUFS input
+        normalizer.process(samples.data(), BLOCK);
+    }
+    // 16 dB short, but boost is capped at 12 dB
+    EXPECT_NEAR(normalizer.gainDb(), 12.0f, 0.3f);
+    EXPECT_NEAR(normalizer.inputMeter().shortTermLufs(), -40.0f, 0.3f);
+}
+
+namespace {
+    // Left-channel peak of a sine after the equalizer has settled
+    float equalizedPeak(WaveMux::Equalizer &eq, float frequency, int blocks = 100) {
+        size_t phase = 0;
+        float peak = 0.0f;
+        for (int block = 0; block < blocks; ++block) {
+            auto samples = sineBlock(0.25f, frequency, BLOCK, phase);
+            const float *output = eq.process(samples.data(), BLOCK);
+            if (block == blocks - 1) {
+                for (size_t frame = 0; frame < BLOCK; ++frame) {
+                    peak = std::max(peak, std::abs(output[frame * 2]));
+                }
+            }
+        }
+        return peak / 0.25f;
+    }
+}
+
+TEST(EqualizerTest, BypassedWithoutBands) {
+    WaveMux::Equalizer eq(SAMPLE_RATE);
+    auto block = constantBlock(0.5f);
+    EXPECT_EQ(eq.process(block.data(), BLOCK), block.data());
+
+    WaveMux::EqBand band;
+    band.enabled = false;
+    eq.setBands({band});
+    EXPECT_EQ(eq.process(block.data(), BLOCK), block.data());
+}
+
+TEST(EqualizerTest, PeakBoostsCenterFrequency) {
+    WaveMux::Equalizer eq(SAMPLE_RATE);
+    WaveMux::EqBand band;
+    band.frequency = 1000.0f;
+    band.gainDb = 6.0f;
+    band.q = 1.0f;
+    eq.setBands({band});
+
+    EXPECT_NEAR(equalizedPeak(eq, 1000.0f), 2.0f, 0.05f);
+    EXPECT_NEAR(equalizedPeak(eq, 12000.0f), 1.0f, 0.05f);
+}
+
+TEST(EqualizerTest, HighPassCutsRumble) {
+    WaveMux::Equalizer eq(SAMPLE_RATE);
+    WaveMux::EqBand band;
+    band.type = WaveMux::EqBandType::HighPass;
+    band.frequency = 120.0f;
+    eq.setBands({band});
+
+    EXPECT_LT(equalizedPeak(eq, 30.0f, 400), 0.1f);  // About -24 dB two octaves down
+    EXPECT_NEAR(equalizedPeak(eq, 3000.0f), 1.0f, 0.02f);
+}
+
+TEST(EqualizerTest, ShelvesAndCascade) {
+    WaveMux::Equalizer eq(SAMPLE_RATE);
+    WaveMux::EqBand low;
+    low.type = WaveMux::EqBandType::LowShelf;
+    low.frequency = 200.0f;
+    low.gainDb = -6.0f;
+    WaveMux::EqBand high;
+    high.type = WaveMux::EqBandType::HighShelf;
+    high.frequency = 4000.0f;
+    high.gainDb = 6.0f;
+    eq.setBands({low, high});
+
+    EXPECT_NEAR(equalizedPeak(eq, 40.0f, 400), 0.5f, 0.03f);
+    EXPECT_NEAR(equalizedPeak(eq, 18000.0f), 2.0f, 0.1f);
+    EXPECT_NEAR(equalizedPeak(eq, 1000.0f), 1.0f, 0.1f);
+}
+
+TEST(EqualizerTest, ChannelsStayIndependent) {
+    WaveMux::Equalizer eq(SAMPLE_RATE);
+    WaveMux::EqBand band;
+    band.gainDb = 12.0f;
+    eq.setBands({band});
+
+    std::vector<float> samples(BLOCK * 2, 0.0f);
+    for (size_t frame = 0; frame < BLOCK; ++frame) {
+        samples[frame * 2] = std::sin(0.1f * frame);  // Left only
+    }
+    const float *output = eq.process(samples.data(), BLOCK);
+    for (size_t frame = 0; frame < BLOCK; ++frame) {
+        EXPECT_FLOAT_EQ(output[frame * 2 + 1], 0.0f);
+    }
+}
+
+TEST(EqualizerTest, GainChangesGlide) {
+    WaveMux::Equalizer eq(SAMPLE_RATE);
+    WaveMux::EqBand band;
+    band.frequency = 1000.0f;
+    band.q = 1.0f;
+    eq.setBands({band});
+    EXPECT_NEAR(equalizedPeak(eq, 1000.0f), 1.0f, 0.02f);
+
+    band.gainDb = 12.0f;
+    eq.setBands({band});
+    const float firstBlock = equalizedPeak(eq, 1000.0f, 1);
+    EXPECT_GT(firstBlock, 1.0f);
+    EXPECT_LT(firstBlock, 2.0f);  // Far from the +12 dB target right away
+    EXPECT_NEAR(equalizedPeak(eq, 1000.0f, 200), 3.98f, 0.1f);
+}
+
+TEST(TripleBufferTest, ReaderSeesLatestValue) {
+    WaveMux::TripleBuffer<int> buffer;
+    EXPECT_FALSE(buffer.update());
+
+    buffer.back() = 1;
+    buffer.publish();
+    buffer.back() = 2;
+    buffer.publish();
+    EXPECT_TRUE(buffer.update());
+    EXPECT_EQ(buffer.front(), 2);
+    EXPECT_FALSE(buffer.update());
+    EXPECT_EQ(buffer.front(), 2);
+}
+
+TEST(MixGraphTest, AppliesStripEq) {
+    WaveMux::MixGraph graph(2, SAMPLE_RATE);
+    graph.setStripGain(0, 1.0f);
+    graph.setStripGain(1, 1.0f);
+
+    WaveMux::EqBand band;
+    band.type = WaveMux::EqBandType::LowPass;
+    band.frequency = 100.0f;
+    graph.setStripEq(1, {band});
+
+    // Strip 1 carries a high tone the low-pass removes; strip 0 is silent
+    auto silence = constantBlock(0.0f);
+    size_t phase = 0;
+    std::vector<float> output(BLOCK * 2);
+    float peak = 0.0f;
+    for (int block = 0; block < 20; ++block) {
+        auto tone = sineBlock(0.5f, 10000.0f, BLOCK, phase);
+        const float *inputs[] = {silence.data(), tone.data()};
+        graph.process(inputs, output.data(), BLOCK);
+        peak = 0.0f;
+        for (float sample : output) {
+            peak = std::max(peak, std::abs(sample));
+        }
+    }
+    EXPECT_LT(peak, 0.01f);
+}
+
+namespace {
+    WaveMux::NoiseGateSettings gateSettings() {
+        WaveMux::NoiseGateSettings settings;
+        settings.enabled = true;
+        settings.thresholdDb = -40.0f;
+        settings.rangeDb = 60.0f;
+        return settings;
+    }
+}
+
+TEST(NoiseGateTest, DisabledIsBypassed) {
+    WaveMux::NoiseGate gate(SAMPLE_RATE);
+    EXPECT_TRUE(gate.isBypassed());
+    auto block = constantBlock(0.001f);
+    gate.process(block.data(), BLOCK, 2);
+    EXPECT_FLOAT_EQ(block.back(), 0.001f);
+}
+
+TEST(NoiseGateTest, ClosesOnBackgroundNoise) {
+    WaveMux::NoiseGate gate(SAMPLE_RATE);
+    gate.setSettings(gateSettings());
+    EXPECT_FALSE(gate.isBypassed());
+
+    size_t phase = 0;
+    std::vector<float> block;
+    for (int i = 0; i < 100; ++i) {  // ~0.5 s of -60 dBFS hum
+        block = sineBlock(0.001f, 100.0f, BLOCK, phase);
+        gate.process(block.data(), BLOCK, 2);
+    }
+    EXPECT_FALSE(gate.isOpen());
+    EXPECT_NEAR(gate.gainReductionDb(), 60.0f, 1.0f);
+    for (float sample : block) {
+        EXPECT_LT(std::abs(sample), 1e-5f);
+    }
+}
+
+TEST(NoiseGateTest, OpensQuicklyForSpeech) {
+    WaveMux::NoiseGate gate(SAMPLE_RATE);
+    gate.setSettings(gateSettings());
+
+    size_t phase = 0;
+    for (int i = 0; i < 100; ++i) {
+        auto block = sineBlock(0.001f, 100.0f, BLOCK, phase);
+        gate.process(block.data(), BLOCK, 2);
+    }
+    ASSERT_FALSE(gate.isOpen());
+
+    // -14 dBFS: open (and at full gain) within the first block
+    auto block = sineBlock(0.2f, 300.0f, BLOCK, phase);
+    gate.process(block.data(), BLOCK, 2);
+    EXPECT_TRUE(gate.isOpen());
+    EXPECT_LT(gate.gainReductionDb(), 0.1f);
+}
+
+TEST(NoiseGateTest, HoldsThroughShortPauses) {
+    WaveMux::NoiseGate gate(SAMPLE_RATE);
+    gate.setSettings(gateSettings());
+
+    size_t phase = 0;
+    auto loud = sineBlock(0.2f, 300.0f, BLOCK, phase);
+    gate.process(loud.data(), BLOCK, 2);
+
+    // A 20 ms gap between words is shorter than the 80 ms hold
+    for (int i = 0; i < 4; ++i) {
+        auto silence = constantBlock(0.0f);
+        gate.process(silence.data(), BLOCK, 2);
+    }
+    EXPECT_TRUE(gate.isOpen());
+
+    // ... but a long pause closes it
+    for (int i = 0; i < 40; ++i) {
+        auto silence = constantBlock(0.0f);
+        gate.process(silence.data(), BLOCK, 2);
+    }
+    EXPECT_FALSE(gate.isOpen());
+}
+
+TEST(MixGraphTest, GatesStripBeforeMixing) {
+    WaveMux::MixGraph graph(1, SAMPLE_RATE);
+    graph.setStripGain(0, 1.0f);
+    graph.setStripGate(0, gateSettings());
+    ASSERT_NE(graph.stripGate(0), nullptr);
+    EXPECT_EQ(graph.stripGate(1), nullptr);
+
+    size_t phase = 0;
+    std::vector<float> output(BLOCK * 2);
+    for (int i = 0; i < 100; ++i) {
+        auto hum = sineBlock(0.001f, 100.0f, BLOCK, phase);
+        const float *inputs[] = {hum.data()};
+        graph.process(inputs, output.data(), BLOCK);
+    }
+    EXPECT_FALSE(graph.stripGate(0)->isOpen());
+    EXPECT_LT(std::abs(output.back()), 1e-5f);
+}
+
+TEST(SpectrumAnalyzerTest, MatchesDirectDft) {
+    WaveMux::SpectrumAnalyzer analyzer(SAMPLE_RATE);
+    constexpr size_t N = WaveMux::SpectrumAnalyzer::FFT_SIZE;
+    std::vector<float> samples(N);
+    uint32_t seed = 12345;
+    for (auto &sample : samples) {
+        seed = seed * 1664525u + 1013904223u;
+        sample = static_cast<float>(seed >> 8) / (1 << 24) - 0.5f;
+    }
+    std::vector<float> bands(WaveMux::SpectrumAnalyzer::BANDS);
+    analyzer.analyze(samples.data(), bands.data());
+
+    for (size_t k : {0u, 1u, 7u, 100u, 511u, 512u}) {
+        double re = 0.0;
+        double im = 0.0;
+        for (size_t n = 0; n < N; ++n) {
+            const double windowed = samples[n] * (0.5 - 0.5 * std::cos(2.0 * M_PI * n / N));
+            re += windowed * std::cos(2.0 * M_PI * k * n / N);
+            im -= windowed * std::sin(2.0 * M_PI * k * n / N);
+        }
+        const double power = (re * re + im * im) * 16.0 / (double(N) * N);
+        EXPECT_NEAR(analyzer.binPowers()[k], power, 1e-4 * std::max(1.0, power)) << "bin " << k;
+    }
+}
+
+TEST(SpectrumAnalyzerTest, FullScaleSineReadsZeroDbInItsBand) {
+    WaveMux::SpectrumAnalyzer analyzer(SAMPLE_RATE);
+    size_t phase = 0;
+    // sineBlock is interleaved stereo; take the left channel
+    auto stereo = sineBlock(1.0f, 1000.0f, WaveMux::SpectrumAnalyzer::FFT_SIZE, phase);
+    std::vector<float> samples(WaveMux::SpectrumAnalyzer::FFT_SIZE);
+    for (size_t i = 0; i < samples.size(); ++i) {
+        samples[i] = stereo[2 * i];
+    }
+
+    std::vector<float> bands(WaveMux::SpectrumAnalyzer::BANDS);
+    analyzer.analyze(samples.data(), bands.data());
+
+    size_t loudest = 0;
+    for (size_t band = 0; band < bands.size(); ++band) {
+        if (bands[band] > bands[loudest]) {
+            loudest = band;
+        }
+    }
+    EXPECT_NEAR(analyzer.bandCenter(loudest), 1000.0f, 150.0f);
+    EXPECT_NEAR(bands[loudest], 0.0f, 1.5f);  // Hann scalloping is at most 1.4 dB
+    EXPECT_LT(bands[0], -60.0f);
+    EXPECT_LT(bands.back(), -60.0f);
+}
+
+TEST(SpectrumAnalyzerTest, SilenceSitsOnTheFloor) {
+    WaveMux::SpectrumAnalyzer analyzer(SAMPLE_RATE);
+    std::vector<float> silence(WaveMux::SpectrumAnalyzer::FFT_SIZE, 0.0f);
+    std::vector<float> bands(WaveMux::SpectrumAnalyzer::BANDS);
+    analyzer.analyze(silence.data(), bands.data());
+    for (float level : bands) {
+        EXPECT_FLOAT_EQ(level, WaveMux::SpectrumAnalyzer::FLOOR_DB);
+    }
+}
+
+TEST(DelayLineTest, DelaysByExactFrameCount) {
+    WaveMux::DelayLine line(1000, 2);
+    line.setDelay(300);
+
+    // A ramp in 256-frame blocks; frame n comes out as frame n + 300
+    std::vector<float> input(BLOCK * 2);
+    std::vector<float> output;
+    for (int block = 0; block < 8; ++block) {
+        for (size_t frame = 0; frame < BLOCK; ++frame) {
+            input[frame * 2] = static_cast<float>(block * BLOCK + frame + 1);
+            input[frame * 2 + 1] = -input[frame * 2];
+        }
+        const float *delayed = line.process(input.data(), BLOCK);
+        output.insert(output.end(), delayed, delayed + BLOCK * 2);
+    }
+
+    // The first block crossfades in from no delay; after that it is exact
+    for (size_t frame = BLOCK; frame < output.size() / 2; ++frame) {
+        const float expected = frame >= 300 ? static_cast<float>(frame - 300 + 1) : 0.0f;
+        ASSERT_FLOAT_EQ(output[frame * 2], expected) << "frame " << frame;
+        ASSERT_FLOAT_EQ(output[frame * 2 + 1], -expected);
+    }
+}
+
+TEST(DelayLineTest, ZeroDelayPassesInputThrough) {
+    WaveMux::DelayLine line(1000, 2);
+    auto input = constantBlock(0.5f);
+    EXPECT_EQ(line.process(input.data(), BLOCK), input.data());
+
+    // History is kept while bypassed, so a delay picks up real audio at once
+    line.setDelay(100);
+    auto silence = constantBlock(0.0f);
+    const float *delayed = line.process(silence.data(), BLOCK);
+    // Crossfading in: the first 100 frames are the previous block's audio
+    EXPECT_FLOAT_EQ(delayed[99 * 2 + 1], 0.5f * 100.0f / BLOCK);
+    EXPECT_FLOAT_EQ(delayed[100 * 2], 0.0f);
+}
+
+TEST(DelayLineTest, ClampsToMaximum) {
+    WaveMux::DelayLine line(480, 2);
+    line.setDelay(100000);
+    EXPECT_EQ(line.delay(), 480u);
+}
+
+TEST(ImpulseProbeTest, FindsProbeUnderNoiseToTheSample) {
+    WaveMux::ImpulseProbe probe(SAMPLE_RATE);
+    std::vector<float> recording(24000);
+    uint32_t seed = 1;
+    for (auto &sample : recording) {
+        seed = seed * 1664525u + 1013904223u;
+        sample = 0.05f * (static_cast<float>(seed >> 8) / 8388608.0f - 1.0f);
+    }
+    const size_t at = 12345;
+    for (size_t i = 0; i < probe.signal().size(); ++i) {
+        recording[at + i] += 0.3f * probe.signal()[i];
+    }
+
+    auto found = probe.find(recording.data(), recording.size());
+    ASSERT_TRUE(found.has_value());
+    EXPECT_EQ(*found, at);
+}
+
+TEST(ImpulseProbeTest, IgnoresRecordingsWithoutIt) {
+    WaveMux::ImpulseProbe probe(SAMPLE_RATE);
+    std::vector<float> silence(24000, 0.0f);
+    EXPECT_FALSE(probe.find(silence.data(), silence.size()).has_value());
+
+    size_t phase = 0;
+    auto tone = sineBlock(0.5f, 1000.0f, 12000, phase);
+    std::vector<float> mono(12000);
+    for (size_t i = 0; i < mono.size(); ++i) {
+        mono[i] = tone[i * 2];
+    }
+    EXPECT_FALSE(probe.find(mono.data(), mono.size()).has_value());
+}
+
+TEST(MixGraphTest, AlignsStripsWithDelays) {
+    // The same click arrives 64 frames early on strip 0; delaying it lines it up
+    WaveMux::MixGraph graph(2, SAMPLE_RATE);
+    graph.setStripGain(0, 1.0f);
+    graph.setStripGain(1, 1.0f);
+    graph.setStripDelay(0, 64);
+    EXPECT_EQ(graph.stripDelay(0), 64u);
+    EXPECT_EQ(graph.maxDelayFrames(), static_cast<size_t>(SAMPLE_RATE / 2));
+
+    auto silence = constantBlock(0.0f);
+    std::vector<float> output(BLOCK * 2);
+    const float *quiet[] = {silence.data(), silence.data()};
+    graph.process(quiet, output.data(), BLOCK);  // Delay settles
+
+    auto early = constantBlock(0.0f);
+    auto late = constantBlock(0.0f);
+    early[10 * 2] = early[10 * 2 + 1] = 0.25f;
+    late[74 * 2] = late[74 * 2 + 1] = 0.25f;
+    const float *inputs[] = {early.data(), late.data()};
+    graph.process(inputs, output.data(), BLOCK);
+
+    EXPECT_FLOAT_EQ(output[74 * 2], 0.5f);
+    EXPECT_FLOAT_EQ(output[10 * 2], 0.0f);
+}
@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <vector>
+#include "eventlog.h"
+
+using WaveMux::EventLog;
+using WaveMux::RateLimiter;
+
+class EventLogTest : public ::testing::Test {
+protected:
+    void SetUp() override { EventLog::clear(); }
+    void TearDown() override { EventLog::clear(); }
+};
+
+TEST_F(EventLogTest, RecordsOperationsInOrder) {
+    EventLog::record(EventLog::Code::DBusCall, "SetChannelVolume");
+    EventLog::record(EventLog::Code::ChannelVolume, "game", 80);
+    EventLog::record(EventLog::Code::AppMute, "firefox", 42, 1);
+
+    const auto events = EventLog::events();
+    ASSERT_EQ(events.size(), 3u);
+    EXPECT_EQ(events[0].code, EventLog::Code::DBusCall);
+    EXPECT_STREQ(events[1].subject, "game");
+    EXPECT_EQ(events[1].a, 80);
+    EXPECT_EQ(events[2].b, 1);
+    EXPECT_LE(events[0].timeUs, events[2].timeUs);
+
+    const std::string text = EventLog::text();
+    EXPECT_NE(text.find("dbus.call"), std::string::npos);
+    EXPECT_NE(text.find("channel.volume     game 80\n"), std::string::npos);
+    EXPECT_NE(text.find("app.mute           firefox 42 1\n"), std::string::npos);
+    // Arguments a code doesn't use are left out
+    EXPECT_NE(text.find("SetChannelVolume\n"), std::string::npos);
+}
+
+TEST_F(EventLogTest, KeepsTheNewestEventsWhenTheRingWraps) {
+    const size_t total = EventLog::CAPACITY + 100;
+    for (size_t i = 0; i < total; ++i) {
+        EventLog::record(EventLog::Code::StreamAdded, "app", static_cast<int64_t>(i));
+    }
+    EXPECT_EQ(EventLog::eventCount(), EventLog::CAPACITY);
+
+    const auto events = EventLog::events();
+    ASSERT_EQ(events.size(), EventLog::CAPACITY);
+    EXPECT_EQ(events.front().a, 100);
+    EXPECT_EQ(events.back().a, static_cast<int64_t>(total - 1));
+
+    const auto newest = EventLog::events(10);
+    ASSERT_EQ(newest.size(), 10u);
+    EXPECT_EQ(newest.front().a, static_cast<int64_t>(total - 10));
+}
+
+TEST_F(EventLogTest, CutsLongSubjects) {
+    const std::string command(200, 'x');
+    EventLog::record(EventLog::Code::CommandTimedOut, command);
+    const auto events = EventLog::events();
+    ASSERT_EQ(events.size(), 1u);
+    EXPECT_EQ(std::string(events[0].subject), command.substr(0, EventLog::SUBJECT_BYTES - 1));
+}
+
+TEST_F(EventLogTest, RecordsFromManyThreads) {
+    constexpr int THREADS = 4;
+    constexpr int PER_THREAD = 500;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; ++t) {
+        threads.emplace_back([] {
+            for (int i = 0; i < PER_THREAD; ++i) {
+                EventLog::record(EventLog::Code::Xrun, "alsa_output", i, 0);
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(EventLog::events().size(), static_cast<size_t>(THREADS * PER_THREAD));
+}
+
+TEST(RateLimiterTest, AllowsABurstPerWindowAndCountsTheRest) {
+    RateLimiter limiter(3, 1000);
+    uint64_t suppressed = 0;
+    int allowed = 0;
+    for (int i = 0; i < 10; ++i) {
+        allowed += limiter.allow(5000 + i, &suppressed) ? 1 : 0;
+        EXPECT_EQ(suppressed, 0u);
+    }
+    EXPECT_EQ(allowed, 3);
+
+    // The first message of the next window reports what was dropped
+    EXPECT_TRUE(limiter.allow(6000, &suppressed));
+    EXPECT_EQ(suppressed, 7u);
+    EXPECT_TRUE(limiter.allow(6001, &suppressed));
+    EXPECT_EQ(suppressed, 0u);
+
+    // A quiet window reports nothing
+    EXPECT_TRUE(limiter.allow(9000, &suppressed));
+    EXPECT_EQ(suppressed, 0u);
+}
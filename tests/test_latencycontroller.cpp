@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+#include "latencycontroller.h"
+
+using WaveMux::LatencyController;
+using WaveMux::LatencyControllerSettings;
+
+namespace {
+    LatencyControllerSettings quickSettings() {
+        LatencyControllerSettings settings;
+        settings.minMs = 20;
+        settings.maxMs = 300;
+        settings.stepMs = 10;
+        settings.stableWindows = 3;
+        settings.backoff = 1.5;
+        settings.floorWindows = 100;
+        settings.holdWindows = 0;
+        return settings;
+    }
+
+    // Stable windows until the next change (or the limit)
+    int runStable(LatencyController &controller, int windows) {
+        int changes = 0;
+        for (int i = 0; i < windows; ++i) {
+            changes += controller.update(0) ? 1 : 0;
+        }
+        return changes;
+    }
+}
+
+TEST(LatencyControllerTest, LowersWhileStable) {
+    LatencyController controller(150, quickSettings());
+    EXPECT_FALSE(controller.update(0));
+    EXPECT_FALSE(controller.update(0));
+    EXPECT_TRUE(controller.update(0));
+    EXPECT_EQ(controller.latencyMs(), 140);
+
+    runStable(controller, 1000);
+    EXPECT_EQ(controller.latencyMs(), 20);
+    EXPECT_EQ(runStable(controller, 30), 0);
+}
+
+TEST(LatencyControllerTest, BacksOffAndRemembersTheFailure) {
+    LatencyController controller(40, quickSettings());
+    EXPECT_TRUE(controller.update(2));
+    EXPECT_EQ(controller.latencyMs(), 60);
+    EXPECT_EQ(controller.floorMs(), 50);
+
+    // Settles one step above the latency that failed
+    runStable(controller, 50);
+    EXPECT_EQ(controller.latencyMs(), 50);
+
+    // A second failure raises the floor again
+    EXPECT_TRUE(controller.update(1));
+    EXPECT_EQ(controller.latencyMs(), 75);
+    runStable(controller, 50);
+    EXPECT_EQ(controller.latencyMs(), 60);
+}
+
+TEST(LatencyControllerTest, FloorLapsesAfterALongStableStretch) {
+    LatencyController controller(40, quickSettings());
+    controller.update(1);
+    runStable(controller, 99);
+    EXPECT_EQ(controller.latencyMs(), 50);
+    runStable(controller, 1);
+    EXPECT_EQ(controller.floorMs(), 20);
+    runStable(controller, 30);
+    EXPECT_EQ(controller.latencyMs(), 20);
+}
+
+TEST(LatencyControllerTest, HoldsEachNewLatencyBeforeLoweringAgain) {
+    LatencyControllerSettings settings = quickSettings();
+    settings.holdWindows = 10;
+    LatencyController controller(150, settings);
+    EXPECT_EQ(runStable(controller, 3), 1);
+    EXPECT_EQ(controller.latencyMs(), 140);
+
+    // Held, then a full stable stretch again
+    EXPECT_EQ(runStable(controller, 12), 0);
+    EXPECT_TRUE(controller.update(0));
+    EXPECT_EQ(controller.latencyMs(), 130);
+
+    // A hold never delays backing off
+    EXPECT_TRUE(controller.update(1));
+    EXPECT_EQ(controller.latencyMs(), 195);
+}
+
+TEST(LatencyControllerTest, StaysWithinLimits) {
+    LatencyController controller(1000, quickSettings());
+    EXPECT_EQ(controller.latencyMs(), 300);
+    EXPECT_FALSE(controller.update(5));
+    EXPECT_EQ(controller.latencyMs(), 300);
+
+    controller.reset(5);
+    EXPECT_EQ(controller.latencyMs(), 20);
+    EXPECT_EQ(controller.floorMs(), 20);
+    EXPECT_TRUE(controller.update(1));
+    EXPECT_EQ(controller.latencyMs(), 30);
+}
@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+#include <QStringList>
+#include "listmodels.h"
+
+using WaveMux::Channel;
+using WaveMux::ChannelModel;
+using WaveMux::Stream;
+using WaveMux::StreamModel;
+
+namespace {
+    Channel channel(const QString &id, int volume = 100) {
+        Channel result;
+        result.id = id;
+        result.displayName = id.toUpper();
+        result.volume = volume;
+        return result;
+    }
+
+    Stream stream(uint32_t id, const QString &appName) {
+        Stream result;
+        result.id = id;
+        result.appName = appName;
+        return result;
+    }
+
+    // Every structural change and data change the model announces
+    struct ModelLog {
+        explicit ModelLog(QAbstractItemModel *model) {
+            QObject::connect(model, &QAbstractItemModel::rowsInserted, [this](const QModelIndex &, int first, int) {
+                changes << QString("insert %1").arg(first);
+            });
+            QObject::connect(model, &QAbstractItemModel::rowsRemoved, [this](const QModelIndex &, int first, int) {
+                changes << QString("remove %1").arg(first);
+            });
+            QObject::connect(model, &QAbstractItemModel::rowsMoved,
+                             [this](const QModelIndex &, int first, int, const QModelIndex &, int destination) {
+                changes << QString("move %1 %2").arg(first).arg(destination);
+            });
+            QObject::connect(model, &QAbstractItemModel::dataChanged,
+                             [this](const QModelIndex &topLeft, const QModelIndex &, const QList<int> &roles) {
+                changes << QString("change %1").arg(topLeft.row());
+                changedRoles = roles;
+            });
+            QObject::connect(model, &QAbstractItemModel::modelReset, [this]() { changes << "reset"; });
+        }
+
+        QStringList changes;
+        QList<int> changedRoles;
+    };
+}
+
+TEST(ListModelsTest, UnchangedListsAnnounceNothing) {
+    ChannelModel model;
+    model.setItems({channel("game"), channel("chat")});
+    ModelLog log(&model);
+    model.setItems({channel("game"), channel("chat")});
+    EXPECT_TRUE(log.changes.isEmpty()) << log.changes.join(", ").toStdString();
+    EXPECT_EQ(model.count(), 2);
+}
+
+TEST(ListModelsTest, OneChangedLevelTouchesOneRoleOfOneRow) {
+    ChannelModel model;
+    model.setItems({channel("game"), channel("chat"), channel("media")});
+    ModelLog log(&model);
+
+    model.setItems({channel("game"), channel("chat", 40), channel("media")});
+    EXPECT_EQ(log.changes, QStringList{"change 1"});
+    EXPECT_EQ(log.changedRoles, QList<int>{ChannelModel::VolumeRole});
+    EXPECT_EQ(model.data(model.index(1), ChannelModel::VolumeRole).toInt(), 40);
+
+    log.changes.clear();
+    Channel muted = channel("media");
+    muted.muted = true;
+    EXPECT_TRUE(model.setItem(muted));
+    EXPECT_EQ(log.changes, QStringList{"change 2"});
+    EXPECT_FALSE(model.setItem(channel("aux")));
+}
+
+TEST(ListModelsTest, StreamsComingAndGoingAreRowInsertsAndRemovals) {
+    StreamModel model;
+    model.setItems({stream(10, "firefox"), stream(11, "discord")});
+    ModelLog log(&model);
+    int countChanges = 0;
+    QObject::connect(&model, &StreamModel::countChanged, [&countChanges]() { ++countChanges; });
+
+    model.setItems({stream(10, "firefox"), stream(11, "discord"), stream(12, "game")});
+    EXPECT_EQ(log.changes, QStringList{"insert 2"});
+
+    log.changes.clear();
+    model.setItems({stream(11, "discord"), stream(12, "game")});
+    EXPECT_EQ(log.changes, QStringList{"remove 0"});
+
+    log.changes.clear();
+    EXPECT_TRUE(model.removeItem("12"));
+    EXPECT_FALSE(model.removeItem("12"));
+    EXPECT_EQ(log.changes, QStringList{"remove 1"});
+    EXPECT_EQ(countChanges, 3);
+    EXPECT_EQ(model.indexOf(11u), 0);
+    EXPECT_EQ(model.indexOf(12u), -1);
+}
+
+TEST(ListModelsTest, ReorderedItemsMoveInsteadOfBeingRecreated) {
+    ChannelModel model;
+    model.setItems({channel("game"), channel("chat"), channel("media")});
+    ModelLog log(&model);
+
+    model.setItems({channel("media"), channel("game"), channel("chat")});
+    EXPECT_FALSE(log.changes.contains("reset"));
+    EXPECT_EQ(log.changes.filter("insert").size(), 0);
+    EXPECT_EQ(log.changes.filter("remove").size(), 0);
+    ASSERT_EQ(model.count(), 3);
+    EXPECT_EQ(model.items().at(0).id, "media");
+    EXPECT_EQ(model.items().at(1).id, "game");
+    EXPECT_EQ(model.items().at(2).id, "chat");
+}
+
+TEST(ListModelsTest, GetReturnsEveryRoleByName) {
+    StreamModel model;
+    model.setItems({stream(7, "spotify")});
+    const QVariantMap row = model.get(0);
+    EXPECT_EQ(row.value("streamId").toUInt(), 7u);
+    EXPECT_EQ(row.value("appName").toString(), "spotify");
+    EXPECT_EQ(row.value("volume").toInt(), 100);
+    EXPECT_TRUE(model.get(1).isEmpty());
+}
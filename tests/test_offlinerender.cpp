@@ -0,0 +1,210 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <unistd.h>
+#include <vector>
+#include "offlinerender.h"
+#include "wavfilereader.h"
+#include "wavfilewriter.h"
+
+using WaveMux::OfflineRenderer;
+using WaveMux::RenderLevels;
+using WaveMux::RenderScript;
+
+namespace {
+    constexpr float SAMPLE_RATE = 48000.0f;
+    constexpr size_t CHANNELS = WaveMux::MixGraph::CHANNELS;
+
+    std::vector<float> sine(float frequency, float amplitude, size_t frames) {
+        std::vector<float> samples(frames * CHANNELS);
+        for (size_t frame = 0; frame < frames; ++frame) {
+            const float value = amplitude * std::sin(2.0f * float(M_PI) * frequency * frame / SAMPLE_RATE);
+            samples[frame * CHANNELS] = value;
+            samples[frame * CHANNELS + 1] = value;
+        }
+        return samples;
+    }
+
+    std::vector<float> mixOf(const std::vector<float> &a, float gainA, const std::vector<float> &b, float gainB) {
+        std::vector<float> mix(a.size());
+        for (size_t i = 0; i < a.size(); ++i) {
+            mix[i] = a[i] * gainA + b[i] * gainB;
+        }
+        return mix;
+    }
+
+    std::vector<float> slice(const std::vector<float> &samples, size_t fromFrame, size_t toFrame) {
+        return std::vector<float>(samples.begin() + fromFrame * CHANNELS, samples.begin() + toFrame * CHANNELS);
+    }
+
+    RenderScript parsed(const char *text) {
+        RenderScript script;
+        std::string error;
+        EXPECT_TRUE(script.parse(text, &error)) << error;
+        return script;
+    }
+
+    std::string tempPath(const char *name) {
+        return std::string("/tmp/wavemux_test_") + std::to_string(getpid()) + "_" + name;
+    }
+}
+
+TEST(OfflineRenderTest, MixesAreTheSumOfTheirLevels) {
+    const size_t frames = 4800;
+    const auto game = sine(440.0f, 0.5f, frames);
+    const auto chat = sine(660.0f, 0.5f, frames);
+
+    OfflineRenderer renderer(SAMPLE_RATE);
+    renderer.setInput("game", game);
+    renderer.setInput("chat", chat);
+    renderer.setLevels("game", RenderLevels{100, false, 100, 50});
+    renderer.setLevels("chat", RenderLevels{100, false, 80, 100});
+    EXPECT_FALSE(renderer.setInput("mic", game));
+
+    const auto result = renderer.render();
+    ASSERT_EQ(result.frames, frames);
+    const auto stream = mixOf(game, WaveMux::percentToGain(50), chat, 1.0f);
+    const auto personal = mixOf(game, 1.0f, chat, WaveMux::percentToGain(80));
+    EXPECT_LT(WaveMux::compareSignals(result.stream, stream).maxError, 1e-6f);
+    EXPECT_LT(WaveMux::compareSignals(result.personal, personal).maxError, 1e-6f);
+    EXPECT_GT(result.realtimeFactor, 0.0);
+}
+
+TEST(OfflineRenderTest, LevelChangesTakeEffectAtTheNextBlock) {
+    const size_t frames = 4096;
+    const auto game = std::vector<float>(frames * CHANNELS, 0.5f);
+
+    OfflineRenderer renderer(SAMPLE_RATE);
+    renderer.setInput("game", game);
+    RenderScript script;
+    script.add({5.0, RenderScript::Command::Mute, "game", 1});  // Frame 240, inside the first block
+
+    const auto result = renderer.render(script);
+    const size_t block = OfflineRenderer::BLOCK_FRAMES;
+    EXPECT_FLOAT_EQ(result.personal[(block - 1) * CHANNELS], 0.5f);
+    // Ramps down across the second block...
+    EXPECT_NEAR(result.personal[(block + block / 2 - 1) * CHANNELS], 0.25f, 1e-6f);
+    // ...and stays down
+    EXPECT_FLOAT_EQ(result.personal[(2 * block - 1) * CHANNELS], 0.0f);
+    EXPECT_FLOAT_EQ(result.personal.back(), 0.0f);
+    EXPECT_TRUE(renderer.levels("game").muted);
+}
+
+TEST(OfflineRenderTest, ScriptedChangesDoNotClick) {
+    const size_t frames = static_cast<size_t>(SAMPLE_RATE * 2);
+    const auto game = sine(440.0f, 0.8f, frames);
+    const auto chat = sine(1000.0f, 0.5f, frames);
+
+    OfflineRenderer renderer(SAMPLE_RATE);
+    renderer.setInput("game", game);
+    renderer.setInput("chat", chat);
+    const RenderScript script = parsed(R"(
+        profile quiet game volume=40 stream=100
+        profile quiet chat muted=on
+
+        0     stream game 50
+        0     stream chat 100
+        100   volume game 20
+        250   mute chat on
+        400   mute chat off
+        600   master 60
+        800   personal game 0
+        1000  personal game 100
+        1200  master 100
+        1500  profile quiet
+    )");
+    const auto result = renderer.render(script);
+
+    const float threshold = 1.5f * (WaveMux::maxSecondDifference(game) + WaveMux::maxSecondDifference(chat));
+    EXPECT_TRUE(WaveMux::findDiscontinuities(result.personal, threshold).empty());
+    EXPECT_TRUE(WaveMux::findDiscontinuities(result.stream, threshold).empty());
+
+    // After the profile switch the Stream mix is game alone at 40% volume
+    const size_t settled = static_cast<size_t>(SAMPLE_RATE * 1.6);
+    const auto expected = mixOf(game, WaveMux::percentToGain(40), chat, 0.0f);
+    const auto difference = WaveMux::compareSignals(slice(result.stream, settled, frames),
+                                                    slice(expected, settled, frames));
+    EXPECT_LT(difference.maxError, 1e-6f);
+}
+
+TEST(OfflineRenderTest, FindsAGainStep) {
+    auto samples = sine(440.0f, 0.8f, 4800);
+    const size_t step = 1000;
+    for (size_t i = step * CHANNELS; i < samples.size(); ++i) {
+        samples[i] *= 0.25f;
+    }
+    const float threshold = 2.0f * WaveMux::maxSecondDifference(sine(440.0f, 0.8f, 4800));
+    const auto glitches = WaveMux::findDiscontinuities(samples, threshold);
+    ASSERT_EQ(glitches.size(), 1u);
+    EXPECT_EQ(glitches[0], step);
+
+    const auto difference = WaveMux::compareSignals(samples, sine(440.0f, 0.8f, 4800));
+    EXPECT_GT(difference.maxError, 0.1f);
+    EXPECT_GE(difference.frame, step);
+}
+
+TEST(OfflineRenderTest, ReportsScriptErrorsByLine) {
+    const struct {
+        const char *text;
+        const char *error;
+    } cases[] = {
+        {"0 volume game 80\n0 volume mic 80", "line 2: "},
+        {"0 volume game 101", "line 1: "},
+        {"x volume game 80", "line 1: "},
+        {"0 profile missing", "line 1: "},
+        {"# comment\n\nprofile p game loud=1", "line 3: "},
+        {"0 dance", "line 1: unknown command"},
+    };
+    for (const auto &test : cases) {
+        RenderScript script;
+        std::string error;
+        EXPECT_FALSE(script.parse(test.text, &error)) << test.text;
+        EXPECT_EQ(error.rfind(test.error, 0), 0u) << error;
+    }
+
+    const RenderScript script = parsed("500 master 50\n0 mute chat on   # first\n500 master 40\n");
+    ASSERT_EQ(script.events().size(), 3u);
+    EXPECT_EQ(script.events()[0].command, RenderScript::Command::Mute);
+    EXPECT_EQ(script.events()[1].value, 50);
+    EXPECT_EQ(script.events()[2].value, 40);
+}
+
+TEST(OfflineRenderTest, ReadsWavFiles) {
+    const std::string floatPath = tempPath("render_float.wav");
+    const auto samples = sine(440.0f, 0.5f, 1000);
+    WaveMux::WavFileWriter writer;
+    ASSERT_TRUE(writer.open(floatPath, 48000, 2, false));
+    ASSERT_TRUE(writer.write(samples.data(), samples.size()));
+    ASSERT_TRUE(writer.close());
+
+    WaveMux::WavAudio audio;
+    std::string error;
+    ASSERT_TRUE(WaveMux::readWavFile(floatPath, &audio, &error)) << error;
+    EXPECT_EQ(audio.sampleRate, 48000);
+    EXPECT_EQ(audio.channels, 2);
+    EXPECT_EQ(audio.samples, samples);
+    std::remove(floatPath.c_str());
+
+    // 16-bit mono PCM, the minimal 44-byte header
+    const std::string pcmPath = tempPath("render_pcm.wav");
+    {
+        const int16_t pcm[] = {0, 16384, -32768};
+        const auto u32 = [](uint32_t v) { return std::string{char(v), char(v >> 8), char(v >> 16), char(v >> 24)}; };
+        const auto u16 = [](uint16_t v) { return std::string{char(v), char(v >> 8)}; };
+        std::ofstream file(pcmPath, std::ios::binary);
+        file << "RIFF" << u32(36 + sizeof(pcm)) << "WAVE" << "fmt " << u32(16) << u16(1) << u16(1) << u32(44100)
+             << u32(88200) << u16(2) << u16(16) << "data" << u32(sizeof(pcm));
+        file.write(reinterpret_cast<const char *>(pcm), sizeof(pcm));
+    }
+    ASSERT_TRUE(WaveMux::readWavFile(pcmPath, &audio, &error)) << error;
+    EXPECT_EQ(audio.sampleRate, 44100);
+    EXPECT_EQ(audio.channels, 1);
+    ASSERT_EQ(audio.frames(), 3u);
+    EXPECT_FLOAT_EQ(audio.samples[1], 0.5f);
+    EXPECT_FLOAT_EQ(audio.samples[2], -1.0f);
+    std::remove(pcmPath.c_str());
+
+    EXPECT_FALSE(WaveMux::readWavFile(tempPath("missing.wav"), &audio, &error));
+}
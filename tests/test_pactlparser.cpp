@@ -0,0 +1,140 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+#include "pactlparser.h"
+
+using WaveMux::PactlListing;
+
+namespace {
+    // Trimmed `pactl list sink-inputs` output, as libpulse formats it
+    const char *SINK_INPUTS =
+        "Sink Input #40\n"
+        "\tDriver: protocol-native.c\n"
+        "\tOwner Module: 10\n"
+        "\tClient: 25\n"
+        "\tSink: 3\n"
+        "\tSample Specification: s16le 2ch 44100Hz\n"
+        "\tMute: no\n"
+        "\tVolume: front-left: 42598 /  65% / -11.23 dB,   front-right: 42598 /  65% / -11.23 dB\n"
+        "\t        balance 0.00\n"
+        "\tBuffer Latency: 0 usec\n"
+        "\tProperties:\n"
+        "\t\tmedia.name = \"Playback\"\n"
+        "\t\tapplication.name = \"Firefox\"\n"
+        "\t\tapplication.process.binary = \"firefox-bin\"\n"
+        "\n"
+        "Sink Input #41\n"
+        "\tSink: 4\n"
+        "\tMute: yes\n"
+        "\tVolume: mono: 65536 / 100% / 0.00 dB\n"
+        "\tProperties:\n"
+        "\t\tmedia.name = \"Track \\\"Intro\\\" = 1\"\n"
+        "\t\tapplication.name = \"say \"hi\"\"\n"
+        "\t\tmodule.id = \"17\"\n"
+        "\tFormat: pcm, format.sample_format = \"\\\"s16le\\\"\"\n";
+}
+
+TEST(PactlParserTest, TokenizesObjectsFieldsAndProperties) {
+    const PactlListing listing(SINK_INPUTS);
+    ASSERT_EQ(listing.size(), 2u);
+
+    EXPECT_EQ(listing[0].type, "Sink Input");
+    EXPECT_EQ(listing[0].index, 40u);
+    EXPECT_EQ(listing.field(0, "Sink"), "3");
+    EXPECT_EQ(listing.field(0, "Mute"), "no");
+    EXPECT_EQ(listing.field(0, "Buffer Latency"), "0 usec");
+    EXPECT_EQ(listing.property(0, "application.name"), "Firefox");
+    EXPECT_EQ(listing.property(0, "application.process.binary"), "firefox-bin");
+    EXPECT_EQ(PactlListing::volumePercent(listing.field(0, "Volume")), 65);
+
+    // Fields and properties live in separate namespaces
+    EXPECT_EQ(listing.field(0, "media.name"), "");
+    EXPECT_FALSE(listing.hasProperty(0, "Sink"));
+
+    EXPECT_EQ(listing[1].index, 41u);
+    EXPECT_EQ(listing.field(1, "Mute"), "yes");
+    EXPECT_EQ(PactlListing::volumePercent(listing.field(1, "Volume")), 100);
+    EXPECT_EQ(PactlListing::toIndex(listing.property(1, "module.id")), 17u);
+    // A field after the Properties section ends it
+    EXPECT_EQ(listing.field(1, "Format"), "pcm, format.sample_format = \"\\\"s16le\\\"\"");
+
+    EXPECT_EQ(listing.find(41), 1u);
+    EXPECT_FALSE(listing.find(42));
+}
+
+TEST(PactlParserTest, KeepsQuotesInsideValues) {
+    const PactlListing listing(SINK_INPUTS);
+    EXPECT_EQ(listing.property(1, "media.name"), "Track \\\"Intro\\\" = 1");
+    EXPECT_EQ(PactlListing::unescape(listing.property(1, "media.name")), "Track \"Intro\" = 1");
+    // Unescaped quotes (older libpulse) survive too
+    EXPECT_EQ(listing.property(1, "application.name"), "say \"hi\"");
+}
+
+TEST(PactlParserTest, ParsesSinksAndSources) {
+    const PactlListing listing(
+        "Sink #0\n"
+        "\tState: SUSPENDED\n"
+        "\tName: alsa_output.usb-Headset\n"
+        "\tDescription: USB Headset: Analog Stereo\n"
+        "\tPorts:\n"
+        "\t\tanalog-output: Analog Output (type: Unknown, priority: 9900)\n"
+        "\tActive Port: analog-output\n"
+        "\r\n"
+        "Source #1\r\n"
+        "\tName: alsa_input.usb-Headset\r\n");
+    ASSERT_EQ(listing.size(), 2u);
+    EXPECT_EQ(listing[0].type, "Sink");
+    EXPECT_EQ(listing.field(0, "Name"), "alsa_output.usb-Headset");
+    // Only the first colon splits
+    EXPECT_EQ(listing.field(0, "Description"), "USB Headset: Analog Stereo");
+    // Port lines aren't properties
+    EXPECT_FALSE(listing.hasProperty(0, "analog-output: Analog Output (type"));
+    EXPECT_EQ(listing.field(0, "Active Port"), "analog-output");
+    EXPECT_EQ(listing[1].type, "Source");
+    EXPECT_EQ(listing.field(1, "Name"), "alsa_input.usb-Headset");
+}
+
+TEST(PactlParserTest, ToleratesMalformedInput) {
+    EXPECT_EQ(PactlListing("").size(), 0u);
+    EXPECT_EQ(PactlListing("\tName: orphan\n\t\tkey = \"value\"\n").size(), 0u);
+    EXPECT_EQ(PactlListing("Sink #99999999999\n\tName: x\n").size(), 0u);
+    EXPECT_EQ(PactlListing("Sink #\nSink # \n #3\n").size(), 0u);
+
+    // Truncated mid-line: what is there is kept
+    const PactlListing truncated("Sink Input #7\n\tSink: 2\n\tProperties:\n\t\tapplication.name = \"Fire");
+    ASSERT_EQ(truncated.size(), 1u);
+    EXPECT_EQ(truncated.field(0, "Sink"), "2");
+    EXPECT_EQ(truncated.property(0, "application.name"), "\"Fire");
+
+    // An unknown top-level line ends the object
+    const PactlListing interrupted("Sink #1\n\tName: a\nGarbage\n\tName: b\n");
+    EXPECT_EQ(interrupted.field(0, "Name"), "a");
+
+    EXPECT_FALSE(PactlListing::toIndex("12a"));
+    EXPECT_FALSE(PactlListing::toIndex("4294967296"));
+    EXPECT_EQ(PactlListing::toIndex("4294967295"), 4294967295u);
+    EXPECT_FALSE(PactlListing::volumePercent("muted"));
+    EXPECT_FALSE(PactlListing::volumePercent("%"));
+    EXPECT_EQ(PactlListing::unescape("trailing\\"), "trailing\\");
+}
+
+TEST(PactlParserTest, SurvivesRandomInput) {
+    // Quick in-tree stand-in for the libFuzzer target (tests/fuzz)
+    const std::string alphabet = "Sink Input #0123456789\t\n\r :=\"\\%abc.";
+    std::mt19937 random(42);
+    std::string text;
+    for (int run = 0; run < 2000; ++run) {
+        text.resize(random() % 512);
+        for (char &c : text) {
+            c = alphabet[random() % alphabet.size()];
+        }
+        const PactlListing listing(text);
+        for (size_t i = 0; i < listing.size(); ++i) {
+            const auto &object = listing[i];
+            ASSERT_LE(object.begin, object.end);
+            listing.field(i, "Sink");
+            PactlListing::volumePercent(listing.field(i, "Volume"));
+            PactlListing::unescape(listing.property(i, "application.name"));
+        }
+    }
+}
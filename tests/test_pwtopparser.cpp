@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <string>
+#include "pwtopparser.h"
+
+using WaveMux::PwTopSnapshot;
+
+namespace {
+    // One row the way pw-top prints it
+    std::string row(char state, unsigned id, unsigned quantum, unsigned rate, const char *wait, const char *busy,
+                    const char *waitQuantum, const char *busyQuantum, unsigned errors, const char *format,
+                    const char *name, bool follower) {
+        char line[256];
+        std::snprintf(line, sizeof(line), "%c %4.1u %6.1u %6.1u %s %s %s %s  %3.1u %16.16s %s%s\n", state, id,
+                      quantum, rate, wait, busy, waitQuantum, busyQuantum, errors, format, follower ? " + " : "",
+                      name);
+        return line;
+    }
+
+    const char *HEADER = "S   ID  QUANT   RATE    WAIT    BUSY   W/Q   B/Q  ERR FORMAT           NAME \n";
+}
+
+TEST(PwTopParserTest, ParsesDriversAndFollowers) {
+    const std::string text = std::string(HEADER)
+        + row('S', 28, 0, 0, "   --- ", "   --- ", " --- ", " --- ", 0, "", "Dummy-Driver", false)
+        + row('R', 30, 1024, 48000, " 12.3us", " 21.0us", " 0.01", " 0.02", 3, "S16LE 2 48000", "alsa_output.pci", false)
+        + row('R', 45, 0, 0, "  9.8us", "  5.2us", " 0.01", " 0.00", 0, "F32LE 2 48000", "wavemux_game", true)
+        + row('R', 46, 0, 0, "  1.5ms", "   --- ", " 0.07", " --- ", 0, "", "loopback-12-34", true);
+
+    const PwTopSnapshot snapshot(text);
+    ASSERT_EQ(snapshot.nodes().size(), 4u);
+
+    const auto *driver = snapshot.find(30);
+    ASSERT_NE(driver, nullptr);
+    EXPECT_EQ(driver->state, 'R');
+    EXPECT_FALSE(driver->follower);
+    EXPECT_EQ(driver->quantum, 1024u);
+    EXPECT_EQ(driver->rate, 48000u);
+    EXPECT_DOUBLE_EQ(*driver->waitUs, 12.3);
+    EXPECT_DOUBLE_EQ(*driver->busyUs, 21.0);
+    EXPECT_DOUBLE_EQ(*driver->busyQuantum, 0.02);
+    EXPECT_EQ(driver->errors, 3u);
+    EXPECT_EQ(driver->name, "alsa_output.pci");
+
+    const auto *follower = snapshot.find(45);
+    ASSERT_NE(follower, nullptr);
+    EXPECT_TRUE(follower->follower);
+    EXPECT_EQ(follower->name, "wavemux_game");
+    EXPECT_DOUBLE_EQ(*follower->busyUs, 5.2);
+
+    const auto *idle = snapshot.find(28);
+    EXPECT_EQ(idle->state, 'S');
+    EXPECT_FALSE(idle->busyUs);
+    EXPECT_FALSE(idle->busyQuantum);
+    EXPECT_EQ(idle->name, "Dummy-Driver");
+
+    const auto *partial = snapshot.find(46);
+    EXPECT_DOUBLE_EQ(*partial->waitUs, 1500.0);
+    EXPECT_FALSE(partial->busyUs);
+    EXPECT_EQ(partial->name, "loopback-12-34");
+
+    EXPECT_EQ(snapshot.find(99), nullptr);
+}
+
+TEST(PwTopParserTest, KeepsOnlyTheLastSnapshot) {
+    const std::string text = std::string(HEADER)
+        + row('R', 30, 1024, 48000, " 50.0us", " 40.0us", " 0.01", " 0.02", 0, "", "first", false)
+        + "\n" + HEADER
+        + row('R', 31, 256, 48000, " 10.0us", " 20.0us", " 0.01", " 0.02", 0, "", "second", false);
+    const PwTopSnapshot snapshot(text);
+    ASSERT_EQ(snapshot.nodes().size(), 1u);
+    EXPECT_EQ(snapshot.nodes()[0].name, "second");
+    EXPECT_EQ(snapshot.nodes()[0].quantum, 256u);
+}
+
+TEST(PwTopParserTest, ToleratesMalformedInput) {
+    EXPECT_TRUE(PwTopSnapshot("").nodes().empty());
+    EXPECT_TRUE(PwTopSnapshot("R 30 1024\n").nodes().empty());
+    EXPECT_TRUE(PwTopSnapshot("R x 1024 48000 1us 1us 0.1 0.1 0 name\n").nodes().empty());
+    EXPECT_TRUE(PwTopSnapshot("RR 30 1024 48000 1us 1us 0.1 0.1 0 name\n").nodes().empty());
+    // Short rows without the padded format column still give a name
+    const PwTopSnapshot bare("R 30 1024 48000 1.0us 2.0us 0.1 0.2 0 name\n");
+    ASSERT_EQ(bare.nodes().size(), 1u);
+    EXPECT_EQ(bare.nodes()[0].name, "name");
+
+    EXPECT_EQ(PwTopSnapshot::timeUs("2.0s"), 2000000.0);
+    EXPECT_EQ(PwTopSnapshot::timeUs("0.5ms"), 500.0);
+    EXPECT_FALSE(PwTopSnapshot::timeUs("---"));
+    EXPECT_FALSE(PwTopSnapshot::timeUs("+++"));
+    EXPECT_FALSE(PwTopSnapshot::timeUs("us"));
+    EXPECT_FALSE(PwTopSnapshot::timeUs("1.2.3us"));
+    EXPECT_FALSE(PwTopSnapshot::timeUs("-1us"));
+}
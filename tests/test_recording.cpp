@@ -0,0 +1,218 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <numeric>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+#include "dsp/replayring.h"
+#include "dsp/ringbuffer.h"
+#include "wavfilewriter.h"
+
+namespace {
+    uint32_t readU32(const std::vector<char> &bytes, size_t at) {
+        uint32_t value = 0;
+        for (int i = 3; i >= 0; --i) {
+            value = (value << 8) | static_cast<unsigned char>(bytes[at + i]);
+        }
+        return value;
+    }
+
+    std::vector<char> readFile(const std::string &path) {
+        std::ifstream file(path, std::ios::binary);
+        return std::vector<char>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    std::string tempPath(const char *name) {
+        return std::string("/tmp/wavemux_test_") + std::to_string(getpid()) + "_" + name;
+    }
+}
+
+TEST(SpscRingBufferTest, RoundsCapacityToPowerOfTwo) {
+    WaveMux::SpscRingBuffer<float> ring(1000);
+    EXPECT_EQ(ring.capacity(), 1024u);
+    EXPECT_EQ(ring.writeAvailable(), 1024u);
+    EXPECT_EQ(ring.readAvailable(), 0u);
+}
+
+TEST(SpscRingBufferTest, WrapsAroundAndRefusesOverflow) {
+    WaveMux::SpscRingBuffer<int> ring(8);
+    std::vector<int> data(6);
+    std::iota(data.begin(), data.end(), 0);
+
+    EXPECT_EQ(ring.write(data.data(), 6), 6u);
+    std::vector<int> out(6);
+    EXPECT_EQ(ring.read(out.data(), 4), 4u);
+    EXPECT_EQ(out[3], 3);
+
+    // 2 left + 6 more crosses the end of the storage
+    EXPECT_EQ(ring.write(data.data(), 6), 6u);
+    EXPECT_EQ(ring.write(data.data(), 1), 0u);  // Full
+    EXPECT_EQ(ring.read(out.data(), 6), 6u);
+    EXPECT_EQ(out[0], 4);
+    EXPECT_EQ(out[1], 5);
+    EXPECT_EQ(out[2], 0);
+    EXPECT_EQ(out[5], 3);
+}
+
+TEST(SpscRingBufferTest, TransfersAcrossThreadsInOrder) {
+    WaveMux::SpscRingBuffer<uint32_t> ring(256);
+    constexpr uint32_t COUNT = 200000;
+
+    std::thread producer([&]() {
+        uint32_t next = 0;
+        while (next < COUNT) {
+            uint32_t value = next;
+            if (ring.write(&value, 1) == 0) {
+                std::this_thread::yield();  // Full
+            } else {
+                ++next;
+            }
+        }
+    });
+
+    uint32_t expected = 0;
+    bool inOrder = true;
+    while (expected < COUNT) {
+        uint32_t values[64];
+        const size_t count = ring.read(values, 64);
+        if (count == 0) {
+            std::this_thread::yield();
+        }
+        for (size_t i = 0; i < count; ++i) {
+            inOrder = inOrder && values[i] == expected++;
+        }
+    }
+    producer.join();
+    EXPECT_TRUE(inOrder);
+}
+
+TEST(ReplayRingTest, KeepsOnlyTheNewestHistory) {
+    WaveMux::ReplayRing ring(100, 16, false);
+    std::vector<float> block(16);
+    float next = 0.0f;
+    for (int i = 0; i < 20; ++i) {  // 320 samples into a 100-sample history
+        for (auto &sample : block) {
+            sample = next++;
+        }
+        ring.write(block.data(), block.size());
+    }
+    EXPECT_EQ(ring.written(), 320u);
+
+    std::vector<float> out(200);
+    ASSERT_EQ(ring.snapshot(out.data(), out.size()), 100u);
+    EXPECT_FLOAT_EQ(out[0], 220.0f);
+    EXPECT_FLOAT_EQ(out[99], 319.0f);
+
+    // Shorter requests take the tail
+    ASSERT_EQ(ring.snapshot(out.data(), 10), 10u);
+    EXPECT_FLOAT_EQ(out[0], 310.0f);
+}
+
+TEST(ReplayRingTest, CompactStorageHalvesMemory) {
+    WaveMux::ReplayRing compact(48000, 2048, true);
+    WaveMux::ReplayRing full(48000, 2048, false);
+    EXPECT_EQ(compact.memoryBytes() * 2, full.memoryBytes());
+
+    const float samples[] = {0.5f, -0.25f, 2.0f, -2.0f};
+    compact.write(samples, 4);
+    float out[4];
+    ASSERT_EQ(compact.snapshot(out, 4), 4u);
+    EXPECT_NEAR(out[0], 0.5f, 1.0f / 32767.0f);
+    EXPECT_NEAR(out[1], -0.25f, 1.0f / 32767.0f);
+    EXPECT_FLOAT_EQ(out[2], 1.0f);  // Clipped
+    EXPECT_FLOAT_EQ(out[3], -1.0f);
+}
+
+TEST(ReplayRingTest, SnapshotsStayConsistentWhileWriting) {
+    // Samples count up, so a consistent snapshot is a run of consecutive values
+    WaveMux::ReplayRing ring(4096, 256, false);
+    std::atomic<bool> done{false};
+    std::thread writer([&]() {
+        std::vector<float> block(256);
+        float next = 0.0f;
+        while (!done) {
+            for (auto &sample : block) {
+                sample = next;
+                next = next < 1.0e6f ? next + 1.0f : 0.0f;
+            }
+            ring.write(block.data(), block.size());
+        }
+    });
+
+    std::vector<float> out(4096);
+    bool consistent = true;
+    for (int i = 0; i < 2000 && consistent; ++i) {
+        while (ring.written() < ring.history()) {
+            std::this_thread::yield();
+        }
+        const size_t count = ring.snapshot(out.data(), out.size());
+        for (size_t j = 1; j < count; ++j) {
+            consistent = consistent && (out[j] == out[j - 1] + 1.0f || out[j] == 0.0f);
+        }
+    }
+    done = true;
+    writer.join();
+    EXPECT_TRUE(consistent);
+}
+
+TEST(WavFileWriterTest, WritesFloatWavWithAlignedData) {
+    const std::string path = tempPath("aligned.wav");
+    WaveMux::WavFileWriter writer;
+    ASSERT_TRUE(writer.open(path, 48000, 2));
+
+    std::vector<float> samples(4800 * 2);
+    for (size_t i = 0; i < samples.size(); ++i) {
+        samples[i] = static_cast<float>(i) / samples.size();
+    }
+    EXPECT_TRUE(writer.write(samples.data(), samples.size()));
+    EXPECT_TRUE(writer.close());
+
+    const auto bytes = readFile(path);
+    ASSERT_EQ(bytes.size(), WaveMux::WavFileWriter::HEADER_BYTES + samples.size() * sizeof(float));
+    EXPECT_EQ(std::memcmp(bytes.data(), "RIFF", 4), 0);
+    EXPECT_EQ(readU32(bytes, 4), bytes.size() - 8);
+    EXPECT_EQ(std::memcmp(bytes.data() + 8, "WAVE", 4), 0);
+    EXPECT_EQ(readU32(bytes, 24), 48000u);
+    EXPECT_EQ(readU32(bytes, 46), 4800u);  // fact: frames
+
+    // Data chunk header sits right before the page boundary
+    const size_t dataHeader = WaveMux::WavFileWriter::HEADER_BYTES - 8;
+    EXPECT_EQ(std::memcmp(bytes.data() + dataHeader, "data", 4), 0);
+    EXPECT_EQ(readU32(bytes, dataHeader + 4), samples.size() * sizeof(float));
+
+    float last = 0.0f;
+    std::memcpy(&last, bytes.data() + bytes.size() - sizeof(float), sizeof(float));
+    EXPECT_FLOAT_EQ(last, samples.back());
+    std::remove(path.c_str());
+}
+
+TEST(WavFileWriterTest, SpansSeveralBufferFlushes) {
+    const std::string path = tempPath("large.wav");
+    WaveMux::WavFileWriter writer;
+    ASSERT_TRUE(writer.open(path, 48000, 2));
+
+    // 2.5 MiB in odd-sized pieces
+    std::vector<float> piece(3001, 0.5f);
+    size_t total = 0;
+    while (total * sizeof(float) < 5 * WaveMux::WavFileWriter::BUFFER_BYTES / 2) {
+        ASSERT_TRUE(writer.write(piece.data(), piece.size()));
+        total += piece.size();
+    }
+    EXPECT_EQ(writer.dataBytes(), total * sizeof(float));
+    EXPECT_TRUE(writer.close());
+
+    const auto bytes = readFile(path);
+    EXPECT_EQ(bytes.size(), WaveMux::WavFileWriter::HEADER_BYTES + total * sizeof(float));
+    std::remove(path.c_str());
+}
+
+TEST(WavFileWriterTest, FailsForMissingDirectory) {
+    WaveMux::WavFileWriter writer;
+    EXPECT_FALSE(writer.open("/nonexistent-dir/x.wav", 48000, 2));
+    EXPECT_FALSE(writer.isOpen());
+    EXPECT_NE(writer.lastError(), 0);
+}
@@ -0,0 +1,79 @@
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+#include "stats.h"
+
+TEST(HistogramTest, BucketsAreAQuarterOctaveWide) {
+    using WaveMux::Histogram;
+    EXPECT_EQ(Histogram::bucketFor(0), 0u);
+    EXPECT_EQ(Histogram::bucketFor(3), 3u);
+    EXPECT_EQ(Histogram::bucketFor(4), 4u);
+    EXPECT_EQ(Histogram::bucketFor(8), 8u);
+    EXPECT_EQ(Histogram::bucketFor(1000), Histogram::bucketFor(1023));
+    EXPECT_NE(Histogram::bucketFor(1000), Histogram::bucketFor(1024));
+    EXPECT_EQ(Histogram::bucketFor(UINT64_MAX), Histogram::BUCKETS - 1);
+
+    // Every bucket's representative value falls back into that bucket
+    for (size_t bucket = 0; bucket < Histogram::BUCKETS; ++bucket) {
+        EXPECT_EQ(Histogram::bucketFor(Histogram::bucketValue(bucket)), bucket);
+    }
+}
+
+TEST(HistogramTest, SummarizesPercentiles) {
+    WaveMux::Histogram histogram;
+    for (uint64_t value = 1; value <= 1000; ++value) {
+        histogram.record(value);
+    }
+    const auto summary = histogram.summary();
+    EXPECT_EQ(summary.count, 1000u);
+    EXPECT_EQ(summary.sum, 500500u);
+    EXPECT_EQ(summary.max, 1000u);
+    EXPECT_NEAR(static_cast<double>(summary.p50), 500.0, 50.0);
+    EXPECT_NEAR(static_cast<double>(summary.p99), 990.0, 100.0);
+    EXPECT_LE(summary.p99, summary.max);
+
+    histogram.reset();
+    EXPECT_EQ(histogram.summary().count, 0u);
+    EXPECT_EQ(histogram.summary().p50, 0u);
+}
+
+TEST(HistogramTest, CountsEverySampleFromManyThreads) {
+    WaveMux::Histogram histogram;
+    WaveMux::Counter counter;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&, t]() {
+            for (int i = 0; i < 10000; ++i) {
+                histogram.record(static_cast<uint64_t>(t * 100 + 1));
+                counter.add();
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(histogram.summary().count, 40000u);
+    EXPECT_EQ(histogram.summary().max, 301u);
+    EXPECT_EQ(counter.value(), 40000u);
+}
+
+TEST(StatsTest, RegistryReturnsTheSameMetric) {
+    WaveMux::Histogram &first = WaveMux::Stats::histogram("test.operation");
+    WaveMux::Histogram &second = WaveMux::Stats::histogram("test.operation");
+    EXPECT_EQ(&first, &second);
+
+    first.record(1500);
+    WaveMux::Stats::counter("test.events").add(3);
+    {
+        const WaveMux::ScopedTimer timer(WaveMux::Stats::histogram("test.scope"));
+    }
+    EXPECT_EQ(WaveMux::Stats::histogram("test.scope").summary().count, 1u);
+
+    const std::string dump = WaveMux::Stats::dump();
+    EXPECT_NE(dump.find("test.operation"), std::string::npos);
+    EXPECT_NE(dump.find("1.50 ms"), std::string::npos);
+    EXPECT_NE(dump.find("test.events"), std::string::npos);
+
+    WaveMux::Stats::reset();
+    EXPECT_EQ(WaveMux::Stats::counter("test.events").value(), 0u);
+}
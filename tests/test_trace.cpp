@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <vector>
+#include "trace.h"
+
+namespace {
+    size_t occurrences(const std::string &text, const std::string &pattern) {
+        size_t count = 0;
+        for (size_t at = text.find(pattern); at != std::string::npos; at = text.find(pattern, at + 1)) {
+            ++count;
+        }
+        return count;
+    }
+}
+
+class TraceTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        WaveMux::Trace::setEnabled(false);
+        WaveMux::Trace::clear();
+    }
+    void TearDown() override {
+        WaveMux::Trace::setEnabled(false);
+        WaveMux::Trace::clear();
+    }
+};
+
+TEST_F(TraceTest, RecordsNothingWhileDisabled) {
+    {
+        const WaveMux::TraceSpan span("backend", "pactl list sinks");
+        WaveMux::Trace::instant("event", "sink #1");
+    }
+    EXPECT_EQ(WaveMux::Trace::eventCount(), 0u);
+    EXPECT_EQ(occurrences(WaveMux::Trace::chromeJson(), "\"ph\""), 0u);
+}
+
+TEST_F(TraceTest, ExportsSpansAsChromeJson) {
+    WaveMux::Trace::setEnabled(true);
+    {
+        const WaveMux::TraceSpan outer("mix", "updateLoopbacks");
+        const WaveMux::TraceSpan inner("backend", "pactl load-module \"quoted\"");
+    }
+    WaveMux::Trace::instant("event", "Event 'new' on sink #7");
+
+    const std::string json = WaveMux::Trace::chromeJson();
+    EXPECT_EQ(json.rfind("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", 0), 0u);
+    EXPECT_EQ(occurrences(json, "\"ph\":\"X\""), 2u);
+    EXPECT_EQ(occurrences(json, "\"ph\":\"i\""), 1u);
+    EXPECT_NE(json.find("\"name\":\"pactl load-module \\\"quoted\\\"\",\"cat\":\"backend\""), std::string::npos);
+
+    // Sorted by start: the outer span ends last but starts first
+    EXPECT_LT(json.find("updateLoopbacks"), json.find("pactl load-module"));
+}
+
+TEST_F(TraceTest, KeepsTheNewestEventsWhenTheRingWraps) {
+    WaveMux::Trace::setEnabled(true);
+    const size_t total = WaveMux::Trace::CAPACITY + 100;
+    for (size_t i = 0; i < total; ++i) {
+        WaveMux::Trace::complete("test", ("event " + std::to_string(i)).c_str(), i, 1);
+    }
+    EXPECT_EQ(WaveMux::Trace::eventCount(), WaveMux::Trace::CAPACITY);
+
+    const std::string json = WaveMux::Trace::chromeJson();
+    EXPECT_EQ(occurrences(json, "\"ph\":\"X\""), WaveMux::Trace::CAPACITY);
+    EXPECT_EQ(json.find("\"event 99\""), std::string::npos);
+    EXPECT_NE(json.find("\"event 100\""), std::string::npos);
+    EXPECT_NE(json.find("\"event " + std::to_string(total - 1) + "\""), std::string::npos);
+}
+
+TEST_F(TraceTest, RecordsFromManyThreads) {
+    WaveMux::Trace::setEnabled(true);
+    constexpr int THREADS = 4;
+    constexpr int SPANS = 1000;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; ++t) {
+        threads.emplace_back([]() {
+            for (int i = 0; i < SPANS; ++i) {
+                const WaveMux::TraceSpan span("dbus", "SetVolume");
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(WaveMux::Trace::eventCount(), static_cast<size_t>(THREADS * SPANS));
+    EXPECT_EQ(occurrences(WaveMux::Trace::chromeJson(), "\"name\":\"SetVolume\""), static_cast<size_t>(THREADS * SPANS));
+}
@@ -27,6 +27,8 @@ TEST_F(TypesTest, StreamDefaultValues) {
     EXPECT_TRUE(stream.mediaName.isEmpty());
     EXPECT_TRUE(stream.processName.isEmpty());
     EXPECT_TRUE(stream.assignedChannel.isEmpty());
+    EXPECT_EQ(stream.volume, 100);
+    EXPECT_FALSE(stream.muted);
 }
 
 TEST_F(TypesTest, DeviceDefaultValues) {
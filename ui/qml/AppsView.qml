@@ -66,7 +66,7 @@ Rectangle {
                     clip: true
                     spacing: 8
 
-                    model: daemon.streams
+                    model: daemon.streamModel
 
                     delegate: Rectangle {
                         id: streamDelegate
@@ -76,11 +76,13 @@ Rectangle {
                         color: "#0d0d0d"
 
                         // Store stream data for inner repeater access
-                        property int streamId: modelData.id
-                        property string streamChannel: modelData.assignedChannel || ""
-                        property string streamAppName: modelData.appName || ""
-                        property string streamProcessName: modelData.processName || ""
-                        property string streamMediaName: modelData.mediaName || ""
+                        property int streamId: model.streamId
+                        property string streamChannel: model.assignedChannel || ""
+                        property string streamAppName: model.appName || ""
+                        property string streamProcessName: model.processName || ""
+                        property string streamMediaName: model.mediaName || ""
+                        property int streamVolume: model.volume
+                        property bool streamMuted: model.muted
 
                         RowLayout {
                             anchors.fill: parent
@@ -128,6 +130,71 @@ Rectangle {
                                 }
                             }
 
+                            // App level within its channel
+                            Slider {
+                                id: appVolumeSlider
+                                Layout.preferredWidth: 90
+                                from: 0
+                                to: 100
+                                stepSize: 1
+                                value: streamDelegate.streamVolume
+                                opacity: streamDelegate.streamMuted ? 0.4 : 1.0
+
+                                onMoved: daemon.setStreamVolume(streamDelegate.streamId, Math.round(value))
+
+                                onPressedChanged: {
+                                    if (!pressed) {
+                                        value = Qt.binding(function() { return streamDelegate.streamVolume })
+                                    }
+                                }
+
+                                background: Rectangle {
+                                    x: appVolumeSlider.leftPadding
+                                    y: appVolumeSlider.topPadding + appVolumeSlider.availableHeight / 2 - height / 2
+                                    width: appVolumeSlider.availableWidth
+                                    height: 4
+                                    radius: 2
+                                    color: "#333333"
+
+                                    Rectangle {
+                                        width: appVolumeSlider.visualPosition * parent.width
+                                        height: parent.height
+                                        radius: 2
+                                        color: "#ff6b35"
+                                    }
+                                }
+
+                                handle: Rectangle {
+                                    x: appVolumeSlider.leftPadding + appVolumeSlider.visualPosition * (appVolumeSlider.availableWidth - width)
+                                    y: appVolumeSlider.topPadding + appVolumeSlider.availableHeight / 2 - height / 2
+                                    width: 12
+                                    height: 12
+                                    radius: 6
+                                    color: appVolumeSlider.pressed ? "#ff6b35" : "#ffffff"
+                                }
+                            }
+
+                            Rectangle {
+                                width: 28
+                                height: 28
+                                radius: 4
+                                color: streamDelegate.streamMuted ? "#e94560" : "#2a2a2a"
+
+                                Label {
+                                    anchors.centerIn: parent
+                                    text: "M"
+                                    font.pixelSize: 11
+                                    font.bold: true
+                                    color: streamDelegate.streamMuted ? "#ffffff" : "#888888"
+                                }
+
+                                MouseArea {
+                                    anchors.fill: parent
+                                    cursorShape: Qt.PointingHandCursor
+                                    onClicked: daemon.setStreamMute(streamDelegate.streamId, !streamDelegate.streamMuted)
+                                }
+                            }
+
                             // Channel buttons
                             Row {
                                 spacing: 6
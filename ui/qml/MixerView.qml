@@ -13,6 +13,18 @@ Rectangle {
         "aux": { color: "#9C27B0", icon: "🔊", name: "AUX" }
     })
 
+    // The daemon only analyzes audio while someone watches, so only ask for
+    // the spectrum while the mixer is on screen
+    readonly property bool spectrumWanted: visible && daemon.connected
+    function updateSpectrumSubscription() {
+        if (spectrumWanted)
+            daemon.subscribeSpectrum(Object.keys(channelConfig))
+        else
+            daemon.unsubscribeSpectrum()
+    }
+    onSpectrumWantedChanged: updateSpectrumSubscription()
+    Component.onCompleted: updateSpectrumSubscription()
+
     ColumnLayout {
         anchors.fill: parent
         anchors.margins: 24
@@ -26,7 +38,7 @@ Rectangle {
 
             // Channel strips
             Repeater {
-                model: daemon.channels
+                model: daemon.channelModel
 
                 Rectangle {
                     id: channelStrip
@@ -35,7 +47,7 @@ Rectangle {
                     radius: 16
                     color: "#1a1a1a"
 
-                    property string chId: modelData.id
+                    property string chId: model.channelId
                     property var config: channelConfig[chId] || { color: "#666", icon: "?", name: "Unknown" }
 
                     // Colored top accent bar
@@ -63,7 +75,7 @@ Rectangle {
                         radius: 16
                         color: "transparent"
                         border.color: channelStrip.config.color
-                        border.width: modelData.volume > 0 && !modelData.muted ? 1 : 0
+                        border.width: model.volume > 0 && !model.muted ? 1 : 0
                         opacity: 0.3
                     }
 
@@ -103,11 +115,36 @@ Rectangle {
                                 font.pixelSize: 14
                                 font.bold: true
                                 font.letterSpacing: 0.5
-                                color: modelData.muted ? "#555" : "#fff"
+                                color: model.muted ? "#555" : "#fff"
                                 anchors.horizontalCenter: parent.horizontalCenter
                             }
                         }
 
+                        // Live spectrum, -90..0 dBFS
+                        Canvas {
+                            id: spectrumCanvas
+                            Layout.fillWidth: true
+                            Layout.preferredHeight: 28
+
+                            property var bands: daemon.spectrum[channelStrip.chId] || []
+                            property bool muted: model.muted
+                            onBandsChanged: requestPaint()
+                            onMutedChanged: requestPaint()
+
+                            onPaint: {
+                                var ctx = getContext("2d")
+                                ctx.clearRect(0, 0, width, height)
+                                if (bands.length === 0)
+                                    return
+                                ctx.fillStyle = muted ? "#555" : channelStrip.config.color
+                                var barWidth = width / bands.length
+                                for (var i = 0; i < bands.length; ++i) {
+                                    var level = Math.max(0, Math.min(1, (bands[i] + 90) / 90))
+                                    ctx.fillRect(i * barWidth, height * (1 - level), Math.max(1, barWidth - 0.5), height * level)
+                                }
+                            }
+                        }
+
                         // Two vertical sliders side by side (Personal + Stream)
                         RowLayout {
                             Layout.fillWidth: true
@@ -123,7 +160,7 @@ Rectangle {
                                 // Use separate drag value to avoid breaking binding
                                 property bool dragging: false
                                 property int dragVolume: 0
-                                property int displayVolume: dragging ? dragVolume : modelData.personalVolume
+                                property int displayVolume: dragging ? dragVolume : model.personalVolume
 
                                 Column {
                                     anchors.fill: parent
@@ -197,7 +234,7 @@ Rectangle {
                                                 let relY = Math.max(0, Math.min(personalTrack.height, personalMouse.mouseY - personalTrack.y))
                                                 let vol = Math.round((1 - relY / personalTrack.height) * 100)
                                                 personalSlider.dragVolume = vol
-                                                daemon.setChannelPersonalVolume(modelData.id, vol)
+                                                daemon.setChannelPersonalVolume(model.channelId, vol)
                                             }
                                         }
                                     }
@@ -224,7 +261,7 @@ Rectangle {
                                 // Use separate drag value to avoid breaking binding
                                 property bool dragging: false
                                 property int dragVolume: 0
-                                property int displayVolume: dragging ? dragVolume : modelData.streamVolume
+                                property int displayVolume: dragging ? dragVolume : model.streamVolume
 
                                 Behavior on opacity { NumberAnimation { duration: 200 } }
 
@@ -300,7 +337,7 @@ Rectangle {
                                                 let relY = Math.max(0, Math.min(streamTrack.height, streamMouse.mouseY - streamTrack.y))
                                                 let vol = Math.round((1 - relY / streamTrack.height) * 100)
                                                 streamSlider.dragVolume = vol
-                                                daemon.setChannelStreamVolume(modelData.id, vol)
+                                                daemon.setChannelStreamVolume(model.channelId, vol)
                                             }
                                         }
                                     }
@@ -322,13 +359,13 @@ Rectangle {
                             Layout.fillWidth: true
                             Layout.preferredHeight: 36
                             radius: 8
-                            color: modelData.muted ? channelStrip.config.color : "#252525"
+                            color: model.muted ? channelStrip.config.color : "#252525"
 
                             Behavior on color { ColorAnimation { duration: 150 } }
 
                             Label {
                                 anchors.centerIn: parent
-                                text: modelData.muted ? "🔇 MUTED" : "🔈 MUTE"
+                                text: model.muted ? "🔇 MUTED" : "🔈 MUTE"
                                 font.pixelSize: 10
                                 font.bold: true
                                 color: "#fff"
@@ -337,7 +374,7 @@ Rectangle {
                             MouseArea {
                                 anchors.fill: parent
                                 cursorShape: Qt.PointingHandCursor
-                                onClicked: daemon.setChannelMute(modelData.id, !modelData.muted)
+                                onClicked: daemon.setChannelMute(model.channelId, !model.muted)
                             }
                         }
                     }
@@ -573,7 +610,7 @@ Rectangle {
                         height: parent.height
 
                         Repeater {
-                            model: daemon.streams
+                            model: daemon.streamModel
 
                             Rectangle {
                                 id: appCard
@@ -582,8 +619,8 @@ Rectangle {
                                 radius: 12
                                 color: "#252525"
 
-                                property int streamId: modelData.id
-                                property string assignedCh: modelData.assignedChannel || ""
+                                property int streamId: model.streamId
+                                property string assignedCh: model.assignedChannel || ""
                                 property var chConfig: channelConfig[assignedCh]
 
                                 // Colored left border when assigned
@@ -660,7 +697,7 @@ Rectangle {
                                             spacing: 2
 
                                             Label {
-                                                text: modelData.appName || modelData.processName || "Unknown"
+                                                text: model.appName || model.processName || "Unknown"
                                                 font.pixelSize: 12
                                                 font.bold: true
                                                 color: "#fff"
@@ -669,7 +706,7 @@ Rectangle {
                                             }
 
                                             Label {
-                                                text: modelData.mediaName || (appCard.assignedCh ? channelConfig[appCard.assignedCh].name : "Unassigned")
+                                                text: model.mediaName || (appCard.assignedCh ? channelConfig[appCard.assignedCh].name : "Unassigned")
                                                 font.pixelSize: 10
                                                 color: appCard.assignedCh ? "#888" : "#f66"
                                                 elide: Text.ElideRight
@@ -726,7 +763,7 @@ Rectangle {
                             height: parent.height - 8
                             radius: 12
                             color: "#1f1f1f"
-                            visible: daemon.streams.length === 0
+                            visible: daemon.streamModel.count === 0
 
                             Column {
                                 anchors.centerIn: parent
@@ -39,21 +39,17 @@ Rectangle {
                     ComboBox {
                         id: outputCombo
                         Layout.fillWidth: true
-                        model: daemon.outputDevices
+                        model: daemon.deviceModel
                         textRole: "name"
 
                         currentIndex: {
-                            for (var i = 0; i < daemon.outputDevices.length; i++) {
-                                if (daemon.outputDevices[i].id === daemon.outputDevice) {
-                                    return i
-                                }
-                            }
-                            return -1
+                            daemon.deviceModel.count  // Re-evaluate when devices come and go
+                            return daemon.deviceModel.indexOf(daemon.outputDevice)
                         }
 
                         onActivated: {
                             if (currentIndex >= 0) {
-                                daemon.setOutputDevice(daemon.outputDevices[currentIndex].id)
+                                daemon.setOutputDevice(daemon.deviceModel.get(currentIndex).deviceId)
                                 daemon.saveConfig()
                             }
                         }
@@ -109,7 +105,7 @@ Rectangle {
                                     Label {
                                         anchors.fill: parent
                                         anchors.leftMargin: 10
-                                        text: modelData.name
+                                        text: model.name
                                         font.pixelSize: 12
                                         color: "#ffffff"
                                         verticalAlignment: Text.AlignVCenter
@@ -222,21 +218,17 @@ Rectangle {
                         ComboBox {
                             id: streamOutputCombo
                             Layout.fillWidth: true
-                            model: daemon.outputDevices
+                            model: daemon.deviceModel
                             textRole: "name"
 
                             currentIndex: {
-                                for (var i = 0; i < daemon.outputDevices.length; i++) {
-                                    if (daemon.outputDevices[i].id === daemon.streamOutputDevice) {
-                                        return i
-                                    }
-                                }
-                                return -1
+                                daemon.deviceModel.count  // Re-evaluate when devices come and go
+                                return daemon.deviceModel.indexOf(daemon.streamOutputDevice)
                             }
 
                             onActivated: {
                                 if (currentIndex >= 0) {
-                                    daemon.setStreamOutputDevice(daemon.outputDevices[currentIndex].id)
+                                    daemon.setStreamOutputDevice(daemon.deviceModel.get(currentIndex).deviceId)
                                     daemon.saveConfig()
                                 }
                             }
@@ -292,7 +284,7 @@ Rectangle {
                                         Label {
                                             anchors.fill: parent
                                             anchors.leftMargin: 10
-                                            text: modelData.name
+                                            text: model.name
                                             font.pixelSize: 12
                                             color: "#ffffff"
                                             verticalAlignment: Text.AlignVCenter
@@ -317,6 +309,236 @@ Rectangle {
                 }
             }
 
+            // Profiles
+            Rectangle {
+                Layout.fillWidth: true
+                Layout.preferredHeight: 130
+                color: "#1a1a1a"
+                radius: 8
+
+                ColumnLayout {
+                    anchors.fill: parent
+                    anchors.margins: 15
+                    spacing: 10
+
+                    Label {
+                        text: "PROFILES"
+                        font.pixelSize: 10
+                        font.bold: true
+                        font.letterSpacing: 1
+                        color: "#666666"
+                    }
+
+                    // Saved profiles - click to switch
+                    Flow {
+                        Layout.fillWidth: true
+                        spacing: 6
+
+                        Repeater {
+                            model: daemon.profiles
+
+                            Rectangle {
+                                width: profileLabel.implicitWidth + 24
+                                height: 28
+                                radius: 4
+                                color: daemon.activeProfile === modelData ? "#ff6b35" : "#0d0d0d"
+                                border.color: daemon.activeProfile === modelData ? "#ff6b35" : "#333333"
+                                border.width: 1
+
+                                Label {
+                                    id: profileLabel
+                                    anchors.centerIn: parent
+                                    text: modelData
+                                    font.pixelSize: 11
+                                    color: "#ffffff"
+                                }
+
+                                MouseArea {
+                                    anchors.fill: parent
+                                    cursorShape: Qt.PointingHandCursor
+                                    acceptedButtons: Qt.LeftButton | Qt.RightButton
+                                    onClicked: function(mouse) {
+                                        if (mouse.button === Qt.RightButton) {
+                                            daemon.deleteProfile(modelData)
+                                        } else {
+                                            daemon.switchProfile(modelData)
+                                        }
+                                    }
+                                }
+                            }
+                        }
+                    }
+
+                    // Save current mixer state as a profile
+                    RowLayout {
+                        Layout.fillWidth: true
+                        spacing: 8
+
+                        TextField {
+                            id: profileNameField
+                            Layout.fillWidth: true
+                            placeholderText: "Profile name (e.g. Gaming)"
+
+                            background: Rectangle {
+                                implicitHeight: 32
+                                radius: 4
+                                color: "#0d0d0d"
+                                border.color: "#333333"
+                                border.width: 1
+                            }
+                            color: "#ffffff"
+                            placeholderTextColor: "#555555"
+                            font.pixelSize: 12
+                            leftPadding: 12
+                        }
+
+                        Rectangle {
+                            width: 80
+                            height: 32
+                            radius: 4
+                            color: profileNameField.text.trim().length > 0 ? "#ff6b35" : "#2a2a2a"
+
+                            Label {
+                                anchors.centerIn: parent
+                                text: "SAVE"
+                                font.pixelSize: 10
+                                font.bold: true
+                                color: "#ffffff"
+                            }
+
+                            MouseArea {
+                                anchors.fill: parent
+                                cursorShape: Qt.PointingHandCursor
+                                onClicked: {
+                                    let name = profileNameField.text.trim()
+                                    if (name.length > 0) {
+                                        daemon.saveProfile(name)
+                                        profileNameField.text = ""
+                                    }
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+
+            // Graph load of the objects WaveMux created
+            Rectangle {
+                id: dspLoadPanel
+                Layout.fillWidth: true
+                Layout.preferredHeight: 160
+                color: "#1a1a1a"
+                radius: 8
+
+                property var load: daemon.dspLoad
+
+                // Samples only while the panel is on screen
+                Timer {
+                    interval: 2000
+                    repeat: true
+                    triggeredOnStart: true
+                    running: dspLoadPanel.visible && daemon.connected
+                    onTriggered: daemon.refreshDspLoad()
+                }
+
+                ColumnLayout {
+                    anchors.fill: parent
+                    anchors.margins: 15
+                    spacing: 8
+
+                    RowLayout {
+                        Layout.fillWidth: true
+
+                        Label {
+                            text: "DSP LOAD"
+                            font.pixelSize: 10
+                            font.bold: true
+                            font.letterSpacing: 1
+                            color: "#666666"
+                        }
+
+                        Item { Layout.fillWidth: true }
+
+                        Label {
+                            visible: dspLoadPanel.load.available === true
+                            text: (dspLoadPanel.load.ownLoad * 100).toFixed(1) + "% of cycle · graph "
+                                  + (dspLoadPanel.load.graphLoad * 100).toFixed(1) + "%"
+                                  + (dspLoadPanel.load.errors > 0 ? " · " + dspLoadPanel.load.errors + " xruns" : "")
+                            font.pixelSize: 11
+                            color: dspLoadPanel.load.errors > 0 ? "#ff6b35" : "#888888"
+                        }
+                    }
+
+                    // Mix engines time their own processing
+                    Label {
+                        Layout.fillWidth: true
+                        visible: text.length > 0
+                        text: {
+                            var engines = dspLoadPanel.load.engines || []
+                            var parts = []
+                            for (var i = 0; i < engines.length; i++) {
+                                parts.push(engines[i].mixId + " engine " + (engines[i].load * 100).toFixed(1)
+                                           + "% (" + engines[i].busyUs.toFixed(0) + " µs/block)")
+                            }
+                            return parts.join(" · ")
+                        }
+                        font.pixelSize: 11
+                        color: "#888888"
+                        elide: Text.ElideRight
+                    }
+
+                    ListView {
+                        id: nodeLoadList
+                        Layout.fillWidth: true
+                        Layout.fillHeight: true
+                        clip: true
+                        spacing: 2
+                        model: dspLoadPanel.load.nodes || []
+
+                        delegate: RowLayout {
+                            width: nodeLoadList.width
+                            spacing: 10
+
+                            Label {
+                                text: modelData.role
+                                font.pixelSize: 11
+                                font.family: "monospace"
+                                color: modelData.active ? "#ffffff" : "#555555"
+                                Layout.fillWidth: true
+                                elide: Text.ElideRight
+                            }
+
+                            Label {
+                                text: modelData.busyUs < 0 ? "—" : modelData.busyUs.toFixed(1) + " µs"
+                                font.pixelSize: 11
+                                color: "#888888"
+                                Layout.preferredWidth: 70
+                                horizontalAlignment: Text.AlignRight
+                            }
+
+                            Label {
+                                text: modelData.busyQuantum < 0 ? "" : (modelData.busyQuantum * 100).toFixed(1) + "%"
+                                font.pixelSize: 11
+                                color: modelData.errors > 0 ? "#ff6b35" : "#ffffff"
+                                Layout.preferredWidth: 50
+                                horizontalAlignment: Text.AlignRight
+                            }
+                        }
+
+                        Label {
+                            anchors.centerIn: parent
+                            text: dspLoadPanel.load.available === false ? dspLoadPanel.load.reason : "No load data yet"
+                            font.pixelSize: 12
+                            color: "#444444"
+                            visible: nodeLoadList.count === 0
+                            width: nodeLoadList.width
+                            horizontalAlignment: Text.AlignHCenter
+                            wrapMode: Text.WordWrap
+                        }
+                    }
+                }
+            }
+
             // Routing rules
             Rectangle {
                 Layout.fillWidth: true
@@ -98,10 +98,10 @@ Rectangle {
 
                     // Device count debug
                     Label {
-                        text: "Found " + daemon.outputDevices.length + " device(s)"
+                        text: "Found " + daemon.deviceModel.count + " device(s)"
                         font.pixelSize: 12
                         color: "#666666"
-                        visible: daemon.outputDevices.length === 0
+                        visible: daemon.deviceModel.count === 0
                     }
 
                     // Scrollable device list
@@ -118,22 +118,22 @@ Rectangle {
                             spacing: 8
 
                             Repeater {
-                                model: daemon.outputDevices
+                                model: daemon.deviceModel
 
                                 Rectangle {
                                     width: deviceScroll.availableWidth
                                     height: 60
                                     radius: 8
-                                    color: selectedOutput === modelData.id ? "#e94560" : "#252542"
-                                    border.color: selectedOutput === modelData.id ? "#e94560" : "#333355"
+                                    color: selectedOutput === model.deviceId ? "#e94560" : "#252542"
+                                    border.color: selectedOutput === model.deviceId ? "#e94560" : "#333355"
                                     border.width: 1
 
                                     MouseArea {
                                         anchors.fill: parent
                                         cursorShape: Qt.PointingHandCursor
                                         onClicked: {
-                                            selectedOutput = modelData.id
-                                            console.log("Selected device:", modelData.id)
+                                            selectedOutput = model.deviceId
+                                            console.log("Selected device:", model.deviceId)
                                         }
                                     }
 
@@ -147,11 +147,11 @@ Rectangle {
                                             height: 30
                                             radius: 15
                                             anchors.verticalCenter: parent.verticalCenter
-                                            color: selectedOutput === modelData.id ? "#ffffff" : "#333355"
+                                            color: selectedOutput === model.deviceId ? "#ffffff" : "#333355"
 
                                             Label {
                                                 anchors.centerIn: parent
-                                                text: selectedOutput === modelData.id ? "✓" : ""
+                                                text: selectedOutput === model.deviceId ? "✓" : ""
                                                 color: "#e94560"
                                                 font.pixelSize: 16
                                                 font.bold: true
@@ -164,7 +164,7 @@ Rectangle {
                                             spacing: 2
 
                                             Label {
-                                                text: modelData.name || "Unknown Device"
+                                                text: model.name || "Unknown Device"
                                                 font.pixelSize: 14
                                                 color: "#ffffff"
                                                 elide: Text.ElideRight
@@ -172,12 +172,12 @@ Rectangle {
                                             }
 
                                             Label {
-                                                text: modelData.description || ""
+                                                text: model.description || ""
                                                 font.pixelSize: 11
                                                 color: "#888888"
                                                 elide: Text.ElideRight
                                                 width: parent.width
-                                                visible: text !== "" && text !== modelData.name
+                                                visible: text !== "" && text !== model.name
                                             }
                                         }
                                     }
@@ -192,7 +192,7 @@ Rectangle {
                         Layout.preferredHeight: 100
                         radius: 8
                         color: "#252542"
-                        visible: daemon.outputDevices.length === 0
+                        visible: daemon.deviceModel.count === 0
 
                         Label {
                             anchors.centerIn: parent
@@ -328,9 +328,9 @@ Rectangle {
     }
 
     Component.onCompleted: {
-        console.log("SetupWizard loaded, devices:", daemon.outputDevices.length)
-        for (var i = 0; i < daemon.outputDevices.length; i++) {
-            console.log("  Device:", daemon.outputDevices[i].name)
+        console.log("SetupWizard loaded, devices:", daemon.deviceModel.count)
+        for (var i = 0; i < daemon.deviceModel.count; i++) {
+            console.log("  Device:", daemon.deviceModel.get(i).name)
         }
     }
 }